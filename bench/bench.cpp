@@ -0,0 +1,539 @@
+//  Boost Filesystem bench.cpp  --------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Runs the registered benchmarks. Results go to standard output as a console table,
+//  JSON or CSV. Given the JSON results of an earlier run as a baseline, each result
+//  also shows the ratio of its time to the baseline's, and the run fails if any ratio
+//  exceeds the allowed regression:
+//
+//    filesystem_bench --benchmark_format=json > baseline.json
+//    ... change the library ...
+//    filesystem_bench --benchmark_baseline=baseline.json --benchmark_max_regression=10
+
+#include "bench.hpp"
+
+#include <boost/version.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::string;
+
+namespace
+{
+  struct benchmark
+  {
+    const char*       name;
+    bench::function   f;
+  };
+
+  std::vector<benchmark>& registry()
+  {
+    static std::vector<benchmark> benchmarks;
+    return benchmarks;
+  }
+
+  struct result
+  {
+    string          name;
+    boost::int64_t  iterations;
+    double          ns;          // per iteration
+    double          items_rate;  // per second, or 0
+    double          bytes_rate;  // per second, or 0
+    double          baseline_ns; // or 0 if none
+  };
+
+  //  options
+  string filter;
+  double min_time = 0.5;  // seconds
+  string format("console");
+  string baseline_file;
+  double max_regression = -1.0;  // percent, or negative for no limit
+
+  bool option(const char* arg, const char* name, string& value)
+  {
+    std::size_t n = std::strlen(name);
+    if (std::strncmp(arg, name, n) != 0 || arg[n] != '=')
+      return false;
+    value = arg + n + 1;
+    return true;
+  }
+
+  //  A small JSON reader for read_baseline(). It accepts any JSON text and records the
+  //  real_time_ns of each object that also has a string name, wherever the object is,
+  //  so a baseline need not have been written by write_json() or kept its layout.
+  class json_reader
+  {
+  public:
+    json_reader(const string& text, std::map<string, double>& times)
+      : m_text(text), m_pos(0), m_times(times) {}
+
+    //  false if the text is not valid JSON
+    bool parse()
+    {
+      string s;
+      double d;
+      return value(s, d) != 0 && (skip_space(), m_pos == m_text.size());
+    }
+
+  private:
+    const string&               m_text;
+    std::size_t                 m_pos;
+    std::map<string, double>&   m_times;
+
+    void skip_space()
+    {
+      while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t'
+        || m_text[m_pos] == '\n' || m_text[m_pos] == '\r'))
+        ++m_pos;
+    }
+
+    bool next_is(char c)
+    {
+      skip_space();
+      if (m_pos == m_text.size() || m_text[m_pos] != c)
+        return false;
+      ++m_pos;
+      return true;
+    }
+
+    bool literal(const char* word)
+    {
+      std::size_t n = std::strlen(word);
+      if (m_text.compare(m_pos, n, word) != 0)
+        return false;
+      m_pos += n;
+      return true;
+    }
+
+    //  Parses a value into s or d, returning its kind: 's' for a string, 'n' for a
+    //  number, 'o' for anything else, or 0 if it is not valid
+    char value(string& s, double& d)
+    {
+      skip_space();
+      if (m_pos == m_text.size())
+        return 0;
+      switch (m_text[m_pos])
+      {
+      case '"': return string_value(s) ? 's' : 0;
+      case '{': return object() ? 'o' : 0;
+      case '[': return array() ? 'o' : 0;
+      case 't': return literal("true") ? 'o' : 0;
+      case 'f': return literal("false") ? 'o' : 0;
+      case 'n': return literal("null") ? 'o' : 0;
+      }
+      const char* first = m_text.c_str() + m_pos;
+      if (*first != '-' && (*first < '0' || *first > '9'))
+        return 0;
+      char* last;
+      d = std::strtod(first, &last);
+      m_pos += last - first;
+      return last != first ? 'n' : 0;
+    }
+
+    bool object()
+    {
+      ++m_pos;  // '{'
+      if (next_is('}'))
+        return true;
+      string name, key, s;
+      double time = 0, d = 0;
+      bool has_name = false, has_time = false;
+      do
+      {
+        skip_space();
+        if (m_pos == m_text.size() || m_text[m_pos] != '"' || !string_value(key)
+          || !next_is(':'))
+          return false;
+        char kind = value(s, d);
+        if (kind == 0)
+          return false;
+        if (key == "name" && kind == 's')
+        {
+          name.swap(s);
+          has_name = true;
+        }
+        else if (key == "real_time_ns" && kind == 'n')
+        {
+          time = d;
+          has_time = true;
+        }
+      } while (next_is(','));
+      if (!next_is('}'))
+        return false;
+      if (has_name && has_time)
+        m_times[name] = time;
+      return true;
+    }
+
+    bool array()
+    {
+      ++m_pos;  // '['
+      if (next_is(']'))
+        return true;
+      string s;
+      double d;
+      do
+      {
+        if (value(s, d) == 0)
+          return false;
+      } while (next_is(','));
+      return next_is(']');
+    }
+
+    bool string_value(string& s)
+    {
+      s.clear();
+      ++m_pos;  // '"'
+      while (m_pos < m_text.size())
+      {
+        unsigned char c = static_cast<unsigned char>(m_text[m_pos++]);
+        if (c == '"')
+          return true;
+        if (c < 0x20)
+          return false;
+        if (c != '\\')
+        {
+          s += static_cast<char>(c);
+          continue;
+        }
+        if (m_pos == m_text.size())
+          return false;
+        switch (m_text[m_pos++])
+        {
+        case '"':  s += '"'; break;
+        case '\\': s += '\\'; break;
+        case '/':  s += '/'; break;
+        case 'b':  s += '\b'; break;
+        case 'f':  s += '\f'; break;
+        case 'n':  s += '\n'; break;
+        case 'r':  s += '\r'; break;
+        case 't':  s += '\t'; break;
+        case 'u':
+          {
+            unsigned long cp;
+            if (!hex4(cp))
+              return false;
+            if (cp >= 0xD800 && cp < 0xDC00)  // a surrogate pair
+            {
+              unsigned long low;
+              if (!literal("\\u") || !hex4(low) || low < 0xDC00 || low > 0xDFFF)
+                return false;
+              cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            }
+            append_utf8(s, cp);
+            break;
+          }
+        default: return false;
+        }
+      }
+      return false;
+    }
+
+    bool hex4(unsigned long& cp)
+    {
+      if (m_text.size() - m_pos < 4)
+        return false;
+      cp = 0;
+      for (int i = 0; i < 4; ++i)
+      {
+        char c = m_text[m_pos++];
+        int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10
+          : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+        if (digit < 0)
+          return false;
+        cp = cp * 16 + digit;
+      }
+      return true;
+    }
+
+    static void append_utf8(string& s, unsigned long cp)
+    {
+      if (cp < 0x80)
+        s += static_cast<char>(cp);
+      else if (cp < 0x800)
+      {
+        s += static_cast<char>(0xC0 | cp >> 6);
+        s += static_cast<char>(0x80 | (cp & 0x3F));
+      }
+      else if (cp < 0x10000)
+      {
+        s += static_cast<char>(0xE0 | cp >> 12);
+        s += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        s += static_cast<char>(0x80 | (cp & 0x3F));
+      }
+      else
+      {
+        s += static_cast<char>(0xF0 | cp >> 18);
+        s += static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+        s += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        s += static_cast<char>(0x80 | (cp & 0x3F));
+      }
+    }
+  };
+
+  //  Reads the real_time_ns of each benchmark from JSON such as write_json() writes
+  std::map<string, double> read_baseline(const string& file)
+  {
+    std::map<string, double> times;
+    std::ifstream in(file.c_str(), std::ios_base::binary);
+    if (!in)
+    {
+      std::cerr << "error: cannot read baseline " << file << endl;
+      std::exit(1);
+    }
+    std::ostringstream text;
+    text << in.rdbuf();
+    if (!json_reader(text.str(), times).parse())
+    {
+      std::cerr << "error: baseline " << file << " is not valid JSON" << endl;
+      std::exit(1);
+    }
+    return times;
+  }
+
+  //  s as a JSON string, quoted and escaped
+  string json_string(const string& s)
+  {
+    string quoted("\"");
+    for (string::const_iterator it = s.begin(); it != s.end(); ++it)
+    {
+      unsigned char c = static_cast<unsigned char>(*it);
+      if (c == '"' || c == '\\')
+        (quoted += '\\') += static_cast<char>(c);
+      else if (c < 0x20)
+      {
+        char escape[8];
+        std::sprintf(escape, "\\u%04x", c);
+        quoted += escape;
+      }
+      else
+        quoted += static_cast<char>(c);
+    }
+    return quoted += '"';
+  }
+
+  //  s as a CSV field, quoted if it holds a comma, quote or line break
+  string csv_field(const string& s)
+  {
+    if (s.find_first_of(",\"\r\n") == string::npos)
+      return s;
+    string quoted("\"");
+    for (string::const_iterator it = s.begin(); it != s.end(); ++it)
+    {
+      if (*it == '"')
+        quoted += '"';
+      quoted += *it;
+    }
+    return quoted += '"';
+  }
+
+  result run(const benchmark& b)
+  {
+    //  grow the iteration count until the run is long enough, as Google Benchmark does
+    boost::int64_t iterations = 1;
+    for (;;)
+    {
+      bench::state st(iterations);
+      b.f(st);
+      double seconds = st.elapsed() / 1e9;
+      if (seconds >= min_time || iterations >= 1000000000)
+      {
+        result r;
+        r.name = b.name;
+        r.iterations = iterations;
+        r.ns = st.elapsed() / static_cast<double>(iterations);
+        r.items_rate = seconds > 0 ? st.items_processed() / seconds : 0;
+        r.bytes_rate = seconds > 0 ? st.bytes_processed() / seconds : 0;
+        r.baseline_ns = 0;
+        return r;
+      }
+      double multiplier = seconds > 0 ? min_time * 1.4 / seconds : 10.0;
+      multiplier = (std::min)(multiplier, 10.0);
+      iterations = (std::max)(static_cast<boost::int64_t>(iterations * multiplier),
+        iterations + 1);
+    }
+  }
+
+  const void* volatile sink;  // for bench::use()
+
+  double ratio(const result& r)
+  {
+    return r.baseline_ns > 0 ? r.ns / r.baseline_ns : 0;
+  }
+
+  void write_console(const std::vector<result>& results)
+  {
+    cout << std::left << std::setw(36) << "benchmark" << std::right
+         << std::setw(14) << "ns/iter" << std::setw(14) << "iterations"
+         << std::setw(14) << "items/s" << std::setw(14) << "MB/s";
+    if (!baseline_file.empty())
+      cout << std::setw(14) << "baseline ns" << std::setw(10) << "ratio";
+    cout << '\n';
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      const result& r = results[i];
+      cout << std::left << std::setw(36) << r.name << std::right << std::fixed
+           << std::setprecision(1) << std::setw(14) << r.ns
+           << std::setw(14) << r.iterations
+           << std::setprecision(0) << std::setw(14) << r.items_rate
+           << std::setprecision(1) << std::setw(14) << r.bytes_rate / 1e6;
+      if (!baseline_file.empty())
+        cout << std::setw(14) << r.baseline_ns
+             << std::setprecision(3) << std::setw(10) << ratio(r);
+      cout << '\n';
+    }
+  }
+
+  void write_json(const std::vector<result>& results)
+  {
+    cout << "{\n  \"context\": { \"library\": \"boost_filesystem\", \"boost_version\": \""
+         << BOOST_LIB_VERSION << "\", \"min_time\": " << min_time
+         << ", \"baseline\": " << json_string(baseline_file)
+         << " },\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      const result& r = results[i];
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(3)
+         << "    { \"name\": " << json_string(r.name)
+         << ", \"iterations\": " << r.iterations
+         << ", \"real_time_ns\": " << r.ns
+         << ", \"items_per_second\": " << r.items_rate
+         << ", \"bytes_per_second\": " << r.bytes_rate;
+      if (r.baseline_ns > 0)
+        os << ", \"baseline_real_time_ns\": " << r.baseline_ns
+           << ", \"ratio\": " << ratio(r);
+      os << " }" << (i + 1 < results.size() ? "," : "") << '\n';
+      cout << os.str();
+    }
+    cout << "  ]\n}\n";
+  }
+
+  void write_csv(const std::vector<result>& results)
+  {
+    cout << "name,iterations,real_time_ns,items_per_second,bytes_per_second,"
+            "baseline_real_time_ns,ratio\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      const result& r = results[i];
+      cout << std::fixed << std::setprecision(3) << csv_field(r.name) << ','
+           << r.iterations << ',' << r.ns << ',' << r.items_rate << ','
+           << r.bytes_rate << ',';
+      if (r.baseline_ns > 0)
+        cout << r.baseline_ns << ',' << ratio(r);
+      else
+        cout << ',';
+      cout << '\n';
+    }
+  }
+}  // unnamed namespace
+
+namespace bench
+{
+  int register_benchmark(const char* name, function f)
+  {
+    benchmark b = { name, f };
+    registry().push_back(b);
+    return 0;
+  }
+
+  void use(const void* p) { sink = p; }
+}  // namespace bench
+
+//--------------------------------------------------------------------------------------//
+//                                      main                                            //
+//--------------------------------------------------------------------------------------//
+
+int cpp_main(int argc, char* argv[])
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    string value;
+    if (option(argv[i], "--benchmark_filter", filter)
+      || option(argv[i], "--benchmark_format", format)
+      || option(argv[i], "--benchmark_baseline", baseline_file))
+      continue;
+    if (option(argv[i], "--benchmark_min_time", value))
+      min_time = std::atof(value.c_str());
+    else if (option(argv[i], "--benchmark_max_regression", value))
+      max_regression = std::atof(value.c_str());
+    else if (std::strcmp(argv[i], "--benchmark_list_tests") == 0)
+    {
+      for (std::size_t j = 0; j < registry().size(); ++j)
+        cout << registry()[j].name << '\n';
+      return 0;
+    }
+    else
+    {
+      cout << "Usage: filesystem_bench [--benchmark_filter=<substring>]\n"
+              "  [--benchmark_min_time=<seconds>]\n"
+              "  [--benchmark_format=console|json|csv]\n"
+              "  [--benchmark_baseline=<json-file>]\n"
+              "  [--benchmark_max_regression=<percent>]\n"
+              "  [--benchmark_list_tests]\n";
+      return 1;
+    }
+  }
+  if (format != "console" && format != "json" && format != "csv")
+  {
+    std::cerr << "error: unknown format " << format << endl;
+    return 1;
+  }
+
+  std::map<string, double> baseline;
+  if (!baseline_file.empty())
+    baseline = read_baseline(baseline_file);
+
+  std::vector<result> results;
+  for (std::size_t i = 0; i < registry().size(); ++i)
+  {
+    const benchmark& b = registry()[i];
+    if (!filter.empty() && string(b.name).find(filter) == string::npos)
+      continue;
+    if (format != "console")
+      std::cerr << b.name << "..." << endl;
+    results.push_back(run(b));
+    std::map<string, double>::const_iterator it = baseline.find(b.name);
+    if (it != baseline.end())
+      results.back().baseline_ns = it->second;
+  }
+
+  if (format == "json")
+    write_json(results);
+  else if (format == "csv")
+    write_csv(results);
+  else
+    write_console(results);
+
+  int regressions = 0;
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    if (max_regression >= 0 && ratio(results[i]) > 1.0 + max_regression / 100.0)
+    {
+      std::cerr << "regression: " << results[i].name << " is " << std::fixed
+                << std::setprecision(1) << (ratio(results[i]) - 1.0) * 100.0
+                << "% slower than the baseline" << endl;
+      ++regressions;
+    }
+  }
+  return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+//  Boost Filesystem bench.hpp  --------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  A minimal benchmark harness in the style of Google Benchmark. A benchmark is a
+//  function taking a bench::state, registered by BOOST_FILESYSTEM_BENCHMARK, that
+//  repeats the work being measured while state.keep_running() is true:
+//
+//    void path_construct(bench::state& st)
+//    {
+//      while (st.keep_running())
+//        bench::do_not_optimize(fs::path("/foo/bar"));
+//    }
+//    BOOST_FILESYSTEM_BENCHMARK(path_construct);
+//
+//  The harness chooses the number of iterations so that each benchmark runs for at
+//  least the minimum time, and reports the wall-clock time per iteration.
+
+#ifndef BOOST_FILESYSTEM_BENCH_HPP
+#define BOOST_FILESYSTEM_BENCH_HPP
+
+#include <boost/cstdint.hpp>
+#include <boost/timer/timer.hpp>
+#include <string>
+
+namespace bench
+{
+  class state
+  {
+  public:
+    explicit state(boost::int64_t iterations)
+      : m_iterations(iterations), m_remaining(iterations), m_items(0), m_bytes(0),
+        m_started(false) {}
+
+    //  true while more iterations are wanted; the timer runs from the first call
+    bool keep_running()
+    {
+      if (!m_started)
+      {
+        m_started = true;
+        m_timer.start();
+      }
+      if (m_remaining-- > 0)
+        return true;
+      m_timer.stop();
+      return false;
+    }
+
+    //  exclude setup or teardown within an iteration from the time
+    void pause_timing()   { m_timer.stop(); }
+    void resume_timing()  { m_timer.resume(); }
+
+    //  work done by all iterations, reported as a rate
+    void set_items_processed(boost::int64_t n)  { m_items = n; }
+    void set_bytes_processed(boost::int64_t n)  { m_bytes = n; }
+
+    boost::int64_t iterations() const           { return m_iterations; }
+    boost::int64_t items_processed() const      { return m_items; }
+    boost::int64_t bytes_processed() const      { return m_bytes; }
+    boost::timer::nanosecond_type elapsed() const { return m_timer.elapsed().wall; }
+
+  private:
+    boost::int64_t            m_iterations;
+    boost::int64_t            m_remaining;
+    boost::int64_t            m_items;
+    boost::int64_t            m_bytes;
+    bool                      m_started;
+    boost::timer::cpu_timer   m_timer;
+  };
+
+  typedef void (*function)(state&);
+
+  //  returns 0 so that registration can initialize a namespace scope variable
+  int register_benchmark(const char* name, function f);
+
+  //  keeps the compiler from discarding a computed value
+  void use(const void* p);
+  template <class T>
+  inline void do_not_optimize(const T& value) { use(&value); }
+}  // namespace bench
+
+#define BOOST_FILESYSTEM_BENCHMARK(f) \
+  static int f##_registration = bench::register_benchmark(#f, f)
+
+#endif  // BOOST_FILESYSTEM_BENCH_HPP
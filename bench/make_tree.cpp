@@ -0,0 +1,159 @@
+//  Boost Filesystem make_tree.cpp  ----------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Builds a tree with generate_tree(), or removes one, so that a performance report
+//  can be reproduced from the profile and seed it gives. For example:
+//
+//    make_tree /tmp/t --profile=source --seed=42
+//    make_tree /tmp/t --remove
+
+#include <boost/config/warning_disable.hpp>
+
+#ifndef BOOST_FILESYSTEM_NO_DEPRECATED
+#  define BOOST_FILESYSTEM_NO_DEPRECATED
+#endif
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#  define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/tree_generator.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace fs = boost::filesystem;
+using std::cout;
+using std::string;
+
+namespace
+{
+  bool option(const char* arg, const char* name, string& value)
+  {
+    std::size_t n = std::strlen(name);
+    if (std::strncmp(arg, name, n) != 0 || arg[n] != '=')
+      return false;
+    value = arg + n + 1;
+    return true;
+  }
+
+  //  Named shapes; other options given after --profile adjust them
+  bool set_profile(const string& name, fs::tree_profile& profile)
+  {
+    profile = fs::tree_profile();
+    if (name == "small")
+      return true;
+    if (name == "wide")          // few levels of large directories
+    {
+      profile.fanout = 32;
+      profile.depth = 1;
+      profile.files_per_directory = 1000;
+      profile.max_file_size = 0;
+    }
+    else if (name == "deep")     // a long narrow chain
+    {
+      profile.fanout = 1;
+      profile.depth = 200;
+      profile.files_per_directory = 4;
+      profile.max_file_size = 0;
+    }
+    else if (name == "source")   // like a source tree: many small files, a few large
+    {
+      profile.fanout = 6;
+      profile.depth = 3;
+      profile.files_per_directory = 24;
+      profile.max_file_size = 256 * 1024;
+      profile.sizes = fs::tree_profile::log_uniform;
+      profile.symlink_ratio = 0.02;
+    }
+    else if (name == "sparse")   // large sparse files, as for disk images
+    {
+      profile.fanout = 2;
+      profile.depth = 2;
+      profile.files_per_directory = 8;
+      profile.min_file_size = 1024 * 1024;
+      profile.max_file_size = 256 * 1024 * 1024;
+      profile.sizes = fs::tree_profile::log_uniform;
+      profile.sparse_ratio = 0.9;
+    }
+    else
+      return false;
+    return true;
+  }
+
+  int usage()
+  {
+    cout << "Usage: make_tree <root> [--seed=<n>]\n"
+            "  [--profile=small|wide|deep|source|sparse]\n"
+            "  [--fanout=<n>] [--depth=<n>] [--files=<n>] [--min_size=<bytes>]\n"
+            "  [--max_size=<bytes>] [--sizes=uniform|log] [--symlinks=<ratio>]\n"
+            "  [--sparse=<ratio>]\n"
+            "   or: make_tree <root> --remove\n";
+    return 1;
+  }
+}  // unnamed namespace
+
+//--------------------------------------------------------------------------------------//
+//                                      main                                            //
+//--------------------------------------------------------------------------------------//
+
+int cpp_main(int argc, char* argv[])
+{
+  if (argc < 2 || argv[1][0] == '-')
+    return usage();
+  fs::path root(argv[1]);
+
+  if (argc == 3 && std::strcmp(argv[2], "--remove") == 0)
+  {
+    cout << fs::remove_all(root) << " entries removed\n";
+    return 0;
+  }
+
+  fs::tree_profile profile;
+  boost::uintmax_t seed = 1;
+  for (int i = 2; i < argc; ++i)
+  {
+    string value;
+    if (option(argv[i], "--seed", value))
+      seed = boost::lexical_cast<boost::uintmax_t>(value);
+    else if (option(argv[i], "--profile", value))
+    {
+      if (!set_profile(value, profile))
+        return usage();
+    }
+    else if (option(argv[i], "--fanout", value))
+      profile.fanout = boost::lexical_cast<unsigned>(value);
+    else if (option(argv[i], "--depth", value))
+      profile.depth = boost::lexical_cast<unsigned>(value);
+    else if (option(argv[i], "--files", value))
+      profile.files_per_directory = boost::lexical_cast<unsigned>(value);
+    else if (option(argv[i], "--min_size", value))
+      profile.min_file_size = boost::lexical_cast<boost::uintmax_t>(value);
+    else if (option(argv[i], "--max_size", value))
+      profile.max_file_size = boost::lexical_cast<boost::uintmax_t>(value);
+    else if (option(argv[i], "--sizes", value) && (value == "uniform" || value == "log"))
+      profile.sizes = value == "log"
+        ? fs::tree_profile::log_uniform : fs::tree_profile::uniform;
+    else if (option(argv[i], "--symlinks", value))
+      profile.symlink_ratio = boost::lexical_cast<double>(value);
+    else if (option(argv[i], "--sparse", value))
+      profile.sparse_ratio = boost::lexical_cast<double>(value);
+    else
+      return usage();
+  }
+
+  fs::tree_stats stats = fs::generate_tree(root, profile, seed);
+  cout << stats.directories << " directories, " << stats.files << " files ("
+       << stats.sparse_files << " sparse), " << stats.symlinks << " symlinks, "
+       << stats.bytes << " bytes\n";
+  return 0;
+}
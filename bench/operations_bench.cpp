@@ -0,0 +1,199 @@
+//  Boost Filesystem operations_bench.cpp  ---------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Macrobenchmarks of iteration, recursive traversal, status, copy_file and remove_all
+//  over trees made by generate_tree() in the temporary directory. Rates are entries or
+//  bytes per second, so that an extra system call per entry shows up directly.
+
+#include <boost/config/warning_disable.hpp>
+
+#ifndef BOOST_FILESYSTEM_NO_DEPRECATED
+#  define BOOST_FILESYSTEM_NO_DEPRECATED
+#endif
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#  define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include "bench.hpp"
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/tree_generator.hpp>
+
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+  const std::size_t copy_size = 1024 * 1024;
+  const boost::uint64_t seed = 1;
+
+  //  8 + 64 + 512 directories of 16 small files
+  fs::tree_profile tree_shape()
+  {
+    fs::tree_profile profile;
+    profile.fanout = 8;
+    profile.depth = 3;
+    profile.files_per_directory = 16;
+    profile.max_file_size = 64;
+    return profile;
+  }
+
+  //  4 + 16 directories of 8 small files, for remove_all
+  fs::tree_profile small_tree_shape()
+  {
+    fs::tree_profile profile;
+    profile.fanout = 4;
+    profile.depth = 2;
+    profile.files_per_directory = 8;
+    profile.max_file_size = 64;
+    return profile;
+  }
+
+  //  one directory of 1000 empty files
+  fs::tree_profile flat_shape()
+  {
+    fs::tree_profile profile;
+    profile.depth = 0;
+    profile.files_per_directory = 1000;
+    profile.max_file_size = 0;
+    return profile;
+  }
+
+  //  the trees shared by the benchmarks, removed at exit
+  struct fixture
+  {
+    fs::path                root;
+    std::vector<fs::path>   files;
+
+    fixture()
+      : root(fs::temp_directory_path() / fs::unique_path("filesystem_bench-%%%%-%%%%"))
+    {
+      fs::generate_tree(root / "tree", tree_shape(), seed);
+      for (fs::recursive_directory_iterator it(root / "tree");
+        it != fs::recursive_directory_iterator(); ++it)
+        if (fs::is_regular_file(it->status()))
+          files.push_back(it->path());
+      fs::generate_tree(root / "flat", flat_shape(), seed);
+      fs::save_string_file(root / "copy_source", std::string(copy_size, 'x'));
+      fs::create_directory(root / "scratch");
+    }
+   ~fixture()
+    {
+      boost::system::error_code ec;
+      fs::remove_all(root, ec);
+    }
+  };
+
+  const fixture& trees()
+  {
+    static const fixture fx;
+    return fx;
+  }
+
+  void directory_iterator_flat(bench::state& st)
+  {
+    const fs::path dir(trees().root / "flat");
+    boost::int64_t entries = 0;
+    while (st.keep_running())
+      for (fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it)
+        ++entries;
+    st.set_items_processed(entries);
+  }
+  BOOST_FILESYSTEM_BENCHMARK(directory_iterator_flat);
+
+  //  the type of each entry, which the iterator may know without a stat()
+  void directory_iterator_flat_status(bench::state& st)
+  {
+    const fs::path dir(trees().root / "flat");
+    boost::int64_t entries = 0;
+    while (st.keep_running())
+    {
+      for (fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it)
+      {
+        bench::do_not_optimize(it->symlink_status().type());
+        ++entries;
+      }
+    }
+    st.set_items_processed(entries);
+  }
+  BOOST_FILESYSTEM_BENCHMARK(directory_iterator_flat_status);
+
+  void recursive_directory_iterator_tree(bench::state& st)
+  {
+    const fs::path dir(trees().root / "tree");
+    boost::int64_t entries = 0;
+    while (st.keep_running())
+      for (fs::recursive_directory_iterator it(dir);
+        it != fs::recursive_directory_iterator(); ++it)
+        ++entries;
+    st.set_items_processed(entries);
+  }
+  BOOST_FILESYSTEM_BENCHMARK(recursive_directory_iterator_tree);
+
+  void recursive_directory_cursor_tree(bench::state& st)
+  {
+    const fs::path dir(trees().root / "tree");
+    fs::recursive_directory_cursor rc;
+    boost::int64_t entries = 0;
+    while (st.keep_running())
+      for (rc.open(dir); !rc.at_end(); rc.increment())
+        ++entries;
+    st.set_items_processed(entries);
+  }
+  BOOST_FILESYSTEM_BENCHMARK(recursive_directory_cursor_tree);
+
+  void status_files(bench::state& st)
+  {
+    const std::vector<fs::path>& files = trees().files;
+    while (st.keep_running())
+      for (std::size_t i = 0; i < files.size(); ++i)
+        bench::do_not_optimize(fs::status(files[i]));
+    st.set_items_processed(st.iterations() * files.size());
+  }
+  BOOST_FILESYSTEM_BENCHMARK(status_files);
+
+  void symlink_status_files(bench::state& st)
+  {
+    const std::vector<fs::path>& files = trees().files;
+    while (st.keep_running())
+      for (std::size_t i = 0; i < files.size(); ++i)
+        bench::do_not_optimize(fs::symlink_status(files[i]));
+    st.set_items_processed(st.iterations() * files.size());
+  }
+  BOOST_FILESYSTEM_BENCHMARK(symlink_status_files);
+
+  void copy_file_1mb(bench::state& st)
+  {
+    const fs::path from(trees().root / "copy_source");
+    const fs::path to(trees().root / "scratch" / "copy_target");
+    while (st.keep_running())
+      fs::copy_file(from, to, fs::copy_option::overwrite_if_exists);
+    st.set_bytes_processed(st.iterations() * copy_size);
+    fs::remove(to);
+  }
+  BOOST_FILESYSTEM_BENCHMARK(copy_file_1mb);
+
+  //  the tree is recreated, untimed, for each iteration
+  void remove_all_tree(bench::state& st)
+  {
+    const fs::path dir(trees().root / "scratch" / "remove_all");
+    boost::int64_t entries = 0;
+    while (st.keep_running())
+    {
+      st.pause_timing();
+      fs::tree_stats stats = fs::generate_tree(dir, small_tree_shape(), seed);
+      entries += stats.directories + stats.files + stats.symlinks;
+      st.resume_timing();
+      fs::remove_all(dir);
+    }
+    st.set_items_processed(entries);
+  }
+  BOOST_FILESYSTEM_BENCHMARK(remove_all_tree);
+}  // unnamed namespace
@@ -0,0 +1,150 @@
+//  Boost Filesystem path_bench.cpp  ---------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Microbenchmarks of class path: construction, parsing into elements, decomposition,
+//  comparison, hashing and conversion between narrow and wide encodings.
+
+#include <boost/config/warning_disable.hpp>
+
+#ifndef BOOST_FILESYSTEM_NO_DEPRECATED
+#  define BOOST_FILESYSTEM_NO_DEPRECATED
+#endif
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#  define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include "bench.hpp"
+#include <boost/filesystem/path.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <string>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+  const std::string narrow("/usr/local/include/boost/filesystem/operations.hpp");
+  const std::wstring wide(L"/usr/local/include/boost/filesystem/operations.hpp");
+
+  void path_construct_narrow(bench::state& st)
+  {
+    while (st.keep_running())
+    {
+      fs::path p(narrow);
+      bench::do_not_optimize(p);
+    }
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_construct_narrow);
+
+  //  includes conversion to the native encoding on POSIX
+  void path_construct_wide(bench::state& st)
+  {
+    while (st.keep_running())
+    {
+      fs::path p(wide);
+      bench::do_not_optimize(p);
+    }
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_construct_wide);
+
+  void path_append(bench::state& st)
+  {
+    const fs::path base("/usr/local/include");
+    while (st.keep_running())
+    {
+      fs::path p(base);
+      p /= "boost";
+      p /= "filesystem";
+      p /= "operations.hpp";
+      bench::do_not_optimize(p);
+    }
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_append);
+
+  void path_iterate(bench::state& st)
+  {
+    const fs::path p(narrow);
+    boost::int64_t elements = 0;
+    while (st.keep_running())
+    {
+      for (fs::path::const_iterator it = p.begin(); it != p.end(); ++it)
+      {
+        bench::do_not_optimize(*it);
+        ++elements;
+      }
+    }
+    st.set_items_processed(elements);
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_iterate);
+
+  void path_decompose(bench::state& st)
+  {
+    const fs::path p(narrow);
+    while (st.keep_running())
+    {
+      bench::do_not_optimize(p.root_path());
+      bench::do_not_optimize(p.parent_path());
+      bench::do_not_optimize(p.filename());
+      bench::do_not_optimize(p.stem());
+      bench::do_not_optimize(p.extension());
+    }
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_decompose);
+
+  void path_compare(bench::state& st)
+  {
+    const fs::path a(narrow);
+    const fs::path b("/usr/local/include/boost/filesystem/operations.cpp");
+    while (st.keep_running())
+      bench::do_not_optimize(a.compare(b));
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_compare);
+
+  void path_hash(bench::state& st)
+  {
+    const fs::path p(narrow);
+    while (st.keep_running())
+      bench::do_not_optimize(fs::hash_value(p));
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_hash);
+
+  void path_lexically_normal(bench::state& st)
+  {
+    const fs::path p("/usr/local/./include/../include/boost/filesystem/operations.hpp");
+    while (st.keep_running())
+      bench::do_not_optimize(p.lexically_normal());
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_lexically_normal);
+
+  void path_to_wstring(bench::state& st)
+  {
+    const fs::path p(narrow);
+    boost::int64_t bytes = 0;
+    while (st.keep_running())
+    {
+      bench::do_not_optimize(p.wstring());
+      bytes += narrow.size();
+    }
+    st.set_bytes_processed(bytes);
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_to_wstring);
+
+  void path_to_string(bench::state& st)
+  {
+    const fs::path p(wide);
+    boost::int64_t bytes = 0;
+    while (st.keep_running())
+    {
+      bench::do_not_optimize(p.string());
+      bytes += narrow.size();
+    }
+    st.set_bytes_processed(bytes);
+  }
+  BOOST_FILESYSTEM_BENCHMARK(path_to_string);
+}  // unnamed namespace
@@ -0,0 +1,522 @@
+//  filesystem/async.hpp  --------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  Asynchronous versions of the operations most likely to block for a long time, such as
+//  on a slow network file system. Each runs the synchronous operation on an executor and
+//  completes through a std::future or by calling a handler; bind_executor() and
+//  completion_queue deliver handler calls to a thread of the caller's choosing, such as
+//  an event loop. Tree operations can be abandoned through a cancellation_token.
+//
+//  Requires C++11; BOOST_FILESYSTEM_NO_ASYNC is defined when it is not available.
+
+#ifndef BOOST_FILESYSTEM_ASYNC_HPP
+#define BOOST_FILESYSTEM_ASYNC_HPP
+
+#include <boost/config.hpp>
+
+#if defined(BOOST_NO_CXX11_HDR_FUTURE) || defined(BOOST_NO_CXX11_HDR_THREAD) \
+  || defined(BOOST_NO_CXX11_HDR_MUTEX) || defined(BOOST_NO_CXX11_HDR_CONDITION_VARIABLE) \
+  || defined(BOOST_NO_CXX11_HDR_FUNCTIONAL) || defined(BOOST_NO_CXX11_HDR_ATOMIC) \
+  || defined(BOOST_NO_CXX11_LAMBDAS) || defined(BOOST_NO_CXX11_SMART_PTR) \
+  || defined(BOOST_NO_CXX11_RVALUE_REFERENCES) || defined(BOOST_NO_EXCEPTIONS)
+# define BOOST_FILESYSTEM_NO_ASYNC
+#endif
+
+#ifndef BOOST_FILESYSTEM_NO_ASYNC
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_convertible.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                     executors                                        //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  class executor
+  {
+  public:
+    virtual ~executor() {}
+
+    //  Arranges for f to be called once. f must not throw.
+    virtual void post(std::function<void()> f) = 0;
+  };
+
+  //  Runs posted functions on a fixed set of threads. The destructor waits for functions
+  //  already posted to finish.
+  class thread_pool_executor : public executor
+  {
+  public:
+    explicit thread_pool_executor(unsigned threads = 0)  // 0: one per processor
+      : m_stop(false)
+    {
+      if (threads == 0)
+        threads = std::thread::hardware_concurrency();
+      if (threads == 0)
+        threads = 2;
+      for (unsigned i = 0; i < threads; ++i)
+        m_threads.push_back(std::thread(&thread_pool_executor::run, this));
+    }
+
+    ~thread_pool_executor() { shutdown(); }
+
+    //  Functions posted after shutdown() run on the calling thread.
+    void post(std::function<void()> f)
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_stop)
+        {
+          m_tasks.push_back(std::move(f));
+          m_ready.notify_one();
+          return;
+        }
+      }
+      f();
+    }
+
+    //  Runs the functions already posted, then ends the threads.
+    void shutdown()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_ready.notify_all();
+      }
+      for (std::size_t i = 0; i < m_threads.size(); ++i)
+      {
+        if (m_threads[i].joinable()
+          && m_threads[i].get_id() != std::this_thread::get_id())
+          m_threads[i].join();
+      }
+    }
+
+  private:
+    std::vector<std::thread>            m_threads;
+    std::deque<std::function<void()> >  m_tasks;
+    std::mutex                          m_mutex;
+    std::condition_variable             m_ready;
+    bool                                m_stop;
+
+    thread_pool_executor(const thread_pool_executor&);             // = delete
+    thread_pool_executor& operator=(const thread_pool_executor&);  // = delete
+
+    void run()
+    {
+      for (;;)
+      {
+        std::function<void()> f;
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          while (m_tasks.empty() && !m_stop)
+            m_ready.wait(lock);
+          if (m_tasks.empty())
+            return;
+          f = std::move(m_tasks.front());
+          m_tasks.pop_front();
+        }
+        f();
+      }
+    }
+  };
+
+  //  The executor used when none is given; its threads start on first use.
+  inline executor& default_executor()
+  {
+    static thread_pool_executor pool;
+    return pool;
+  }
+
+  //  Holds posted functions until a thread of the caller's choosing runs them, such as
+  //  an event loop calling poll() each time round.
+  class completion_queue : public executor
+  {
+  public:
+    completion_queue() : m_stop(false) {}
+
+    void post(std::function<void()> f)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.push_back(std::move(f));
+      m_ready.notify_one();
+    }
+
+    //  Runs the functions already posted without waiting for more; returns how many.
+    std::size_t poll()
+    {
+      std::size_t count = 0;
+      std::function<void()> f;
+      while (pop(f, false))
+      {
+        f();
+        ++count;
+      }
+      return count;
+    }
+
+    //  Waits for a function to be posted and runs it. Returns false without running
+    //  anything once stop() has been called and nothing is left to run.
+    bool run_one()
+    {
+      std::function<void()> f;
+      if (!pop(f, true))
+        return false;
+      f();
+      return true;
+    }
+
+    //  Makes run_one() stop waiting.
+    void stop()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+      m_ready.notify_all();
+    }
+
+  private:
+    std::deque<std::function<void()> >  m_tasks;
+    std::mutex                          m_mutex;
+    std::condition_variable             m_ready;
+    bool                                m_stop;
+
+    completion_queue(const completion_queue&);             // = delete
+    completion_queue& operator=(const completion_queue&);  // = delete
+
+    bool pop(std::function<void()>& f, bool wait)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while (wait && m_tasks.empty() && !m_stop)
+        m_ready.wait(lock);
+      if (m_tasks.empty())
+        return false;
+      f = std::move(m_tasks.front());
+      m_tasks.pop_front();
+      return true;
+    }
+  };
+
+  //  A handler that, when called, posts the call of handler to ex instead of making it.
+  template <class Handler>
+  class executor_binder
+  {
+  public:
+    executor_binder(executor& ex, const Handler& handler)
+      : m_executor(&ex), m_handler(handler) {}
+
+    template <class A1>
+    void operator()(const A1& a1) const
+    {
+      Handler handler(m_handler);
+      m_executor->post([handler, a1]() mutable { handler(a1); });
+    }
+
+    template <class A1, class A2>
+    void operator()(const A1& a1, const A2& a2) const
+    {
+      Handler handler(m_handler);
+      m_executor->post([handler, a1, a2]() mutable { handler(a1, a2); });
+    }
+
+  private:
+    executor*  m_executor;
+    Handler    m_handler;
+  };
+
+  template <class Handler>
+  executor_binder<Handler> bind_executor(executor& ex, const Handler& handler)
+  {
+    return executor_binder<Handler>(ex, handler);
+  }
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                  cancellation_token                                  //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  //  Copies share their state, so a token kept by the caller cancels the operation it
+  //  was passed to. A cancelled operation reports errc::operation_canceled.
+  class cancellation_token
+  {
+  public:
+    cancellation_token() : m_cancelled(std::make_shared<std::atomic<bool> >(false)) {}
+
+    void cancel()           { *m_cancelled = true; }
+    bool cancelled() const  { return *m_cancelled; }
+
+  private:
+    std::shared_ptr<std::atomic<bool> > m_cancelled;
+  };
+
+//--------------------------------------------------------------------------------------//
+//                             implementation details                                   //
+//--------------------------------------------------------------------------------------//
+
+  namespace detail
+  {
+    //  Handler overloads must not be chosen for an executor or token argument.
+    template <class Handler>
+    struct is_async_handler
+    {
+      static const bool value = !is_convertible<Handler&, executor&>::value
+        && !is_convertible<Handler, cancellation_token>::value;
+    };
+
+    template <class T, class F>
+    void async_fulfil(std::promise<T>& promise, F& f)
+    {
+      try { promise.set_value(f()); }
+      catch (...) { promise.set_exception(std::current_exception()); }
+    }
+
+    template <class F>
+    void async_fulfil(std::promise<void>& promise, F& f)
+    {
+      try { f(); promise.set_value(); }
+      catch (...) { promise.set_exception(std::current_exception()); }
+    }
+
+    //  Runs f on ex, delivering what it returns, or what it throws, to the future.
+    template <class T, class F>
+    std::future<T> async_future(executor& ex, F f)
+    {
+      std::shared_ptr<std::promise<T> > promise(std::make_shared<std::promise<T> >());
+      std::future<T> result(promise->get_future());
+      ex.post([promise, f]() mutable { async_fulfil(*promise, f); });
+      return result;
+    }
+
+    //  Runs f(ec) on ex, then calls handler(ec, result).
+    template <class T, class F, class Handler>
+    void async_callback(executor& ex, F f, Handler handler)
+    {
+      ex.post([f, handler]() mutable
+      {
+        system::error_code ec;
+        T result(f(ec));
+        handler(ec, result);
+      });
+    }
+
+    inline bool async_cancelled(const cancellation_token& token, system::error_code& ec)
+    {
+      if (token.cancelled())
+        ec = system::errc::make_error_code(system::errc::operation_canceled);
+      return token.cancelled();
+    }
+
+    //  remove_all(), checking token before each removal
+    inline boost::uintmax_t async_remove_all(const path& p,
+      const cancellation_token& token, system::error_code& ec)
+    {
+      boost::uintmax_t count = 0;
+      file_status st(filesystem::symlink_status(p, ec));
+      if (ec || !exists(st))
+        return 0;
+      if (is_directory(st))
+      {
+        directory_iterator itr(p, ec);
+        for (; !ec && itr != directory_iterator(); itr.increment(ec))
+        {
+          if (async_cancelled(token, ec))
+            return count;
+          count += async_remove_all(itr->path(), token, ec);
+          if (ec)
+            return count;
+        }
+        if (ec)
+          return count;
+      }
+      if (async_cancelled(token, ec))
+        return count;
+      if (filesystem::remove(p, ec))
+        ++count;
+      return count;
+    }
+
+    inline std::vector<directory_entry> async_directory_listing(const path& p,
+      const cancellation_token& token, system::error_code& ec)
+    {
+      std::vector<directory_entry> entries;
+      directory_iterator itr(p, ec);
+      for (; !ec && itr != directory_iterator(); itr.increment(ec))
+      {
+        if (async_cancelled(token, ec))
+          break;
+        entries.push_back(*itr);
+      }
+      return entries;
+    }
+
+    template <class T>
+    T async_throw_if(const T& result, const char* message, const path& p,
+      const system::error_code& ec)
+    {
+      if (ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error(message, p, ec));
+      return result;
+    }
+  }  // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                               asynchronous operations                                //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//  Each operation has two forms. The first returns a std::future, which holds the result
+//  of the synchronous operation or the filesystem_error it throws. The second calls
+//  handler(ec, result), or handler(ec) when there is no result, on a thread of ex; wrap
+//  the handler with bind_executor() to have the call made elsewhere.
+
+  inline
+  std::future<file_status> async_status(const path& p, executor& ex = default_executor())
+  {
+    return detail::async_future<file_status>(ex, [p]() { return status(p); });
+  }
+
+  template <class Handler>
+  typename enable_if_c<detail::is_async_handler<Handler>::value>::type
+  async_status(const path& p, Handler handler, executor& ex = default_executor())
+  {
+    detail::async_callback<file_status>(ex,
+      [p](system::error_code& ec) { return status(p, ec); }, handler);
+  }
+
+  inline
+  std::future<boost::uintmax_t> async_file_size(const path& p,
+    executor& ex = default_executor())
+  {
+    return detail::async_future<boost::uintmax_t>(ex, [p]() { return file_size(p); });
+  }
+
+  template <class Handler>
+  typename enable_if_c<detail::is_async_handler<Handler>::value>::type
+  async_file_size(const path& p, Handler handler, executor& ex = default_executor())
+  {
+    detail::async_callback<boost::uintmax_t>(ex,
+      [p](system::error_code& ec) { return file_size(p, ec); }, handler);
+  }
+
+  inline
+  std::future<void> async_copy_file(const path& from, const path& to,
+    BOOST_SCOPED_ENUM(copy_option) option = copy_option::fail_if_exists,
+    executor& ex = default_executor())
+  {
+    return detail::async_future<void>(ex,
+      [from, to, option]() { copy_file(from, to, option); });
+  }
+
+  template <class Handler>
+  typename enable_if_c<detail::is_async_handler<Handler>::value>::type
+  async_copy_file(const path& from, const path& to, BOOST_SCOPED_ENUM(copy_option) option,
+    Handler handler, executor& ex = default_executor())
+  {
+    ex.post([from, to, option, handler]() mutable
+    {
+      system::error_code ec;
+      copy_file(from, to, option, ec);
+      handler(ec);
+    });
+  }
+
+  inline
+  std::future<bool> async_create_directories(const path& p,
+    executor& ex = default_executor())
+  {
+    return detail::async_future<bool>(ex, [p]() { return create_directories(p); });
+  }
+
+  template <class Handler>
+  typename enable_if_c<detail::is_async_handler<Handler>::value>::type
+  async_create_directories(const path& p, Handler handler,
+    executor& ex = default_executor())
+  {
+    detail::async_callback<bool>(ex,
+      [p](system::error_code& ec) { return create_directories(p, ec); }, handler);
+  }
+
+  inline
+  std::future<boost::uintmax_t> async_remove_all(const path& p,
+    const cancellation_token& token = cancellation_token(),
+    executor& ex = default_executor())
+  {
+    return detail::async_future<boost::uintmax_t>(ex, [p, token]()
+    {
+      system::error_code ec;
+      boost::uintmax_t count = detail::async_remove_all(p, token, ec);
+      return detail::async_throw_if(count, "boost::filesystem::remove_all", p, ec);
+    });
+  }
+
+  template <class Handler>
+  typename enable_if_c<detail::is_async_handler<Handler>::value>::type
+  async_remove_all(const path& p, Handler handler,
+    const cancellation_token& token = cancellation_token(),
+    executor& ex = default_executor())
+  {
+    detail::async_callback<boost::uintmax_t>(ex, [p, token](system::error_code& ec)
+      { return detail::async_remove_all(p, token, ec); }, handler);
+  }
+
+  //  The entries of directory p, as a directory_iterator would find them.
+  inline
+  std::future<std::vector<directory_entry> > async_directory_listing(const path& p,
+    const cancellation_token& token = cancellation_token(),
+    executor& ex = default_executor())
+  {
+    return detail::async_future<std::vector<directory_entry> >(ex, [p, token]()
+    {
+      system::error_code ec;
+      std::vector<directory_entry> entries(detail::async_directory_listing(p, token, ec));
+      return detail::async_throw_if(entries, "boost::filesystem::directory_iterator",
+        p, ec);
+    });
+  }
+
+  template <class Handler>
+  typename enable_if_c<detail::is_async_handler<Handler>::value>::type
+  async_directory_listing(const path& p, Handler handler,
+    const cancellation_token& token = cancellation_token(),
+    executor& ex = default_executor())
+  {
+    detail::async_callback<std::vector<directory_entry> >(ex,
+      [p, token](system::error_code& ec)
+      { return detail::async_directory_listing(p, token, ec); }, handler);
+  }
+
+}  // namespace filesystem
+}  // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+
+#endif  // BOOST_FILESYSTEM_NO_ASYNC
+#endif  // BOOST_FILESYSTEM_ASYNC_HPP
@@ -0,0 +1,246 @@
+//  filesystem/backend.hpp  ------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  The file system the operations act on. By default they make system calls, as they
+//  always have; set_backend() installs another backend for the core operations and
+//  directory_iterator to dispatch through, such as memory_backend for hermetic tests
+//  and microbenchmarks, or latency_backend to make a local file system behave like a
+//  slow network one, or caching_backend to answer repeated status queries from memory.
+//  The fstreams and directory_cursor always use the native file system, and the bulk
+//  operations use io_uring only while no backend is installed.
+
+#ifndef BOOST_FILESYSTEM_BACKEND_HPP
+#define BOOST_FILESYSTEM_BACKEND_HPP
+
+#include <boost/config.hpp>
+
+# if defined( BOOST_NO_STD_WSTRING )
+#   error Configuration not supported: Boost.Filesystem V3 and later requires std::wstring support
+# endif
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <cstddef>
+#include <ctime>
+#include <string>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+  //  Each function behaves as the error_code overload of the operation of the same name,
+  //  except that remove() removes only a file or an empty directory, and that none
+  //  throws other than std::bad_alloc. A backend must be safe to call from several
+  //  threads at once, as the bulk operations and move() do.
+  class backend
+  {
+  public:
+    virtual ~backend() {}
+
+    virtual file_status status(const path& p, system::error_code& ec) = 0;
+    virtual file_status symlink_status(const path& p, system::error_code& ec) = 0;
+    virtual boost::uintmax_t file_size(const path& p, system::error_code& ec) = 0;
+    virtual std::time_t last_write_time(const path& p, system::error_code& ec) = 0;
+    virtual void last_write_time(const path& p, std::time_t new_time,
+      system::error_code& ec) = 0;
+    virtual bool create_directory(const path& p, system::error_code& ec) = 0;
+    virtual void create_symlink(const path& to, const path& new_symlink,
+      system::error_code& ec) = 0;
+    virtual path read_symlink(const path& p, system::error_code& ec) = 0;
+    virtual bool remove(const path& p, system::error_code& ec) = 0;
+    virtual void rename(const path& old_p, const path& new_p,
+      system::error_code& ec) = 0;
+    virtual void copy_file(const path& from, const path& to, bool overwrite,
+      system::error_code& ec) = 0;
+    virtual void resize_file(const path& p, boost::uintmax_t size,
+      system::error_code& ec) = 0;
+
+    //  The caller deletes the result, which is 0 if ec is set
+    virtual backend_directory* open_directory(const path& p,
+      system::error_code& ec) = 0;
+
+    //  Told that an operation which does not dispatch through a backend, such as
+    //  permissions(), changed p, or if subtree is true p and everything below it, so
+    //  that a backend holding metadata can drop it. Must not throw.
+    virtual void changed(const path&, bool /*subtree*/) {}
+
+    //  Whether the files are those of the native file system, as they are for the
+    //  native backend and for one that forwards to it. Only then do the operations
+    //  without a backend form act on them, and move() copy across devices.
+    virtual bool native() const  { return false; }
+  };
+
+  //  The system calls, as made when no other backend is installed
+  BOOST_FILESYSTEM_DECL backend& native_backend() BOOST_NOEXCEPT;
+
+  BOOST_FILESYSTEM_DECL backend& current_backend() BOOST_NOEXCEPT;
+
+  //  Installs b, or the native backend if b is 0, and returns the backend it replaces.
+  //  Not synchronized: call it only while no other thread is using the library, and
+  //  keep b alive until it has been replaced.
+  BOOST_FILESYSTEM_DECL backend* set_backend(backend* b) BOOST_NOEXCEPT;
+
+//--------------------------------------------------------------------------------------//
+//                                   memory_backend                                     //
+//--------------------------------------------------------------------------------------//
+
+  //  A file system held in memory, starting as an empty root directory. Relative paths
+  //  are resolved against the root, and "C:/a", "/a" and "a" all name the same file.
+  //  Symlinks are followed as by POSIX. Permissions are recorded but not enforced.
+  class BOOST_FILESYSTEM_DECL memory_backend : public backend
+  {
+  public:
+    memory_backend();
+    ~memory_backend();
+
+    file_status status(const path& p, system::error_code& ec);
+    file_status symlink_status(const path& p, system::error_code& ec);
+    boost::uintmax_t file_size(const path& p, system::error_code& ec);
+    std::time_t last_write_time(const path& p, system::error_code& ec);
+    void last_write_time(const path& p, std::time_t new_time, system::error_code& ec);
+    bool create_directory(const path& p, system::error_code& ec);
+    void create_symlink(const path& to, const path& new_symlink, system::error_code& ec);
+    path read_symlink(const path& p, system::error_code& ec);
+    bool remove(const path& p, system::error_code& ec);
+    void rename(const path& old_p, const path& new_p, system::error_code& ec);
+    void copy_file(const path& from, const path& to, bool overwrite,
+      system::error_code& ec);
+    void resize_file(const path& p, boost::uintmax_t size, system::error_code& ec);
+    backend_directory* open_directory(const path& p, system::error_code& ec);
+
+    //  The contents of regular files, which the fstreams cannot reach. write_file()
+    //  creates the file if need be.
+    void write_file(const path& p, const std::string& contents, system::error_code& ec);
+    std::string read_file(const path& p, system::error_code& ec);
+
+  private:
+    struct impl;
+    boost::scoped_ptr<impl> m_imp;
+
+    memory_backend(const memory_backend&);
+    memory_backend& operator=(const memory_backend&);
+  };
+
+//--------------------------------------------------------------------------------------//
+//                                   latency_backend                                    //
+//--------------------------------------------------------------------------------------//
+
+  //  Forwards each call to another backend after a delay: round_trip_us microseconds
+  //  for every call, as for an NFS request, and for copy_file() also us_per_mib for
+  //  each MiB copied. A directory costs one round trip to open and one for each further
+  //  entries_per_read entries read, as READDIRPLUS returns them in batches.
+  class BOOST_FILESYSTEM_DECL latency_backend : public backend
+  {
+  public:
+    latency_backend(backend& next, boost::uint32_t round_trip_us,
+      boost::uint32_t us_per_mib = 0, unsigned entries_per_read = 128);
+
+    file_status status(const path& p, system::error_code& ec);
+    file_status symlink_status(const path& p, system::error_code& ec);
+    boost::uintmax_t file_size(const path& p, system::error_code& ec);
+    std::time_t last_write_time(const path& p, system::error_code& ec);
+    void last_write_time(const path& p, std::time_t new_time, system::error_code& ec);
+    bool create_directory(const path& p, system::error_code& ec);
+    void create_symlink(const path& to, const path& new_symlink, system::error_code& ec);
+    path read_symlink(const path& p, system::error_code& ec);
+    bool remove(const path& p, system::error_code& ec);
+    void rename(const path& old_p, const path& new_p, system::error_code& ec);
+    void copy_file(const path& from, const path& to, bool overwrite,
+      system::error_code& ec);
+    void resize_file(const path& p, boost::uintmax_t size, system::error_code& ec);
+    backend_directory* open_directory(const path& p, system::error_code& ec);
+    void changed(const path& p, bool subtree);
+    bool native() const;
+
+  private:
+    backend&         m_next;
+    boost::uint32_t  m_round_trip_us;
+    boost::uint32_t  m_us_per_mib;
+    unsigned         m_entries_per_read;
+  };
+
+//--------------------------------------------------------------------------------------//
+//                                   caching_backend                                    //
+//--------------------------------------------------------------------------------------//
+
+  struct cache_statistics
+  {
+    cache_statistics()
+      : hits(0), misses(0), expirations(0), invalidations(0), evictions(0), entries(0) {}
+
+    double hit_rate() const
+      { return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses); }
+
+    boost::uintmax_t  hits;           // calls answered from the cache
+    boost::uintmax_t  misses;         // calls forwarded, expired entries included
+    boost::uintmax_t  expirations;    // entries found to have outlived the TTL
+    boost::uintmax_t  invalidations;  // entries dropped by invalidate() or a change
+    boost::uintmax_t  evictions;      // entries dropped to make room
+    boost::uintmax_t  entries;        // held now
+  };
+
+  //  Answers status(), symlink_status(), file_size() and last_write_time() from a cache
+  //  in front of another backend, keyed by the path as given, for ttl_ms milliseconds
+  //  after each entry was fetched. Results that report "not found" are cached too. The
+  //  entries are spread over shards, each with its own lock and up to max_entries /
+  //  shards entries; a full shard drops its expired entries, then its first in path
+  //  order. Changes made through the operations, or reported by changed(), drop the
+  //  entries for the paths they touch, their parents, and for renames, removals and new
+  //  symlinks, the paths below them. Changes made any other way, or through another
+  //  path naming the same file, are seen when the entries expire or are invalidated.
+  class BOOST_FILESYSTEM_DECL caching_backend : public backend
+  {
+  public:
+    caching_backend(backend& next, boost::uint32_t ttl_ms,
+      std::size_t max_entries = 65536, unsigned shards = 16);
+    ~caching_backend();
+
+    file_status status(const path& p, system::error_code& ec);
+    file_status symlink_status(const path& p, system::error_code& ec);
+    boost::uintmax_t file_size(const path& p, system::error_code& ec);
+    std::time_t last_write_time(const path& p, system::error_code& ec);
+    void last_write_time(const path& p, std::time_t new_time, system::error_code& ec);
+    bool create_directory(const path& p, system::error_code& ec);
+    void create_symlink(const path& to, const path& new_symlink, system::error_code& ec);
+    path read_symlink(const path& p, system::error_code& ec);
+    bool remove(const path& p, system::error_code& ec);
+    void rename(const path& old_p, const path& new_p, system::error_code& ec);
+    void copy_file(const path& from, const path& to, bool overwrite,
+      system::error_code& ec);
+    void resize_file(const path& p, boost::uintmax_t size, system::error_code& ec);
+    backend_directory* open_directory(const path& p, system::error_code& ec);
+    void changed(const path& p, bool subtree);
+    bool native() const;
+
+    //  Drops the entry for p, and if subtree is true those for the paths below it
+    void invalidate(const path& p, bool subtree = false);
+    void clear();
+
+    cache_statistics statistics() const;
+    void reset_statistics();
+
+  private:
+    struct impl;
+    boost::scoped_ptr<impl> m_imp;
+
+    caching_backend(const caching_backend&);
+    caching_backend& operator=(const caching_backend&);
+  };
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+#endif // BOOST_FILESYSTEM_BACKEND_HPP
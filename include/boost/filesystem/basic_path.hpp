@@ -0,0 +1,278 @@
+//  filesystem/basic_path.hpp  ---------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Paths whose storage the program chooses. path keeps its native string on the global
+//  heap; a basic_path<Allocator> keeps it wherever its allocator puts it, such as a
+//  per-request arena through pmr::path, and an inline_path<N> keeps up to N - 1
+//  characters inside itself, on the stack if it is there. Both build paths with
+//  operator/= and operator+= as path does, and convert to and from path, which does
+//  the parsing, decomposition and conversion of encodings.
+//
+//  pmr::path needs <memory_resource>; BOOST_FILESYSTEM_NO_PMR is defined when it is not
+//  available.
+
+#ifndef BOOST_FILESYSTEM_BASIC_PATH_HPP
+#define BOOST_FILESYSTEM_BASIC_PATH_HPP
+
+#include <boost/config.hpp>
+
+# if defined( BOOST_NO_STD_WSTRING )
+#   error Configuration not supported: Boost.Filesystem V3 and later requires std::wstring support
+# endif
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/static_assert.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#if defined(__has_include)
+# if __has_include(<memory_resource>)
+#   include <memory_resource>
+# endif
+#endif
+#if !defined(__cpp_lib_memory_resource)
+# define BOOST_FILESYSTEM_NO_PMR
+#endif
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+  namespace detail
+  {
+    //  Whether operator/= puts a separator between a path of size characters at s and a
+    //  non-empty component beginning with first
+    inline bool separator_needed(const path::value_type* s, std::size_t size,
+      path::value_type first) BOOST_NOEXCEPT
+    {
+      return size != 0 && !is_element_separator(s[size - 1])
+        && !is_directory_separator(first);
+    }
+  } // namespace detail
+
+  //------------------------------------------------------------------------------------//
+  //                                                                                    //
+  //                                  class basic_path                                  //
+  //                                                                                    //
+  //------------------------------------------------------------------------------------//
+
+  template <class Allocator = std::allocator<path::value_type> >
+  class basic_path
+  {
+  public:
+    typedef path::value_type                                  value_type;
+    typedef Allocator                                         allocator_type;
+    typedef std::basic_string<value_type, std::char_traits<value_type>, Allocator>
+                                                              string_type;
+    typedef typename string_type::size_type                   size_type;
+
+    basic_path() {}
+    explicit basic_path(const allocator_type& a) : m_pathname(a) {}
+    basic_path(const path& p, const allocator_type& a = allocator_type())
+      : m_pathname(p.native().data(), p.native().size(), a) {}
+    basic_path(const value_type* s, const allocator_type& a = allocator_type())
+      : m_pathname(s, a) {}
+    basic_path(const basic_path& p, const allocator_type& a)
+      : m_pathname(p.m_pathname, a) {}
+
+    basic_path& operator=(const path& p)
+    {
+      m_pathname.assign(p.native().data(), p.native().size());
+      return *this;
+    }
+    basic_path& operator=(const value_type* s)  { m_pathname.assign(s); return *this; }
+
+    basic_path& operator/=(const path& p)
+      { return append(p.native().data(), p.native().size()); }
+    basic_path& operator/=(const value_type* s)
+      { return append(s, string_type::traits_type::length(s)); }
+    basic_path& operator/=(const basic_path& p)
+      { return append(p.m_pathname.data(), p.m_pathname.size()); }
+
+    basic_path& operator+=(const path& p)  { m_pathname += p.native(); return *this; }
+    basic_path& operator+=(const value_type* s)  { m_pathname += s; return *this; }
+    basic_path& operator+=(const basic_path& p)
+      { m_pathname += p.m_pathname; return *this; }
+
+    void clear()                     { m_pathname.clear(); }
+    void reserve(size_type chars)    { m_pathname.reserve(chars); }
+    void swap(basic_path& rhs)       { m_pathname.swap(rhs.m_pathname); }
+
+    const string_type&  native() const  { return m_pathname; }
+    const value_type*   c_str() const   { return m_pathname.c_str(); }
+    size_type           size() const    { return m_pathname.size(); }
+    bool                empty() const   { return m_pathname.empty(); }
+    allocator_type      get_allocator() const  { return m_pathname.get_allocator(); }
+
+    //  Copies the native string into a path, to decompose it or pass it to operations
+    path to_path() const  { return path(m_pathname.c_str()); }
+    operator path() const  { return to_path(); }
+
+  private:
+    string_type  m_pathname;
+
+    basic_path& append(const value_type* s, size_type n)
+    {
+      if (n == 0)
+        return *this;
+      if (s >= m_pathname.data() && s < m_pathname.data() + m_pathname.size())
+      {
+        string_type rhs(s, n, m_pathname.get_allocator());  // self-append
+        return append(rhs.data(), n);
+      }
+      if (detail::separator_needed(m_pathname.data(), m_pathname.size(), *s))
+      {
+        m_pathname.reserve(m_pathname.size() + 1 + n);
+        m_pathname += path::preferred_separator;
+      }
+      m_pathname.append(s, n);
+      return *this;
+    }
+  };
+
+# ifndef BOOST_FILESYSTEM_NO_PMR
+  namespace pmr
+  {
+    //  A path whose storage comes from the memory_resource it is constructed with
+    typedef basic_path<std::pmr::polymorphic_allocator<path::value_type> > path;
+  }
+# endif
+
+  //------------------------------------------------------------------------------------//
+  //                                                                                    //
+  //                                 class inline_path                                  //
+  //                                                                                    //
+  //------------------------------------------------------------------------------------//
+
+  //  Holds a path of up to N - 1 characters, and its terminating null, in itself; a
+  //  longer path moves to the heap, and back once cleared or assigned a shorter one.
+  //  The default N is 256 bytes' worth of characters.
+  template <std::size_t N = 256 / sizeof(path::value_type)>
+  class inline_path
+  {
+    BOOST_STATIC_ASSERT(N > 1);
+    typedef std::char_traits<path::value_type> traits_type;
+  public:
+    typedef path::value_type  value_type;
+    typedef std::size_t       size_type;
+
+    static const size_type inline_capacity = N - 1;
+
+    inline_path() : m_size(0)  { m_inline[0] = 0; }
+    inline_path(const path& p) : m_size(0)
+      { m_inline[0] = 0; assign(p.native().data(), p.native().size()); }
+    inline_path(const value_type* s) : m_size(0)
+      { m_inline[0] = 0; assign(s, traits_type::length(s)); }
+    inline_path(const inline_path& p) : m_size(0)
+      { m_inline[0] = 0; assign(p.data(), p.size()); }
+
+    inline_path& operator=(const inline_path& p)
+    {
+      if (this != &p)
+        assign(p.data(), p.size());
+      return *this;
+    }
+    inline_path& operator=(const path& p)
+      { assign(p.native().data(), p.native().size()); return *this; }
+    inline_path& operator=(const value_type* s)
+      { assign(s, traits_type::length(s)); return *this; }
+
+    inline_path& operator/=(const path& p)
+      { return append(p.native().data(), p.native().size(), true); }
+    inline_path& operator/=(const value_type* s)
+      { return append(s, traits_type::length(s), true); }
+    inline_path& operator/=(const inline_path& p)
+      { return append(p.data(), p.size(), true); }
+
+    inline_path& operator+=(const path& p)
+      { return append(p.native().data(), p.native().size(), false); }
+    inline_path& operator+=(const value_type* s)
+      { return append(s, traits_type::length(s), false); }
+    inline_path& operator+=(const inline_path& p)
+      { return append(p.data(), p.size(), false); }
+
+    void clear()  { assign(m_inline, 0); }
+
+    const value_type*  c_str() const   { return data(); }
+    size_type          size() const    { return is_inline() ? m_size : m_heap.size(); }
+    bool               empty() const   { return size() == 0; }
+    //  Whether the path is held in the object rather than on the heap
+    bool               is_inline() const  { return m_heap.empty(); }
+
+    path to_path() const  { return path(data()); }
+    operator path() const  { return to_path(); }
+
+  private:
+    value_type                     m_inline[N];
+    size_type                      m_size;  // while is_inline()
+    std::basic_string<value_type>  m_heap;  // empty while is_inline()
+
+    const value_type* data() const  { return is_inline() ? m_inline : m_heap.c_str(); }
+
+    void assign(const value_type* s, size_type n)
+    {
+      if (n <= inline_capacity)
+      {
+        traits_type::move(m_inline, s, n);  // s may be within m_inline or m_heap
+        m_inline[n] = 0;
+        m_size = n;
+        std::basic_string<value_type>().swap(m_heap);
+      }
+      else
+        m_heap.assign(s, n);
+    }
+
+    inline_path& append(const value_type* s, size_type n, bool separate)
+    {
+      if (n == 0)
+        return *this;
+      size_type size = this->size();
+      bool sep = separate && detail::separator_needed(data(), size, *s);
+      size_type total = size + (sep ? 1 : 0) + n;
+      if (is_inline() && total <= inline_capacity)
+      {
+        if (sep)
+          m_inline[size++] = path::preferred_separator;
+        traits_type::move(m_inline + size, s, n);  // s may be within m_inline
+        m_inline[total] = 0;
+        m_size = total;
+      }
+      else if (s >= data() && s < data() + size && !is_inline())
+      {
+        std::basic_string<value_type> rhs(s, n);  // self-append on the heap
+        return append(rhs.data(), n, separate);
+      }
+      else
+      {
+        if (is_inline())
+        {
+          //  moves to the heap; m_inline is left intact, as s may be within it
+          m_heap.reserve(total);
+          m_heap.assign(m_inline, m_size);
+        }
+        if (sep)
+          m_heap += path::preferred_separator;
+        m_heap.append(s, n);
+      }
+      return *this;
+    }
+  };
+
+  template <std::size_t N>
+  const typename inline_path<N>::size_type inline_path<N>::inline_capacity;
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+#endif // BOOST_FILESYSTEM_BASIC_PATH_HPP
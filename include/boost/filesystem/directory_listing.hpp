@@ -0,0 +1,145 @@
+//  filesystem/directory_listing.hpp  --------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  A directory's entries held compactly, for directories too large to hold as a vector
+//  of directory_entry: the names share one buffer, the type and permissions of each
+//  entry are packed into 32 bits, and the other metadata asked for is held in one array
+//  per field. Like directory_cursor, it always reads the native file system.
+
+#ifndef BOOST_FILESYSTEM_DIRECTORY_LISTING_HPP
+#define BOOST_FILESYSTEM_DIRECTORY_LISTING_HPP
+
+#include <boost/config.hpp>
+
+# if defined( BOOST_NO_STD_WSTRING )
+#   error Configuration not supported: Boost.Filesystem V3 and later requires std::wstring support
+# endif
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <ctime>
+#include <vector>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+  //  The metadata beyond each entry's name and type that a listing may hold. Any but
+  //  listing_inode costs one lstat per entry, made in inode order; the type and inode
+  //  cost none where the directory reports them. The inode is always the number the
+  //  directory reported, or lstat's where it reported none.
+  enum listing_field
+  {
+    listing_permissions = 1,
+    listing_size = 2,             // of regular files; 0 for others
+    listing_last_write_time = 4,
+    listing_inode = 8,            // 0 on Windows
+    listing_all_fields = 15
+  };
+
+  class BOOST_FILESYSTEM_DECL directory_listing
+  {
+  public:
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    directory_listing() : m_fields(0), m_sorted(true) { m_offsets.push_back(0); }
+
+    //  Reads every entry of dir but dot and dot-dot, holding the listing_field bits in
+    //  fields. Entries describe what they name, as symlink_status() does.
+    explicit directory_listing(const path& dir, unsigned fields = 0);
+    directory_listing(const path& dir, unsigned fields, system::error_code& ec);
+
+    void read(const path& dir, unsigned fields = 0);
+    void read(const path& dir, unsigned fields, system::error_code& ec);
+
+    //  Adds an entry, with its fields other than the type and permissions set to 0
+    void push_back(const path& filename, file_status s);
+    void reserve(std::size_t entries, std::size_t name_chars);
+    void clear();
+
+    const path&  directory() const  { return m_directory; }
+    unsigned     fields() const     { return m_fields; }
+    std::size_t  size() const       { return m_offsets.size() - 1; }
+    bool         empty() const      { return m_offsets.size() == 1; }
+
+    //  The name of entry i, null-terminated, and its length without the terminator
+    const path::value_type* name(std::size_t i) const  { return &m_names[m_offsets[i]]; }
+    std::size_t name_size(std::size_t i) const
+      { return m_offsets[i + 1] - m_offsets[i] - 1; }
+
+    path filename(std::size_t i) const  { return path(name(i), name(i) + name_size(i)); }
+    path entry_path(std::size_t i) const  { return m_directory / filename(i); }
+    directory_entry entry(std::size_t i) const
+      { return directory_entry(entry_path(i), file_status(), symlink_status(i)); }
+
+    file_type type(std::size_t i) const
+      { return static_cast<file_type>(m_modes[i] & type_mask); }
+    //  perms_not_known unless listing_permissions was asked for
+    perms permissions(std::size_t i) const
+    {
+      return (m_modes[i] & perms_known) != 0
+        ? static_cast<perms>((m_modes[i] >> perms_shift) & perms_mask) : perms_not_known;
+    }
+    file_status symlink_status(std::size_t i) const
+      { return file_status(type(i), permissions(i)); }
+
+    //  0 unless the field was asked for
+    boost::uintmax_t file_size(std::size_t i) const
+      { return m_sizes.empty() ? 0 : m_sizes[i]; }
+    std::time_t last_write_time(std::size_t i) const
+      { return m_mtimes.empty() ? 0 : m_mtimes[i]; }
+    boost::uint64_t inode(std::size_t i) const
+      { return m_inodes.empty() ? 0 : m_inodes[i]; }
+
+    //  Orders the entries by name, comparing the names' characters as unsigned values.
+    //  Needs memory for a second copy of the listing while it works.
+    void sort();
+    bool sorted() const  { return m_sorted; }
+
+    //  The index of the entry named filename, or npos; a binary search once sorted
+    std::size_t find(const path& filename) const;
+
+    //  The memory held, in bytes
+    std::size_t memory_size() const;
+
+  private:
+    //  m_modes packs the file_type, and above it the permission bits and whether
+    //  they are known
+    static const boost::uint32_t type_mask = 0xF;
+    static const unsigned perms_shift = 4;
+    static const boost::uint32_t perms_mask = 07777;
+    static const boost::uint32_t perms_known = 0x10000;
+
+    path                           m_directory;
+    unsigned                       m_fields;
+    bool                           m_sorted;
+    std::vector<path::value_type>  m_names;    // each null-terminated
+    std::vector<boost::uint32_t>   m_offsets;  // of each name, then of the end
+    std::vector<boost::uint32_t>   m_modes;
+    std::vector<boost::uintmax_t>  m_sizes;    // each field's array is empty unless
+    std::vector<std::time_t>       m_mtimes;   // the field was asked for
+    std::vector<boost::uint64_t>   m_inodes;
+
+    struct order;
+    int compare(std::size_t i, const path::value_type* name, std::size_t size) const;
+    void append(const path::string_type& name, boost::uint32_t mode,
+      system::error_code& ec);
+  };
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+#endif // BOOST_FILESYSTEM_DIRECTORY_LISTING_HPP
@@ -0,0 +1,652 @@
+//  filesystem/generator.hpp  ----------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  Directory traversal by coroutines. walk() is a generator that yields each entry below
+//  a directory, handing each subdirectory to a nested generator by co_yield elements_of,
+//  which transfers control straight to the nested coroutine and back (symmetric
+//  transfer), so the depth of the tree costs no extra resumptions. Pruning is a predicate
+//  and filtering is ordinary code in the consumer. Coroutine frames, and the buffer each
+//  level's directory_cursor reads into, are allocated from a std::pmr::memory_resource
+//  passed after std::allocator_arg; a frame_arena serves them all from one buffer. On
+//  Linux that leaves the entries' paths as the traversal's only other allocations;
+//  elsewhere each level's directory stream is the platform's own, and under an installed
+//  backend each level is a directory_iterator. async_walk() is an async_generator that
+//  runs the traversal on an executor.
+//
+//  Requires C++20 coroutines; BOOST_FILESYSTEM_NO_COROUTINES is defined when they are
+//  not available.
+
+#ifndef BOOST_FILESYSTEM_GENERATOR_HPP
+#define BOOST_FILESYSTEM_GENERATOR_HPP
+
+#include <boost/config.hpp>
+
+#if !defined(__cpp_impl_coroutine) || !defined(__has_include) \
+  || defined(BOOST_NO_EXCEPTIONS)
+# define BOOST_FILESYSTEM_NO_COROUTINES
+#elif !__has_include(<coroutine>) || !__has_include(<memory_resource>)
+# define BOOST_FILESYSTEM_NO_COROUTINES
+#endif
+
+#ifndef BOOST_FILESYSTEM_NO_COROUTINES
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/async.hpp>
+#include <boost/filesystem/backend.hpp>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                              coroutine frame allocation                              //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  //  Hands out memory from one buffer, last in first out, as nested generators create
+  //  and destroy their frames. Memory freed out of order is reused once everything
+  //  allocated after it has been freed. Requests that do not fit go to the upstream
+  //  resource. Not thread safe.
+  class frame_arena : public std::pmr::memory_resource
+  {
+  public:
+    explicit frame_arena(std::size_t size = 64 * 1024,
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : m_upstream(upstream),
+        m_owned(static_cast<unsigned char*>(upstream->allocate(size))),
+        m_buffer(m_owned), m_size(size), m_top(0), m_last(0) {}
+
+    frame_arena(void* buffer, std::size_t size,
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+      : m_upstream(upstream), m_owned(0), m_buffer(static_cast<unsigned char*>(buffer)),
+        m_size(size), m_top(0), m_last(0) {}
+
+    frame_arena(const frame_arena&) = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+
+    ~frame_arena()
+    {
+      if (m_owned)
+        m_upstream->deallocate(m_owned, m_size);
+    }
+
+    std::size_t capacity() const noexcept { return m_size; }
+    std::size_t used() const noexcept     { return m_top; }  // includes block headers
+
+  private:
+    struct header
+    {
+      std::size_t  previous_top;
+      header*      previous;
+      bool         freed;
+    };
+
+    std::pmr::memory_resource*  m_upstream;
+    unsigned char*              m_owned;
+    unsigned char*              m_buffer;
+    std::size_t                 m_size;
+    std::size_t                 m_top;   // offset of the first unused byte
+    header*                     m_last;  // most recent block still allocated, or 0
+
+    static std::uintptr_t align_up(std::uintptr_t n, std::size_t alignment) noexcept
+    {
+      return (n + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+      if (alignment < alignof(header))
+        alignment = alignof(header);
+      std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_buffer);
+      std::uintptr_t data = align_up(base + m_top + sizeof(header), alignment);
+      if (data + bytes > base + m_size)
+        return m_upstream->allocate(bytes, alignment);
+
+      header* h = reinterpret_cast<header*>(data) - 1;
+      h->previous_top = m_top;
+      h->previous = m_last;
+      h->freed = false;
+      m_last = h;
+      m_top = data + bytes - base;
+      return reinterpret_cast<void*>(data);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+    {
+      unsigned char* q = static_cast<unsigned char*>(p);
+      if (q < m_buffer || q >= m_buffer + m_size)
+      {
+        if (alignment < alignof(header))
+          alignment = alignof(header);
+        m_upstream->deallocate(p, bytes, alignment);
+        return;
+      }
+      reinterpret_cast<header*>(p)[-1].freed = true;
+      while (m_last && m_last->freed)
+      {
+        m_top = m_last->previous_top;
+        m_last = m_last->previous;
+      }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+      return this == &other;
+    }
+  };
+
+  namespace detail
+  {
+    //  Base of the promise types: each frame is followed by a pointer to the
+    //  memory_resource it came from, so that it can be returned there.
+    class frame_allocated_promise
+    {
+    public:
+      static void* operator new(std::size_t size)
+      {
+        return allocate(size, std::pmr::get_default_resource());
+      }
+
+      template <class... Args>
+      static void* operator new(std::size_t size, std::allocator_arg_t,
+        std::pmr::memory_resource* mr, Args&&...)
+      {
+        return allocate(size, mr);
+      }
+
+      //  member function coroutines
+      template <class This, class... Args>
+      static void* operator new(std::size_t size, This&&, std::allocator_arg_t,
+        std::pmr::memory_resource* mr, Args&&...)
+      {
+        return allocate(size, mr);
+      }
+
+      static void operator delete(void* p, std::size_t size) noexcept
+      {
+        const std::size_t offset = resource_offset(size);
+        std::pmr::memory_resource* mr;
+        std::memcpy(&mr, static_cast<unsigned char*>(p) + offset, sizeof(mr));
+        mr->deallocate(p, offset + sizeof(mr), alignment);
+      }
+
+    private:
+      static constexpr std::size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+      static std::size_t resource_offset(std::size_t size) noexcept
+      {
+        const std::size_t a = alignof(std::pmr::memory_resource*);
+        return (size + a - 1) & ~(a - 1);
+      }
+
+      static void* allocate(std::size_t size, std::pmr::memory_resource* mr)
+      {
+        const std::size_t offset = resource_offset(size);
+        void* p = mr->allocate(offset + sizeof(mr), alignment);
+        std::memcpy(static_cast<unsigned char*>(p) + offset, &mr, sizeof(mr));
+        return p;
+      }
+    };
+  }  // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                      generator                                       //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  //  co_yield elements_of(g) within a generator yields each element of g in turn
+  template <class Generator>
+  struct elements_of
+  {
+    explicit elements_of(Generator&& g) noexcept : range(std::move(g)) {}
+    Generator range;
+  };
+
+  //  A lazily started coroutine that yields const T& values, iterated by a range for.
+  //  Yielded values must outlive the suspension; temporaries and locals of the
+  //  coroutine do. Exceptions thrown by the coroutine propagate from begin() and ++.
+  template <class T>
+  class generator
+  {
+  public:
+    class promise_type;
+
+  private:
+    typedef std::coroutine_handle<promise_type> handle;
+
+    struct final_awaiter
+    {
+      bool await_ready() const noexcept { return false; }
+      std::coroutine_handle<> await_suspend(handle h) noexcept
+      {
+        promise_type& p = h.promise();
+        if (!p.m_parent)
+          return std::noop_coroutine();
+        p.m_root->m_leaf = p.m_parent;
+        return p.m_parent;
+      }
+      void await_resume() const noexcept {}
+    };
+
+    struct nested_awaiter;  // defined once generator is complete
+
+  public:
+    class promise_type : public detail::frame_allocated_promise
+    {
+    public:
+      promise_type() noexcept
+        : m_value(0), m_root(this), m_leaf(handle::from_promise(*this)) {}
+
+      generator get_return_object() noexcept
+      {
+        return generator(handle::from_promise(*this));
+      }
+
+      std::suspend_always initial_suspend() const noexcept { return {}; }
+      final_awaiter final_suspend() const noexcept { return {}; }
+
+      std::suspend_always yield_value(const T& value) noexcept
+      {
+        m_root->m_value = std::addressof(value);
+        return {};
+      }
+
+      nested_awaiter yield_value(elements_of<generator> g) noexcept
+      {
+        return nested_awaiter(std::move(g.range));
+      }
+
+      void return_void() const noexcept {}
+
+      void unhandled_exception()
+      {
+        if (!m_parent)
+          throw;
+        m_exception = std::current_exception();  // rethrown in the parent
+      }
+
+      template <class U>
+      std::suspend_never await_transform(U&&) = delete;  // generators do not co_await
+
+    private:
+      friend class generator;
+
+      const T*            m_value;      // root only
+      promise_type*       m_root;
+      handle              m_leaf;       // root only; the coroutine to resume next
+      handle              m_parent;     // null for the root
+      std::exception_ptr  m_exception;  // nested only
+    };
+
+    class iterator
+    {
+    public:
+      typedef std::input_iterator_tag  iterator_category;
+      typedef std::ptrdiff_t           difference_type;
+      typedef T                        value_type;
+      typedef const T&                 reference;
+      typedef const T*                 pointer;
+
+      iterator() noexcept {}
+
+      reference operator*() const noexcept  { return *m_coro.promise().m_value; }
+      pointer operator->() const noexcept   { return m_coro.promise().m_value; }
+
+      iterator& operator++()
+      {
+        m_coro.promise().m_leaf.resume();
+        return *this;
+      }
+      void operator++(int) { ++*this; }
+
+      friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept
+      {
+        return !it.m_coro || it.m_coro.done();
+      }
+
+    private:
+      friend class generator;
+      explicit iterator(handle coro) noexcept : m_coro(coro) {}
+
+      handle m_coro;
+    };
+
+    generator() noexcept {}
+    generator(generator&& other) noexcept
+      : m_coro(std::exchange(other.m_coro, handle())) {}
+    generator& operator=(generator&& other) noexcept
+    {
+      std::swap(m_coro, other.m_coro);
+      return *this;
+    }
+    ~generator()
+    {
+      if (m_coro)
+        m_coro.destroy();
+    }
+
+    //  Runs the coroutine to its first co_yield. Call once.
+    iterator begin()
+    {
+      if (m_coro)
+        m_coro.resume();
+      return iterator(m_coro);
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+  private:
+    explicit generator(handle coro) noexcept : m_coro(coro) {}
+
+    handle m_coro;
+  };
+
+  template <class T>
+  struct generator<T>::nested_awaiter
+  {
+    explicit nested_awaiter(generator&& g) noexcept : nested(std::move(g)) {}
+
+    bool await_ready() const noexcept { return !nested.m_coro; }
+    std::coroutine_handle<> await_suspend(handle h) noexcept
+    {
+      promise_type& inner = nested.m_coro.promise();
+      inner.m_parent = h;
+      inner.m_root = h.promise().m_root;
+      inner.m_root->m_leaf = nested.m_coro;
+      return nested.m_coro;
+    }
+    void await_resume()
+    {
+      if (nested.m_coro && nested.m_coro.promise().m_exception)
+        std::rethrow_exception(nested.m_coro.promise().m_exception);
+    }
+
+    generator nested;
+  };
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   async_generator                                    //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  //  co_await resume_on(ex) continues the awaiting coroutine on a thread of ex
+  class resume_on
+  {
+  public:
+    explicit resume_on(executor& ex) noexcept : m_ex(ex) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h)
+    {
+      m_ex.post([h]() { h.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+  private:
+    executor& m_ex;
+  };
+
+  //  A generator that may co_await, consumed from another coroutine by
+  //
+  //    while (const T* value = co_await g.next()) ...
+  //
+  //  next() transfers control to the generator, and co_yield transfers it back, so the
+  //  consumer resumes on whichever thread the generator yields from. next() yields a null
+  //  pointer at the end, and rethrows an exception thrown by the generator. The
+  //  async_generator must not be destroyed while a next() is pending.
+  template <class T>
+  class async_generator
+  {
+  public:
+    class promise_type;
+
+  private:
+    typedef std::coroutine_handle<promise_type> handle;
+
+    struct yield_awaiter
+    {
+      bool await_ready() const noexcept { return false; }
+      std::coroutine_handle<> await_suspend(handle h) noexcept
+      {
+        return h.promise().m_consumer;
+      }
+      void await_resume() const noexcept {}
+    };
+
+  public:
+    class promise_type : public detail::frame_allocated_promise
+    {
+    public:
+      promise_type() noexcept : m_value(0) {}
+
+      async_generator get_return_object() noexcept
+      {
+        return async_generator(handle::from_promise(*this));
+      }
+
+      std::suspend_always initial_suspend() const noexcept { return {}; }
+      yield_awaiter final_suspend() noexcept
+      {
+        m_value = 0;
+        return {};
+      }
+
+      yield_awaiter yield_value(const T& value) noexcept
+      {
+        m_value = std::addressof(value);
+        return {};
+      }
+
+      void return_void() const noexcept {}
+      void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+    private:
+      friend class async_generator;
+
+      const T*                 m_value;
+      std::exception_ptr       m_exception;
+      std::coroutine_handle<>  m_consumer;
+    };
+
+    class next_awaiter
+    {
+    public:
+      bool await_ready() const noexcept { return !m_coro || m_coro.done(); }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept
+      {
+        m_coro.promise().m_consumer = consumer;
+        return m_coro;
+      }
+      const T* await_resume()
+      {
+        if (!m_coro)
+          return 0;
+        promise_type& p = m_coro.promise();
+        if (p.m_exception)
+          std::rethrow_exception(std::exchange(p.m_exception, std::exception_ptr()));
+        return p.m_value;
+      }
+
+    private:
+      friend class async_generator;
+      explicit next_awaiter(handle coro) noexcept : m_coro(coro) {}
+
+      handle m_coro;
+    };
+
+    async_generator() noexcept {}
+    async_generator(async_generator&& other) noexcept
+      : m_coro(std::exchange(other.m_coro, handle())) {}
+    async_generator& operator=(async_generator&& other) noexcept
+    {
+      std::swap(m_coro, other.m_coro);
+      return *this;
+    }
+    ~async_generator()
+    {
+      if (m_coro)
+        m_coro.destroy();
+    }
+
+    next_awaiter next() noexcept { return next_awaiter(m_coro); }
+
+  private:
+    explicit async_generator(handle coro) noexcept : m_coro(coro) {}
+
+    handle m_coro;
+  };
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                  directory traversal                                 //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  struct always_descend
+  {
+    bool operator()(const directory_entry&) const noexcept { return true; }
+  };
+
+  namespace detail
+  {
+    //  The read buffer of one level of walk(), taken from the memory_resource the level's
+    //  frame came from and returned there, last in first out
+    class walk_buffer
+    {
+    public:
+      static constexpr std::size_t size = 4 * 1024;
+
+      explicit walk_buffer(std::pmr::memory_resource* mr)
+        : m_mr(mr), m_data(mr->allocate(size, alignof(std::uint64_t))) {}
+      ~walk_buffer() { m_mr->deallocate(m_data, size, alignof(std::uint64_t)); }
+
+      walk_buffer(const walk_buffer&) = delete;
+      walk_buffer& operator=(const walk_buffer&) = delete;
+
+      void* data() const noexcept { return m_data; }
+
+    private:
+      std::pmr::memory_resource*  m_mr;
+      void*                       m_data;
+    };
+
+    template <class Descend>
+    bool walk_enters(const directory_entry& entry, Descend& descend,
+      BOOST_SCOPED_ENUM(symlink_option) opt)
+    {
+      return (is_directory(entry.symlink_status())
+          || (opt == symlink_option::recurse && is_directory(entry.status())))
+        && descend(entry);
+    }
+
+    //  One level of walk(). dir and descend belong to the caller, which outlives the
+    //  generator: the parent level's entry is not touched until the level is finished.
+    template <class Descend>
+    generator<directory_entry> walk_level(std::allocator_arg_t,
+      std::pmr::memory_resource* mr, const path& dir, Descend& descend,
+      BOOST_SCOPED_ENUM(symlink_option) opt)
+    {
+      walk_buffer buffer(mr);
+      directory_cursor cursor(buffer.data(), walk_buffer::size);
+      for (cursor.open(dir); !cursor.at_end(); cursor.increment())
+      {
+        const directory_entry& entry = cursor.entry();
+        co_yield entry;
+        if (walk_enters(entry, descend, opt))
+          co_yield elements_of(walk_level(std::allocator_arg, mr, entry.path(), descend,
+            opt));
+      }
+    }
+
+    //  As walk_level(), through the installed backend, which directory_cursor bypasses
+    template <class Descend>
+    generator<directory_entry> walk_backend_level(std::allocator_arg_t,
+      std::pmr::memory_resource* mr, const path& dir, Descend& descend,
+      BOOST_SCOPED_ENUM(symlink_option) opt)
+    {
+      for (directory_iterator it(dir), end; it != end; ++it)
+      {
+        const directory_entry& entry = *it;
+        co_yield entry;
+        if (walk_enters(entry, descend, opt))
+          co_yield elements_of(walk_backend_level(std::allocator_arg, mr, entry.path(),
+            descend, opt));
+      }
+    }
+  }  // namespace detail
+
+  //  Yields each entry below p, parents before their contents, as
+  //  recursive_directory_iterator does. A directory is entered if descend(entry)
+  //  returns true; with symlink_option::recurse, symlinks to directories are entered too.
+  //  Errors are reported by throwing filesystem_error from the iterator.
+  template <class Descend = always_descend>
+  generator<directory_entry> walk(std::allocator_arg_t, std::pmr::memory_resource* mr,
+    path p, Descend descend = Descend(),
+    BOOST_SCOPED_ENUM(symlink_option) opt = symlink_option::none)
+  {
+    if (&current_backend() == &native_backend())
+      co_yield elements_of(detail::walk_level(std::allocator_arg, mr, p, descend, opt));
+    else
+      co_yield elements_of(detail::walk_backend_level(std::allocator_arg, mr, p, descend,
+        opt));
+  }
+
+  template <class Descend = always_descend>
+  generator<directory_entry> walk(const path& p, Descend descend = Descend(),
+    BOOST_SCOPED_ENUM(symlink_option) opt = symlink_option::none)
+  {
+    return walk(std::allocator_arg, std::pmr::get_default_resource(), p,
+      std::move(descend), opt);
+  }
+
+  //  As walk(), with the traversal run on a thread of ex
+  template <class Descend = always_descend>
+  async_generator<directory_entry> async_walk(std::allocator_arg_t,
+    std::pmr::memory_resource* mr, path p, executor& ex, Descend descend = Descend(),
+    BOOST_SCOPED_ENUM(symlink_option) opt = symlink_option::none)
+  {
+    co_await resume_on(ex);
+    for (const directory_entry& entry
+      : walk(std::allocator_arg, mr, p, std::move(descend), opt))
+      co_yield entry;
+  }
+
+  template <class Descend = always_descend>
+  async_generator<directory_entry> async_walk(const path& p,
+    executor& ex = default_executor(), Descend descend = Descend(),
+    BOOST_SCOPED_ENUM(symlink_option) opt = symlink_option::none)
+  {
+    return async_walk(std::allocator_arg, std::pmr::get_default_resource(), p, ex,
+      std::move(descend), opt);
+  }
+
+}  // namespace filesystem
+}  // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+
+#endif  // BOOST_FILESYSTEM_NO_COROUTINES
+
+#endif  // BOOST_FILESYSTEM_GENERATOR_HPP
@@ -0,0 +1,195 @@
+//  filesystem/instrumentation.hpp  ----------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Per-operation counters and latency histograms, and tracing of calls as nested spans,
+//  collected only when the library itself was built with BOOST_FILESYSTEM_INSTRUMENTATION
+//  defined. Otherwise the probes compile to nothing, enabled() returns false, every
+//  snapshot is zero, and observers and tracers are never called.
+
+#ifndef BOOST_FILESYSTEM_INSTRUMENTATION_HPP
+#define BOOST_FILESYSTEM_INSTRUMENTATION_HPP
+
+#include <boost/config.hpp>
+
+# if defined( BOOST_NO_STD_WSTRING )
+#   error Configuration not supported: Boost.Filesystem V3 and later requires std::wstring support
+# endif
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <cstddef>
+#include <iosfwd>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+namespace instrumentation
+{
+  //  The instrumented operations. An operation that calls others, as remove_all() calls
+  //  symlink_status() and directory_iterator, counts the syscalls and bytes of those
+  //  calls as its own as well as reporting them under their own operations.
+  enum operation
+  {
+    status_op,
+    symlink_status_op,
+    file_size_op,
+    directory_iterator_construct_op,
+    directory_iterator_increment_op,
+    directory_cursor_open_op,
+    directory_cursor_increment_op,
+    copy_file_op,
+    copy_directory_op,
+    create_directory_op,
+    create_directories_op,
+    create_symlink_op,
+    remove_op,
+    remove_all_op,
+    remove_all_subtree_op,  // each directory that remove_all() removes
+    rename_op,
+    resize_file_op,
+    move_op,
+    bulk_copy_file_op,
+    bulk_create_directories_op,
+    bulk_remove_all_op,
+    bulk_status_op,
+    operation_count
+  };
+
+  //  "status", "remove_all", and so on
+  BOOST_FILESYSTEM_DECL const char* operation_name(operation op) BOOST_NOEXCEPT;
+
+  //  latency[i] counts the calls that took from 2^(i-1) to 2^i - 1 nanoseconds, and
+  //  latency[0] those that took no measurable time; the last bucket also counts all
+  //  slower calls
+  const std::size_t latency_buckets = 40;
+
+  struct operation_stats
+  {
+    boost::uint64_t  calls;
+    boost::uint64_t  syscalls;
+    boost::uint64_t  bytes;     // copied, for copy_file
+    boost::uint64_t  errors;    // calls that reported an error or threw
+    boost::uint64_t  total_ns;
+    boost::uint64_t  max_ns;
+    boost::uint64_t  latency[latency_buckets];
+  };
+
+  struct snapshot
+  {
+    operation_stats  operations[operation_count];
+  };
+
+  //  What an observer is told about each call, on the thread that made it
+  struct operation_record
+  {
+    operation         op;
+    const path*       p;        // the first path argument, or 0
+    boost::uint64_t   ns;
+    boost::uint64_t   syscalls;
+    boost::uint64_t   bytes;
+    bool              failed;
+  };
+
+  //  An observer must not throw, and should be quick, since it runs inside every call.
+  class observer
+  {
+  public:
+    virtual ~observer() {}
+    virtual void operation_completed(const operation_record& record) = 0;
+  };
+
+  //  true if the library was built with BOOST_FILESYSTEM_INSTRUMENTATION
+  BOOST_FILESYSTEM_DECL bool enabled() BOOST_NOEXCEPT;
+
+  //  The counts since the start of the program or the last reset(). Counts are updated
+  //  independently, so a snapshot taken while other threads are making calls may be
+  //  mid-way through one of them.
+  BOOST_FILESYSTEM_DECL void take_snapshot(snapshot& s) BOOST_NOEXCEPT;
+  BOOST_FILESYSTEM_DECL void reset() BOOST_NOEXCEPT;
+
+  //  Installs o, or removes the observer if o is 0, and returns the observer it replaces.
+  //  The caller must keep o alive until it has been replaced and any calls that might
+  //  still be using it have returned. Does nothing, returning 0, unless enabled().
+  BOOST_FILESYSTEM_DECL observer* set_observer(observer* o) BOOST_NOEXCEPT;
+
+  //  tracing  -------------------------------------------------------------------------//
+
+  struct span
+  {
+    operation         op;
+    const path*       p;         // as for operation_record
+    boost::uint64_t   start_ns;  // by the steady clock, from an unspecified epoch
+    unsigned          thread;    // numbers the threads from 1, in order of first span
+    unsigned          depth;     // the number of spans and untraced calls enclosing it
+  };
+
+  //  A tracer is told as each traced call begins and ends, on the thread that made it;
+  //  spans on a thread nest. Like an observer, it must not throw, and should be quick.
+  class tracer
+  {
+  public:
+    virtual ~tracer() {}
+    virtual void begin_span(const span& s) = 0;
+    virtual void end_span(const span& s, const operation_record& record) = 0;
+  };
+
+  //  Sampling for large trees. A call is traced if the call enclosing it on the same
+  //  thread, if any, was traced, and either it is not full_depth calls deep or it is one
+  //  in every sample_every of the calls that deep on its thread. So the top levels are
+  //  complete, and below them whole subtrees are kept or dropped.
+  struct trace_options
+  {
+    trace_options() : sample_every(1), full_depth(1) {}
+    trace_options(unsigned every, unsigned depth)
+      : sample_every(every), full_depth(depth) {}
+
+    unsigned  sample_every;  // 1 traces every call
+    unsigned  full_depth;
+  };
+
+  //  Installs t, or removes the tracer if t is 0, and returns the tracer it replaces. A
+  //  call that began while another tracer was installed reports its end to that tracer,
+  //  which must be kept alive until such calls have returned. Calls already in progress
+  //  when t is installed are not traced, nor are the calls they make. Does nothing,
+  //  returning 0, unless enabled().
+  BOOST_FILESYSTEM_DECL tracer* set_tracer(tracer* t,
+    const trace_options& options = trace_options()) BOOST_NOEXCEPT;
+
+  //  Writes spans to a stream in the Chrome trace event format, for chrome://tracing,
+  //  Perfetto and similar viewers. Each span is a begin and an end event, named for the
+  //  operation, in category "data" if it copies file contents and "metadata" otherwise.
+  //  Begin events carry the path and end events the syscalls, bytes, and failure. The
+  //  closing of the JSON is written by close() or the destructor. Spans may be reported
+  //  by several threads at once.
+  class BOOST_FILESYSTEM_DECL chrome_trace_writer : public tracer
+  {
+  public:
+    explicit chrome_trace_writer(std::ostream& os);
+    ~chrome_trace_writer();
+
+    void begin_span(const span& s);
+    void end_span(const span& s, const operation_record& record);
+    void close();  // remove this tracer first
+
+  private:
+    struct impl;
+    boost::scoped_ptr<impl> m_imp;
+  };
+
+} // namespace instrumentation
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+#endif // BOOST_FILESYSTEM_INSTRUMENTATION_HPP
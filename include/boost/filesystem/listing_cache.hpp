@@ -0,0 +1,115 @@
+//  filesystem/listing_cache.hpp  ------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Shared, immutable snapshots of directories' entries, for threads that list the same
+//  directories over and over. Like directory_cursor, the cache always reads the native
+//  file system, whatever backend is installed.
+
+#ifndef BOOST_FILESYSTEM_LISTING_CACHE_HPP
+#define BOOST_FILESYSTEM_LISTING_CACHE_HPP
+
+#include <boost/config.hpp>
+
+# if defined( BOOST_NO_STD_WSTRING )
+#   error Configuration not supported: Boost.Filesystem V3 and later requires std::wstring support
+# endif
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cstddef>
+#include <vector>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+  //  A directory's entries, in the order they were read, each with both its status and
+  //  its symlink_status already known, so that the entries never stat again and the
+  //  snapshot can be read by any number of threads without locking.
+  class directory_snapshot
+  {
+  public:
+    typedef std::vector<directory_entry>::const_iterator  const_iterator;
+
+    directory_snapshot(const path& dir, std::vector<directory_entry>& entries)
+      : m_directory(dir) { m_entries.swap(entries); }
+
+    const path&             directory() const  { return m_directory; }
+    std::size_t             size() const       { return m_entries.size(); }
+    bool                    empty() const      { return m_entries.empty(); }
+    const_iterator          begin() const      { return m_entries.begin(); }
+    const_iterator          end() const        { return m_entries.end(); }
+    const directory_entry&  operator[](std::size_t i) const  { return m_entries[i]; }
+
+  private:
+    path                          m_directory;
+    std::vector<directory_entry>  m_entries;
+  };
+
+  typedef boost::shared_ptr<const directory_snapshot> directory_snapshot_ptr;
+
+  struct listing_cache_statistics
+  {
+    listing_cache_statistics()
+      : hits(0), shared(0), misses(0), invalidations(0), evictions(0), entries(0) {}
+
+    boost::uintmax_t  hits;           // answered by a snapshot still valid
+    boost::uintmax_t  shared;         // answered by a listing another thread just made
+    boost::uintmax_t  misses;         // answered by reading the directory
+    boost::uintmax_t  invalidations;  // dropped by invalidate() or clear()
+    boost::uintmax_t  evictions;      // snapshots dropped to make room
+    boost::uintmax_t  entries;        // directories held now
+  };
+
+  //  list() stats the directory, and returns the snapshot held for it if the directory
+  //  is still the same one, by device and inode (volume and file index on Windows), and
+  //  its last write time has not changed. Otherwise it reads the directory and holds the
+  //  new snapshot in place of the old. Threads that find the same directory stale at
+  //  once wait for one of them to read it, and share its snapshot. A directory written
+  //  in the same second that it was read may have changed unseen, as its last write time
+  //  can only show the second, so its snapshot is used by the thread that read it but
+  //  not trusted by the next list(), which reads the directory again. A full cache drops
+  //  the snapshot least recently listed.
+  class BOOST_FILESYSTEM_DECL listing_cache
+  {
+  public:
+    explicit listing_cache(std::size_t max_directories = 1024, unsigned shards = 16);
+    ~listing_cache();
+
+    //  Keyed by p as given. Never returns 0; throws filesystem_error on failure.
+    directory_snapshot_ptr list(const path& p);
+    //  Returns 0 if ec is set
+    directory_snapshot_ptr list(const path& p, system::error_code& ec);
+
+    void invalidate(const path& p);
+    void clear();
+
+    listing_cache_statistics statistics() const;
+    void reset_statistics();
+
+  private:
+    struct impl;
+    boost::scoped_ptr<impl> m_imp;
+
+    listing_cache(const listing_cache&);
+    listing_cache& operator=(const listing_cache&);
+  };
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+#endif // BOOST_FILESYSTEM_LISTING_CACHE_HPP
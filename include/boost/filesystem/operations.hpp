@@ -341,9 +341,77 @@ namespace boost
   };
 
   BOOST_SCOPED_ENUM_START(copy_option)
-    {none=0, fail_if_exists = none, overwrite_if_exists};
+    {none=0, fail_if_exists = none, overwrite_if_exists,
+     preallocate = 4};  // reserve the target's space before copying, if supported
   BOOST_SCOPED_ENUM_END
 
+  BOOST_BITMASK(BOOST_SCOPED_ENUM(copy_option))
+
+  BOOST_SCOPED_ENUM_START(move_option)
+  {
+    none = 0,
+    no_copy = 1,        // report the rename() failure rather than copy and remove
+    single_thread = 2,  // copy a directory tree on the calling thread only
+    always_copy = 4,    // copy and remove as if across devices, without trying rename()
+    resume = 8          // complete an interrupted copying move, reusing its targets
+  };
+  BOOST_SCOPED_ENUM_END
+
+  BOOST_BITMASK(BOOST_SCOPED_ENUM(move_option))
+
+  struct move_progress
+  {
+    boost::uintmax_t files;    // files, directories, and symlinks copied so far
+    boost::uintmax_t bytes;    // bytes of regular file contents copied so far
+    boost::uintmax_t removed;  // source entries removed after the copy completed
+  };
+
+  //  Called each time a move that copies makes progress. Calls are serialized, but may
+  //  come from any of the threads copying the tree. Return false to abandon the move.
+  typedef bool (*move_progress_handler)(const move_progress& progress, void* context);
+
+  BOOST_SCOPED_ENUM_START(preallocate_option)
+  {
+    none = 0,        // allocate the range, extending the file if it ends before the range
+    keep_size = 1,   // allocate the range, leaving the file size alone
+    punch_hole = 2,  // deallocate the range, which then reads as zeros; implies keep_size
+    zero_range = 4   // make the range read as zeros, without writing them where possible
+  };
+  BOOST_SCOPED_ENUM_END
+
+  BOOST_BITMASK(BOOST_SCOPED_ENUM(preallocate_option))
+
+# ifdef BOOST_WINDOWS_API
+  typedef void* native_file_handle;  // HANDLE
+# else
+  typedef int native_file_handle;    // file descriptor
+# endif
+
+  BOOST_SCOPED_ENUM_START(rename_option)
+  {
+    none = 0,
+    no_replace = 1,  // fail if new_p exists, atomically where supported
+    exchange = 2     // atomically swap old_p and new_p, which must both exist
+  };
+  BOOST_SCOPED_ENUM_END
+
+  //  User and group ids for change_owner_all(), as POSIX uid_t and gid_t values.
+  typedef unsigned long owner_id;
+  const owner_id unchanged_owner = static_cast<owner_id>(-1);  // leave this id alone
+
+  //  How the bulk_ functions do their work. Each either submits batches of requests to
+  //  the kernel through io_uring, if the library was built with
+  //  BOOST_FILESYSTEM_USE_IO_URING and the kernel supports the requests, or else spreads
+  //  the paths over a thread pool.
+  struct bulk_options
+  {
+    bulk_options() : use_io_uring(true), queue_depth(64), threads(0) {}
+
+    bool      use_io_uring;  // false to always use the thread pool
+    unsigned  queue_depth;   // io_uring requests in flight at once
+    unsigned  threads;       // thread pool size; 0 for one per processor
+  };
+
 //--------------------------------------------------------------------------------------//
 //                             implementation details                                   //
 //--------------------------------------------------------------------------------------//
@@ -353,7 +421,8 @@ namespace boost
     //  We cannot pass a BOOST_SCOPED_ENUM to a compled function because it will result
     //  in an undefined reference if the library is compled with -std=c++0x but the use
     //  is compiled in C++03 mode, or visa versa. See tickets 6124, 6779, 10038.
-    enum copy_option {none=0, fail_if_exists = none, overwrite_if_exists};
+    enum copy_option {none=0, fail_if_exists = none, overwrite_if_exists,
+                      _detail_preallocate = 4};
 
     BOOST_FILESYSTEM_DECL
     file_status status(const path&p, system::error_code* ec=0);
@@ -366,6 +435,27 @@ namespace boost
     BOOST_FILESYSTEM_DECL
     path canonical(const path& p, const path& base, system::error_code* ec=0);
     BOOST_FILESYSTEM_DECL
+    std::vector<path> absolute_batch(const std::vector<path>& paths,
+                                     system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
+    void bulk_copy_file(const std::vector<path>& from, const std::vector<path>& to,
+                        detail::copy_option option, const bulk_options& options,
+                        system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
+    boost::uintmax_t bulk_create_directories(const std::vector<path>& paths,
+                                             const bulk_options& options,
+                                             system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
+    boost::uintmax_t bulk_remove_all(const std::vector<path>& paths,
+                                     const bulk_options& options, system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
+    std::vector<file_status> bulk_status(const std::vector<path>& paths,
+                                         const bulk_options& options,
+                                         system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
+    boost::uintmax_t change_owner_all(const path& p, owner_id user, owner_id group,
+                                      system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
     void copy(const path& from, const path& to, system::error_code* ec=0);
     BOOST_FILESYSTEM_DECL
     void copy_directory(const path& from, const path& to, system::error_code* ec=0);
@@ -390,6 +480,10 @@ namespace boost
     BOOST_FILESYSTEM_DECL
     void current_path(const path& p, system::error_code* ec=0);
     BOOST_FILESYSTEM_DECL
+    path cached_current_path(bool revalidate, system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
+    void invalidate_cached_current_path();
+    BOOST_FILESYSTEM_DECL
     bool equivalent(const path& p1, const path& p2, system::error_code* ec=0);
     BOOST_FILESYSTEM_DECL
     boost::uintmax_t file_size(const path& p, system::error_code* ec=0);
@@ -401,8 +495,23 @@ namespace boost
     void last_write_time(const path& p, const std::time_t new_time,
                          system::error_code* ec=0);
     BOOST_FILESYSTEM_DECL
+    void move(const path& from, const path& to, unsigned int options,  // move_option bits
+              move_progress_handler handler, void* context, system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
     void permissions(const path& p, perms prms, system::error_code* ec=0);
     BOOST_FILESYSTEM_DECL
+    boost::uintmax_t permissions_all(const path& p, perms prms, system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
+    void preallocate(const path& p, boost::uintmax_t offset, boost::uintmax_t length,
+                     unsigned int options, system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
+    void preallocate(native_file_handle h, boost::uintmax_t offset,
+                     boost::uintmax_t length, unsigned int options,
+                     system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
+    boost::uintmax_t prefetch(const path& p, boost::uintmax_t offset,
+                              boost::uintmax_t length, system::error_code* ec=0);
+    BOOST_FILESYSTEM_DECL
     path read_symlink(const path& p, system::error_code* ec=0);
     BOOST_FILESYSTEM_DECL
     path relative(const path& p, const path& base, system::error_code* ec = 0);
@@ -413,6 +522,9 @@ namespace boost
     BOOST_FILESYSTEM_DECL
     void rename(const path& old_p, const path& new_p, system::error_code* ec=0);
     BOOST_FILESYSTEM_DECL
+    void rename(const path& old_p, const path& new_p, unsigned int option,  // rename_option
+                system::error_code* ec);
+    BOOST_FILESYSTEM_DECL
     void resize_file(const path& p, uintmax_t size, system::error_code* ec=0);
     BOOST_FILESYSTEM_DECL
     space_info space(const path& p, system::error_code* ec=0); 
@@ -496,6 +608,15 @@ namespace boost
   path absolute(const path& p, const path& base=current_path());
   //  If base.is_absolute(), throws nothing. Thus no need for ec argument
 
+  //  absolute(p, cached_current_path(true)) for each of paths, with the working
+  //  directory found once for the whole batch
+  inline
+  std::vector<path> absolute_batch(const std::vector<path>& paths)
+                                       {return detail::absolute_batch(paths);}
+  inline
+  std::vector<path> absolute_batch(const std::vector<path>& paths, system::error_code& ec)
+                                       {return detail::absolute_batch(paths, &ec);}
+
   inline
   path canonical(const path& p, const path& base=current_path())
                                        {return detail::canonical(p, base);}
@@ -506,6 +627,62 @@ namespace boost
   path canonical(const path& p, const path& base, system::error_code& ec)
                                        {return detail::canonical(p, base, &ec);}
 
+  inline
+  void bulk_copy_file(const std::vector<path>& from, const std::vector<path>& to,
+                      BOOST_SCOPED_ENUM(copy_option) option = copy_option::fail_if_exists,
+                      const bulk_options& options = bulk_options())
+  {
+    detail::bulk_copy_file(from, to, static_cast<detail::copy_option>(option), options);
+  }
+  inline
+  void bulk_copy_file(const std::vector<path>& from, const std::vector<path>& to,
+                      BOOST_SCOPED_ENUM(copy_option) option, const bulk_options& options,
+                      system::error_code& ec) BOOST_NOEXCEPT
+  {
+    detail::bulk_copy_file(from, to, static_cast<detail::copy_option>(option), options,
+                           &ec);
+  }
+  inline
+  boost::uintmax_t bulk_create_directories(const std::vector<path>& paths,
+                                           const bulk_options& options = bulk_options())
+                                       {return detail::bulk_create_directories(paths, options);}
+  inline
+  boost::uintmax_t bulk_create_directories(const std::vector<path>& paths,
+                                           const bulk_options& options,
+                                           system::error_code& ec) BOOST_NOEXCEPT
+                                       {return detail::bulk_create_directories(paths, options,
+                                                                               &ec);}
+  inline
+  boost::uintmax_t bulk_remove_all(const std::vector<path>& paths,
+                                   const bulk_options& options = bulk_options())
+                                       {return detail::bulk_remove_all(paths, options);}
+  inline
+  boost::uintmax_t bulk_remove_all(const std::vector<path>& paths,
+                                   const bulk_options& options,
+                                   system::error_code& ec) BOOST_NOEXCEPT
+                                       {return detail::bulk_remove_all(paths, options, &ec);}
+  inline
+  std::vector<file_status> bulk_status(const std::vector<path>& paths,
+                                       const bulk_options& options = bulk_options())
+                                       {return detail::bulk_status(paths, options);}
+  inline
+  std::vector<file_status> bulk_status(const std::vector<path>& paths,
+                                       const bulk_options& options,
+                                       system::error_code& ec)
+                                       {return detail::bulk_status(paths, options, &ec);}
+
+  //  true if the bulk_ functions can use io_uring on this system
+  BOOST_FILESYSTEM_DECL
+  bool io_uring_available() BOOST_NOEXCEPT;
+
+  inline
+  boost::uintmax_t change_owner_all(const path& p, owner_id user, owner_id group)
+                                       {return detail::change_owner_all(p, user, group);}
+  inline
+  boost::uintmax_t change_owner_all(const path& p, owner_id user, owner_id group,
+                                    system::error_code& ec) BOOST_NOEXCEPT
+                                       {return detail::change_owner_all(p, user, group, &ec);}
+
 # ifndef BOOST_FILESYSTEM_NO_DEPRECATED
   inline
   path complete(const path& p)
@@ -604,6 +781,19 @@ namespace boost
   inline
   void current_path(const path& p, system::error_code& ec) BOOST_NOEXCEPT {detail::current_path(p, &ec);}
 
+  //  The working directory as last found, found again only when current_path(p) has
+  //  changed it since, or invalidate_cached_current_path() has been called, or, if
+  //  revalidate, the directory open as "." is no longer the one that was found
+  inline
+  path cached_current_path(bool revalidate = false)
+                                       {return detail::cached_current_path(revalidate);}
+  inline
+  path cached_current_path(bool revalidate, system::error_code& ec)
+    {return detail::cached_current_path(revalidate, &ec);}
+  //  For programs that change the working directory other than by current_path(p)
+  inline
+  void invalidate_cached_current_path() {detail::invalidate_cached_current_path();}
+
   inline
   bool equivalent(const path& p1, const path& p2) {return detail::equivalent(p1, p2);}
 
@@ -647,11 +837,104 @@ namespace boost
                        system::error_code& ec) BOOST_NOEXCEPT
                                        {detail::last_write_time(p, new_time, &ec);}
   inline
+  void move(const path& from, const path& to)
+                                       {detail::move(from, to, 0, 0, 0);}
+  inline
+  void move(const path& from, const path& to, system::error_code& ec) BOOST_NOEXCEPT
+                                       {detail::move(from, to, 0, 0, 0, &ec);}
+  inline
+  void move(const path& from, const path& to, BOOST_SCOPED_ENUM(move_option) options,
+            move_progress_handler handler = 0, void* context = 0)
+  {
+    detail::move(from, to, static_cast<unsigned int>(options), handler, context);
+  }
+  inline
+  void move(const path& from, const path& to, BOOST_SCOPED_ENUM(move_option) options,
+            move_progress_handler handler, void* context,
+            system::error_code& ec) BOOST_NOEXCEPT
+  {
+    detail::move(from, to, static_cast<unsigned int>(options), handler, context, &ec);
+  }
+  inline
   void permissions(const path& p, perms prms)
                                        {detail::permissions(p, prms);}
   inline
   void permissions(const path& p, perms prms, system::error_code& ec) BOOST_NOEXCEPT
                                        {detail::permissions(p, prms, &ec);}
+  inline
+  boost::uintmax_t permissions_all(const path& p, perms prms)
+                                       {return detail::permissions_all(p, prms);}
+  inline
+  boost::uintmax_t permissions_all(const path& p, perms prms,
+                                   system::error_code& ec) BOOST_NOEXCEPT
+                                       {return detail::permissions_all(p, prms, &ec);}
+
+  inline
+  void preallocate(const path& p, boost::uintmax_t offset, boost::uintmax_t length,
+                   BOOST_SCOPED_ENUM(preallocate_option) options = preallocate_option::none)
+  {
+    detail::preallocate(p, offset, length, static_cast<unsigned int>(options));
+  }
+  inline
+  void preallocate(const path& p, boost::uintmax_t offset, boost::uintmax_t length,
+                   BOOST_SCOPED_ENUM(preallocate_option) options,
+                   system::error_code& ec) BOOST_NOEXCEPT
+  {
+    detail::preallocate(p, offset, length, static_cast<unsigned int>(options), &ec);
+  }
+  inline
+  void preallocate(native_file_handle h, boost::uintmax_t offset, boost::uintmax_t length,
+                   BOOST_SCOPED_ENUM(preallocate_option) options = preallocate_option::none)
+  {
+    detail::preallocate(h, offset, length, static_cast<unsigned int>(options));
+  }
+  inline
+  void preallocate(native_file_handle h, boost::uintmax_t offset, boost::uintmax_t length,
+                   BOOST_SCOPED_ENUM(preallocate_option) options,
+                   system::error_code& ec) BOOST_NOEXCEPT
+  {
+    detail::preallocate(h, offset, length, static_cast<unsigned int>(options), &ec);
+  }
+
+  inline
+  void punch_hole(const path& p, boost::uintmax_t offset, boost::uintmax_t length)
+  {
+    detail::preallocate(p, offset, length,
+      static_cast<unsigned int>(preallocate_option::punch_hole));
+  }
+  inline
+  void punch_hole(const path& p, boost::uintmax_t offset, boost::uintmax_t length,
+                  system::error_code& ec) BOOST_NOEXCEPT
+  {
+    detail::preallocate(p, offset, length,
+      static_cast<unsigned int>(preallocate_option::punch_hole), &ec);
+  }
+  inline
+  void punch_hole(native_file_handle h, boost::uintmax_t offset, boost::uintmax_t length)
+  {
+    detail::preallocate(h, offset, length,
+      static_cast<unsigned int>(preallocate_option::punch_hole));
+  }
+  inline
+  void punch_hole(native_file_handle h, boost::uintmax_t offset, boost::uintmax_t length,
+                  system::error_code& ec) BOOST_NOEXCEPT
+  {
+    detail::preallocate(h, offset, length,
+      static_cast<unsigned int>(preallocate_option::punch_hole), &ec);
+  }
+
+  //  Asks the system to begin reading length bytes of p from offset, 0 meaning to the
+  //  end, into the page cache, and returns without waiting. Returns the bytes asked
+  //  for, which is 0 if p is not a regular file or the system has no such request.
+  inline
+  boost::uintmax_t prefetch(const path& p, boost::uintmax_t offset = 0,
+                            boost::uintmax_t length = 0)
+                                       {return detail::prefetch(p, offset, length);}
+  inline
+  boost::uintmax_t prefetch(const path& p, boost::uintmax_t offset,
+                            boost::uintmax_t length,
+                            system::error_code& ec) BOOST_NOEXCEPT
+                                       {return detail::prefetch(p, offset, length, &ec);}
 
   inline
   path read_symlink(const path& p)     {return detail::read_symlink(p);}
@@ -679,6 +962,17 @@ namespace boost
   inline
   void rename(const path& old_p, const path& new_p, system::error_code& ec) BOOST_NOEXCEPT
                                        {detail::rename(old_p, new_p, &ec);}
+  inline
+  void rename(const path& old_p, const path& new_p, BOOST_SCOPED_ENUM(rename_option) option)
+  {
+    detail::rename(old_p, new_p, static_cast<unsigned int>(option), 0);
+  }
+  inline
+  void rename(const path& old_p, const path& new_p, BOOST_SCOPED_ENUM(rename_option) option,
+              system::error_code& ec) BOOST_NOEXCEPT
+  {
+    detail::rename(old_p, new_p, static_cast<unsigned int>(option), &ec);
+  }
   inline  // name suggested by Scott McMurray
   void resize_file(const path& p, uintmax_t size) {detail::resize_file(p, size);}
 
@@ -771,11 +1065,8 @@ public:
 
 #if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
   directory_entry(directory_entry&& rhs) BOOST_NOEXCEPT
-  {
-    m_path = std::move(rhs.m_path);
-    m_status = std::move(rhs.m_status);
-    m_symlink_status = std::move(rhs.m_symlink_status);
-  }
+    : m_path(std::move(rhs.m_path)), m_status(rhs.m_status),
+      m_symlink_status(rhs.m_symlink_status) {}
   directory_entry& operator=(directory_entry&& rhs) BOOST_NOEXCEPT
   { 
     m_path = std::move(rhs.m_path);
@@ -783,6 +1074,17 @@ public:
     m_symlink_status = std::move(rhs.m_symlink_status);
     return *this;
   }
+
+  //  take p's storage rather than copying it
+  explicit directory_entry(boost::filesystem::path&& p) BOOST_NOEXCEPT
+    : m_path(std::move(p)) {}
+  directory_entry(boost::filesystem::path&& p,
+    file_status st, file_status symlink_st = file_status()) BOOST_NOEXCEPT
+    : m_path(std::move(p)), m_status(st), m_symlink_status(symlink_st) {}
+
+  void assign(boost::filesystem::path&& p,
+    file_status st = file_status(), file_status symlink_st = file_status())
+    { m_path = std::move(p); m_status = st; m_symlink_status = symlink_st; }
 #endif
 
   void assign(const boost::filesystem::path& p,
@@ -838,6 +1140,19 @@ private:
 
 class directory_iterator;
 
+//  A directory opened by a backend other than the native one; see backend.hpp
+class backend_directory
+{
+public:
+  virtual ~backend_directory() {}
+
+  //  Sets filename, which has no parent path, and the statuses to those of the next
+  //  entry other than dot and dot-dot. Returns false, with ec clear, if there are no
+  //  more entries, or with ec set if the directory could not be read.
+  virtual bool read(path& filename, file_status& s, file_status& symlink_s,
+    system::error_code& ec) = 0;
+};
+
 namespace detail
 {
   BOOST_FILESYSTEM_DECL
@@ -850,14 +1165,15 @@ namespace detail
 
   struct dir_itr_imp
   {
-    directory_entry  dir_entry;
-    void*            handle;
+    directory_entry     dir_entry;
+    void*               handle;
+    backend_directory*  stream;  // instead of handle, if a backend is installed
 
 #   ifdef BOOST_POSIX_API
-    void*            buffer;  // see dir_itr_increment implementation
+    void*               buffer;  // see dir_itr_increment implementation
 #   endif
 
-    dir_itr_imp() : handle(0)
+    dir_itr_imp() : handle(0), stream(0)
 #   ifdef BOOST_POSIX_API
       , buffer(0)
 #   endif
@@ -865,6 +1181,7 @@ namespace detail
 
     ~dir_itr_imp() // never throws
     {
+      delete stream;
       dir_itr_close(handle
 #       if defined(BOOST_POSIX_API)
          , buffer
@@ -922,7 +1239,8 @@ namespace detail
       system::error_code* ec);
 
     // shared_ptr provides the shallow-copy semantics required for single pass iterators
-    // (i.e. InputIterators). The end iterator is indicated by !m_imp || !m_imp->handle
+    // (i.e. InputIterators). The end iterator is indicated by !m_imp, or by an m_imp
+    // with neither a handle nor a stream
     boost::shared_ptr< detail::dir_itr_imp >  m_imp;
 
     friend class boost::iterator_core_access;
@@ -941,8 +1259,8 @@ namespace detail
     bool equal(const directory_iterator& rhs) const
     { 
       return m_imp == rhs.m_imp
-        || (!m_imp && rhs.m_imp && !rhs.m_imp->handle)
-        || (!rhs.m_imp && m_imp && !m_imp->handle);
+        || (!m_imp && rhs.m_imp && !rhs.m_imp->handle && !rhs.m_imp->stream)
+        || (!rhs.m_imp && m_imp && !m_imp->handle && !m_imp->stream);
     }
 
   };  // directory_iterator
@@ -1339,6 +1657,570 @@ namespace filesystem
   typedef recursive_directory_iterator wrecursive_directory_iterator;
 # endif
 
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                  directory_cursor                                    //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  class directory_cursor;
+
+  namespace detail
+  {
+    BOOST_FILESYSTEM_DECL void directory_cursor_open(directory_cursor& c, const path& p,
+      system::error_code* ec);
+    BOOST_FILESYSTEM_DECL void directory_cursor_increment(directory_cursor& c,
+      system::error_code* ec);
+    BOOST_FILESYSTEM_DECL void directory_cursor_close(directory_cursor& c,
+      bool release_buffer) BOOST_NOEXCEPT;
+    BOOST_FILESYSTEM_DECL void directory_cursor_suspend(directory_cursor& c)
+      BOOST_NOEXCEPT;
+  }  // namespace detail
+
+  //  A move-only alternative to directory_iterator that keeps its state in the object
+  //  rather than in shared heap memory. open() may be called again to read another
+  //  directory, reusing the storage of the previous one, so a traversal that keeps one
+  //  cursor per level makes no allocations once each level has been reached. On Linux,
+  //  entries are read by getdents64() into a buffer that is either supplied by the caller
+  //  or allocated on the first open(); elsewhere the platform directory stream is used.
+  class directory_cursor
+  {
+  public:
+    //  creates a closed cursor; at_end() is true
+    directory_cursor() BOOST_NOEXCEPT
+      : m_handle(0), m_fd(-1), m_buffer(0), m_size(0), m_pos(0), m_end(0),
+        m_offset(0), m_inode(0), m_type(status_error), m_owns_buffer(false),
+        m_at_end(true), m_suspended(false) {}
+
+    //  Entries are read into the size bytes at buffer, which must outlive the cursor and
+    //  be aligned as for boost::uint64_t. A few kilobytes is enough for most directories.
+    directory_cursor(void* buffer, std::size_t size) BOOST_NOEXCEPT
+      : m_handle(0), m_fd(-1), m_buffer(static_cast<char*>(buffer)), m_size(size),
+        m_pos(0), m_end(0), m_offset(0), m_inode(0), m_type(status_error),
+        m_owns_buffer(false), m_at_end(true), m_suspended(false) {}
+
+    explicit directory_cursor(const path& p)
+      : m_handle(0), m_fd(-1), m_buffer(0), m_size(0), m_pos(0), m_end(0),
+        m_offset(0), m_inode(0), m_type(status_error), m_owns_buffer(false),
+        m_at_end(true), m_suspended(false)
+          { detail::directory_cursor_open(*this, p, 0); }
+
+    directory_cursor(const path& p, system::error_code& ec) BOOST_NOEXCEPT
+      : m_handle(0), m_fd(-1), m_buffer(0), m_size(0), m_pos(0), m_end(0),
+        m_offset(0), m_inode(0), m_type(status_error), m_owns_buffer(false),
+        m_at_end(true), m_suspended(false)
+          { detail::directory_cursor_open(*this, p, &ec); }
+
+   ~directory_cursor() { detail::directory_cursor_close(*this, true); }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    directory_cursor(directory_cursor&& rhs) BOOST_NOEXCEPT
+      : m_handle(0), m_fd(-1), m_buffer(0), m_size(0), m_pos(0), m_end(0),
+        m_offset(0), m_inode(0), m_type(status_error), m_owns_buffer(false),
+        m_at_end(true), m_suspended(false)
+          { swap(rhs); }
+
+    directory_cursor& operator=(directory_cursor&& rhs) BOOST_NOEXCEPT
+    {
+      detail::directory_cursor_close(*this, true);
+      m_buffer = 0;
+      m_size = 0;
+      swap(rhs);
+      return *this;
+    }
+#endif
+
+    void swap(directory_cursor& rhs) BOOST_NOEXCEPT
+    {
+      std::swap(m_entry, rhs.m_entry);
+      m_name.swap(rhs.m_name);
+      std::swap(m_handle, rhs.m_handle);
+      std::swap(m_fd, rhs.m_fd);
+      std::swap(m_buffer, rhs.m_buffer);
+      std::swap(m_size, rhs.m_size);
+      std::swap(m_pos, rhs.m_pos);
+      std::swap(m_end, rhs.m_end);
+      std::swap(m_offset, rhs.m_offset);
+      std::swap(m_inode, rhs.m_inode);
+      std::swap(m_type, rhs.m_type);
+      std::swap(m_owns_buffer, rhs.m_owns_buffer);
+      std::swap(m_at_end, rhs.m_at_end);
+      std::swap(m_suspended, rhs.m_suspended);
+#     ifdef BOOST_WINDOWS_API
+      m_filename.swap(rhs.m_filename);
+#     endif
+    }
+
+    //  Closes the current directory, if any, and moves to the first entry of p other
+    //  than dot and dot-dot. at_end() is true if there is none.
+    void open(const path& p)  { detail::directory_cursor_open(*this, p, 0); }
+    void open(const path& p, system::error_code& ec) BOOST_NOEXCEPT
+                              { detail::directory_cursor_open(*this, p, &ec); }
+
+    void increment()          { detail::directory_cursor_increment(*this, 0); }
+    directory_cursor& increment(system::error_code& ec) BOOST_NOEXCEPT
+    {
+      detail::directory_cursor_increment(*this, &ec);
+      return *this;
+    }
+
+    void close() BOOST_NOEXCEPT { detail::directory_cursor_close(*this, false); }
+
+    //  Closes the directory but keeps entry() and the position after it, so that the
+    //  next increment() reopens the directory and carries on from there. Entries added
+    //  or removed meanwhile may or may not be seen, as with any concurrent change; where
+    //  the stream cannot be repositioned, the entries already returned are skipped.
+    void suspend() BOOST_NOEXCEPT   { detail::directory_cursor_suspend(*this); }
+    bool suspended() const BOOST_NOEXCEPT { return m_suspended; }
+
+    bool at_end() const BOOST_NOEXCEPT { return m_at_end; }
+
+    const directory_entry& entry() const BOOST_NOEXCEPT
+    {
+      BOOST_ASSERT_MSG(!m_at_end, "entry() of directory_cursor at end");
+      return m_entry;
+    }
+
+    //  The entry's inode number and type as the directory reported them, without a
+    //  stat: 0 where it reports no inode number, as on Windows, and status_error where
+    //  it reports no type, as some file systems do
+    boost::uint64_t inode() const BOOST_NOEXCEPT { return m_inode; }
+    file_type type() const BOOST_NOEXCEPT { return m_type; }
+
+  private:
+    friend BOOST_FILESYSTEM_DECL void detail::directory_cursor_open(directory_cursor& c,
+      const path& p, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::directory_cursor_increment(
+      directory_cursor& c, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::directory_cursor_close(directory_cursor& c,
+      bool release_buffer) BOOST_NOEXCEPT;
+    friend BOOST_FILESYSTEM_DECL void detail::directory_cursor_suspend(
+      directory_cursor& c) BOOST_NOEXCEPT;
+
+    directory_entry    m_entry;
+    path               m_name;         // path of the current entry, built in place
+    void*              m_handle;       // DIR* or HANDLE, when not reading by getdents64()
+    int                m_fd;           // descriptor read by getdents64(), or -1
+    char*              m_buffer;       // for getdents64()
+    std::size_t        m_size;
+    std::size_t        m_pos;          // next unread entry in m_buffer
+    std::size_t        m_end;          // end of the entries in m_buffer
+    boost::int64_t     m_offset;       // position after entry(), for suspend()
+    boost::uint64_t    m_inode;
+    file_type          m_type;
+    bool               m_owns_buffer;
+    bool               m_at_end;
+    bool               m_suspended;
+#   ifdef BOOST_WINDOWS_API
+    std::wstring       m_filename;     // for FindNextFileW()
+#   endif
+
+    directory_cursor(const directory_cursor&);             // = delete
+    directory_cursor& operator=(const directory_cursor&);  // = delete
+  };
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                             recursive_directory_cursor                               //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  //  A move-only alternative to recursive_directory_iterator. It keeps a directory_cursor
+  //  for each level it has reached and reopens it for each directory at that level, so
+  //  a traversal allocates only when it first goes deeper than before. The levels are
+  //  held in one block, reserved for at least max_open() levels and doubled as needed.
+  //
+  //  If max_open(n) is set, no more than n directories are held open: going deeper
+  //  suspends the shallowest open level, which is reopened at its position when the
+  //  traversal returns to it. On Linux the open levels then share one arena of n read
+  //  buffers, level i using buffer i % n, so memory no longer grows with depth.
+  //
+  //  Implementation is inline for the same reason as recur_dir_itr_imp's.
+  class recursive_directory_cursor
+  {
+  public:
+    recursive_directory_cursor() BOOST_NOEXCEPT
+      : m_cursors(0), m_levels(0), m_capacity(0), m_level(-1),
+        m_options(symlink_option::none), m_no_push(false), m_max_open(0) {}
+
+    explicit recursive_directory_cursor(const path& p,
+      BOOST_SCOPED_ENUM(symlink_option) opt = symlink_option::none)
+      : m_cursors(0), m_levels(0), m_capacity(0), m_level(-1),
+        m_options(symlink_option::none), m_no_push(false), m_max_open(0)
+          { open(p, opt); }
+
+    recursive_directory_cursor(const path& p, BOOST_SCOPED_ENUM(symlink_option) opt,
+      system::error_code& ec)
+      : m_cursors(0), m_levels(0), m_capacity(0), m_level(-1),
+        m_options(symlink_option::none), m_no_push(false), m_max_open(0)
+          { open(p, opt, ec); }
+
+   ~recursive_directory_cursor() { m_release_cursors(); }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    recursive_directory_cursor(recursive_directory_cursor&& rhs) BOOST_NOEXCEPT
+      : m_cursors(0), m_levels(0), m_capacity(0), m_level(-1),
+        m_options(symlink_option::none), m_no_push(false), m_max_open(0)
+          { swap(rhs); }
+
+    recursive_directory_cursor& operator=(recursive_directory_cursor&& rhs) BOOST_NOEXCEPT
+    {
+      swap(rhs);
+      rhs.close();
+      return *this;
+    }
+#endif
+
+    void swap(recursive_directory_cursor& rhs) BOOST_NOEXCEPT
+    {
+      std::swap(m_cursors, rhs.m_cursors);
+      std::swap(m_levels, rhs.m_levels);
+      std::swap(m_capacity, rhs.m_capacity);
+      std::swap(m_level, rhs.m_level);
+      std::swap(m_options, rhs.m_options);
+      std::swap(m_no_push, rhs.m_no_push);
+      std::swap(m_max_open, rhs.m_max_open);
+      m_arena.swap(rhs.m_arena);
+    }
+
+    //  Limits the number of directories held open to n, or removes the limit if n is 0.
+    //  Closes any directories open.
+    void max_open(std::size_t n)
+    {
+      close();
+      m_release_cursors();
+      m_arena.clear();
+      m_max_open = n;
+    }
+    std::size_t max_open() const BOOST_NOEXCEPT { return m_max_open; }
+
+    //  Closes any directories open, and moves to the first entry of p
+    void open(const path& p,
+      BOOST_SCOPED_ENUM(symlink_option) opt = symlink_option::none)
+    {
+      close();
+      m_options = opt;
+      cursor(0).open(p);
+      if (!m_cursors[0].at_end())
+        m_level = 0;
+    }
+
+    void open(const path& p, BOOST_SCOPED_ENUM(symlink_option) opt,
+      system::error_code& ec)
+    {
+      close();
+      m_options = opt;
+      cursor(0).open(p, ec);
+      if (!ec && !m_cursors[0].at_end())
+        m_level = 0;
+    }
+
+    //  Moves into the current entry if it is a directory that should be recursed into,
+    //  otherwise to the next entry, leaving finished directories as needed. Progress is
+    //  made even when an error is reported.
+    void increment()                          { m_increment(0); }
+    recursive_directory_cursor& increment(system::error_code& ec)
+    {
+      m_increment(&ec);
+      return *this;
+    }
+
+    //  Moves to the next entry of the parent directory
+    void pop()
+    {
+      BOOST_ASSERT_MSG(m_level > 0, "pop() on recursive_directory_cursor with level < 1");
+      m_cursors[m_level--].close();
+      m_advance(0);
+    }
+
+    //  false if the next increment() will not recurse into the current entry
+    bool recursion_pending() const BOOST_NOEXCEPT { return !m_no_push; }
+    void disable_recursion_pending(bool value=true) BOOST_NOEXCEPT { m_no_push = value; }
+
+    void close() BOOST_NOEXCEPT
+    {
+      for (; m_level >= 0; --m_level)
+        m_cursors[m_level].close();
+      m_no_push = false;
+    }
+
+    bool at_end() const BOOST_NOEXCEPT  { return m_level < 0; }
+    int depth() const BOOST_NOEXCEPT    { return m_level; }
+    BOOST_SCOPED_ENUM(symlink_option) options() const BOOST_NOEXCEPT { return m_options; }
+
+    const directory_entry& entry() const BOOST_NOEXCEPT
+    {
+      BOOST_ASSERT_MSG(m_level >= 0, "entry() of recursive_directory_cursor at end");
+      return m_cursors[m_level].entry();
+    }
+
+  private:
+    directory_cursor*                   m_cursors;  // [0, m_level] open, the rest spare
+    std::size_t                         m_levels;   // m_cursors set up for a level
+    std::size_t                         m_capacity; // m_cursors allocated
+    int                                 m_level;    // -1 at end
+    BOOST_SCOPED_ENUM(symlink_option)   m_options;
+    bool                                m_no_push;
+    std::size_t                         m_max_open; // 0 for no limit
+    std::vector<boost::uint64_t>        m_arena;    // m_max_open read buffers
+
+    recursive_directory_cursor(const recursive_directory_cursor&);             // = delete
+    recursive_directory_cursor& operator=(const recursive_directory_cursor&);  // = delete
+
+    static const std::size_t arena_buffer_words = 4 * 1024;  // 32 KB, as for a DIR
+    static const std::size_t initial_levels = 16;
+
+    directory_cursor& cursor(std::size_t level)
+    {
+      if (level == m_levels)
+      {
+        if (level == m_capacity)
+        {
+          //  swapping moves the open levels without touching their directories
+          std::size_t capacity = m_capacity != 0 ? 2 * m_capacity : initial_levels;
+          if (capacity < m_max_open)
+            capacity = m_max_open;
+          directory_cursor* cursors = new directory_cursor[capacity];
+          for (std::size_t i = 0; i < m_levels; ++i)
+            cursors[i].swap(m_cursors[i]);
+          delete [] m_cursors;
+          m_cursors = cursors;
+          m_capacity = capacity;
+        }
+#       ifdef __linux__  // where directory_cursor reads by getdents64()
+        if (m_max_open != 0)
+        {
+          //  a level shares its buffer only with levels that are suspended or closed
+          //  while it is open
+          if (m_arena.empty())
+            m_arena.resize(m_max_open * arena_buffer_words);
+          directory_cursor(&m_arena[level % m_max_open * arena_buffer_words],
+            arena_buffer_words * sizeof(boost::uint64_t)).swap(m_cursors[level]);
+        }
+#       endif
+        ++m_levels;
+      }
+      return m_cursors[level];
+    }
+
+    void m_release_cursors()
+    {
+      delete [] m_cursors;
+      m_cursors = 0;
+      m_levels = m_capacity = 0;
+    }
+
+    //  As recur_dir_itr_imp::push_directory()
+    bool m_push_directory(system::error_code& ec)
+    {
+      ec.clear();
+      if (m_no_push)
+      {
+        m_no_push = false;
+        return false;
+      }
+
+      const directory_entry& e = entry();
+      if ((m_options & symlink_option::recurse) != symlink_option::recurse)
+      {
+        file_status symlink_stat = e.symlink_status(ec);
+        if (ec || is_symlink(symlink_stat))
+          return false;
+      }
+      file_status stat = e.status(ec);
+      if (ec || !is_directory(stat))
+        return false;
+
+      //  cursor() may move the levels, leaving e dangling, so the path is taken from the
+      //  moved entry(); suspend before the open, which may use the same arena buffer
+      directory_cursor& next = cursor(m_level + 1);
+      if (m_max_open != 0 && m_level + 1 >= static_cast<int>(m_max_open))
+        m_cursors[m_level + 1 - m_max_open].suspend();
+      next.open(entry().path(), ec);
+      if (ec || next.at_end())
+        return false;
+      ++m_level;
+      return true;
+    }
+
+    //  Increments the deepest cursor, leaving each directory that is finished, until an
+    //  entry is reached or every directory is finished
+    void m_advance(system::error_code* ec)
+    {
+      system::error_code increment_ec;
+      while (m_level >= 0)
+      {
+        m_cursors[m_level].increment(increment_ec);
+        if (increment_ec && ec && !*ec)
+          *ec = increment_ec;
+        if (!m_cursors[m_level].at_end())
+          break;
+        --m_level;
+      }
+    }
+
+    void m_increment(system::error_code* ec)
+    {
+      BOOST_ASSERT_MSG(m_level >= 0, "increment of recursive_directory_cursor at end");
+      system::error_code push_ec;
+      if (m_push_directory(push_ec))
+      {
+        if (ec)
+          ec->clear();
+        return;
+      }
+
+      system::error_code advance_ec;
+      m_advance(&advance_ec);
+      if (!push_ec)
+        push_ec = advance_ec;
+
+      if (!push_ec)
+      {
+        if (ec)
+          ec->clear();
+      }
+      else if (ec)
+        *ec = push_ec;
+      else
+        BOOST_FILESYSTEM_THROW(filesystem_error(
+          "filesystem::recursive_directory_cursor directory error", push_ec));
+    }
+  };
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                               extent_iterator helpers                                //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  BOOST_SCOPED_ENUM_START(extent_type)
+  {
+    data,  // allocated, or at least not known to be unallocated
+    hole   // unallocated; reads as zeros
+  };
+  BOOST_SCOPED_ENUM_END
+
+  struct file_extent
+  {
+    boost::uintmax_t                offset;
+    boost::uintmax_t                length;
+    BOOST_SCOPED_ENUM(extent_type)  type;
+  };
+
+  class extent_iterator;
+
+  namespace detail
+  {
+    BOOST_FILESYSTEM_DECL
+      void extent_itr_close(native_file_handle handle);  // never throws
+
+    struct extent_itr_imp
+    {
+      file_extent         extent;
+      native_file_handle  handle;
+      bool                is_open;
+      boost::uintmax_t    size;     // of the file when the iterator was constructed
+      path                p;        // for error reporting
+
+      extent_itr_imp() : is_open(false), size(0) {}
+      ~extent_itr_imp() { if (is_open) extent_itr_close(handle); }
+    };
+
+    BOOST_FILESYSTEM_DECL void extent_iterator_construct(extent_iterator& it,
+      const path& p, system::error_code* ec);
+    BOOST_FILESYSTEM_DECL void extent_iterator_increment(extent_iterator& it,
+      system::error_code* ec);
+  }  // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                  extent_iterator                                     //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  //  Iterates over the data and hole extents of a regular file in order of offset.
+  //  Adjacent extents always differ in type, and together they cover the whole file.
+  class extent_iterator
+    : public boost::iterator_facade< extent_iterator,
+                                     const file_extent,
+                                     boost::single_pass_traversal_tag >
+  {
+  public:
+
+    extent_iterator() BOOST_NOEXCEPT {}  // creates the "end" iterator
+
+    explicit extent_iterator(const path& p)
+        : m_imp(new detail::extent_itr_imp)
+          { detail::extent_iterator_construct(*this, p, 0); }
+
+    extent_iterator(const path& p, system::error_code& ec) BOOST_NOEXCEPT
+        : m_imp(new detail::extent_itr_imp)
+          { detail::extent_iterator_construct(*this, p, &ec); }
+
+    extent_iterator& increment(system::error_code& ec) BOOST_NOEXCEPT
+    { 
+      detail::extent_iterator_increment(*this, &ec);
+      return *this;
+    }
+
+  private:
+    friend BOOST_FILESYSTEM_DECL void detail::extent_iterator_construct(extent_iterator& it,
+      const path& p, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::extent_iterator_increment(extent_iterator& it,
+      system::error_code* ec);
+
+    // shared_ptr provides the shallow-copy semantics required for single pass iterators
+    // (i.e. InputIterators). The end iterator is indicated by !m_imp
+    boost::shared_ptr< detail::extent_itr_imp >  m_imp;
+
+    friend class boost::iterator_core_access;
+
+    const file_extent& dereference() const 
+    {
+      BOOST_ASSERT_MSG(m_imp.get(), "attempt to dereference end iterator");
+      return m_imp->extent;
+    }
+
+    void increment() { detail::extent_iterator_increment(*this, 0); }
+
+    bool equal(const extent_iterator& rhs) const { return m_imp == rhs.m_imp; }
+
+  };  // extent_iterator
+
+  //  enable extent_iterator C++11 range-base for statement use  -----------------------//
+
+  inline
+  const extent_iterator& begin(const extent_iterator& iter) BOOST_NOEXCEPT
+    {return iter;}
+  inline
+  extent_iterator end(const extent_iterator&) BOOST_NOEXCEPT
+    {return extent_iterator();}
+
+  //  enable extent_iterator BOOST_FOREACH  --------------------------------------------//
+
+  inline
+  extent_iterator& range_begin(extent_iterator& iter) BOOST_NOEXCEPT
+    {return iter;}
+  inline
+  extent_iterator range_begin(const extent_iterator& iter) BOOST_NOEXCEPT
+    {return iter;}
+  inline
+  extent_iterator range_end(const extent_iterator&) BOOST_NOEXCEPT
+    {return extent_iterator();}
+  }  // namespace filesystem
+
+  //  namespace boost template specializations
+  template<>
+  struct range_mutable_iterator<boost::filesystem::extent_iterator>
+    { typedef boost::filesystem::extent_iterator type; };
+  template<>
+  struct range_const_iterator <boost::filesystem::extent_iterator>
+    { typedef boost::filesystem::extent_iterator type; };
+
+namespace filesystem
+{
+
 //  test helper  -----------------------------------------------------------------------//
 
 //  Not part of the documented interface since false positives are possible;
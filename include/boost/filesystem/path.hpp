@@ -46,6 +46,7 @@ namespace boost
 {
 namespace filesystem
 {
+  class path_builder;
 
   //------------------------------------------------------------------------------------//
   //                                                                                    //
@@ -154,9 +155,14 @@ namespace filesystem
   //  functions. GCC is not even consistent for the same release on different platforms.
 
 # if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
-    path(path&& p) BOOST_NOEXCEPT { m_pathname = std::move(p.m_pathname); }
+    path(path&& p) BOOST_NOEXCEPT : m_pathname(std::move(p.m_pathname)) {}
     path& operator=(path&& p) BOOST_NOEXCEPT
       { m_pathname = std::move(p.m_pathname); return *this; }
+
+    //  take s's storage rather than copying it
+    path(string_type&& s) BOOST_NOEXCEPT : m_pathname(std::move(s)) {}
+    path& operator=(string_type&& s) BOOST_NOEXCEPT
+      { m_pathname = std::move(s); return *this; }
 # endif
 
     template <class Source>
@@ -377,6 +383,14 @@ namespace filesystem
     path&  replace_extension(const path& new_extension = path());
     void   swap(path& rhs) BOOST_NOEXCEPT     { m_pathname.swap(rhs.m_pathname); }
 
+    //  Returns the native string, leaving the path empty, without copying it
+    string_type release()
+    {
+      string_type result;
+      result.swap(m_pathname);
+      return result;
+    }
+
     //  -----  observers  -----
   
     //  For operating systems that format file paths differently than directory
@@ -640,6 +654,7 @@ namespace filesystem
     //    warning #427-D: qualified name is not allowed in member declaration 
     friend class iterator;
     friend bool operator<(const path& lhs, const path& rhs);
+    friend class path_builder;  // truncates m_pathname to undo its appends
 
     // see path::iterator::increment/decrement comment below
     static void m_path_iterator_increment(path::iterator & it);
@@ -789,7 +804,34 @@ namespace filesystem
 
   inline void swap(path& lhs, path& rhs)                   { lhs.swap(rhs); }
 
-  inline path operator/(const path& lhs, const path& rhs)  { return path(lhs) /= rhs; }
+  inline path operator/(const path& lhs, const path& rhs)
+  {
+    path result(lhs);
+    result /= rhs;
+    return result;
+  }
+
+  inline path operator+(const path& lhs, const path& rhs)
+  {
+    path result(lhs);
+    result += rhs;
+    return result;
+  }
+
+# if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+  //  append to lhs's storage rather than to a copy of it
+  inline path operator/(path&& lhs, const path& rhs)
+  {
+    lhs /= rhs;
+    return std::move(lhs);
+  }
+
+  inline path operator+(path&& lhs, const path& rhs)
+  {
+    lhs += rhs;
+    return std::move(lhs);
+  }
+# endif
 
   //  inserters and extractors
   //    use boost::io::quoted() to handle spaces in paths
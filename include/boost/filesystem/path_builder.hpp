@@ -0,0 +1,192 @@
+//  filesystem/path_builder.hpp  -------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Building paths a component at a time without reallocating at each one. join() sizes
+//  its result before appending the first part, and a path_builder, which traversal code
+//  keeps as it descends and ascends, removes the component pushed last by truncating
+//  its path rather than parsing it.
+
+#ifndef BOOST_FILESYSTEM_PATH_BUILDER_HPP
+#define BOOST_FILESYSTEM_PATH_BUILDER_HPP
+
+#include <boost/config.hpp>
+
+# if defined( BOOST_NO_STD_WSTRING )
+#   error Configuration not supported: Boost.Filesystem V3 and later requires std::wstring support
+# endif
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <vector>
+#include <utility>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+  //  push(p) appends p as operator/= does, so a separator is added only where one is
+  //  needed: not to an empty path, after a separator (or on Windows a colon), nor
+  //  before a p that begins with one; an empty p appends nothing. pop() restores the
+  //  path to what it was before the matching push().
+  class path_builder
+  {
+  public:
+    typedef boost::filesystem::path::string_type::size_type size_type;
+
+    path_builder() {}
+    explicit path_builder(const boost::filesystem::path& base) : m_path(base) {}
+# if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    explicit path_builder(boost::filesystem::path&& base) : m_path(std::move(base)) {}
+# endif
+
+    //  Makes room for a path of chars characters, and for depth pushes
+    void reserve(size_type chars, std::size_t depth = 0)
+    {
+      m_path.m_pathname.reserve(chars);
+      m_sizes.reserve(depth);
+    }
+
+    path_builder& push(const boost::filesystem::path& component)
+    {
+      m_sizes.push_back(m_path.m_pathname.size());
+      m_path /= component;
+      return *this;
+    }
+
+    void pop()
+    {
+      BOOST_ASSERT_MSG(!m_sizes.empty(), "pop() from path_builder with nothing pushed");
+      m_path.m_pathname.resize(m_sizes.back());
+      m_sizes.pop_back();
+    }
+
+    std::size_t depth() const  { return m_sizes.size(); }  // pushes not yet popped
+
+    const boost::filesystem::path& path() const  { return m_path; }
+    operator const boost::filesystem::path&() const  { return m_path; }
+
+    //  Starts again from base, or from an empty path, keeping the storage held
+    void assign(const boost::filesystem::path& base)
+    {
+      m_path.m_pathname.assign(base.m_pathname);
+      m_sizes.clear();
+    }
+    void clear()
+    {
+      m_path.m_pathname.clear();
+      m_sizes.clear();
+    }
+
+    //  Returns the path built, leaving the builder empty, without copying it
+    boost::filesystem::path release()
+    {
+      boost::filesystem::path result;
+      result.swap(m_path);
+      m_sizes.clear();
+      return result;
+    }
+
+  private:
+    boost::filesystem::path  m_path;
+    std::vector<size_type>   m_sizes;  // of m_path before each push not yet popped
+  };
+
+  //  join(a, b, ...) returns a / b / ..., allocating the result's storage once, at its
+  //  final size. Parts that are not already paths are converted first, as operator/
+  //  would convert them. Without variadic templates, join() takes up to six parts.
+
+  namespace detail
+  {
+# if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) \
+  && !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    template <class... Paths>
+    path join_paths(const path& first, const Paths&... rest)
+    {
+      path::string_type storage;
+      path::string_type::size_type size = first.native().size();
+      int sizes[] = { 0, (size += rest.native().size() + 1, 0)... };
+      storage.reserve(size);
+      path result(std::move(storage));  // keeps the capacity reserved
+      result /= first;
+      int appends[] = { 0, (result /= rest, 0)... };
+      (void)sizes;
+      (void)appends;
+      return result;
+    }
+# endif
+  } // namespace detail
+
+# if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) \
+  && !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+  //  Each part that is not a path is converted to a temporary that lives until join()
+  //  returns; parts that are paths are not copied
+  template <class First, class... Rest>
+  path join(const First& first, const Rest&... rest)
+  {
+    return detail::join_paths(static_cast<const path&>(first),
+      static_cast<const path&>(rest)...);
+  }
+# else
+  inline path join(const path& p1)  { return p1; }
+
+  inline path join(const path& p1, const path& p2)
+  {
+    path_builder builder;
+    builder.reserve(p1.native().size() + p2.native().size() + 1, 2);
+    builder.push(p1).push(p2);
+    return builder.release();
+  }
+
+  inline path join(const path& p1, const path& p2, const path& p3)
+  {
+    path_builder builder;
+    builder.reserve(p1.native().size() + p2.native().size() + p3.native().size() + 2, 3);
+    builder.push(p1).push(p2).push(p3);
+    return builder.release();
+  }
+
+  inline path join(const path& p1, const path& p2, const path& p3, const path& p4)
+  {
+    path_builder builder;
+    builder.reserve(p1.native().size() + p2.native().size() + p3.native().size()
+      + p4.native().size() + 3, 4);
+    builder.push(p1).push(p2).push(p3).push(p4);
+    return builder.release();
+  }
+
+  inline path join(const path& p1, const path& p2, const path& p3, const path& p4,
+    const path& p5)
+  {
+    path_builder builder;
+    builder.reserve(p1.native().size() + p2.native().size() + p3.native().size()
+      + p4.native().size() + p5.native().size() + 4, 5);
+    builder.push(p1).push(p2).push(p3).push(p4).push(p5);
+    return builder.release();
+  }
+
+  inline path join(const path& p1, const path& p2, const path& p3, const path& p4,
+    const path& p5, const path& p6)
+  {
+    path_builder builder;
+    builder.reserve(p1.native().size() + p2.native().size() + p3.native().size()
+      + p4.native().size() + p5.native().size() + p6.native().size() + 5, 6);
+    builder.push(p1).push(p2).push(p3).push(p4).push(p5).push(p6);
+    return builder.release();
+  }
+# endif
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+#endif // BOOST_FILESYSTEM_PATH_BUILDER_HPP
@@ -0,0 +1,104 @@
+//  filesystem/prefetcher.hpp  ---------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Reading ahead of a known sequence of files. A program that knows which files it will
+//  read next, from a manifest or the order of a traversal, queues them in a
+//  file_prefetcher and takes them from it one at a time; the files a little way ahead
+//  are meanwhile being read into the page cache by prefetch(), so that the reads of
+//  the program and of the disk overlap instead of alternating.
+
+#ifndef BOOST_FILESYSTEM_PREFETCHER_HPP
+#define BOOST_FILESYSTEM_PREFETCHER_HPP
+
+#include <boost/config.hpp>
+
+# if defined( BOOST_NO_STD_WSTRING )
+#   error Configuration not supported: Boost.Filesystem V3 and later requires std::wstring support
+# endif
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <cstddef>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+  struct prefetch_options
+  {
+    prefetch_options()
+      : window(32), byte_budget(64 * 1024 * 1024), bytes_per_file(0) {}
+
+    std::size_t       window;          // files queued ahead that may be prefetched
+    boost::uintmax_t  byte_budget;     // prefetched bytes not yet taken, at most
+    boost::uintmax_t  bytes_per_file;  // from the start of each file; 0 for all
+  };
+
+  struct prefetch_statistics
+  {
+    prefetch_statistics() : files(0), bytes(0), failures(0) {}
+
+    boost::uintmax_t  files;     // prefetched
+    boost::uintmax_t  bytes;     // prefetched
+    boost::uintmax_t  failures;  // files that could not be opened; not an error
+  };
+
+  //  Each time the queue changes, the first window files not yet taken are prefetched,
+  //  in order, as long as the bytes prefetched and not yet taken stay within the
+  //  budget, except that the first file is prefetched whatever its size. Not
+  //  synchronized: use one from one thread at a time.
+  class BOOST_FILESYSTEM_DECL file_prefetcher
+  {
+  public:
+    explicit file_prefetcher(const prefetch_options& options = prefetch_options());
+
+    ~file_prefetcher();
+
+    void push_back(const path& p)  { queue(p, true); }
+
+    //  Queues each element of [first, last), such as the entries of a
+    //  directory_iterator, which convert to paths
+    template <class InputIterator>
+    void append(InputIterator first, InputIterator last)
+    {
+      for (; first != last; ++first)
+        queue(*first, false);
+      fill();
+    }
+
+    bool empty() const;
+    std::size_t size() const;  // files queued and not yet taken
+    const path& front() const;
+
+    //  Removes and returns the first file queued, and prefetches any that the window
+    //  and budget now allow
+    path take();
+
+    prefetch_statistics statistics() const;
+
+  private:
+    struct impl;
+    boost::scoped_ptr<impl> m_imp;
+
+    void queue(const path& p, bool fill_now);
+    void fill();
+
+    file_prefetcher(const file_prefetcher&);
+    file_prefetcher& operator=(const file_prefetcher&);
+  };
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+#endif // BOOST_FILESYSTEM_PREFETCHER_HPP
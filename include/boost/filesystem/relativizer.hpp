@@ -0,0 +1,76 @@
+//  filesystem/relativizer.hpp  --------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Paths relative to one base, for many paths. relative(p, base) makes base weakly
+//  canonical and splits it into elements for every p; a relativizer does that once, and
+//  compares each p with the elements it keeps.
+
+#ifndef BOOST_FILESYSTEM_RELATIVIZER_HPP
+#define BOOST_FILESYSTEM_RELATIVIZER_HPP
+
+#include <boost/config.hpp>
+
+# if defined( BOOST_NO_STD_WSTRING )
+#   error Configuration not supported: Boost.Filesystem V3 and later requires std::wstring support
+# endif
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/system/error_code.hpp>
+#include <cstddef>
+#include <vector>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+  //  By default relative(p) returns what relative(p, base) returns: both are made weakly
+  //  canonical, with base made so once, by the constructor. A lexical relativizer uses
+  //  base and each p as given, returning what p.lexically_relative(base) returns, and
+  //  never touches the file system.
+  class BOOST_FILESYSTEM_DECL relativizer
+  {
+  public:
+    explicit relativizer(const path& base, bool lexical = false);
+    relativizer(const path& base, bool lexical, system::error_code& ec);
+
+    const path&  base() const     { return m_base; }  // weakly canonical unless lexical
+    bool         lexical() const  { return m_lexical; }
+
+    path relative(const path& p) const;
+    path relative(const path& p, system::error_code& ec) const;
+
+    //  Returns the relative path of each of paths, in order, found by threads threads:
+    //  by the calling thread alone if 1, or one per processor if 0. The first error
+    //  stops the batch; the results of the paths not reached are empty.
+    std::vector<path> relative(const std::vector<path>& paths,
+      unsigned threads = 1) const;
+    std::vector<path> relative(const std::vector<path>& paths, unsigned threads,
+      system::error_code& ec) const;
+
+  private:
+    path                       m_base;
+    bool                       m_lexical;
+    path::string_type          m_elements;  // base's elements, one after another,
+    std::vector<std::size_t>   m_offsets;   // each starting here; then the end
+
+    void m_init(const path& base, system::error_code* ec);
+    path m_lexically_relative(const path& p) const;
+    path m_relative(const path& p, system::error_code* ec) const;
+    std::vector<path> m_relative(const std::vector<path>& paths, unsigned threads,
+      system::error_code* ec) const;
+  };
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+#endif // BOOST_FILESYSTEM_RELATIVIZER_HPP
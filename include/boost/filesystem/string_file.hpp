@@ -13,6 +13,7 @@
 #include <string>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/prefetcher.hpp>
 
 namespace boost
 {
@@ -27,6 +28,34 @@ void save_string_file(const path& p, const std::string& str)
   file.write(str.c_str(), str.size());
 }
 
+//  Reserves the file's space before writing, so that a lack of space is reported
+//  before anything is written; file systems that cannot preallocate are not an error.
+//  Only none and keep_size make sense here; punch_hole and zero_range are rejected
+//  before the file is opened.
+inline
+void save_string_file(const path& p, const std::string& str,
+  BOOST_SCOPED_ENUM(preallocate_option) options)
+{
+  if ((options & (preallocate_option::punch_hole | preallocate_option::zero_range))
+    != preallocate_option::none)
+    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::save_string_file",
+      p, system::errc::make_error_code(system::errc::invalid_argument)));
+  ofstream file;
+  file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+  file.open(p, std::ios_base::binary);
+  if (!str.empty())
+  {
+    system::error_code ec;
+    preallocate(p, 0, str.size(), options, ec);
+    if (ec && ec != system::errc::operation_not_supported
+      && ec != system::errc::function_not_supported
+      && ec != system::errc::invalid_argument)
+      BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::save_string_file",
+        p, ec));
+  }
+  file.write(str.c_str(), str.size());
+}
+
 inline
 void load_string_file(const path& p, std::string& str)
 {
@@ -37,6 +66,16 @@ void load_string_file(const path& p, std::string& str)
   str.resize(sz, '\0');
   file.read(&str[0], sz);
 }
+
+//  Takes the next file from files, which meanwhile prefetches the files after it, and
+//  loads it; returns its path
+inline
+path load_string_file(file_prefetcher& files, std::string& str)
+{
+  path p(files.take());
+  load_string_file(p, str);
+  return p;
+}
 }  // namespace filesystem
 }  // namespace boost
 
@@ -0,0 +1,95 @@
+//  filesystem/tree_generator.hpp  -----------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  generate_tree() builds a directory tree of a given shape, the same for the same
+//  profile and seed on every run and platform, so that benchmarks and performance
+//  reports can be reproduced. Remove the tree with remove_all().
+
+#ifndef BOOST_FILESYSTEM_TREE_GENERATOR_HPP
+#define BOOST_FILESYSTEM_TREE_GENERATOR_HPP
+
+#include <boost/config.hpp>
+
+# if defined( BOOST_NO_STD_WSTRING )
+#   error Configuration not supported: Boost.Filesystem V3 and later requires std::wstring support
+# endif
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/cstdint.hpp>
+
+#include <boost/config/abi_prefix.hpp> // must be the last #include
+
+namespace boost
+{
+namespace filesystem
+{
+  //  The shape of a generated tree. Each directory has files_per_directory entries
+  //  other than subdirectories, the first always a regular file, and directories above
+  //  the deepest level also have fanout subdirectories.
+  struct tree_profile
+  {
+    enum size_distribution
+    {
+      uniform,      // every size from min_file_size to max_file_size equally likely
+      log_uniform   // small files more likely, as in most real trees
+    };
+
+    tree_profile()
+      : fanout(4), depth(3), files_per_directory(16), min_file_size(0),
+        max_file_size(4096), sizes(uniform), symlink_ratio(0.0), sparse_ratio(0.0) {}
+
+    unsigned            fanout;
+    unsigned            depth;                // levels of subdirectories below the root
+    unsigned            files_per_directory;  // symlinks included
+    boost::uintmax_t    min_file_size;
+    boost::uintmax_t    max_file_size;
+    size_distribution   sizes;
+    double              symlink_ratio;  // of the files, the share that are symlinks to
+                                        // another file in the same directory
+    double              sparse_ratio;   // of the regular files, the share that are
+                                        // extended by resize_file() rather than written
+  };
+
+  //  What generate_tree() created
+  struct tree_stats
+  {
+    tree_stats() : directories(0), files(0), symlinks(0), sparse_files(0), bytes(0) {}
+
+    boost::uintmax_t  directories;   // including the root, if it was created
+    boost::uintmax_t  files;         // regular files, sparse or not
+    boost::uintmax_t  symlinks;
+    boost::uintmax_t  sparse_files;
+    boost::uintmax_t  bytes;         // the sum of the regular files' sizes
+  };
+
+  namespace detail
+  {
+    BOOST_FILESYSTEM_DECL
+    tree_stats generate_tree(const path& root, const tree_profile& profile,
+      boost::uint64_t seed, system::error_code* ec=0);
+  }
+
+  //  Creates root, if it does not exist, and the tree described by profile below it.
+  //  Names are d<n> for directories, f<n> for files and l<n> for symlinks.
+  inline
+  tree_stats generate_tree(const path& root, const tree_profile& profile,
+    boost::uint64_t seed)                         {return detail::generate_tree(root,
+                                                     profile, seed);}
+  inline
+  tree_stats generate_tree(const path& root, const tree_profile& profile,
+    boost::uint64_t seed, system::error_code& ec) BOOST_NOEXCEPT
+                                                  {return detail::generate_tree(root,
+                                                     profile, seed, &ec);}
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/config/abi_suffix.hpp> // pops abi_prefix.hpp pragmas
+#endif // BOOST_FILESYSTEM_TREE_GENERATOR_HPP
@@ -0,0 +1,1115 @@
+//  backend.cpp  -----------------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  memory_backend, latency_backend and caching_backend. The native backend, and the
+//  dispatch to the installed backend, are in operations.cpp.
+//
+//  memory_backend keeps a tree of nodes under a single mutex. Every path is resolved
+//  from the root, a component at a time, so that symlinks and dot-dot behave as they do
+//  in the kernel's own lookup rather than as lexical path manipulation would suggest.
+//
+//  caching_backend never holds a shard's lock while calling the next backend. Each shard
+//  counts its invalidations in a generation, and a result fetched while the generation
+//  moved on is returned but not stored, so a change racing a miss cannot leave a stale
+//  entry behind.
+
+//  define 64-bit offset macros BEFORE including boost/config.hpp (see ticket #5355)
+#if !(defined(__HP_aCC) && defined(_ILP32) && !defined(_STATVFS_ACPP_PROBLEMS_FIXED))
+#define _FILE_OFFSET_BITS 64 // at worst, these defines may have no effect,
+#endif
+#if !defined(__PGI)
+#define __USE_FILE_OFFSET64 // but that is harmless on Windows and on POSIX
+#else
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// define BOOST_FILESYSTEM_SOURCE so that <boost/filesystem/config.hpp> knows
+// the library is being built (possibly exporting rather than importing code)
+#define BOOST_FILESYSTEM_SOURCE
+
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+# define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem/backend.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_array.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include "path_hash.hpp"
+#include "work_queue.hpp"
+
+#ifdef BOOST_WINDOWS_API
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+using boost::filesystem::path;
+using boost::filesystem::file_status;
+using boost::system::error_code;
+using boost::system::generic_category;
+namespace errc = boost::system::errc;
+
+namespace
+{
+  //  a symlink's target is followed at most this many times in one lookup, as by Linux
+  const unsigned max_symlinks = 40;
+
+  bool fail(int err, error_code& ec)
+  {
+    if (err != 0)
+      ec.assign(err, generic_category());
+    else
+      ec.clear();
+    return err != 0;
+  }
+
+  void sleep_us(boost::uint64_t us)
+  {
+    if (us == 0)
+      return;
+#   ifdef BOOST_WINDOWS_API
+    ::Sleep(static_cast<DWORD>((us + 999) / 1000));
+#   else
+    timespec t;
+    t.tv_sec = static_cast<time_t>(us / 1000000);
+    t.tv_nsec = static_cast<long>(us % 1000000) * 1000;
+    while (::nanosleep(&t, &t) == -1 && errno == EINTR) {}
+#   endif
+  }
+
+  boost::uint64_t monotonic_ms()
+  {
+#   ifdef BOOST_WINDOWS_API
+    LARGE_INTEGER frequency, count;
+    ::QueryPerformanceFrequency(&frequency);
+    ::QueryPerformanceCounter(&count);
+    return static_cast<boost::uint64_t>(count.QuadPart / (frequency.QuadPart / 1000));
+#   else
+    timespec t;
+    ::clock_gettime(CLOCK_MONOTONIC, &t);
+    return static_cast<boost::uint64_t>(t.tv_sec) * 1000 + t.tv_nsec / 1000000;
+#   endif
+  }
+
+//--------------------------------------------------------------------------------------//
+//                                memory_backend helpers                                //
+//--------------------------------------------------------------------------------------//
+
+  struct node;
+  typedef boost::shared_ptr<node> node_ptr;
+
+  struct node
+  {
+    explicit node(fs::file_type t)
+      : type(t), prms(t == fs::regular_file
+          ? fs::owner_read | fs::owner_write | fs::group_read | fs::others_read
+          : t == fs::directory_file
+            ? fs::owner_all | fs::group_read | fs::group_exe | fs::others_read
+              | fs::others_exe
+            : fs::all_all),
+        mtime(std::time(0)), size(0) {}
+
+    fs::file_type                    type;  // regular, directory or symlink
+    fs::perms                        prms;
+    std::time_t                      mtime;
+    std::string                      data;  // contents, or a symlink's target
+    boost::uintmax_t                 size;  // of a regular file; bytes past data are zero
+    std::map<std::string, node_ptr>  children;  // of a directory
+  };
+
+  //  Where a path led. If name is empty the path named a directory without naming its
+  //  entry, as the root or dot-dot do, and found is dirs.back(); otherwise dirs.back()
+  //  is the directory that contains, or would contain, the entry name.
+  struct lookup
+  {
+    std::vector<node*>  dirs;   // the directories passed through, from the root
+    std::string         name;
+    node*               found;  // or 0 if there is no such entry
+  };
+
+  //  Prepends the names in p, other than its root and dots, to pending
+  void push_components(const path& p, std::deque<std::string>& pending)
+  {
+    std::vector<std::string> names;
+    for (path::const_iterator it = p.begin(); it != p.end(); ++it)
+    {
+      if (it->has_root_name() || it->has_root_directory())
+        continue;
+      std::string name(it->string());
+      if (!name.empty() && name != ".")
+        names.push_back(name);
+    }
+    pending.insert(pending.begin(), names.begin(), names.end());
+  }
+
+  //  Returns an errno value, or 0 with r set
+  int resolve(node* root, const path& p, bool follow_last, lookup& r)
+  {
+    r.dirs.assign(1, root);
+    r.name.clear();
+    r.found = root;
+    if (p.empty())
+      return errc::no_such_file_or_directory;
+
+    std::deque<std::string> pending;
+    push_components(p, pending);
+    unsigned links = 0;
+    while (!pending.empty())
+    {
+      std::string name(pending.front());
+      pending.pop_front();
+      if (name == "..")
+      {
+        if (r.dirs.size() > 1)
+          r.dirs.pop_back();
+        r.name.clear();
+        r.found = r.dirs.back();
+        continue;
+      }
+
+      bool last = pending.empty();
+      std::map<std::string, node_ptr>::iterator it = r.dirs.back()->children.find(name);
+      if (it == r.dirs.back()->children.end())
+      {
+        if (!last)
+          return errc::no_such_file_or_directory;
+        r.name = name;
+        r.found = 0;
+        return 0;
+      }
+
+      node* child = it->second.get();
+      if (child->type == fs::symlink_file && (!last || follow_last))
+      {
+        if (++links > max_symlinks)
+          return errc::too_many_symbolic_link_levels;
+        path target(child->data);
+        if (target.has_root_directory())
+          r.dirs.resize(1);
+        push_components(target, pending);
+        r.name.clear();
+        r.found = r.dirs.back();
+        continue;
+      }
+
+      if (last)
+      {
+        r.name = name;
+        r.found = child;
+        return 0;
+      }
+      if (child->type != fs::directory_file)
+        return errc::not_a_directory;
+      r.dirs.push_back(child);
+    }
+    return 0;
+  }
+
+  //  status() and symlink_status() report a missing file as the native ones do
+  file_status status_of(int err, const lookup& r, error_code& ec)
+  {
+    if (err == 0 && r.found == 0)
+      err = errc::no_such_file_or_directory;
+    if (fail(err, ec))
+      return err == errc::no_such_file_or_directory || err == errc::not_a_directory
+        ? file_status(fs::file_not_found, fs::no_perms)
+        : file_status(fs::status_error);
+    return file_status(r.found->type, r.found->prms);
+  }
+
+  //  A directory's entries as they were when it was opened
+  class memory_directory : public fs::backend_directory
+  {
+  public:
+    struct entry
+    {
+      std::string  name;
+      file_status  s;
+      file_status  symlink_s;
+    };
+
+    explicit memory_directory(const node& dir) : m_next(0)
+    {
+      for (std::map<std::string, node_ptr>::const_iterator it = dir.children.begin();
+        it != dir.children.end(); ++it)
+      {
+        entry e;
+        e.name = it->first;
+        e.symlink_s = file_status(it->second->type, it->second->prms);
+        if (it->second->type != fs::symlink_file)
+          e.s = e.symlink_s;  // else left unknown, for directory_entry to ask for
+        m_entries.push_back(e);
+      }
+    }
+
+    bool read(path& filename, file_status& s, file_status& symlink_s, error_code& ec)
+    {
+      ec.clear();
+      if (m_next == m_entries.size())
+        return false;
+      const entry& e = m_entries[m_next++];
+      filename = e.name;
+      s = e.s;
+      symlink_s = e.symlink_s;
+      return true;
+    }
+
+  private:
+    std::vector<entry>  m_entries;
+    std::size_t         m_next;
+  };
+
+//--------------------------------------------------------------------------------------//
+//                               latency_backend helpers                                //
+//--------------------------------------------------------------------------------------//
+
+  class latency_directory : public fs::backend_directory
+  {
+  public:
+    //  takes next over from the caller
+    latency_directory(boost::scoped_ptr<fs::backend_directory>& next,
+      boost::uint32_t round_trip_us, unsigned entries_per_read)
+      : m_round_trip_us(round_trip_us), m_entries_per_read(entries_per_read), m_read(0)
+    {
+      m_next.swap(next);
+    }
+
+    bool read(path& filename, file_status& s, file_status& symlink_s, error_code& ec)
+    {
+      //  the open fetched the first batch
+      if (m_entries_per_read != 0 && m_read != 0 && m_read % m_entries_per_read == 0)
+        sleep_us(m_round_trip_us);
+      ++m_read;
+      return m_next->read(filename, s, symlink_s, ec);
+    }
+
+  private:
+    boost::scoped_ptr<fs::backend_directory>  m_next;
+    boost::uint32_t                           m_round_trip_us;
+    unsigned                                  m_entries_per_read;
+    boost::uintmax_t                          m_read;
+
+    latency_directory(const latency_directory&);
+    latency_directory& operator=(const latency_directory&);
+  };
+
+//--------------------------------------------------------------------------------------//
+//                               caching_backend helpers                                //
+//--------------------------------------------------------------------------------------//
+
+  enum cached_field
+  {
+    status_held = 1,
+    symlink_status_held = 2,
+    size_held = 4,
+    mtime_held = 8
+  };
+
+  struct cache_entry
+  {
+    cache_entry() : held(0), expires(0), size(0), mtime(0) {}
+
+    unsigned          held;     // cached_field bits
+    boost::uint64_t   expires;  // by monotonic_ms()
+    file_status       s;
+    error_code        s_ec;     // set for a cached "not found"
+    file_status       symlink_s;
+    error_code        symlink_s_ec;
+    boost::uintmax_t  size;
+    std::time_t       mtime;
+  };
+
+  typedef std::map<path::string_type, cache_entry> cache_map;
+
+  struct cache_shard
+  {
+    cache_shard()
+      : generation(0), hits(0), misses(0), expirations(0), invalidations(0),
+        evictions(0) {}
+
+    fs::detail::worker_mutex  mutex;
+    cache_map                 entries;
+    boost::uint64_t           generation;  // of invalidations
+    boost::uintmax_t          hits;
+    boost::uintmax_t          misses;
+    boost::uintmax_t          expirations;
+    boost::uintmax_t          invalidations;
+    boost::uintmax_t          evictions;
+  };
+
+  //  Erases the entry for key and those below it in one shard, returning the count
+  std::size_t erase_subtree(cache_map& entries, const path::string_type& key)
+  {
+    std::size_t count = entries.erase(key);
+    path::string_type prefix(key);
+    prefix += static_cast<path::value_type>('/');
+    for (;;)
+    {
+      cache_map::iterator it = entries.lower_bound(prefix);
+      std::size_t erased = 0;
+      while (it != entries.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+      {
+        entries.erase(it++);
+        ++erased;
+      }
+      count += erased;
+#     ifdef BOOST_WINDOWS_API
+      if (prefix[prefix.size() - 1] == L'/')
+      {
+        prefix[prefix.size() - 1] = L'\\';
+        continue;
+      }
+#     endif
+      return count;
+    }
+  }
+
+}  // unnamed namespace
+
+namespace boost
+{
+namespace filesystem
+{
+
+//--------------------------------------------------------------------------------------//
+//                                   memory_backend                                     //
+//--------------------------------------------------------------------------------------//
+
+  struct memory_backend::impl
+  {
+    impl() : root(new node(directory_file)) {}
+
+    int resolve(const path& p, bool follow_last, lookup& r)
+    {
+      return ::resolve(root.get(), p, follow_last, r);
+    }
+
+    detail::worker_mutex  mutex;
+    node_ptr              root;
+  };
+
+  memory_backend::memory_backend() : m_imp(new impl) {}
+  memory_backend::~memory_backend() {}
+
+  file_status memory_backend::status(const path& p, system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, true, r);
+    return status_of(err, r, ec);
+  }
+
+  file_status memory_backend::symlink_status(const path& p, system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, false, r);
+    return status_of(err, r, ec);
+  }
+
+  boost::uintmax_t memory_backend::file_size(const path& p, system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, true, r);
+    if (err == 0 && r.found == 0)
+      err = errc::no_such_file_or_directory;
+    if (err == 0 && r.found->type != regular_file)
+      err = errc::operation_not_permitted;  // as the native file_size()
+    return fail(err, ec) ? static_cast<boost::uintmax_t>(-1) : r.found->size;
+  }
+
+  std::time_t memory_backend::last_write_time(const path& p, system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, true, r);
+    if (err == 0 && r.found == 0)
+      err = errc::no_such_file_or_directory;
+    return fail(err, ec) ? std::time_t(-1) : r.found->mtime;
+  }
+
+  void memory_backend::last_write_time(const path& p, std::time_t new_time,
+    system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, true, r);
+    if (err == 0 && r.found == 0)
+      err = errc::no_such_file_or_directory;
+    if (!fail(err, ec))
+      r.found->mtime = new_time;
+  }
+
+  bool memory_backend::create_directory(const path& p, system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, false, r);
+    if (err == 0 && r.found != 0)
+    {
+      //  as the native create_directory(), not an error if p resolves to a directory
+      lookup target;
+      if (m_imp->resolve(p, true, target) == 0 && target.found != 0
+        && target.found->type == directory_file)
+      {
+        ec.clear();
+        return false;
+      }
+      err = errc::file_exists;
+    }
+    if (fail(err, ec))
+      return false;
+    r.dirs.back()->children[r.name] = node_ptr(new node(directory_file));
+    r.dirs.back()->mtime = std::time(0);
+    return true;
+  }
+
+  void memory_backend::create_symlink(const path& to, const path& new_symlink,
+    system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(new_symlink, false, r);
+    if (err == 0 && r.found != 0)
+      err = errc::file_exists;
+    if (fail(err, ec))
+      return;
+    node_ptr link(new node(symlink_file));
+    link->data = to.string();
+    r.dirs.back()->children[r.name] = link;
+    r.dirs.back()->mtime = std::time(0);
+  }
+
+  path memory_backend::read_symlink(const path& p, system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, false, r);
+    if (err == 0 && r.found == 0)
+      err = errc::no_such_file_or_directory;
+    if (err == 0 && r.found->type != symlink_file)
+      err = errc::invalid_argument;
+    return fail(err, ec) ? path() : path(r.found->data);
+  }
+
+  bool memory_backend::remove(const path& p, system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, false, r);
+    if ((err == 0 && r.found == 0) || err == errc::no_such_file_or_directory
+      || err == errc::not_a_directory)
+    {
+      ec.clear();
+      return false;
+    }
+    if (err == 0 && r.name.empty())
+      err = errc::device_or_resource_busy;
+    if (err == 0 && r.found->type == directory_file && !r.found->children.empty())
+      err = errc::directory_not_empty;
+    if (fail(err, ec))
+      return false;
+    r.dirs.back()->children.erase(r.name);
+    r.dirs.back()->mtime = std::time(0);
+    return true;
+  }
+
+  void memory_backend::rename(const path& old_p, const path& new_p,
+    system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup from, to;
+    int err = m_imp->resolve(old_p, false, from);
+    if (err == 0 && from.found == 0)
+      err = errc::no_such_file_or_directory;
+    if (err == 0 && from.name.empty())
+      err = errc::device_or_resource_busy;
+    if (err == 0)
+      err = m_imp->resolve(new_p, false, to);
+    if (err == 0 && to.name.empty())
+      err = errc::device_or_resource_busy;
+    if (err == 0 && to.found == from.found)
+    {
+      ec.clear();  // as POSIX, renaming a file to itself does nothing
+      return;
+    }
+    if (err == 0 && from.found->type == directory_file)
+    {
+      if (std::find(to.dirs.begin(), to.dirs.end(), from.found) != to.dirs.end())
+        err = errc::invalid_argument;  // into its own subtree
+      else if (to.found != 0 && to.found->type != directory_file)
+        err = errc::not_a_directory;
+      else if (to.found != 0 && !to.found->children.empty())
+        err = errc::directory_not_empty;
+    }
+    else if (err == 0 && to.found != 0 && to.found->type == directory_file)
+      err = errc::is_a_directory;
+    if (fail(err, ec))
+      return;
+
+    node_ptr moved = from.dirs.back()->children[from.name];
+    from.dirs.back()->children.erase(from.name);
+    to.dirs.back()->children[to.name] = moved;
+    from.dirs.back()->mtime = to.dirs.back()->mtime = std::time(0);
+  }
+
+  void memory_backend::copy_file(const path& from, const path& to, bool overwrite,
+    system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup source, target;
+    int err = m_imp->resolve(from, true, source);
+    if (err == 0 && source.found == 0)
+      err = errc::no_such_file_or_directory;
+    if (err == 0 && source.found->type == directory_file)
+      err = errc::is_a_directory;
+    if (err == 0)
+      err = m_imp->resolve(to, true, target);
+    if (err == 0 && target.name.empty())
+      err = errc::is_a_directory;
+    if (err == 0 && target.found != 0)
+    {
+      if (!overwrite)
+        err = errc::file_exists;
+      else if (target.found->type == directory_file)
+        err = errc::is_a_directory;
+    }
+    if (fail(err, ec) || target.found == source.found)
+      return;
+
+    node* copy = target.found;
+    if (copy == 0)  // else overwritten in place, keeping its permissions
+    {
+      node_ptr created(new node(regular_file));
+      created->prms = source.found->prms;
+      target.dirs.back()->children[target.name] = created;
+      copy = created.get();
+    }
+    copy->data = source.found->data;
+    copy->size = source.found->size;
+    copy->mtime = std::time(0);
+  }
+
+  void memory_backend::resize_file(const path& p, boost::uintmax_t size,
+    system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, true, r);
+    if (err == 0 && r.found == 0)
+      err = errc::no_such_file_or_directory;
+    if (err == 0 && r.found->type == directory_file)
+      err = errc::is_a_directory;
+    if (fail(err, ec))
+      return;
+    if (size < r.found->data.size())
+      r.found->data.resize(static_cast<std::size_t>(size));
+    r.found->size = size;  // the rest reads as zero, as a sparse file does
+    r.found->mtime = std::time(0);
+  }
+
+  backend_directory* memory_backend::open_directory(const path& p,
+    system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, true, r);
+    if (err == 0 && r.found == 0)
+      err = errc::no_such_file_or_directory;
+    if (err == 0 && r.found->type != directory_file)
+      err = errc::not_a_directory;
+    return fail(err, ec) ? 0 : new memory_directory(*r.found);
+  }
+
+  void memory_backend::write_file(const path& p, const std::string& contents,
+    system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, true, r);
+    if (err == 0 && (r.name.empty()
+      || (r.found != 0 && r.found->type == directory_file)))
+      err = errc::is_a_directory;
+    if (fail(err, ec))
+      return;
+    node* file = r.found;
+    if (file == 0)
+    {
+      node_ptr created(new node(regular_file));
+      r.dirs.back()->children[r.name] = created;
+      r.dirs.back()->mtime = std::time(0);
+      file = created.get();
+    }
+    file->data = contents;
+    file->size = contents.size();
+    file->mtime = std::time(0);
+  }
+
+  std::string memory_backend::read_file(const path& p, system::error_code& ec)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    lookup r;
+    int err = m_imp->resolve(p, true, r);
+    if (err == 0 && r.found == 0)
+      err = errc::no_such_file_or_directory;
+    if (err == 0 && r.found->type == directory_file)
+      err = errc::is_a_directory;
+    if (fail(err, ec))
+      return std::string();
+    std::string contents(r.found->data);
+    contents.resize(static_cast<std::size_t>(r.found->size), '\0');
+    return contents;
+  }
+
+//--------------------------------------------------------------------------------------//
+//                                   latency_backend                                    //
+//--------------------------------------------------------------------------------------//
+
+  latency_backend::latency_backend(backend& next, boost::uint32_t round_trip_us,
+    boost::uint32_t us_per_mib, unsigned entries_per_read)
+    : m_next(next), m_round_trip_us(round_trip_us), m_us_per_mib(us_per_mib),
+      m_entries_per_read(entries_per_read) {}
+
+  file_status latency_backend::status(const path& p, system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    return m_next.status(p, ec);
+  }
+
+  file_status latency_backend::symlink_status(const path& p, system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    return m_next.symlink_status(p, ec);
+  }
+
+  boost::uintmax_t latency_backend::file_size(const path& p, system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    return m_next.file_size(p, ec);
+  }
+
+  std::time_t latency_backend::last_write_time(const path& p, system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    return m_next.last_write_time(p, ec);
+  }
+
+  void latency_backend::last_write_time(const path& p, std::time_t new_time,
+    system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    m_next.last_write_time(p, new_time, ec);
+  }
+
+  bool latency_backend::create_directory(const path& p, system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    return m_next.create_directory(p, ec);
+  }
+
+  void latency_backend::create_symlink(const path& to, const path& new_symlink,
+    system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    m_next.create_symlink(to, new_symlink, ec);
+  }
+
+  path latency_backend::read_symlink(const path& p, system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    return m_next.read_symlink(p, ec);
+  }
+
+  bool latency_backend::remove(const path& p, system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    return m_next.remove(p, ec);
+  }
+
+  void latency_backend::rename(const path& old_p, const path& new_p,
+    system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    m_next.rename(old_p, new_p, ec);
+  }
+
+  void latency_backend::copy_file(const path& from, const path& to, bool overwrite,
+    system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    m_next.copy_file(from, to, overwrite, ec);
+    if (ec || m_us_per_mib == 0)
+      return;
+    system::error_code size_ec;
+    boost::uintmax_t size = m_next.file_size(to, size_ec);
+    if (!size_ec)
+      sleep_us(size * m_us_per_mib / (1024 * 1024));
+  }
+
+  void latency_backend::resize_file(const path& p, boost::uintmax_t size,
+    system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    m_next.resize_file(p, size, ec);
+  }
+
+  backend_directory* latency_backend::open_directory(const path& p,
+    system::error_code& ec)
+  {
+    sleep_us(m_round_trip_us);
+    boost::scoped_ptr<backend_directory> dir(m_next.open_directory(p, ec));
+    if (!dir)
+      return 0;
+    return new latency_directory(dir, m_round_trip_us, m_entries_per_read);
+  }
+
+  void latency_backend::changed(const path& p, bool subtree)
+  {
+    m_next.changed(p, subtree);
+  }
+
+  bool latency_backend::native() const
+  {
+    return m_next.native();
+  }
+
+//--------------------------------------------------------------------------------------//
+//                                   caching_backend                                    //
+//--------------------------------------------------------------------------------------//
+
+  struct caching_backend::impl
+  {
+    impl(backend& n, boost::uint32_t ttl, std::size_t max_entries, unsigned count)
+      : next(n), ttl_ms(ttl), shard_count(count == 0 ? 1 : count),
+        shard_capacity(max_entries / shard_count == 0 ? 1 : max_entries / shard_count),
+        shards(new cache_shard[shard_count]) {}
+
+    backend&                        next;
+    boost::uint32_t                 ttl_ms;
+    unsigned                        shard_count;
+    std::size_t                     shard_capacity;
+    boost::scoped_array<cache_shard> shards;
+
+    cache_shard& shard(const path::string_type& key)
+    {
+      return shards[detail::path_hash(key) % shard_count];
+    }
+
+    //  Copies out the entry for p if it holds field and has not expired. Either way,
+    //  sets generation for a later store().
+    bool find(const path& p, unsigned field, cache_entry& result,
+      boost::uint64_t& generation)
+    {
+      cache_shard& sh = shard(p.native());
+      detail::scoped_worker_lock lock(sh.mutex);
+      generation = sh.generation;
+      cache_map::iterator it = sh.entries.find(p.native());
+      if (it != sh.entries.end() && it->second.expires <= monotonic_ms())
+      {
+        sh.entries.erase(it);
+        ++sh.expirations;
+        it = sh.entries.end();
+      }
+      if (it == sh.entries.end() || (it->second.held & field) == 0)
+      {
+        ++sh.misses;
+        return false;
+      }
+      ++sh.hits;
+      result = it->second;
+      return true;
+    }
+
+    //  Adds the field of fetched to the entry for p, unless p's shard has been
+    //  invalidated since find() set generation
+    void store(const path& p, unsigned field, const cache_entry& fetched,
+      boost::uint64_t generation)
+    {
+      cache_shard& sh = shard(p.native());
+      detail::scoped_worker_lock lock(sh.mutex);
+      if (sh.generation != generation)
+        return;
+      boost::uint64_t now = monotonic_ms();
+      cache_map::iterator it = sh.entries.find(p.native());
+      if (it == sh.entries.end())
+      {
+        if (sh.entries.size() >= shard_capacity)
+          make_room(sh, now);
+        it = sh.entries.insert(cache_map::value_type(p.native(), cache_entry())).first;
+        it->second.expires = now + ttl_ms;
+      }
+      cache_entry& e = it->second;
+      e.held |= field;
+      switch (field)
+      {
+      case status_held:
+        e.s = fetched.s;
+        e.s_ec = fetched.s_ec;
+        break;
+      case symlink_status_held:
+        e.symlink_s = fetched.symlink_s;
+        e.symlink_s_ec = fetched.symlink_s_ec;
+        break;
+      case size_held:
+        e.size = fetched.size;
+        break;
+      case mtime_held:
+        e.mtime = fetched.mtime;
+        break;
+      }
+    }
+
+    void make_room(cache_shard& sh, boost::uint64_t now)
+    {
+      for (cache_map::iterator it = sh.entries.begin(); it != sh.entries.end();)
+      {
+        if (it->second.expires <= now)
+        {
+          sh.entries.erase(it++);
+          ++sh.expirations;
+        }
+        else
+          ++it;
+      }
+      if (sh.entries.size() >= shard_capacity)
+      {
+        sh.entries.erase(sh.entries.begin());
+        ++sh.evictions;
+      }
+    }
+
+    void invalidate(const path& p, bool subtree)
+    {
+      if (p.empty())
+        return;
+      if (!subtree)
+      {
+        cache_shard& sh = shard(p.native());
+        detail::scoped_worker_lock lock(sh.mutex);
+        ++sh.generation;
+        sh.invalidations += sh.entries.erase(p.native());
+        return;
+      }
+      //  the paths below p hash to any shard
+      for (unsigned i = 0; i < shard_count; ++i)
+      {
+        detail::scoped_worker_lock lock(shards[i].mutex);
+        ++shards[i].generation;
+        shards[i].invalidations += erase_subtree(shards[i].entries, p.native());
+      }
+    }
+
+    //  after p was created, removed or renamed, its parent's time has changed too
+    void invalidate_with_parent(const path& p, bool subtree)
+    {
+      invalidate(p, subtree);
+      invalidate(p.parent_path(), false);
+    }
+  };
+
+  caching_backend::caching_backend(backend& next, boost::uint32_t ttl_ms,
+    std::size_t max_entries, unsigned shards)
+    : m_imp(new impl(next, ttl_ms, max_entries, shards)) {}
+
+  caching_backend::~caching_backend() {}
+
+  file_status caching_backend::status(const path& p, system::error_code& ec)
+  {
+    cache_entry e;
+    boost::uint64_t generation;
+    if (m_imp->find(p, status_held, e, generation))
+    {
+      ec = e.s_ec;
+      return e.s;
+    }
+    e.s = m_imp->next.status(p, ec);
+    e.s_ec = ec;
+    if (!ec || e.s.type() == file_not_found)
+      m_imp->store(p, status_held, e, generation);
+    return e.s;
+  }
+
+  file_status caching_backend::symlink_status(const path& p, system::error_code& ec)
+  {
+    cache_entry e;
+    boost::uint64_t generation;
+    if (m_imp->find(p, symlink_status_held, e, generation))
+    {
+      ec = e.symlink_s_ec;
+      return e.symlink_s;
+    }
+    e.symlink_s = m_imp->next.symlink_status(p, ec);
+    e.symlink_s_ec = ec;
+    if (!ec || e.symlink_s.type() == file_not_found)
+      m_imp->store(p, symlink_status_held, e, generation);
+    return e.symlink_s;
+  }
+
+  boost::uintmax_t caching_backend::file_size(const path& p, system::error_code& ec)
+  {
+    cache_entry e;
+    boost::uint64_t generation;
+    if (m_imp->find(p, size_held, e, generation))
+    {
+      ec.clear();
+      return e.size;
+    }
+    e.size = m_imp->next.file_size(p, ec);
+    if (!ec)
+      m_imp->store(p, size_held, e, generation);
+    return e.size;
+  }
+
+  std::time_t caching_backend::last_write_time(const path& p, system::error_code& ec)
+  {
+    cache_entry e;
+    boost::uint64_t generation;
+    if (m_imp->find(p, mtime_held, e, generation))
+    {
+      ec.clear();
+      return e.mtime;
+    }
+    e.mtime = m_imp->next.last_write_time(p, ec);
+    if (!ec)
+      m_imp->store(p, mtime_held, e, generation);
+    return e.mtime;
+  }
+
+  //  Each change is forwarded before the entries are dropped, so that a miss racing
+  //  it either fetches the new state or is not stored
+
+  void caching_backend::last_write_time(const path& p, std::time_t new_time,
+    system::error_code& ec)
+  {
+    m_imp->next.last_write_time(p, new_time, ec);
+    m_imp->invalidate(p, false);
+  }
+
+  bool caching_backend::create_directory(const path& p, system::error_code& ec)
+  {
+    bool created = m_imp->next.create_directory(p, ec);
+    m_imp->invalidate_with_parent(p, false);
+    return created;
+  }
+
+  void caching_backend::create_symlink(const path& to, const path& new_symlink,
+    system::error_code& ec)
+  {
+    m_imp->next.create_symlink(to, new_symlink, ec);
+    m_imp->invalidate_with_parent(new_symlink, true);
+  }
+
+  path caching_backend::read_symlink(const path& p, system::error_code& ec)
+  {
+    return m_imp->next.read_symlink(p, ec);
+  }
+
+  bool caching_backend::remove(const path& p, system::error_code& ec)
+  {
+    bool removed = m_imp->next.remove(p, ec);
+    m_imp->invalidate_with_parent(p, true);
+    return removed;
+  }
+
+  void caching_backend::rename(const path& old_p, const path& new_p,
+    system::error_code& ec)
+  {
+    m_imp->next.rename(old_p, new_p, ec);
+    m_imp->invalidate_with_parent(old_p, true);
+    m_imp->invalidate_with_parent(new_p, true);
+  }
+
+  void caching_backend::copy_file(const path& from, const path& to, bool overwrite,
+    system::error_code& ec)
+  {
+    m_imp->next.copy_file(from, to, overwrite, ec);
+    m_imp->invalidate_with_parent(to, false);
+  }
+
+  void caching_backend::resize_file(const path& p, boost::uintmax_t size,
+    system::error_code& ec)
+  {
+    m_imp->next.resize_file(p, size, ec);
+    m_imp->invalidate(p, false);
+  }
+
+  backend_directory* caching_backend::open_directory(const path& p,
+    system::error_code& ec)
+  {
+    return m_imp->next.open_directory(p, ec);
+  }
+
+  void caching_backend::changed(const path& p, bool subtree)
+  {
+    m_imp->next.changed(p, subtree);
+    m_imp->invalidate_with_parent(p, subtree);
+  }
+
+  bool caching_backend::native() const
+  {
+    return m_imp->next.native();
+  }
+
+  void caching_backend::invalidate(const path& p, bool subtree)
+  {
+    m_imp->invalidate(p, subtree);
+  }
+
+  void caching_backend::clear()
+  {
+    for (unsigned i = 0; i < m_imp->shard_count; ++i)
+    {
+      cache_shard& sh = m_imp->shards[i];
+      detail::scoped_worker_lock lock(sh.mutex);
+      ++sh.generation;
+      sh.invalidations += sh.entries.size();
+      sh.entries.clear();
+    }
+  }
+
+  cache_statistics caching_backend::statistics() const
+  {
+    cache_statistics result;
+    for (unsigned i = 0; i < m_imp->shard_count; ++i)
+    {
+      cache_shard& sh = m_imp->shards[i];
+      detail::scoped_worker_lock lock(sh.mutex);
+      result.hits += sh.hits;
+      result.misses += sh.misses;
+      result.expirations += sh.expirations;
+      result.invalidations += sh.invalidations;
+      result.evictions += sh.evictions;
+      result.entries += sh.entries.size();
+    }
+    return result;
+  }
+
+  void caching_backend::reset_statistics()
+  {
+    for (unsigned i = 0; i < m_imp->shard_count; ++i)
+    {
+      cache_shard& sh = m_imp->shards[i];
+      detail::scoped_worker_lock lock(sh.mutex);
+      sh.hits = sh.misses = sh.expirations = sh.invalidations = sh.evictions = 0;
+    }
+  }
+
+} // namespace filesystem
+} // namespace boost
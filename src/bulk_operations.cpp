@@ -0,0 +1,907 @@
+//  bulk_operations.cpp  ---------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  The bulk_ functions apply one operation to many paths. By default the paths are
+//  spread over a work_queue's threads. When the library is built with
+//  BOOST_FILESYSTEM_USE_IO_URING on Linux, status, remove_all, and create_directories
+//  instead submit their system calls to the kernel in batches through io_uring, which
+//  costs one io_uring_enter() per batch rather than a thread switch per path. Kernels
+//  older than 5.6 (statx), 5.11 (unlinkat), or 5.15 (mkdirat), and systems where
+//  io_uring is disabled, fall back to the thread pool at run time, as do all calls while
+//  a backend other than the native one is installed.
+
+//  define 64-bit offset macros BEFORE including boost/config.hpp (see ticket #5355)
+#if !(defined(__HP_aCC) && defined(_ILP32) && !defined(_STATVFS_ACPP_PROBLEMS_FIXED))
+#define _FILE_OFFSET_BITS 64 // at worst, these defines may have no effect,
+#endif
+#if !defined(__PGI)
+#define __USE_FILE_OFFSET64 // but that is harmless on Windows and on POSIX
+#else
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// define BOOST_FILESYSTEM_SOURCE so that <boost/filesystem/config.hpp> knows
+// the library is being built (possibly exporting rather than importing code)
+#define BOOST_FILESYSTEM_SOURCE
+
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+# define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/backend.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include "work_queue.hpp"
+#include "instrumentation.hpp"
+
+#if defined(BOOST_FILESYSTEM_USE_IO_URING) && defined(__linux__)
+# define BOOST_FILESYSTEM_IO_URING
+# include <linux/io_uring.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/syscall.h>
+# include <dirent.h>
+# include <fcntl.h>
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+using boost::filesystem::path;
+using boost::system::error_code;
+using boost::system::system_category;
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                        thread pool helpers (all operating systems)                   //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace
+{
+  //  Keeps the first error reported by any thread, and a count of the paths done.
+  class bulk_result
+  {
+  public:
+    bulk_result() : m_count(0) {}
+
+    void fail(const error_code& ec, const path& p)
+    {
+      fs::detail::scoped_worker_lock lock(m_mutex);
+      if (!m_ec)
+      {
+        m_ec = ec;
+        m_path = p;
+      }
+    }
+    void fail(int err, const path& p)  { fail(error_code(err, system_category()), p); }
+
+    void add(boost::uintmax_t n)
+    {
+      fs::detail::scoped_worker_lock lock(m_mutex);
+      m_count += n;
+    }
+
+    bool failed() const              { return m_ec.value() != 0; }
+    boost::uintmax_t count() const   { return m_count; }
+
+    //  Throws or sets *ec as the library's other functions do; returns true on error.
+    bool report(error_code* ec, const char* message) const
+    {
+      if (!m_ec)
+      {
+        if (ec != 0)
+          ec->clear();
+        return false;
+      }
+      if (ec == 0)
+        BOOST_FILESYSTEM_THROW(fs::filesystem_error(message, m_path, m_ec));
+      *ec = m_ec;
+      return true;
+    }
+
+  private:
+    boost::uintmax_t          m_count;
+    error_code                m_ec;
+    path                      m_path;
+    fs::detail::worker_mutex  m_mutex;
+  };
+
+  //  Worker for the work_queue: each task is the index of the first of up to chunk
+  //  paths, so that cheap operations such as status are not swamped by queue locking.
+  template <class Op>
+  class bulk_runner
+  {
+  public:
+    bulk_runner(Op& op, std::size_t count, std::size_t chunk)
+      : m_op(op), m_count(count), m_chunk(chunk) {}
+
+    void operator()(std::size_t first, fs::detail::work_queue<std::size_t>& queue)
+    {
+      std::size_t last = std::min(first + m_chunk, m_count);
+      for (std::size_t i = first; i < last && !queue.stopped(); ++i)
+      {
+        if (!m_op(i))
+        {
+          queue.stop();
+          return;
+        }
+      }
+    }
+
+  private:
+    Op&          m_op;
+    std::size_t  m_count;
+    std::size_t  m_chunk;
+  };
+
+  template <class Op>
+  void run_on_threads(Op& op, std::size_t count, std::size_t chunk, unsigned threads)
+  {
+    if (count == 0)
+      return;
+    fs::detail::work_queue<std::size_t> queue(threads);
+    for (std::size_t i = 0; i < count; i += chunk)
+      queue.push(i);
+    bulk_runner<Op> runner(op, count, chunk);
+    queue.run(runner);
+  }
+
+  struct status_op
+  {
+    status_op(const std::vector<path>& p, std::vector<fs::file_status>& r,
+      bulk_result& res)
+      : paths(p), results(r), result(res) {}
+
+    bool operator()(std::size_t i)
+    {
+      error_code ec;  // set even for a file that is not found, which is no error here
+      results[i] = fs::detail::status(paths[i], &ec);
+      if (results[i].type() == fs::status_error)
+      {
+        result.fail(ec, paths[i]);
+        return false;
+      }
+      return true;
+    }
+
+    const std::vector<path>&        paths;
+    std::vector<fs::file_status>&   results;
+    bulk_result&                    result;
+  };
+
+  struct remove_all_op
+  {
+    remove_all_op(const std::vector<path>& p, bulk_result& res) : paths(p), result(res) {}
+
+    bool operator()(std::size_t i)
+    {
+      error_code ec;
+      boost::uintmax_t n = fs::detail::remove_all(paths[i], &ec);
+      if (ec)
+      {
+        result.fail(ec, paths[i]);
+        return false;
+      }
+      result.add(n);
+      return true;
+    }
+
+    const std::vector<path>&  paths;
+    bulk_result&              result;
+  };
+
+  struct create_directories_op
+  {
+    create_directories_op(const std::vector<path>& p, bulk_result& res)
+      : paths(p), result(res) {}
+
+    bool operator()(std::size_t i)
+    {
+      error_code ec;
+      bool created = fs::detail::create_directories(paths[i], &ec);
+      if (ec)
+      {
+        result.fail(ec, paths[i]);
+        return false;
+      }
+      if (created)
+        result.add(1);
+      return true;
+    }
+
+    const std::vector<path>&  paths;
+    bulk_result&              result;
+  };
+
+  struct copy_file_op
+  {
+    copy_file_op(const std::vector<path>& f, const std::vector<path>& t,
+      fs::detail::copy_option opt, bulk_result& res)
+      : from(f), to(t), option(opt), result(res) {}
+
+    bool operator()(std::size_t i)
+    {
+      error_code ec;
+      fs::detail::copy_file(from[i], to[i], option, &ec);
+      if (ec)
+      {
+        result.fail(ec, from[i]);
+        return false;
+      }
+      return true;
+    }
+
+    const std::vector<path>&  from;
+    const std::vector<path>&  to;
+    fs::detail::copy_option   option;
+    bulk_result&              result;
+  };
+
+#ifdef BOOST_FILESYSTEM_IO_URING
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                io_uring helpers                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  //  A minimal io_uring, driven by the raw system calls so that liburing is not needed.
+  //  Only one thread uses a ring.
+  class uring
+  {
+  public:
+    explicit uring(unsigned entries)
+      : m_fd(-1), m_sq_ptr(MAP_FAILED), m_cq_ptr(MAP_FAILED), m_sqes(MAP_FAILED),
+        m_sq_size(0), m_cq_size(0), m_sqes_size(0), m_tail(0)
+    {
+      io_uring_params params;
+      std::memset(&params, 0, sizeof(params));
+      m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+      if (m_fd < 0)
+        return;
+
+      m_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+      m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+      bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+      if (single_mmap)
+        m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+
+      m_sq_ptr = ::mmap(0, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        m_fd, IORING_OFF_SQ_RING);
+      if (m_sq_ptr == MAP_FAILED)
+        return;
+      m_cq_ptr = single_mmap ? m_sq_ptr : ::mmap(0, m_cq_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+      if (m_cq_ptr == MAP_FAILED)
+        return;
+      m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+      m_sqes = ::mmap(0, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        m_fd, IORING_OFF_SQES);
+      if (m_sqes == MAP_FAILED)
+        return;
+
+      char* sq = static_cast<char*>(m_sq_ptr);
+      char* cq = static_cast<char*>(m_cq_ptr);
+      m_sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+      m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+      m_sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+      m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+      m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+      m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+      m_cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+      m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+      m_entries = params.sq_entries;
+      m_tail = *m_sq_tail;
+    }
+
+    ~uring()
+    {
+      if (m_sqes != MAP_FAILED)
+        ::munmap(m_sqes, m_sqes_size);
+      if (m_cq_ptr != MAP_FAILED && m_cq_ptr != m_sq_ptr)
+        ::munmap(m_cq_ptr, m_cq_size);
+      if (m_sq_ptr != MAP_FAILED)
+        ::munmap(m_sq_ptr, m_sq_size);
+      if (m_fd >= 0)
+        ::close(m_fd);
+    }
+
+    bool ok() const           { return m_sqes != MAP_FAILED; }
+    unsigned entries() const  { return m_entries; }
+
+    bool supports(unsigned op) const
+    {
+      std::vector<char> buf(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op));
+      io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(&buf[0]);
+      if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, 256) < 0)
+        return false;
+      return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+
+    //  Returns a cleared entry to fill in, or 0 if the submission queue is full.
+    io_uring_sqe* get_sqe()
+    {
+      unsigned head = __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+      if (m_tail - head >= m_entries)
+        return 0;
+      unsigned index = m_tail & m_sq_mask;
+      io_uring_sqe* sqe = static_cast<io_uring_sqe*>(m_sqes) + index;
+      std::memset(sqe, 0, sizeof(*sqe));
+      m_sq_array[index] = index;
+      ++m_tail;
+      return sqe;
+    }
+
+    //  Submits the entries filled in and not yet taken by the kernel, and waits for
+    //  wait_nr completions. Returns 0 or an errno value.
+    int submit(unsigned wait_nr)
+    {
+      __atomic_store_n(m_sq_tail, m_tail, __ATOMIC_RELEASE);
+      if (::syscall(__NR_io_uring_enter, m_fd, unconsumed(), wait_nr,
+        wait_nr ? IORING_ENTER_GETEVENTS : 0, 0, 0) < 0)
+        return errno;
+      return 0;
+    }
+
+    //  Waits for a completion without submitting. Returns 0 or an errno value.
+    int wait()
+    {
+      if (::syscall(__NR_io_uring_enter, m_fd, 0, 1, IORING_ENTER_GETEVENTS, 0, 0) < 0)
+        return errno;
+      return 0;
+    }
+
+    //  Entries filled in that the kernel has not taken; only io_uring_enter() takes them
+    unsigned unconsumed() const
+    {
+      return m_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+    }
+
+    bool pop(io_uring_cqe& cqe)
+    {
+      unsigned head = *m_cq_head;
+      if (head == __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE))
+        return false;
+      cqe = m_cqes[head & m_cq_mask];
+      __atomic_store_n(m_cq_head, head + 1, __ATOMIC_RELEASE);
+      return true;
+    }
+
+  private:
+    int            m_fd;
+    void*          m_sq_ptr;
+    void*          m_cq_ptr;
+    void*          m_sqes;
+    std::size_t    m_sq_size;
+    std::size_t    m_cq_size;
+    std::size_t    m_sqes_size;
+    unsigned*      m_sq_head;
+    unsigned*      m_sq_tail;
+    unsigned       m_sq_mask;
+    unsigned*      m_sq_array;
+    unsigned*      m_cq_head;
+    unsigned*      m_cq_tail;
+    unsigned       m_cq_mask;
+    io_uring_cqe*  m_cqes;
+    unsigned       m_entries;
+    unsigned       m_tail;     // local copy of the submission queue tail
+
+    uring(const uring&);
+    uring& operator=(const uring&);
+  };
+
+  //  Runs batch.prepare(i, slot, sqe) and, once the request completes,
+  //  batch.complete(i, slot, result) for i in [0, count), keeping up to ring.entries()
+  //  requests in flight. slot, below ring.entries(), identifies per-request storage.
+  //  complete() returns false to stop submitting. Returns 0 or an errno value.
+  template <class Batch>
+  int uring_run(uring& ring, std::size_t count, Batch& batch)
+  {
+    std::vector<std::size_t> slot_index(ring.entries());
+    std::vector<unsigned> free_slots;
+    for (unsigned slot = ring.entries(); slot != 0; --slot)
+      free_slots.push_back(slot - 1);
+
+    std::size_t next = 0;
+    std::size_t in_flight = 0;
+    bool stop = false;
+    while ((next < count && !stop) || in_flight != 0)
+    {
+      io_uring_sqe* sqe;
+      while (!stop && next < count && !free_slots.empty() && (sqe = ring.get_sqe()) != 0)
+      {
+        unsigned slot = free_slots.back();
+        free_slots.pop_back();
+        slot_index[slot] = next;
+        batch.prepare(next, slot, *sqe);
+        sqe->user_data = slot;
+        ++next;
+        ++in_flight;
+      }
+
+      int err = ring.submit(1);
+      if (err != 0 && err != EINTR && err != EAGAIN && err != EBUSY)
+      {
+        //  The kernel may still read the paths and write the buffers of the requests
+        //  it has taken, which the caller frees on return, so wait for all of them.
+        //  Their completions are posted even if waiting for them fails.
+        in_flight -= ring.unconsumed();
+        io_uring_cqe cqe;
+        while (in_flight != 0)
+        {
+          if (ring.pop(cqe))
+            --in_flight;
+          else if (ring.wait() != 0)
+            ::sched_yield();
+        }
+        return err;
+      }
+
+      io_uring_cqe cqe;
+      while (ring.pop(cqe))
+      {
+        --in_flight;
+        unsigned slot = static_cast<unsigned>(cqe.user_data);
+        if (!batch.complete(slot_index[slot], slot, cqe.res))
+          stop = true;
+        free_slots.push_back(slot);
+      }
+    }
+    return 0;
+  }
+
+  inline bool not_found_error(int errval)
+  {
+    return errval == ENOENT || errval == ENOTDIR;
+  }
+
+  fs::file_status status_from_mode(unsigned mode)
+  {
+    fs::perms prms = static_cast<fs::perms>(mode) & fs::perms_mask;
+    if (S_ISDIR(mode))  return fs::file_status(fs::directory_file, prms);
+    if (S_ISREG(mode))  return fs::file_status(fs::regular_file, prms);
+    if (S_ISBLK(mode))  return fs::file_status(fs::block_file, prms);
+    if (S_ISCHR(mode))  return fs::file_status(fs::character_file, prms);
+    if (S_ISFIFO(mode)) return fs::file_status(fs::fifo_file, prms);
+    if (S_ISSOCK(mode)) return fs::file_status(fs::socket_file, prms);
+    return fs::file_status(fs::type_unknown);
+  }
+
+  inline std::size_t depth_of(const path& p)
+  {
+    return static_cast<std::size_t>(std::distance(p.begin(), p.end()));
+  }
+
+  struct statx_batch
+  {
+    statx_batch(const std::vector<path>& p, std::vector<fs::file_status>& r,
+      unsigned slots, bulk_result& res)
+      : paths(p), results(r), buffers(slots), result(res) {}
+
+    void prepare(std::size_t i, unsigned slot, io_uring_sqe& sqe)
+    {
+      sqe.opcode = IORING_OP_STATX;
+      sqe.fd = AT_FDCWD;
+      sqe.addr = reinterpret_cast<boost::uint64_t>(paths[i].c_str());
+      sqe.len = STATX_TYPE | STATX_MODE;
+      sqe.off = reinterpret_cast<boost::uint64_t>(&buffers[slot]);
+      sqe.statx_flags = 0;  // follow symlinks, as status() does
+    }
+
+    bool complete(std::size_t i, unsigned slot, int res)
+    {
+      if (res >= 0)
+        results[i] = status_from_mode(buffers[slot].stx_mode);
+      else if (not_found_error(-res))
+        results[i] = fs::file_status(fs::file_not_found, fs::no_perms);
+      else
+      {
+        results[i] = fs::file_status(fs::status_error);
+        result.fail(-res, paths[i]);
+        return false;
+      }
+      return true;
+    }
+
+    const std::vector<path>&        paths;
+    std::vector<fs::file_status>&   results;
+    std::vector<struct statx>       buffers;
+    bulk_result&                    result;
+  };
+
+  //  unlinkat() or, for directories, rmdir(), of each path
+  struct unlink_batch
+  {
+    unlink_batch(const std::vector<path>& p, bool dirs, bulk_result& res)
+      : paths(p), directories(dirs), result(res) {}
+
+    void prepare(std::size_t i, unsigned, io_uring_sqe& sqe)
+    {
+      sqe.opcode = IORING_OP_UNLINKAT;
+      sqe.fd = AT_FDCWD;
+      sqe.addr = reinterpret_cast<boost::uint64_t>(paths[i].c_str());
+      sqe.unlink_flags = directories ? AT_REMOVEDIR : 0;
+    }
+
+    bool complete(std::size_t i, unsigned, int res)
+    {
+      if (res >= 0)
+        result.add(1);
+      else if (!not_found_error(-res))
+      {
+        result.fail(-res, paths[i]);
+        return false;
+      }
+      return true;
+    }
+
+    const std::vector<path>&  paths;
+    bool                      directories;
+    bulk_result&              result;
+  };
+
+  struct mkdir_batch
+  {
+    mkdir_batch(const std::vector<path>& p, const std::vector<bool>& f, bulk_result& res)
+      : paths(p), listed(f), result(res) {}
+
+    void prepare(std::size_t i, unsigned, io_uring_sqe& sqe)
+    {
+      sqe.opcode = IORING_OP_MKDIRAT;
+      sqe.fd = AT_FDCWD;
+      sqe.addr = reinterpret_cast<boost::uint64_t>(paths[i].c_str());
+      sqe.len = S_IRWXU | S_IRWXG | S_IRWXO;
+    }
+
+    bool complete(std::size_t i, unsigned, int res)
+    {
+      if (res >= 0)
+      {
+        if (listed[i])
+          result.add(1);
+        return true;
+      }
+      //  an existing parent is fine; an existing listed path must be a directory
+      struct stat st;
+      if (-res == EEXIST
+        && (!listed[i] || (::stat(paths[i].c_str(), &st) == 0 && S_ISDIR(st.st_mode))))
+        return true;
+      result.fail(-res, paths[i]);
+      return false;
+    }
+
+    const std::vector<path>&  paths;
+    const std::vector<bool>&  listed;   // in the caller's list, not just a parent
+    bulk_result&              result;
+  };
+
+  struct removal
+  {
+    removal(const path& p, std::size_t d) : target(p), depth(d) {}
+
+    path         target;
+    std::size_t  depth;  // elements in target
+  };
+
+  inline bool deeper_first(const removal& lhs, const removal& rhs)
+  {
+    return lhs.depth > rhs.depth;
+  }
+
+  //  Lists p and everything below it, without following symlinks. Returns 0 or an
+  //  errno value.
+  int list_tree(const path& p, std::size_t depth, bool is_dir,
+    std::vector<path>& files, std::vector<removal>& dirs)
+  {
+    if (!is_dir)
+    {
+      files.push_back(p);
+      return 0;
+    }
+    dirs.push_back(removal(p, depth));
+    DIR* dir = ::opendir(p.c_str());
+    if (dir == 0)
+      return not_found_error(errno) ? 0 : errno;
+    int err = 0;
+    struct dirent* entry;
+    while (err == 0 && (errno = 0, (entry = ::readdir(dir)) != 0))
+    {
+      const char* name = entry->d_name;
+      if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0)))
+        continue;
+      path child(p / name);
+      bool child_is_dir = entry->d_type == DT_DIR;
+      if (entry->d_type == DT_UNKNOWN)
+      {
+        struct stat st;
+        if (::lstat(child.c_str(), &st) != 0)
+        {
+          if (not_found_error(errno))
+            continue;
+          err = errno;
+          break;
+        }
+        child_is_dir = S_ISDIR(st.st_mode);
+      }
+      err = list_tree(child, depth + 1, child_is_dir, files, dirs);
+    }
+    if (err == 0 && errno != 0)
+      err = errno;
+    ::closedir(dir);
+    return err;
+  }
+
+  bool uring_supports(uring& ring, unsigned op)
+  {
+    return ring.ok() && ring.supports(op);
+  }
+
+  //  Each returns false if io_uring cannot do the job, so that the thread pool must.
+
+  bool uring_status(const std::vector<path>& paths, std::vector<fs::file_status>& results,
+    unsigned depth, bulk_result& result)
+  {
+    uring ring(depth);
+    if (!uring_supports(ring, IORING_OP_STATX))
+      return false;
+    statx_batch batch(paths, results, ring.entries(), result);
+    if (int err = uring_run(ring, paths.size(), batch))
+      result.fail(err, path());
+    return true;
+  }
+
+  bool uring_remove_all(const std::vector<path>& paths, unsigned depth,
+    bulk_result& result)
+  {
+    uring ring(depth);
+    if (!uring_supports(ring, IORING_OP_UNLINKAT))
+      return false;
+
+    std::vector<path> files;
+    std::vector<removal> dirs;
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+      struct stat st;
+      if (::lstat(paths[i].c_str(), &st) != 0)
+      {
+        if (not_found_error(errno))
+          continue;
+        result.fail(errno, paths[i]);
+        return true;
+      }
+      if (int err = list_tree(paths[i], depth_of(paths[i]), S_ISDIR(st.st_mode),
+        files, dirs))
+      {
+        result.fail(err, paths[i]);
+        return true;
+      }
+    }
+
+    unlink_batch file_batch(files, false, result);
+    if (int err = uring_run(ring, files.size(), file_batch))
+      result.fail(err, path());
+
+    //  directories of equal depth cannot contain one another, so each depth is a batch
+    std::stable_sort(dirs.begin(), dirs.end(), deeper_first);
+    std::vector<path> level;
+    for (std::size_t i = 0; i < dirs.size() && !result.failed();)
+    {
+      level.clear();
+      std::size_t d = dirs[i].depth;
+      for (; i < dirs.size() && dirs[i].depth == d; ++i)
+        level.push_back(dirs[i].target);
+      unlink_batch dir_batch(level, true, result);
+      if (int err = uring_run(ring, level.size(), dir_batch))
+        result.fail(err, path());
+    }
+    return true;
+  }
+
+  struct directory_to_create
+  {
+    directory_to_create(const path& p, std::size_t d, bool l)
+      : target(p), depth(d), listed(l) {}
+
+    path         target;
+    std::size_t  depth;
+    bool         listed;
+  };
+
+  //  shallowest first, and a listed duplicate ahead of an unlisted one
+  inline bool creation_order(const directory_to_create& lhs,
+    const directory_to_create& rhs)
+  {
+    if (lhs.depth != rhs.depth)
+      return lhs.depth < rhs.depth;
+    int cmp = lhs.target.compare(rhs.target);
+    return cmp != 0 ? cmp < 0 : lhs.listed && !rhs.listed;
+  }
+
+  inline bool same_target(const directory_to_create& lhs,
+    const directory_to_create& rhs)
+  {
+    return lhs.target == rhs.target;
+  }
+
+  bool uring_create_directories(const std::vector<path>& paths, unsigned depth,
+    bulk_result& result)
+  {
+    uring ring(depth);
+    if (!uring_supports(ring, IORING_OP_MKDIRAT))
+      return false;
+
+    //  every directory named, and each of its parents, once, level by level
+    std::vector<directory_to_create> all;
+    for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+      if (paths[i].empty())
+      {
+        result.fail(EINVAL, paths[i]);
+        return true;
+      }
+      //  as create_directories() does, "a/b/." and "a/b/.." create a/b
+      path target(paths[i]);
+      while (target.filename_is_dot() || target.filename_is_dot_dot())
+        target = target.parent_path();
+      path prefix;
+      std::size_t d = 0;
+      for (path::iterator it = target.begin(); it != target.end(); ++it)
+      {
+        prefix /= *it;
+        ++d;
+        if (prefix.has_relative_path())  // not a root
+          all.push_back(directory_to_create(prefix, d, false));
+      }
+      if (!all.empty() && all.back().target == target)
+        all.back().listed = true;
+    }
+    std::sort(all.begin(), all.end(), creation_order);
+    all.erase(std::unique(all.begin(), all.end(), same_target), all.end());
+
+    std::vector<path> level;
+    std::vector<bool> listed;
+    for (std::size_t i = 0; i < all.size() && !result.failed();)
+    {
+      level.clear();
+      listed.clear();
+      std::size_t d = all[i].depth;
+      for (; i < all.size() && all[i].depth == d; ++i)
+      {
+        level.push_back(all[i].target);
+        listed.push_back(all[i].listed);
+      }
+      mkdir_batch batch(level, listed, result);
+      if (int err = uring_run(ring, level.size(), batch))
+        result.fail(err, path());
+    }
+    return true;
+  }
+
+  bool io_uring_probed = false;  // set once, by probe_io_uring()
+
+  void probe_io_uring()
+  {
+    uring ring(2);
+    io_uring_probed = ring.ok();
+  }
+
+  //  io_uring makes the system calls itself, so it serves only the native backend
+  bool uring_usable(const fs::bulk_options& options)
+  {
+    return options.use_io_uring && &fs::current_backend() == &fs::native_backend();
+  }
+
+#endif  // BOOST_FILESYSTEM_IO_URING
+
+}  // unnamed namespace
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                bulk operations functions declared in operations.hpp                  //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace boost
+{
+namespace filesystem
+{
+  BOOST_FILESYSTEM_DECL
+  bool io_uring_available() BOOST_NOEXCEPT
+  {
+#   ifdef BOOST_FILESYSTEM_IO_URING
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    ::pthread_once(&once, probe_io_uring);
+    return io_uring_probed;
+#   else
+    return false;
+#   endif
+  }
+
+namespace detail
+{
+  BOOST_FILESYSTEM_DECL
+  void bulk_copy_file(const std::vector<path>& from, const std::vector<path>& to,
+    detail::copy_option option, const bulk_options& options, system::error_code* ec)
+  {
+    BOOST_ASSERT_MSG(from.size() == to.size(), "from and to must be the same size");
+    BOOST_FILESYSTEM_PROBE(bulk_copy_file_op, 0, ec);
+
+    //  The data already moves inside the kernel by copy_file_range() where possible, so
+    //  io_uring would save little beyond the opens; the thread pool does every copy.
+    bulk_result result;
+    copy_file_op op(from, to, option, result);
+    run_on_threads(op, std::min(from.size(), to.size()), 1, options.threads);
+    result.report(ec, "boost::filesystem::bulk_copy_file");
+  }
+
+  BOOST_FILESYSTEM_DECL
+  boost::uintmax_t bulk_create_directories(const std::vector<path>& paths,
+    const bulk_options& options, system::error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(bulk_create_directories_op, 0, ec);
+    bulk_result result;
+#   ifdef BOOST_FILESYSTEM_IO_URING
+    if (!uring_usable(options)
+      || !uring_create_directories(paths, options.queue_depth, result))
+#   endif
+    {
+      create_directories_op op(paths, result);
+      run_on_threads(op, paths.size(), 1, options.threads);
+    }
+    return result.report(ec, "boost::filesystem::bulk_create_directories")
+      ? 0 : result.count();
+  }
+
+  BOOST_FILESYSTEM_DECL
+  boost::uintmax_t bulk_remove_all(const std::vector<path>& paths,
+    const bulk_options& options, system::error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(bulk_remove_all_op, 0, ec);
+    bulk_result result;
+#   ifdef BOOST_FILESYSTEM_IO_URING
+    if (!uring_usable(options) || !uring_remove_all(paths, options.queue_depth, result))
+#   endif
+    {
+      remove_all_op op(paths, result);
+      run_on_threads(op, paths.size(), 1, options.threads);
+    }
+    return result.report(ec, "boost::filesystem::bulk_remove_all") ? 0 : result.count();
+  }
+
+  BOOST_FILESYSTEM_DECL
+  std::vector<file_status> bulk_status(const std::vector<path>& paths,
+    const bulk_options& options, system::error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(bulk_status_op, 0, ec);
+    std::vector<file_status> results(paths.size());
+    bulk_result result;
+#   ifdef BOOST_FILESYSTEM_IO_URING
+    if (!uring_usable(options)
+      || !uring_status(paths, results, options.queue_depth, result))
+#   endif
+    {
+      status_op op(paths, results, result);
+      run_on_threads(op, paths.size(), 64, options.threads);
+    }
+    result.report(ec, "boost::filesystem::bulk_status");
+    return results;
+  }
+
+}  // namespace detail
+}  // namespace filesystem
+}  // namespace boost
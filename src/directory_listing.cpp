@@ -0,0 +1,411 @@
+//  directory_listing.cpp  -------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  define 64-bit offset macros BEFORE including boost/config.hpp (see ticket #5355)
+#if !(defined(__HP_aCC) && defined(_ILP32) && !defined(_STATVFS_ACPP_PROBLEMS_FIXED))
+#define _FILE_OFFSET_BITS 64 // at worst, these defines may have no effect,
+#endif
+#if !defined(__PGI)
+#define __USE_FILE_OFFSET64 // but that is harmless on Windows and on POSIX
+#else
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// define BOOST_FILESYSTEM_SOURCE so that <boost/filesystem/config.hpp> knows
+// the library is being built (possibly exporting rather than importing code)
+#define BOOST_FILESYSTEM_SOURCE
+
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+# define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem/directory_listing.hpp>
+#include <boost/filesystem/backend.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <string>
+
+#ifdef BOOST_WINDOWS_API
+# include <windows.h>
+# include "windows_file_time.hpp"
+#else
+# include <sys/types.h>
+# include <sys/stat.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+using boost::filesystem::path;
+using boost::filesystem::file_status;
+using boost::system::error_code;
+
+namespace
+{
+  //  The fields of one entry beyond its name
+  struct entry_metadata
+  {
+    entry_metadata() : type(fs::status_error), prms(fs::perms_not_known), size(0),
+      mtime(0), inode(0) {}
+
+    fs::file_type     type;
+    fs::perms         prms;
+    boost::uintmax_t  size;
+    std::time_t       mtime;
+    boost::uint64_t   inode;
+  };
+
+  //  Returns false, leaving m as it was, if p has gone since its directory was read
+  bool examine(const path& p, entry_metadata& m)
+  {
+#   ifdef BOOST_WINDOWS_API
+    error_code ec;
+    file_status s = fs::native_backend().symlink_status(p, ec);
+    if (s.type() == fs::file_not_found)
+      return false;
+    m.type = s.type();
+    m.prms = s.permissions();
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (::GetFileAttributesExW(p.c_str(), GetFileExInfoStandard, &data))
+    {
+      if (m.type == fs::regular_file)
+        m.size = (static_cast<boost::uintmax_t>(data.nFileSizeHigh) << 32)
+          | data.nFileSizeLow;
+      m.mtime = fs::detail::filetime_to_time_t(data.ftLastWriteTime);
+    }
+#   else
+    struct stat st;
+    if (::lstat(p.c_str(), &st) != 0)
+    {
+      if (errno == ENOENT || errno == ENOTDIR)
+        return false;
+      m.type = fs::status_error;
+      return true;
+    }
+    m.type = S_ISREG(st.st_mode) ? fs::regular_file
+      : S_ISDIR(st.st_mode) ? fs::directory_file
+      : S_ISLNK(st.st_mode) ? fs::symlink_file
+      : S_ISBLK(st.st_mode) ? fs::block_file
+      : S_ISCHR(st.st_mode) ? fs::character_file
+      : S_ISFIFO(st.st_mode) ? fs::fifo_file
+      : S_ISSOCK(st.st_mode) ? fs::socket_file
+      : fs::type_unknown;
+    m.prms = static_cast<fs::perms>(st.st_mode & fs::perms_mask);
+    if (m.type == fs::regular_file)
+      m.size = static_cast<boost::uintmax_t>(st.st_size);
+    m.mtime = st.st_mtime;
+    m.inode = static_cast<boost::uint64_t>(st.st_ino);
+#   endif
+    return true;
+  }
+
+  //  Orders the indexes of entries by the inode numbers the directory reported
+  struct inode_order
+  {
+    explicit inode_order(const std::vector<boost::uint64_t>& i) : inodes(i) {}
+
+    bool operator()(boost::uint32_t i, boost::uint32_t j) const
+      { return inodes[i] < inodes[j]; }
+
+    const std::vector<boost::uint64_t>& inodes;
+  };
+
+}  // unnamed namespace
+
+namespace boost
+{
+namespace filesystem
+{
+  const std::size_t directory_listing::npos;
+
+  //  Orders the indexes of entries by their names
+  struct directory_listing::order
+  {
+    explicit order(const directory_listing& l) : listing(l) {}
+
+    bool operator()(boost::uint32_t i, boost::uint32_t j) const
+      { return listing.compare(i, listing.name(j), listing.name_size(j)) < 0; }
+
+    const directory_listing& listing;
+  };
+
+  directory_listing::directory_listing(const path& dir, unsigned fields)
+    : m_fields(0), m_sorted(true)
+  {
+    m_offsets.push_back(0);
+    read(dir, fields);
+  }
+
+  directory_listing::directory_listing(const path& dir, unsigned fields,
+    system::error_code& ec)
+    : m_fields(0), m_sorted(true)
+  {
+    m_offsets.push_back(0);
+    read(dir, fields, ec);
+  }
+
+  void directory_listing::read(const path& dir, unsigned fields)
+  {
+    system::error_code ec;
+    read(dir, fields, ec);
+    if (ec)
+      BOOST_FILESYSTEM_THROW(filesystem_error(
+        "boost::filesystem::directory_listing::read", dir, ec));
+  }
+
+  void directory_listing::read(const path& dir, unsigned fields, system::error_code& ec)
+  {
+    clear();
+    m_directory = dir;
+    m_fields = fields & listing_all_fields;
+    std::vector<boost::uint64_t> inodes;  // as the directory reported them
+    directory_cursor cursor(dir, ec);
+    for (; !ec && !cursor.at_end(); cursor.increment(ec))
+    {
+      append(cursor.entry().path().filename().native(),
+        static_cast<boost::uint32_t>(cursor.type()) & type_mask, ec);
+      if (ec)
+        break;
+      inodes.push_back(cursor.inode());
+    }
+    if (ec)
+    {
+      clear();
+      return;
+    }
+
+    //  The entries are examined in inode order rather than the order read. File systems
+    //  such as ext4 and XFS keep inodes in tables, so this reads each block of a table
+    //  once and in order, instead of seeking to and fro on a cold cache.
+    std::size_t n = size();
+    unsigned stat_fields = m_fields & (listing_permissions | listing_size
+      | listing_last_write_time);
+    std::vector<boost::uint32_t> examined;
+    for (std::size_t i = 0; i < n; ++i)
+      if (stat_fields != 0 || type(i) == status_error
+        || ((m_fields & listing_inode) != 0 && inodes[i] == 0))
+        examined.push_back(static_cast<boost::uint32_t>(i));
+    std::stable_sort(examined.begin(), examined.end(), inode_order(inodes));
+
+    if ((m_fields & listing_size) != 0)
+      m_sizes.assign(n, 0);
+    if ((m_fields & listing_last_write_time) != 0)
+      m_mtimes.assign(n, 0);
+    if ((m_fields & listing_inode) != 0)
+      m_inodes.swap(inodes);
+    std::vector<bool> gone;
+    for (std::size_t k = 0; k < examined.size(); ++k)
+    {
+      std::size_t i = examined[k];
+      entry_metadata m;
+      m.type = type(i);
+      if (!examine(m_directory / filename(i), m))
+      {
+        gone.resize(n);
+        gone[i] = true;
+        continue;
+      }
+      m_modes[i] = static_cast<boost::uint32_t>(m.type) & type_mask;
+      if ((m_fields & listing_permissions) != 0 && m.prms != perms_not_known)
+        m_modes[i] |= perms_known | ((static_cast<boost::uint32_t>(m.prms) & perms_mask)
+          << perms_shift);
+      if (!m_sizes.empty())
+        m_sizes[i] = m.size;
+      if (!m_mtimes.empty())
+        m_mtimes[i] = m.mtime;
+      if (!m_inodes.empty() && m_inodes[i] == 0)  // the directory's number is kept
+        m_inodes[i] = m.inode;
+    }
+
+    if (!gone.empty())  // drop the entries removed since the directory was read
+    {
+      std::size_t kept = 0, chars = 0;
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        if (gone[i])
+          continue;
+        std::size_t from = m_offsets[i], length = m_offsets[i + 1] - from;
+        std::copy(m_names.begin() + from, m_names.begin() + from + length,
+          m_names.begin() + chars);
+        m_offsets[kept] = static_cast<boost::uint32_t>(chars);
+        chars += length;
+        m_modes[kept] = m_modes[i];
+        if (!m_sizes.empty())
+          m_sizes[kept] = m_sizes[i];
+        if (!m_mtimes.empty())
+          m_mtimes[kept] = m_mtimes[i];
+        if (!m_inodes.empty())
+          m_inodes[kept] = m_inodes[i];
+        ++kept;
+      }
+      m_offsets[kept] = static_cast<boost::uint32_t>(chars);
+      m_offsets.resize(kept + 1);
+      m_names.resize(chars);
+      m_modes.resize(kept);
+      if (!m_sizes.empty())
+        m_sizes.resize(kept);
+      if (!m_mtimes.empty())
+        m_mtimes.resize(kept);
+      if (!m_inodes.empty())
+        m_inodes.resize(kept);
+    }
+    m_sorted = size() < 2;
+  }
+
+  void directory_listing::push_back(const path& filename, file_status s)
+  {
+    boost::uint32_t mode = static_cast<boost::uint32_t>(s.type()) & type_mask;
+    if (s.permissions() != perms_not_known)
+      mode |= perms_known | ((static_cast<boost::uint32_t>(s.permissions()) & perms_mask)
+        << perms_shift);
+    system::error_code ec;
+    append(filename.native(), mode, ec);
+    if (ec)
+      BOOST_FILESYSTEM_THROW(filesystem_error(
+        "boost::filesystem::directory_listing::push_back", filename, ec));
+    if ((m_fields & listing_size) != 0)
+      m_sizes.push_back(0);
+    if ((m_fields & listing_last_write_time) != 0)
+      m_mtimes.push_back(0);
+    if ((m_fields & listing_inode) != 0)
+      m_inodes.push_back(0);
+    std::size_t n = size();
+    if (m_sorted && n > 1 && compare(n - 2, name(n - 1), name_size(n - 1)) > 0)
+      m_sorted = false;
+  }
+
+  //  Adds the name and mode; the caller adds the fields
+  void directory_listing::append(const path::string_type& name, boost::uint32_t mode,
+    system::error_code& ec)
+  {
+    //  the offsets are 32 bits, so the names may take up to 4 GiB less one character
+    if (m_names.size() + name.size() + 1 > 0xFFFFFFFFu)
+    {
+      ec = system::errc::make_error_code(system::errc::value_too_large);
+      return;
+    }
+    m_names.insert(m_names.end(), name.begin(), name.end());
+    m_names.push_back(0);
+    m_offsets.push_back(static_cast<boost::uint32_t>(m_names.size()));
+    m_modes.push_back(mode);
+    ec.clear();
+  }
+
+  void directory_listing::reserve(std::size_t entries, std::size_t name_chars)
+  {
+    m_names.reserve(name_chars + entries);  // and a terminator each
+    m_offsets.reserve(entries + 1);
+    m_modes.reserve(entries);
+    if ((m_fields & listing_size) != 0)
+      m_sizes.reserve(entries);
+    if ((m_fields & listing_last_write_time) != 0)
+      m_mtimes.reserve(entries);
+    if ((m_fields & listing_inode) != 0)
+      m_inodes.reserve(entries);
+  }
+
+  void directory_listing::clear()
+  {
+    m_names.clear();
+    m_offsets.clear();
+    m_offsets.push_back(0);
+    m_modes.clear();
+    m_sizes.clear();
+    m_mtimes.clear();
+    m_inodes.clear();
+    m_sorted = true;
+  }
+
+  int directory_listing::compare(std::size_t i, const path::value_type* name,
+    std::size_t size) const
+  {
+    std::size_t n = name_size(i);
+    int result = std::char_traits<path::value_type>::compare(this->name(i), name,
+      n < size ? n : size);
+    return result != 0 ? result : n < size ? -1 : n > size ? 1 : 0;
+  }
+
+  void directory_listing::sort()
+  {
+    if (m_sorted)
+      return;
+    std::size_t n = size();
+    std::vector<boost::uint32_t> index(n);
+    for (std::size_t i = 0; i < n; ++i)
+      index[i] = static_cast<boost::uint32_t>(i);
+    std::sort(index.begin(), index.end(), order(*this));
+
+    std::vector<path::value_type> names;
+    names.reserve(m_names.size());
+    std::vector<boost::uint32_t> offsets;
+    offsets.reserve(n + 1);
+    offsets.push_back(0);
+    std::vector<boost::uint32_t> modes(n);
+    std::vector<boost::uintmax_t> sizes(m_sizes.size());
+    std::vector<std::time_t> mtimes(m_mtimes.size());
+    std::vector<boost::uint64_t> inodes(m_inodes.size());
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      std::size_t from = index[i];
+      names.insert(names.end(), m_names.begin() + m_offsets[from],
+        m_names.begin() + m_offsets[from + 1]);
+      offsets.push_back(static_cast<boost::uint32_t>(names.size()));
+      modes[i] = m_modes[from];
+      if (!sizes.empty())
+        sizes[i] = m_sizes[from];
+      if (!mtimes.empty())
+        mtimes[i] = m_mtimes[from];
+      if (!inodes.empty())
+        inodes[i] = m_inodes[from];
+    }
+    m_names.swap(names);
+    m_offsets.swap(offsets);
+    m_modes.swap(modes);
+    m_sizes.swap(sizes);
+    m_mtimes.swap(mtimes);
+    m_inodes.swap(inodes);
+    m_sorted = true;
+  }
+
+  std::size_t directory_listing::find(const path& filename) const
+  {
+    const path::string_type& target = filename.native();
+    if (!m_sorted)
+    {
+      for (std::size_t i = 0; i < size(); ++i)
+        if (compare(i, target.c_str(), target.size()) == 0)
+          return i;
+      return npos;
+    }
+    std::size_t first = 0, last = size();
+    while (first < last)
+    {
+      std::size_t middle = first + (last - first) / 2;
+      if (compare(middle, target.c_str(), target.size()) < 0)
+        first = middle + 1;
+      else
+        last = middle;
+    }
+    return first < size() && compare(first, target.c_str(), target.size()) == 0
+      ? first : npos;
+  }
+
+  std::size_t directory_listing::memory_size() const
+  {
+    return m_names.capacity() * sizeof(path::value_type)
+      + m_offsets.capacity() * sizeof(boost::uint32_t)
+      + m_modes.capacity() * sizeof(boost::uint32_t)
+      + m_sizes.capacity() * sizeof(boost::uintmax_t)
+      + m_mtimes.capacity() * sizeof(std::time_t)
+      + m_inodes.capacity() * sizeof(boost::uint64_t);
+  }
+
+} // namespace filesystem
+} // namespace boost
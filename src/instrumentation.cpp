@@ -0,0 +1,381 @@
+//  instrumentation.cpp  ---------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+// define BOOST_FILESYSTEM_SOURCE so that <boost/filesystem/config.hpp> knows
+// the library is being built (possibly exporting rather than importing code)
+#define BOOST_FILESYSTEM_SOURCE
+
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+# define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include "instrumentation.hpp"
+#include "work_queue.hpp"
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#ifdef BOOST_FILESYSTEM_INSTRUMENTATION
+# include <atomic>
+# include <exception>
+#endif
+
+namespace instr = boost::filesystem::instrumentation;
+
+namespace
+{
+  const char* const names[instr::operation_count] =
+  {
+    "status",
+    "symlink_status",
+    "file_size",
+    "directory_iterator_construct",
+    "directory_iterator_increment",
+    "directory_cursor_open",
+    "directory_cursor_increment",
+    "copy_file",
+    "copy_directory",
+    "create_directory",
+    "create_directories",
+    "create_symlink",
+    "remove",
+    "remove_all",
+    "remove_all_subtree",
+    "rename",
+    "resize_file",
+    "move",
+    "bulk_copy_file",
+    "bulk_create_directories",
+    "bulk_remove_all",
+    "bulk_status"
+  };
+
+#ifdef BOOST_FILESYSTEM_INSTRUMENTATION
+
+  //  Relaxed atomics throughout: each count is exact, but counts are not updated together
+  struct counters
+  {
+    std::atomic<boost::uint64_t>  calls;
+    std::atomic<boost::uint64_t>  syscalls;
+    std::atomic<boost::uint64_t>  bytes;
+    std::atomic<boost::uint64_t>  errors;
+    std::atomic<boost::uint64_t>  total_ns;
+    std::atomic<boost::uint64_t>  max_ns;
+    std::atomic<boost::uint64_t>  latency[instr::latency_buckets];
+  };
+
+  counters table[instr::operation_count];  // zero initialized, being static
+  std::atomic<instr::observer*> current_observer(0);
+
+  std::atomic<unsigned> sample_every(1);
+  std::atomic<unsigned> full_depth(1);
+  std::atomic<unsigned> threads_seen(0);
+  thread_local unsigned thread_number = 0;
+  thread_local unsigned sample_count = 0;
+
+  const std::memory_order relaxed = std::memory_order_relaxed;
+
+  std::size_t bucket(boost::uint64_t ns)
+  {
+    std::size_t b = 0;
+    for (; ns != 0 && b < instr::latency_buckets - 1; ns >>= 1)
+      ++b;
+    return b;
+  }
+
+#endif
+}  // unnamed namespace
+
+namespace boost
+{
+namespace filesystem
+{
+
+#ifdef BOOST_FILESYSTEM_INSTRUMENTATION
+
+namespace detail
+{
+  thread_local probe* probe::current = 0;
+  std::atomic<instrumentation::tracer*> probe::installed_tracer(0);
+
+  int probe::uncaught_exceptions() BOOST_NOEXCEPT
+  {
+#   if defined(__cpp_lib_uncaught_exceptions)
+    return std::uncaught_exceptions();
+#   else
+    return std::uncaught_exception() ? 1 : 0;
+#   endif
+  }
+
+  void probe::begin_trace(instrumentation::tracer* t)
+  {
+    if (m_outer != 0 && m_outer->m_tracer == 0)
+      return;  // an untraced call's calls are not traced either
+    unsigned depth = full_depth.load(relaxed);
+    if (m_depth >= depth && (m_outer == 0 || m_outer->m_depth < depth))
+    {
+      //  the root of a subtree below the full levels; the rest are kept with it
+      unsigned every = sample_every.load(relaxed);
+      if (every > 1 && ++sample_count % every != 0)
+        return;
+    }
+    m_tracer = t;
+    t->begin_span(make_span());
+  }
+
+  instrumentation::span probe::make_span() const
+  {
+    if (thread_number == 0)
+      thread_number = threads_seen.fetch_add(1, relaxed) + 1;
+    instrumentation::span s = { m_op, m_path,
+      static_cast<boost::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        m_start.time_since_epoch()).count()), thread_number, m_depth };
+    return s;
+  }
+
+  probe::~probe()
+  {
+    boost::uint64_t ns = static_cast<boost::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_start).count());
+    bool failed = (m_ec != 0 && *m_ec) || uncaught_exceptions() > m_exceptions;
+
+    counters& c = table[m_op];
+    c.calls.fetch_add(1, relaxed);
+    c.syscalls.fetch_add(m_syscalls, relaxed);
+    c.bytes.fetch_add(m_bytes, relaxed);
+    if (failed)
+      c.errors.fetch_add(1, relaxed);
+    c.total_ns.fetch_add(ns, relaxed);
+    for (boost::uint64_t max = c.max_ns.load(relaxed);
+      ns > max && !c.max_ns.compare_exchange_weak(max, ns, relaxed);) {}
+    c.latency[bucket(ns)].fetch_add(1, relaxed);
+
+    current = m_outer;
+    if (m_outer)
+    {
+      m_outer->m_syscalls += m_syscalls;
+      m_outer->m_bytes += m_bytes;
+    }
+
+    instrumentation::operation_record r
+      = { m_op, m_path, ns, m_syscalls, m_bytes, failed };
+    if (instrumentation::observer* o = current_observer.load(std::memory_order_acquire))
+      o->operation_completed(r);
+    if (m_tracer)
+      m_tracer->end_span(make_span(), r);
+  }
+}  // namespace detail
+
+#endif  // BOOST_FILESYSTEM_INSTRUMENTATION
+
+namespace instrumentation
+{
+  BOOST_FILESYSTEM_DECL const char* operation_name(operation op) BOOST_NOEXCEPT
+  {
+    return op >= 0 && op < operation_count ? names[op] : "";
+  }
+
+  BOOST_FILESYSTEM_DECL bool enabled() BOOST_NOEXCEPT
+  {
+#   ifdef BOOST_FILESYSTEM_INSTRUMENTATION
+    return true;
+#   else
+    return false;
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL void take_snapshot(snapshot& s) BOOST_NOEXCEPT
+  {
+    std::memset(&s, 0, sizeof(s));
+#   ifdef BOOST_FILESYSTEM_INSTRUMENTATION
+    for (std::size_t i = 0; i < operation_count; ++i)
+    {
+      const counters& c = table[i];
+      operation_stats& stats = s.operations[i];
+      stats.calls = c.calls.load(relaxed);
+      stats.syscalls = c.syscalls.load(relaxed);
+      stats.bytes = c.bytes.load(relaxed);
+      stats.errors = c.errors.load(relaxed);
+      stats.total_ns = c.total_ns.load(relaxed);
+      stats.max_ns = c.max_ns.load(relaxed);
+      for (std::size_t b = 0; b < latency_buckets; ++b)
+        stats.latency[b] = c.latency[b].load(relaxed);
+    }
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL void reset() BOOST_NOEXCEPT
+  {
+#   ifdef BOOST_FILESYSTEM_INSTRUMENTATION
+    for (std::size_t i = 0; i < operation_count; ++i)
+    {
+      counters& c = table[i];
+      c.calls.store(0, relaxed);
+      c.syscalls.store(0, relaxed);
+      c.bytes.store(0, relaxed);
+      c.errors.store(0, relaxed);
+      c.total_ns.store(0, relaxed);
+      c.max_ns.store(0, relaxed);
+      for (std::size_t b = 0; b < latency_buckets; ++b)
+        c.latency[b].store(0, relaxed);
+    }
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL observer* set_observer(observer* o) BOOST_NOEXCEPT
+  {
+#   ifdef BOOST_FILESYSTEM_INSTRUMENTATION
+    return current_observer.exchange(o, std::memory_order_acq_rel);
+#   else
+    (void)o;
+    return 0;  // there is nothing to observe
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL tracer* set_tracer(tracer* t,
+    const trace_options& options) BOOST_NOEXCEPT
+  {
+#   ifdef BOOST_FILESYSTEM_INSTRUMENTATION
+    sample_every.store(options.sample_every, relaxed);
+    full_depth.store(options.full_depth, relaxed);
+    return detail::probe::installed_tracer.exchange(t, std::memory_order_acq_rel);
+#   else
+    (void)t;
+    (void)options;
+    return 0;
+#   endif
+  }
+
+  //  chrome_trace_writer  -------------------------------------------------------------//
+
+  struct chrome_trace_writer::impl
+  {
+    explicit impl(std::ostream& stream)
+      : os(stream), events(0), epoch(0), closed(false) {}
+
+    std::ostream&               os;
+    boost::uint64_t             events;
+    boost::uint64_t             epoch;   // start_ns of the first span, written as 0
+    bool                        closed;
+    std::string                 event;   // formatted here, then written in one piece
+    detail::worker_mutex        mutex;
+
+    void append(boost::uint64_t n)
+    {
+      char digits[24];
+      char* p = digits + sizeof(digits);
+      do { *--p = static_cast<char>('0' + n % 10); } while ((n /= 10) != 0);
+      event.append(p, digits + sizeof(digits));
+    }
+
+    //  microseconds since the epoch, to the nanosecond
+    void append_timestamp(boost::uint64_t ns)
+    {
+      if (ns < epoch)  // another thread's span began first, but was written later
+      {
+        event += '-';
+        ns = epoch - ns;
+      }
+      else
+        ns -= epoch;
+      append(ns / 1000);
+      event += '.';
+      char frac[3] = { char('0' + ns / 100 % 10), char('0' + ns / 10 % 10),
+        char('0' + ns % 10) };
+      event.append(frac, 3);
+    }
+
+    void append_quoted(const std::string& s)
+    {
+      static const char hex[] = "0123456789abcdef";
+      event += '"';
+      for (std::string::size_type i = 0; i < s.size(); ++i)
+      {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == '"' || c == '\\')
+          { event += '\\'; event += static_cast<char>(c); }
+        else if (c < 0x20)
+          { event += "\\u00"; event += hex[c >> 4]; event += hex[c & 0xf]; }
+        else
+          event += static_cast<char>(c);
+      }
+      event += '"';
+    }
+
+    void begin_event(const span& s, char phase, boost::uint64_t ns)
+    {
+      if (events == 0)
+        epoch = s.start_ns;
+      event.assign(events++ == 0 ? "\n" : ",\n");
+      event += "{\"name\":\"";
+      event += operation_name(s.op);
+      event += "\",\"cat\":\"";
+      event += s.op == copy_file_op || s.op == bulk_copy_file_op ? "data" : "metadata";
+      event += "\",\"ph\":\"";
+      event += phase;
+      event += "\",\"ts\":";
+      append_timestamp(ns);
+      event += ",\"pid\":1,\"tid\":";
+      append(s.thread);
+    }
+  };
+
+  chrome_trace_writer::chrome_trace_writer(std::ostream& os)
+    : m_imp(new impl(os))
+  {
+    m_imp->os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  }
+
+  chrome_trace_writer::~chrome_trace_writer()
+  {
+    close();
+  }
+
+  void chrome_trace_writer::close()
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    if (!m_imp->closed)
+    {
+      m_imp->os << "\n]}\n";
+      m_imp->os.flush();
+      m_imp->closed = true;
+    }
+  }
+
+  void chrome_trace_writer::begin_span(const span& s)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    if (m_imp->closed)
+      return;
+    m_imp->begin_event(s, 'B', s.start_ns);
+    m_imp->event += ",\"args\":{\"path\":";
+    m_imp->append_quoted(s.p != 0 ? s.p->string() : std::string());
+    m_imp->event += "}}";
+    m_imp->os.write(m_imp->event.data(), m_imp->event.size());
+  }
+
+  void chrome_trace_writer::end_span(const span& s, const operation_record& record)
+  {
+    detail::scoped_worker_lock lock(m_imp->mutex);
+    if (m_imp->closed)
+      return;
+    m_imp->begin_event(s, 'E', s.start_ns + record.ns);
+    m_imp->event += ",\"args\":{\"syscalls\":";
+    m_imp->append(record.syscalls);
+    m_imp->event += ",\"bytes\":";
+    m_imp->append(record.bytes);
+    m_imp->event += record.failed ? ",\"failed\":true}}" : ",\"failed\":false}}";
+    m_imp->os.write(m_imp->event.data(), m_imp->event.size());
+  }
+}  // namespace instrumentation
+}  // namespace filesystem
+}  // namespace boost
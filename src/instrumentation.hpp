@@ -0,0 +1,109 @@
+//  filesystem instrumentation.hpp  ----------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  Private header; not part of the library interface.
+//
+//  The probes that feed <boost/filesystem/instrumentation.hpp>. Unless the library is
+//  built with BOOST_FILESYSTEM_INSTRUMENTATION defined, each macro expands to nothing,
+//  or to its argument alone, so instrumented code costs nothing otherwise.
+//
+//    BOOST_FILESYSTEM_PROBE(op, p, ec)  at the top of an operation's body, p pointing to
+//                                       its first path argument, or 0; times the call and
+//                                       counts it as failed if, when it returns, ec holds
+//                                       an error or an exception is propagating
+//    BOOST_FILESYSTEM_SYSCALL(call)     evaluates call, counting one syscall
+//    BOOST_FILESYSTEM_PROBE_BYTES(n)    adds n to the bytes of the innermost probe
+
+#ifndef BOOST_FILESYSTEM_SRC_INSTRUMENTATION_HPP
+#define BOOST_FILESYSTEM_SRC_INSTRUMENTATION_HPP
+
+#include <boost/filesystem/instrumentation.hpp>
+
+#ifdef BOOST_FILESYSTEM_INSTRUMENTATION
+
+# if defined(BOOST_NO_CXX11_HDR_ATOMIC) || defined(BOOST_NO_CXX11_HDR_CHRONO) \
+  || defined(BOOST_NO_CXX11_THREAD_LOCAL)
+#   error BOOST_FILESYSTEM_INSTRUMENTATION requires <atomic>, <chrono>, and thread_local
+# endif
+
+#include <boost/system/error_code.hpp>
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <chrono>
+
+namespace boost
+{
+namespace filesystem
+{
+namespace detail
+{
+  //  Probes nest, as the operations do: a thread's innermost probe is the one that
+  //  counts syscalls, and adds its counts to the probe around it when it completes.
+  //  While a tracer is installed, a probe chosen by begin_trace() is also a span.
+  class probe : boost::noncopyable
+  {
+  public:
+    probe(instrumentation::operation op, const path* p, const system::error_code* ec)
+      : m_op(op), m_path(p), m_ec(ec), m_syscalls(0), m_bytes(0),
+        m_outer(current), m_depth(current ? current->m_depth + 1 : 0), m_tracer(0),
+        m_exceptions(uncaught_exceptions()), m_start(std::chrono::steady_clock::now())
+    {
+      current = this;
+      if (instrumentation::tracer* t = installed_tracer.load(std::memory_order_acquire))
+        begin_trace(t);
+    }
+
+    ~probe();  // records the call
+
+    static void syscall() BOOST_NOEXCEPT         { if (current) ++current->m_syscalls; }
+    static void bytes(boost::uint64_t n) BOOST_NOEXCEPT
+                                                 { if (current) current->m_bytes += n; }
+
+    static std::atomic<instrumentation::tracer*> installed_tracer;
+
+  private:
+    instrumentation::operation                m_op;
+    const path*                               m_path;
+    const system::error_code*                 m_ec;
+    boost::uint64_t                           m_syscalls;
+    boost::uint64_t                           m_bytes;
+    probe*                                    m_outer;
+    unsigned                                  m_depth;
+    instrumentation::tracer*                  m_tracer;  // or 0 if not traced
+    int                                       m_exceptions;
+    std::chrono::steady_clock::time_point     m_start;
+
+    static thread_local probe* current;
+
+    static int uncaught_exceptions() BOOST_NOEXCEPT;
+    void begin_trace(instrumentation::tracer* t);
+    instrumentation::span make_span() const;
+  };
+}  // namespace detail
+}  // namespace filesystem
+}  // namespace boost
+
+# define BOOST_FILESYSTEM_PROBE(op, p, ec) \
+    ::boost::filesystem::detail::probe instrumentation_probe( \
+      ::boost::filesystem::instrumentation::op, p, ec)
+# define BOOST_FILESYSTEM_SYSCALL(call) \
+    (::boost::filesystem::detail::probe::syscall(), call)
+# define BOOST_FILESYSTEM_PROBE_BYTES(n) ::boost::filesystem::detail::probe::bytes(n)
+
+#else
+
+# define BOOST_FILESYSTEM_PROBE(op, p, ec) ((void)0)
+# define BOOST_FILESYSTEM_SYSCALL(call) (call)
+# define BOOST_FILESYSTEM_PROBE_BYTES(n) ((void)0)
+
+#endif  // BOOST_FILESYSTEM_INSTRUMENTATION
+
+#endif  // BOOST_FILESYSTEM_SRC_INSTRUMENTATION_HPP
@@ -0,0 +1,388 @@
+//  listing_cache.cpp  -----------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  Each directory has a slot, found through its shard's map. The map and each slot's
+//  state are immutable once published, and are replaced whole with atomic_store under
+//  the shard's lock, which is never held while reading a directory. With C++11 atomics a
+//  hit takes no lock at all: it loads the map and the slot's state with atomic_load, and
+//  costs one stat and two pointer copies. Without them a hit holds the shard's lock
+//  briefly instead. Reading is serialized per slot: a thread that finds the snapshot
+//  stale takes the slot's own lock, and if the slot's generation moved on while it
+//  waited, another thread has just read the directory and its snapshot is used instead.
+
+//  define 64-bit offset macros BEFORE including boost/config.hpp (see ticket #5355)
+#if !(defined(__HP_aCC) && defined(_ILP32) && !defined(_STATVFS_ACPP_PROBLEMS_FIXED))
+#define _FILE_OFFSET_BITS 64 // at worst, these defines may have no effect,
+#endif
+#if !defined(__PGI)
+#define __USE_FILE_OFFSET64 // but that is harmless on Windows and on POSIX
+#else
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// define BOOST_FILESYSTEM_SOURCE so that <boost/filesystem/config.hpp> knows
+// the library is being built (possibly exporting rather than importing code)
+#define BOOST_FILESYSTEM_SOURCE
+
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+# define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem/listing_cache.hpp>
+#include <boost/filesystem/backend.hpp>
+#include <boost/scoped_array.hpp>
+#include <cerrno>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+#include "path_hash.hpp"
+#include "work_queue.hpp"
+
+#ifdef BOOST_WINDOWS_API
+# include <windows.h>
+# include "windows_file_time.hpp"
+#else
+# include <sys/types.h>
+# include <sys/stat.h>
+#endif
+
+namespace fs = boost::filesystem;
+
+using boost::filesystem::path;
+using boost::filesystem::file_status;
+using boost::system::error_code;
+
+namespace
+{
+  //  What list() compares to decide whether a snapshot still describes a directory
+  struct directory_identity
+  {
+    directory_identity() : device(0), inode(0), mtime(0), mtime_ns(0) {}
+
+    bool operator==(const directory_identity& other) const
+    {
+      return device == other.device && inode == other.inode && mtime == other.mtime
+        && mtime_ns == other.mtime_ns;
+    }
+
+    boost::uint64_t  device;
+    boost::uint64_t  inode;
+    std::time_t      mtime;
+    long             mtime_ns;  // 0 where the system does not report it
+  };
+
+  bool identify(const path& p, directory_identity& id, error_code& ec)
+  {
+#   ifdef BOOST_WINDOWS_API
+    HANDLE h = ::CreateFileW(p.c_str(), FILE_READ_ATTRIBUTES,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, 0, OPEN_EXISTING,
+      FILE_FLAG_BACKUP_SEMANTICS, 0);
+    if (h == INVALID_HANDLE_VALUE)
+    {
+      ec.assign(::GetLastError(), boost::system::system_category());
+      return false;
+    }
+    BY_HANDLE_FILE_INFORMATION info;
+    BOOL ok = ::GetFileInformationByHandle(h, &info);
+    DWORD err = ok ? 0 : ::GetLastError();
+    ::CloseHandle(h);
+    if (!ok)
+    {
+      ec.assign(err, boost::system::system_category());
+      return false;
+    }
+    if ((info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+    {
+      ec.assign(ERROR_DIRECTORY, boost::system::system_category());
+      return false;
+    }
+    id.device = info.dwVolumeSerialNumber;
+    id.inode = (static_cast<boost::uint64_t>(info.nFileIndexHigh) << 32)
+      | info.nFileIndexLow;
+    id.mtime = fs::detail::filetime_to_time_t(info.ftLastWriteTime, &id.mtime_ns);
+#   else
+    struct stat st;
+    if (::stat(p.c_str(), &st) != 0)
+    {
+      ec.assign(errno, boost::system::system_category());
+      return false;
+    }
+    if (!S_ISDIR(st.st_mode))
+    {
+      ec.assign(ENOTDIR, boost::system::system_category());
+      return false;
+    }
+    id.device = static_cast<boost::uint64_t>(st.st_dev);
+    id.inode = static_cast<boost::uint64_t>(st.st_ino);
+    id.mtime = st.st_mtime;
+#   if defined(__linux__)
+    id.mtime_ns = st.st_mtim.tv_nsec;
+#   elif defined(__APPLE__)
+    id.mtime_ns = st.st_mtimespec.tv_nsec;
+#   endif
+#   endif
+    ec.clear();
+    return true;
+  }
+
+  //  Reads every entry of p, with both statuses, from the native file system
+  fs::directory_snapshot_ptr read_directory(const path& p, error_code& ec)
+  {
+    fs::backend& native = fs::native_backend();
+    boost::scoped_ptr<fs::backend_directory> dir(native.open_directory(p, ec));
+    if (!dir)
+      return fs::directory_snapshot_ptr();
+    std::vector<fs::directory_entry> entries;
+    path name;
+    file_status s, symlink_s;
+    while (dir->read(name, s, symlink_s, ec))
+    {
+      path entry_path(p / name);
+      error_code ignored;  // a failed status is recorded as such, as the entry's own
+      if (!fs::status_known(symlink_s))
+        symlink_s = native.symlink_status(entry_path, ignored);
+      if (!fs::status_known(s))
+        s = fs::is_symlink(symlink_s) ? native.status(entry_path, ignored) : symlink_s;
+      entries.push_back(fs::directory_entry(entry_path, s, symlink_s));
+    }
+    if (ec)
+      return fs::directory_snapshot_ptr();
+    return fs::directory_snapshot_ptr(new fs::directory_snapshot(p, entries));
+  }
+
+#ifdef BOOST_FILESYSTEM_WORKER_THREADS
+# define BOOST_FILESYSTEM_LOCK_FREE_HITS
+  typedef std::atomic<boost::uint64_t> hit_count;  // also written by unlocked hits
+#else
+  typedef boost::uint64_t hit_count;
+#endif
+
+  //  A snapshot and what it was read as, replaced whole when the directory is read again
+  struct listing_state
+  {
+    listing_state(const fs::directory_snapshot_ptr& s, const directory_identity& i,
+      bool t, boost::uint64_t g) : snapshot(s), id(i), trusted(t), generation(g) {}
+
+    fs::directory_snapshot_ptr  snapshot;
+    directory_identity          id;           // as of just before snapshot was read
+    bool                        trusted;      // the directory was not written that second
+    boost::uint64_t             generation;   // of snapshots
+  };
+
+  typedef boost::shared_ptr<const listing_state> state_ptr;
+
+  struct listing_slot
+  {
+    listing_slot() : last_listed(0) {}
+
+    fs::detail::worker_mutex  reading;
+    state_ptr                 state;        // or 0 until first read
+    hit_count                 last_listed;  // by the shard's clock
+  };
+
+  typedef boost::shared_ptr<listing_slot> slot_ptr;
+  typedef std::map<path::string_type, slot_ptr> slot_map;
+  typedef boost::shared_ptr<const slot_map> slot_map_ptr;
+
+  struct listing_shard
+  {
+    listing_shard()
+      : slots(new slot_map), clock(0), hits(0), shared(0), misses(0), invalidations(0),
+        evictions(0) {}
+
+    //  Publishes a changed copy of slots; the lock must be held
+    void publish(const slot_map_ptr& changed) { boost::atomic_store(&slots, changed); }
+
+    fs::detail::worker_mutex  mutex;
+    slot_map_ptr              slots;
+    hit_count                 clock;  // counts list() calls, for last_listed
+    hit_count                 hits;
+    boost::uintmax_t          shared;
+    boost::uintmax_t          misses;
+    boost::uintmax_t          invalidations;
+    boost::uintmax_t          evictions;
+  };
+
+}  // unnamed namespace
+
+namespace boost
+{
+namespace filesystem
+{
+  struct listing_cache::impl
+  {
+    impl(std::size_t max_directories, unsigned count)
+      : shard_count(count == 0 ? 1 : count),
+        shard_capacity(max_directories / shard_count == 0
+          ? 1 : max_directories / shard_count),
+        shards(new listing_shard[shard_count]) {}
+
+    unsigned                           shard_count;
+    std::size_t                        shard_capacity;
+    boost::scoped_array<listing_shard> shards;
+
+    listing_shard& shard(const path::string_type& key)
+    {
+      return shards[detail::path_hash(key) % shard_count];
+    }
+
+    void make_room(listing_shard& sh, slot_map& slots)
+    {
+      slot_map::iterator oldest = slots.begin();
+      for (slot_map::iterator it = slots.begin(); it != slots.end(); ++it)
+        if (it->second->last_listed < oldest->second->last_listed)
+          oldest = it;
+      slots.erase(oldest);
+      ++sh.evictions;
+    }
+  };
+
+  listing_cache::listing_cache(std::size_t max_directories, unsigned shards)
+    : m_imp(new impl(max_directories, shards)) {}
+
+  listing_cache::~listing_cache() {}
+
+  directory_snapshot_ptr listing_cache::list(const path& p)
+  {
+    system::error_code ec;
+    directory_snapshot_ptr result(list(p, ec));
+    if (ec)
+      BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::listing_cache::list",
+        p, ec));
+    return result;
+  }
+
+  directory_snapshot_ptr listing_cache::list(const path& p, system::error_code& ec)
+  {
+    //  a directory written before this second began cannot change without its last
+    //  write time changing too
+    std::time_t started = std::time(0);
+    directory_identity id;
+    if (!identify(p, id, ec))
+      return directory_snapshot_ptr();
+
+    listing_shard& sh = m_imp->shard(p.native());
+#   ifdef BOOST_FILESYSTEM_LOCK_FREE_HITS
+    {
+      slot_map_ptr slots(boost::atomic_load(&sh.slots));
+      slot_map::const_iterator it = slots->find(p.native());
+      if (it != slots->end())
+      {
+        state_ptr state(boost::atomic_load(&it->second->state));
+        if (state && state->trusted && state->id == id)
+        {
+          it->second->last_listed = ++sh.clock;
+          ++sh.hits;
+          return state->snapshot;
+        }
+      }
+    }
+#   endif
+
+    slot_ptr slot;
+    boost::uint64_t generation = 0;
+    {
+      detail::scoped_worker_lock lock(sh.mutex);
+      slot_map::const_iterator it = sh.slots->find(p.native());
+      if (it == sh.slots->end())
+      {
+        boost::shared_ptr<slot_map> changed(new slot_map(*sh.slots));
+        if (changed->size() >= m_imp->shard_capacity)
+          m_imp->make_room(sh, *changed);
+        it = changed->insert(slot_map::value_type(p.native(),
+          slot_ptr(new listing_slot))).first;
+        sh.publish(changed);
+      }
+      slot = it->second;
+      slot->last_listed = ++sh.clock;
+      state_ptr state(boost::atomic_load(&slot->state));
+      if (state && state->trusted && state->id == id)
+      {
+        ++sh.hits;
+        return state->snapshot;
+      }
+      if (state)
+        generation = state->generation;
+    }
+
+    detail::scoped_worker_lock reading(slot->reading);
+    {
+      state_ptr state(boost::atomic_load(&slot->state));
+      if (state && state->generation != generation && state->id == id)
+      {
+        detail::scoped_worker_lock lock(sh.mutex);
+        ++sh.shared;
+        return state->snapshot;
+      }
+    }
+    directory_snapshot_ptr snapshot(read_directory(p, ec));
+    if (!snapshot)
+      return snapshot;
+    detail::scoped_worker_lock lock(sh.mutex);
+    boost::atomic_store(&slot->state, state_ptr(new listing_state(snapshot, id,
+      id.mtime < started, generation + 1)));
+    ++sh.misses;
+    return snapshot;
+  }
+
+  void listing_cache::invalidate(const path& p)
+  {
+    listing_shard& sh = m_imp->shard(p.native());
+    detail::scoped_worker_lock lock(sh.mutex);
+    if (sh.slots->find(p.native()) == sh.slots->end())
+      return;
+    boost::shared_ptr<slot_map> changed(new slot_map(*sh.slots));
+    changed->erase(p.native());
+    sh.publish(changed);
+    ++sh.invalidations;
+  }
+
+  void listing_cache::clear()
+  {
+    for (unsigned i = 0; i < m_imp->shard_count; ++i)
+    {
+      listing_shard& sh = m_imp->shards[i];
+      detail::scoped_worker_lock lock(sh.mutex);
+      sh.invalidations += sh.slots->size();
+      sh.publish(slot_map_ptr(new slot_map));
+    }
+  }
+
+  listing_cache_statistics listing_cache::statistics() const
+  {
+    listing_cache_statistics result;
+    for (unsigned i = 0; i < m_imp->shard_count; ++i)
+    {
+      listing_shard& sh = m_imp->shards[i];
+      detail::scoped_worker_lock lock(sh.mutex);
+      result.hits += sh.hits;
+      result.shared += sh.shared;
+      result.misses += sh.misses;
+      result.invalidations += sh.invalidations;
+      result.evictions += sh.evictions;
+      result.entries += sh.slots->size();
+    }
+    return result;
+  }
+
+  void listing_cache::reset_statistics()
+  {
+    for (unsigned i = 0; i < m_imp->shard_count; ++i)
+    {
+      listing_shard& sh = m_imp->shards[i];
+      detail::scoped_worker_lock lock(sh.mutex);
+      sh.hits = sh.shared = sh.misses = sh.invalidations = sh.evictions = 0;
+    }
+  }
+
+} // namespace filesystem
+} // namespace boost
@@ -42,6 +42,7 @@
 #endif
 
 #include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/backend.hpp>
 #include <boost/scoped_array.hpp>
 #include <boost/detail/workaround.hpp>
 #include <vector> 
@@ -52,6 +53,9 @@
 # include <stdio.h>
 #endif
 #include <cerrno>
+#include <algorithm>
+#include "work_queue.hpp"
+#include "instrumentation.hpp"
 
 #ifdef BOOST_FILEYSTEM_INCLUDE_IOSTREAM
 # include <iostream>
@@ -93,6 +97,14 @@ using std::wstring;
 #   include <fcntl.h>
 #   include <utime.h>
 #   include "limits.h"
+#   if defined(__linux__)
+#     include <sys/sendfile.h>
+#     include <sys/syscall.h>
+#     include <linux/falloc.h>
+#     include <linux/fs.h>
+#     include <linux/fiemap.h>
+#     include <sys/ioctl.h>
+#   endif
 
 # else // BOOST_WINDOW_API
 
@@ -196,6 +208,19 @@ inline std::wstring wgetenv(const wchar_t* name)
 #   define BOOST_FILESYSTEM_STATUS_CACHE
 # endif
 
+//  BOOST_FILESYSTEM_AT_FUNCTIONS enables the descriptor relative (openat, unlinkat,
+//  fdopendir) removal of the source tree by move(). The macros tested come from fcntl.h.
+# if defined(BOOST_POSIX_API) && defined(AT_FDCWD) && defined(AT_REMOVEDIR)\
+  && defined(O_DIRECTORY) && defined(O_NOFOLLOW)
+#   define BOOST_FILESYSTEM_AT_FUNCTIONS
+# endif
+
+//  BOOST_FILESYSTEM_GETDENTS enables reading of directory_cursor entries by getdents64()
+//  into the cursor's buffer, instead of through a heap allocated DIR stream.
+# if defined(__linux__) && defined(SYS_getdents64) && defined(O_DIRECTORY)
+#   define BOOST_FILESYSTEM_GETDENTS
+# endif
+
 //  POSIX/Windows macros  ----------------------------------------------------//
 
 //  Portions of the POSIX and Windows API's are very similar, except for name,
@@ -212,19 +237,25 @@ typedef int err_t;
 //  POSIX uses a 0 return to indicate success
 #   define BOOST_ERRNO    errno 
 #   define BOOST_SET_CURRENT_DIRECTORY(P)(::chdir(P)== 0)
-#   define BOOST_CREATE_DIRECTORY(P)(::mkdir(P, S_IRWXU|S_IRWXG|S_IRWXO)== 0)
+#   define BOOST_CREATE_DIRECTORY(P)\
+         (BOOST_FILESYSTEM_SYSCALL(::mkdir(P, S_IRWXU|S_IRWXG|S_IRWXO))== 0)
 #   define BOOST_CREATE_HARD_LINK(F,T)(::link(T, F)== 0)
-#   define BOOST_CREATE_SYMBOLIC_LINK(F,T,Flag)(::symlink(T, F)== 0)
-#   define BOOST_REMOVE_DIRECTORY(P)(::rmdir(P)== 0)
-#   define BOOST_DELETE_FILE(P)(::unlink(P)== 0)
-#   define BOOST_COPY_DIRECTORY(F,T)(!(::stat(from.c_str(), &from_stat)!= 0\
-         || ::mkdir(to.c_str(),from_stat.st_mode)!= 0))
-#   define BOOST_COPY_FILE(F,T,FailIfExistsBool)copy_file_api(F, T, FailIfExistsBool)
-#   define BOOST_MOVE_FILE(OLD,NEW)(::rename(OLD, NEW)== 0)
-#   define BOOST_RESIZE_FILE(P,SZ)(::truncate(P, SZ)== 0)
+#   define BOOST_CREATE_SYMBOLIC_LINK(F,T,Flag)\
+         (BOOST_FILESYSTEM_SYSCALL(::symlink(T, F))== 0)
+#   define BOOST_REMOVE_DIRECTORY(P)(BOOST_FILESYSTEM_SYSCALL(::rmdir(P))== 0)
+#   define BOOST_DELETE_FILE(P)(BOOST_FILESYSTEM_SYSCALL(::unlink(P))== 0)
+#   define BOOST_COPY_DIRECTORY(F,T)\
+         (!(BOOST_FILESYSTEM_SYSCALL(::stat(from.c_str(), &from_stat))!= 0\
+         || BOOST_FILESYSTEM_SYSCALL(::mkdir(to.c_str(),from_stat.st_mode))!= 0))
+#   define BOOST_COPY_FILE(F,T,FailIfExistsBool,PreallocateBool)\
+         copy_file_api(F, T, FailIfExistsBool, PreallocateBool)
+#   define BOOST_MOVE_FILE(OLD,NEW)(BOOST_FILESYSTEM_SYSCALL(::rename(OLD, NEW))== 0)
+#   define BOOST_RESIZE_FILE(P,SZ)(BOOST_FILESYSTEM_SYSCALL(::truncate(P, SZ))== 0)
 
 #   define BOOST_ERROR_NOT_SUPPORTED ENOSYS
 #   define BOOST_ERROR_ALREADY_EXISTS EEXIST
+#   define BOOST_ERROR_NOT_SAME_DEVICE EXDEV
+#   define BOOST_ERROR_CANCELLED ECANCELED
 
 # else  // BOOST_WINDOWS_API
 
@@ -233,19 +264,27 @@ typedef DWORD err_t;
 //  Windows uses a non-0 return to indicate success
 #   define BOOST_ERRNO    ::GetLastError()
 #   define BOOST_SET_CURRENT_DIRECTORY(P)(::SetCurrentDirectoryW(P)!= 0)
-#   define BOOST_CREATE_DIRECTORY(P)(::CreateDirectoryW(P, 0)!= 0)
+#   define BOOST_CREATE_DIRECTORY(P)\
+         (BOOST_FILESYSTEM_SYSCALL(::CreateDirectoryW(P, 0))!= 0)
 #   define BOOST_CREATE_HARD_LINK(F,T)(create_hard_link_api(F, T, 0)!= 0)
-#   define BOOST_CREATE_SYMBOLIC_LINK(F,T,Flag)(create_symbolic_link_api(F, T, Flag)!= 0)
-#   define BOOST_REMOVE_DIRECTORY(P)(::RemoveDirectoryW(P)!= 0)
-#   define BOOST_DELETE_FILE(P)(::DeleteFileW(P)!= 0)
-#   define BOOST_COPY_DIRECTORY(F,T)(::CreateDirectoryExW(F, T, 0)!= 0)
-#   define BOOST_COPY_FILE(F,T,FailIfExistsBool)(::CopyFileW(F, T, FailIfExistsBool)!= 0)
-#   define BOOST_MOVE_FILE(OLD,NEW)(::MoveFileExW(OLD, NEW, MOVEFILE_REPLACE_EXISTING|MOVEFILE_COPY_ALLOWED)!= 0)
-#   define BOOST_RESIZE_FILE(P,SZ)(resize_file_api(P, SZ)!= 0)
+#   define BOOST_CREATE_SYMBOLIC_LINK(F,T,Flag)\
+         (BOOST_FILESYSTEM_SYSCALL(create_symbolic_link_api(F, T, Flag))!= 0)
+#   define BOOST_REMOVE_DIRECTORY(P)(BOOST_FILESYSTEM_SYSCALL(::RemoveDirectoryW(P))!= 0)
+#   define BOOST_DELETE_FILE(P)(BOOST_FILESYSTEM_SYSCALL(::DeleteFileW(P))!= 0)
+#   define BOOST_COPY_DIRECTORY(F,T)\
+         (BOOST_FILESYSTEM_SYSCALL(::CreateDirectoryExW(F, T, 0))!= 0)
+//  CopyFileW() allocates as it sees fit
+#   define BOOST_COPY_FILE(F,T,FailIfExistsBool,PreallocateBool)\
+         (BOOST_FILESYSTEM_SYSCALL(::CopyFileW(F, T, FailIfExistsBool))!= 0)
+#   define BOOST_MOVE_FILE(OLD,NEW)(BOOST_FILESYSTEM_SYSCALL(::MoveFileExW(OLD, NEW,\
+         MOVEFILE_REPLACE_EXISTING|MOVEFILE_COPY_ALLOWED))!= 0)
+#   define BOOST_RESIZE_FILE(P,SZ)(BOOST_FILESYSTEM_SYSCALL(resize_file_api(P, SZ))!= 0)
 #   define BOOST_READ_SYMLINK(P,T)
 
 #   define BOOST_ERROR_ALREADY_EXISTS ERROR_ALREADY_EXISTS
 #   define BOOST_ERROR_NOT_SUPPORTED ERROR_NOT_SUPPORTED
+#   define BOOST_ERROR_NOT_SAME_DEVICE ERROR_NOT_SAME_DEVICE
+#   define BOOST_ERROR_CANCELLED ERROR_CANCELLED
 
 # endif
 
@@ -327,6 +366,63 @@ namespace
     return error_num != 0;
   }
 
+  //  backend helpers  -----------------------------------------------------------------//
+
+  //  The backend the core operations dispatch through, or 0 for the native file system,
+  //  when they make the system calls themselves
+  fs::backend* installed_backend = 0;
+
+  //  Reports the error a backend returned, as error() reports an error number
+  bool backend_error(const error_code& result, const path& p, error_code* ec,
+    const char* message)
+  {
+    if (ec != 0)
+      *ec = result;
+    else if (result)
+      BOOST_FILESYSTEM_THROW(filesystem_error(message, p, result));
+    return result ? true : false;
+  }
+
+  bool backend_error(const error_code& result, const path& p1, const path& p2,
+    error_code* ec, const char* message)
+  {
+    if (ec != 0)
+      *ec = result;
+    else if (result)
+      BOOST_FILESYSTEM_THROW(filesystem_error(message, p1, p2, result));
+    return result ? true : false;
+  }
+
+  //  status() and symlink_status() throw only for status_error, as the native ones do
+  fs::file_status backend_status(const fs::file_status& s, const error_code& result,
+    const path& p, error_code* ec)
+  {
+    if (ec != 0)
+      *ec = result;
+    else if (s.type() == fs::status_error)
+      BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::status", p, result));
+    return s;
+  }
+
+  //  Tells the installed backend of a change an operation made without it
+  void backend_changed(const path& p, bool subtree)
+  {
+    if (installed_backend)
+      installed_backend->changed(p, subtree);
+  }
+
+  //  Whether an operation with no backend form may make system calls on p, as it may
+  //  unless the installed backend's files are not the native file system's. Reports
+  //  operation_not_supported if not.
+  bool native_files(const path& p, error_code* ec, const char* message)
+  {
+    if (installed_backend == 0 || installed_backend->native())
+      return true;
+    backend_error(error_code(boost::system::errc::operation_not_supported,
+      boost::system::generic_category()), p, ec, message);
+    return false;
+  }
+
   //  general helpers  -----------------------------------------------------------------//
 
   bool is_empty_directory(const path& p, error_code* ec)
@@ -351,8 +447,8 @@ namespace
       || not_found_error(BOOST_ERRNO);  // mitigate possible file system race. See #11166
   }
   
-  // called by remove and remove_all_aux
-  bool remove_file_or_directory(const path& p, fs::file_type type, error_code* ec)
+  // called by remove_file_or_directory and the native backend
+  bool native_remove_file_or_directory(const path& p, fs::file_type type, error_code* ec)
     // return true if file removed, false if not removed
   {
     if (type == fs::file_not_found)
@@ -380,12 +476,23 @@ namespace
     return true;
   }
 
+  // called by remove and remove_all_aux
+  bool remove_file_or_directory(const path& p, fs::file_type type, error_code* ec)
+  {
+    if (installed_backend == 0 || type == fs::file_not_found)
+      return native_remove_file_or_directory(p, type, ec);
+    error_code result;
+    bool removed = installed_backend->remove(p, result);
+    return !backend_error(result, p, ec, "boost::filesystem::remove") && removed;
+  }
+
   boost::uintmax_t remove_all_aux(const path& p, fs::file_type type,
     error_code* ec)
   {
     boost::uintmax_t count = 1;
     if (type == fs::directory_file)  // but not a directory symlink
     {
+      BOOST_FILESYSTEM_PROBE(remove_all_subtree_op, &p, ec);
       fs::directory_iterator itr;
       if (ec != 0)
       {
@@ -404,6 +511,8 @@ namespace
         if (ec != 0 && *ec)
           return count;
       }
+      remove_file_or_directory(p, type, ec);
+      return count;
     }
     remove_file_or_directory(p, type, ec);
     return count;
@@ -424,42 +533,108 @@ namespace
     return errno == ENOENT || errno == ENOTDIR;
   }
 
-  bool // true if ok
-  copy_file_api(const std::string& from_p,
-    const std::string& to_p, bool fail_if_exists)
+  //  Returns 0 or an errno value. Linux fallocate() supports every option; elsewhere
+  //  posix_fallocate() supports only the default, which extends the file if need be.
+  int preallocate_api(int fd, boost::uintmax_t offset, boost::uintmax_t length,
+    unsigned int options)
   {
-    const std::size_t buf_sz = 32768;
-    boost::scoped_array<char> buf(new char [buf_sz]);
-    int infile=-1, outfile=-1;  // -1 means not open
+    const unsigned int keep_size
+      = static_cast<unsigned int>(fs::preallocate_option::keep_size);
+    const unsigned int punch_hole
+      = static_cast<unsigned int>(fs::preallocate_option::punch_hole);
+    const unsigned int zero_range
+      = static_cast<unsigned int>(fs::preallocate_option::zero_range);
+
+#   if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+    int mode = 0;
+    if (options & keep_size)
+      mode |= FALLOC_FL_KEEP_SIZE;
+#     ifdef FALLOC_FL_PUNCH_HOLE
+    if (options & punch_hole)
+      mode |= FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE;  // the kernel requires both
+#     endif
+#     ifdef FALLOC_FL_ZERO_RANGE
+    if (options & zero_range)
+      mode |= FALLOC_FL_ZERO_RANGE;
+#     endif
+    if ((options & (punch_hole | zero_range)) && mode == 0)
+      return EOPNOTSUPP;  // headers predate the flag
 
-    // bug fixed: code previously did a stat()on the from_file first, but that
-    // introduced a gratuitous race condition; the stat()is now done after the open()
+    int result;
+    while ((result = ::fallocate(fd, mode, offset, length))!= 0 && errno == EINTR) {}
+    if (result == 0)
+      return 0;
+    if (mode != 0 || (errno != EOPNOTSUPP && errno != ENOSYS))
+      return errno;
+    // the file system does not support fallocate(); posix_fallocate() will emulate it
+#   endif
 
-    if ((infile = ::open(from_p.c_str(), O_RDONLY))< 0)
-      { return false; }
+    if (options & (keep_size | punch_hole | zero_range))
+      return EOPNOTSUPP;
+#   if defined(_POSIX_ADVISORY_INFO) && _POSIX_ADVISORY_INFO > 0
+    return ::posix_fallocate(fd, offset, length);  // returns the error, not setting errno
+#   else
+    return BOOST_ERROR_NOT_SUPPORTED;
+#   endif
+  }
 
-    struct stat from_stat;
-    if (::stat(from_p.c_str(), &from_stat)!= 0)
-    { 
-      ::close(infile);
-      return false;
-    }
+  //  Copies the rest of infile to outfile, letting the kernel move the data when it can.
+  //  copy_file_range() keeps the data out of user space entirely and lets file systems
+  //  that support it share extents or copy server side; sendfile() at least avoids the
+  //  user space buffer. Each is abandoned for the next when the kernel or the file system
+  //  reports that it cannot handle these descriptors, or when it copies nothing at all,
+  //  since some pseudo file systems report a zero size for files that are not empty.
+  bool // true if ok, otherwise errno is set
+  copy_file_data(int infile, int outfile, boost::uintmax_t* bytes_copied = 0)
+  {
+    boost::uintmax_t total = 0;
+    ssize_t sz;
+    const std::size_t chunk_sz = std::size_t(1) << 30;
 
-    int oflag = O_CREAT | O_WRONLY | O_TRUNC;
-    if (fail_if_exists)
-      oflag |= O_EXCL;
-    if ((outfile = ::open(to_p.c_str(), oflag, from_stat.st_mode))< 0)
+#   if defined(__linux__)
+#     if defined(__NR_copy_file_range)
+    for (;;)
     {
-      int open_errno = errno;
-      BOOST_ASSERT(infile >= 0);
-      ::close(infile);
-      errno = open_errno;
-      return false;
+      sz = BOOST_FILESYSTEM_SYSCALL(::syscall(__NR_copy_file_range, infile,
+        static_cast<loff_t*>(0), outfile, static_cast<loff_t*>(0), chunk_sz, 0u));
+      if (sz > 0)
+        { total += sz; continue; }
+      if (sz == 0 || errno == ENOSYS || errno == EXDEV || errno == EINVAL
+        || errno == EOPNOTSUPP || errno == EBADF)
+        break;
+      if (errno != EINTR)
+        return false;
+    }
+    if (sz == 0 && total != 0)
+    {
+      BOOST_FILESYSTEM_PROBE_BYTES(total);
+      if (bytes_copied) *bytes_copied = total;
+      return true;
+    }
+#     endif
+    for (;;)
+    {
+      sz = BOOST_FILESYSTEM_SYSCALL(::sendfile(outfile, infile, 0, chunk_sz));
+      if (sz > 0)
+        { total += sz; continue; }
+      if (sz == 0 || errno == ENOSYS || errno == EINVAL)
+        break;
+      if (errno != EINTR)
+        return false;
+    }
+    if (sz == 0 && total != 0)
+    {
+      BOOST_FILESYSTEM_PROBE_BYTES(total);
+      if (bytes_copied) *bytes_copied = total;
+      return true;
     }
+#   endif
 
-    ssize_t sz, sz_read=1, sz_write;
+    const std::size_t buf_sz = 32768;
+    boost::scoped_array<char> buf(new char [buf_sz]);
+    ssize_t sz_read=1, sz_write;
     while (sz_read > 0
-      && (sz_read = ::read(infile, buf.get(), buf_sz)) > 0)
+      && (sz_read = BOOST_FILESYSTEM_SYSCALL(::read(infile, buf.get(), buf_sz))) > 0)
     {
       // Allow for partial writes - see Advanced Unix Programming (2nd Ed.),
       // Marc Rochkind, Addison-Wesley, 2004, page 94
@@ -471,8 +646,8 @@ namespace
           // is that POSIX specifies 0 return only if 3rd arg is 0, and that will never
           // happen due to loop entry and coninuation conditions. BOOST_ASSERT #1 above
           // and #2 below added to verify that analysis.
-        if ((sz = ::write(outfile, buf.get() + sz_write,
-          sz_read - sz_write)) < 0)
+        if ((sz = BOOST_FILESYSTEM_SYSCALL(::write(outfile, buf.get() + sz_write,
+          sz_read - sz_write))) < 0)
         { 
           sz_read = sz; // cause read loop termination
           break;        //  and error reported after closes
@@ -480,16 +655,126 @@ namespace
         BOOST_ASSERT(sz > 0);                  // #2
         sz_write += sz;
       } while (sz_write < sz_read);
+      total += sz_write;
     }
 
-    if (::close(infile)< 0)
-      sz_read = -1;
-    if (::close(outfile)< 0)
-      sz_read = -1;
-
+    BOOST_FILESYSTEM_PROBE_BYTES(total);
+    if (bytes_copied) *bytes_copied = total;
     return sz_read >= 0;
   }
 
+  bool // true if ok
+  copy_file_api(const std::string& from_p,
+    const std::string& to_p, bool fail_if_exists, bool preallocate)
+  {
+    int infile=-1, outfile=-1;  // -1 means not open
+
+    // bug fixed: code previously did a stat()on the from_file first, but that
+    // introduced a gratuitous race condition; the stat()is now done after the open()
+
+    if ((infile = BOOST_FILESYSTEM_SYSCALL(::open(from_p.c_str(), O_RDONLY)))< 0)
+      { return false; }
+
+    struct stat from_stat;
+    if (BOOST_FILESYSTEM_SYSCALL(::fstat(infile, &from_stat))!= 0)
+    { 
+      int stat_errno = errno;
+      ::close(infile);
+      errno = stat_errno;
+      return false;
+    }
+
+    int oflag = O_CREAT | O_WRONLY | O_TRUNC;
+    if (fail_if_exists)
+      oflag |= O_EXCL;
+    if ((outfile = BOOST_FILESYSTEM_SYSCALL(::open(to_p.c_str(), oflag,
+      from_stat.st_mode)))< 0)
+    {
+      int open_errno = errno;
+      BOOST_ASSERT(infile >= 0);
+      ::close(infile);
+      errno = open_errno;
+      return false;
+    }
+
+    //  reserve the space up front, both to avoid fragmentation and so that a lack of
+    //  space is reported before any copying; file systems that cannot are not an error
+    int copy_errno = preallocate && from_stat.st_size > 0
+      ? preallocate_api(outfile, 0, from_stat.st_size, 0) : 0;
+    if (copy_errno == EOPNOTSUPP || copy_errno == ENOSYS || copy_errno == EINVAL)
+      copy_errno = 0;
+    bool ok = copy_errno == 0 && copy_file_data(infile, outfile);
+    if (!ok && copy_errno == 0)
+      copy_errno = errno;
+
+    if (BOOST_FILESYSTEM_SYSCALL(::close(infile))< 0 && ok)
+      { ok = false; copy_errno = errno; }
+    if (BOOST_FILESYSTEM_SYSCALL(::close(outfile))< 0 && ok)
+      { ok = false; copy_errno = errno; }
+
+    errno = copy_errno;
+    return ok;
+  }
+
+  //  renameat2() flags, as in linux/fs.h
+# ifndef RENAME_NOREPLACE
+#   define RENAME_NOREPLACE (1 << 0)
+# endif
+# ifndef RENAME_EXCHANGE
+#   define RENAME_EXCHANGE (1 << 1)
+# endif
+
+  //  Returns 0 or an errno value. Linux renameat2() and Mac OS X renamex_np() do the
+  //  whole job atomically. Without them, no_replace uses link() then unlink(), which is
+  //  just as safe, and as a last resort, for directories and file systems without hard
+  //  links, checks that new_p does not exist before calling rename(). That check can
+  //  race with another process creating new_p. exchange has no fallback.
+  int rename_api(const path& old_p, const path& new_p, unsigned int option)
+  {
+    const bool exchange
+      = option == static_cast<unsigned int>(fs::rename_option::exchange);
+
+#   if defined(__linux__) && defined(__NR_renameat2)
+    if (::syscall(__NR_renameat2, AT_FDCWD, old_p.c_str(), AT_FDCWD, new_p.c_str(),
+      exchange ? RENAME_EXCHANGE : RENAME_NOREPLACE)== 0)
+      return 0;
+    if (errno != ENOSYS && errno != EINVAL)
+      return errno;
+    // the kernel predates renameat2(), or the file system does not support the flag
+#   elif defined(__APPLE__) && defined(RENAME_SWAP) && defined(RENAME_EXCL)
+    if (::renamex_np(old_p.c_str(), new_p.c_str(),
+      exchange ? RENAME_SWAP : RENAME_EXCL)== 0)
+      return 0;
+    if (errno != ENOTSUP && errno != EINVAL)
+      return errno;
+#   endif
+
+    if (exchange)
+      return BOOST_ERROR_NOT_SUPPORTED;
+
+#   ifdef BOOST_FILESYSTEM_AT_FUNCTIONS
+    if (::linkat(AT_FDCWD, old_p.c_str(), AT_FDCWD, new_p.c_str(), 0)== 0)
+#   else
+    if (::link(old_p.c_str(), new_p.c_str())== 0)
+#   endif
+    {
+      if (::unlink(old_p.c_str())== 0)
+        return 0;
+      int err = errno;
+      ::unlink(new_p.c_str());
+      return err;
+    }
+    if (errno != EPERM && errno != EMLINK && errno != ENOTSUP && errno != EOPNOTSUPP)
+      return errno;
+
+    struct stat new_stat;
+    if (::lstat(new_p.c_str(), &new_stat)== 0)
+      return EEXIST;
+    if (errno != ENOENT)
+      return errno;
+    return ::rename(old_p.c_str(), new_p.c_str())== 0 ? 0 : errno;
+  }
+
   inline fs::file_type query_file_type(const path& p, error_code* ec)
   {
     return fs::detail::symlink_status(p, ec).type();
@@ -766,6 +1051,66 @@ namespace
       : fs::regular_file;
   }
 
+  //  Returns 0 or a Windows error value. MoveFileExW() refuses to replace an existing
+  //  file unless asked to, so no_replace is atomic; exchange is not supported.
+  DWORD rename_api(const path& old_p, const path& new_p, unsigned int option)
+  {
+    if (option == static_cast<unsigned int>(fs::rename_option::exchange))
+      return BOOST_ERROR_NOT_SUPPORTED;
+    return ::MoveFileExW(old_p.c_str(), new_p.c_str(), MOVEFILE_COPY_ALLOWED)!= 0
+      ? 0 : BOOST_ERRNO;
+  }
+
+  //  Returns 0 or a Windows error value. punch_hole marks the file sparse so that
+  //  FSCTL_SET_ZERO_DATA deallocates the range rather than writing zeros. Otherwise the
+  //  allocation size is set, which reserves space from the start of the file through
+  //  offset + length; NTFS may release space beyond the end of file when it is closed.
+  DWORD preallocate_api(HANDLE h, boost::uintmax_t offset, boost::uintmax_t length,
+    unsigned int options)
+  {
+    const unsigned int keep_size
+      = static_cast<unsigned int>(fs::preallocate_option::keep_size);
+    const unsigned int punch_hole
+      = static_cast<unsigned int>(fs::preallocate_option::punch_hole);
+    const unsigned int zero_range
+      = static_cast<unsigned int>(fs::preallocate_option::zero_range);
+
+    if (options & (punch_hole | zero_range))
+    {
+      DWORD bytes;
+      if ((options & punch_hole)
+        && !::DeviceIoControl(h, FSCTL_SET_SPARSE, 0, 0, 0, 0, &bytes, 0))
+        return BOOST_ERRNO;
+      FILE_ZERO_DATA_INFORMATION zero_data;
+      zero_data.FileOffset.QuadPart = offset;
+      zero_data.BeyondFinalZero.QuadPart = offset + length;
+      return ::DeviceIoControl(h, FSCTL_SET_ZERO_DATA, &zero_data, sizeof(zero_data),
+        0, 0, &bytes, 0) ? 0 : BOOST_ERRNO;
+    }
+
+#   if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0600
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(h, &size))
+      return BOOST_ERRNO;
+    if (offset + length <= static_cast<boost::uintmax_t>(size.QuadPart))
+      return 0;
+    FILE_ALLOCATION_INFO alloc;
+    alloc.AllocationSize.QuadPart = offset + length;
+    if (!::SetFileInformationByHandle(h, FileAllocationInfo, &alloc, sizeof(alloc)))
+      return BOOST_ERRNO;
+    if (!(options & keep_size))
+    {
+      FILE_END_OF_FILE_INFO eof;
+      eof.EndOfFile.QuadPart = offset + length;
+      if (!::SetFileInformationByHandle(h, FileEndOfFileInfo, &eof, sizeof(eof)))
+        return BOOST_ERRNO;
+    }
+    return 0;
+#   else
+    return BOOST_ERROR_NOT_SUPPORTED;
+#   endif
+  }
+
   BOOL resize_file_api(const wchar_t* p, boost::uintmax_t size)
   {
     handle_wrapper h(CreateFileW(p, GENERIC_WRITE, 0, 0, OPEN_EXISTING,
@@ -802,1528 +1147,3581 @@ namespace
 
 #endif
 
-//#ifdef BOOST_WINDOWS_API
-//
-//
-//  inline bool get_free_disk_space(const std::wstring& ph,
-//    PULARGE_INTEGER avail, PULARGE_INTEGER total, PULARGE_INTEGER free)
-//    { return ::GetDiskFreeSpaceExW(ph.c_str(), avail, total, free)!= 0; }
-//
-//#endif
-
-} // unnamed namespace
-
 //--------------------------------------------------------------------------------------//
 //                                                                                      //
-//                operations functions declared in operations.hpp                       //
-//                            in alphabetic order                                       //
+//                          move helpers (all operating systems)                        //
 //                                                                                      //
 //--------------------------------------------------------------------------------------//
 
-namespace boost
-{
-namespace filesystem
-{
-
-  BOOST_FILESYSTEM_DECL
-  path absolute(const path& p, const path& base)
-  {
-//    if ( p.empty() || p.is_absolute() )
-//      return p;
-//    //  recursively calling absolute is sub-optimal, but is simple
-//    path abs_base(base.is_absolute() ? base : absolute(base));
-//# ifdef BOOST_WINDOWS_API
-//    if (p.has_root_directory())
-//      return abs_base.root_name() / p;
-//    //  !p.has_root_directory
-//    if (p.has_root_name())
-//      return p.root_name()
-//        / abs_base.root_directory() / abs_base.relative_path() / p.relative_path();
-//    //  !p.has_root_name()
-//# endif
-//    return abs_base / p;
-
-    //  recursively calling absolute is sub-optimal, but is sure and simple
-    path abs_base(base.is_absolute() ? base : absolute(base));
+  const char partial_move_suffix[] = ".partial-move";
+  const err_t contents_differ = static_cast<err_t>(-1);  // from compare_file_data()
 
-    //  store expensive to compute values that are needed multiple times
-    path p_root_name (p.root_name());
-    path base_root_name (abs_base.root_name());
-    path p_root_directory (p.root_directory());
+# ifdef BOOST_FILESYSTEM_AT_FUNCTIONS
 
-    if (p.empty())
-      return abs_base;
+  //  Removes name, relative to the directory open as parent_fd, and everything below
+  //  it. Working from descriptors costs one unlinkat() per file rather than a path
+  //  resolution plus a status query, and is not misled if a directory is replaced by a
+  //  symlink partway through. Returns 0 or an errno value.
+  int remove_all_at(int parent_fd, const char* name, bool maybe_file,
+    boost::uintmax_t& count)
+  {
+    int err = EISDIR;
+    if (maybe_file)
+    {
+      if (::unlinkat(parent_fd, name, 0)== 0)
+        { ++count; return 0; }
+      err = errno;
+      if (err != EISDIR && err != EPERM)  // POSIX specifies EPERM for a directory
+        return not_found_error(err) ? 0 : err;
+    }
 
-    if (!p_root_name.empty())  // p.has_root_name()
+    int fd = ::openat(parent_fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+    if (fd < 0)
     {
-      if (p_root_directory.empty())  // !p.has_root_directory()
-        return p_root_name / abs_base.root_directory()
-        / abs_base.relative_path() / p.relative_path();
-      // p is absolute, so fall through to return p at end of block
+      if (errno == ENOTDIR || errno == ELOOP)  // not a directory after all
+        return err;
+      return not_found_error(errno) ? 0 : errno;
+    }
+    DIR* dir = ::fdopendir(fd);
+    if (dir == 0)
+    {
+      err = errno;
+      ::close(fd);
+      return err;
     }
 
-    else if (!p_root_directory.empty())  // p.has_root_directory()
+    err = 0;
+    struct dirent* entry;
+    while (err == 0 && (errno = 0, (entry = ::readdir(dir))!= 0))
     {
-#     ifdef BOOST_POSIX_API
-      // POSIX can have root name it it is a network path
-      if (base_root_name.empty())   // !abs_base.has_root_name()
-        return p;
+      if (entry->d_name[0] == dot && (entry->d_name[1] == 0
+        || (entry->d_name[1] == dot && entry->d_name[2] == 0)))
+        continue;
+#     ifdef BOOST_FILESYSTEM_STATUS_CACHE
+      bool child_maybe_file = entry->d_type != DT_DIR;
+#     else
+      bool child_maybe_file = true;
 #     endif
-      return base_root_name / p;
+      err = remove_all_at(::dirfd(dir), entry->d_name, child_maybe_file, count);
     }
+    if (err == 0 && errno != 0)  // readdir() failed
+      err = errno;
+    ::closedir(dir);
 
-    else
+    if (err == 0)
     {
-      return abs_base / p;
+      if (::unlinkat(parent_fd, name, AT_REMOVEDIR)== 0)
+        ++count;
+      else if (!not_found_error(errno))
+        err = errno;
     }
-
-    return p;  // p.is_absolute() is true
+    return err;
   }
 
-namespace detail
-{
-  BOOST_FILESYSTEM_DECL bool possible_large_file_size_support()
-  {
+# endif
+
 #   ifdef BOOST_POSIX_API
-    struct stat lcl_stat;
-    return sizeof(lcl_stat.st_size)> 4;
+
+  //  Reads the files open as fd1 and fd2 from their current offsets to their ends.
+  //  Returns 0 if they have the same contents, contents_differ if not, or an errno
+  //  value.
+  err_t compare_file_data(int fd1, int fd2)
+  {
+    const std::size_t buf_sz = 32768;
+    boost::scoped_array<char> buf1(new char [buf_sz]);
+    boost::scoped_array<char> buf2(new char [buf_sz]);
+    for (;;)
+    {
+      ssize_t sz1 = BOOST_FILESYSTEM_SYSCALL(::read(fd1, buf1.get(), buf_sz));
+      if (sz1 < 0)
+        return errno;
+      ssize_t sz2 = 0;  // read until as much as sz1, or the end
+      while (sz2 < sz1)
+      {
+        ssize_t sz = BOOST_FILESYSTEM_SYSCALL(::read(fd2, buf2.get() + sz2, sz1 - sz2));
+        if (sz < 0)
+          return errno;
+        if (sz == 0)
+          break;
+        sz2 += sz;
+      }
+      if (sz2 != sz1 || std::memcmp(buf1.get(), buf2.get(), sz1) != 0)
+        return contents_differ;
+      if (sz1 == 0)  // the end of fd1, which must be the end of fd2 too
+        return BOOST_FILESYSTEM_SYSCALL(::read(fd2, buf2.get(), 1)) == 0
+          ? 0 : contents_differ;
+    }
+  }
+
 #   else
-    return true;
-#   endif
+
+  //  Returns 0 if the files at p1 and p2 have the same contents, contents_differ if not,
+  //  or an error value
+  err_t compare_file_data(const path& p1, const path& p2)
+  {
+    handle_wrapper h1(create_file_handle(p1, GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+      0));
+    if (h1.handle == INVALID_HANDLE_VALUE)
+      return BOOST_ERRNO;
+    handle_wrapper h2(create_file_handle(p2, GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+      0));
+    if (h2.handle == INVALID_HANDLE_VALUE)
+      return BOOST_ERRNO;
+
+    const DWORD buf_sz = 32768;
+    boost::scoped_array<char> buf1(new char [buf_sz]);
+    boost::scoped_array<char> buf2(new char [buf_sz]);
+    for (;;)
+    {
+      DWORD sz1, sz2;
+      if (!::ReadFile(h1.handle, buf1.get(), buf_sz, &sz1, 0)
+        || !::ReadFile(h2.handle, buf2.get(), buf_sz, &sz2, 0))
+        return BOOST_ERRNO;
+      if (sz1 != sz2 || std::memcmp(buf1.get(), buf2.get(), sz1) != 0)
+        return contents_differ;
+      if (sz1 == 0)
+        return 0;
+    }
   }
 
-  BOOST_FILESYSTEM_DECL
-  path canonical(const path& p, const path& base, system::error_code* ec)
+#   endif
+
+  //  Copies regular file from to to, keeping its permissions and modification time, by
+  //  way of a temporary sibling of to that is renamed into place once complete. So an
+  //  interrupted move leaves each target either complete or absent. When resuming such a
+  //  move, a target that has the contents, as well as the size and modification time, of
+  //  the source is taken to have been copied by it, and is not copied again. Any other
+  //  target is replaced.
+  err_t move_copy_file(const path& from, const path& to, bool resume,
+    boost::uintmax_t& bytes)
   {
-    path source (p.is_absolute() ? p : absolute(p, base));
-    path root(source.root_path());
-    path result;
+    bytes = 0;
+    path tmp(to);
+    tmp += partial_move_suffix;
 
-    system::error_code local_ec;
-    file_status stat (status(source, local_ec));
+#   ifdef BOOST_POSIX_API
 
-    if (stat.type() == fs::file_not_found)
+    int infile = ::open(from.c_str(), O_RDONLY);
+    if (infile < 0)
+      return errno;
+
+    int err = 0;
+    struct stat from_stat, to_stat;
+    if (::fstat(infile, &from_stat)!= 0)
     {
-      if (ec == 0)
-        BOOST_FILESYSTEM_THROW(filesystem_error(
-          "boost::filesystem::canonical", source,
-          error_code(system::errc::no_such_file_or_directory, system::generic_category())));
-      ec->assign(system::errc::no_such_file_or_directory, system::generic_category());
-      return result;
-    }
-    else if (local_ec)
-    {
-      if (ec == 0)
-        BOOST_FILESYSTEM_THROW(filesystem_error(
-          "boost::filesystem::canonical", source, local_ec));
-      *ec = local_ec;
-      return result;
+      err = errno;
+      ::close(infile);
+      return err;
     }
-
-    bool scan (true);
-    while (scan)
+    if (resume && ::stat(to.c_str(), &to_stat)== 0 && S_ISREG(to_stat.st_mode)
+      && to_stat.st_size == from_stat.st_size
+      && to_stat.st_mtime == from_stat.st_mtime)
     {
-      scan = false;
-      result.clear();
-      for (path::iterator itr = source.begin(); itr != source.end(); ++itr)
+      int tofile = ::open(to.c_str(), O_RDONLY);
+      if (tofile >= 0)
       {
-        if (*itr == dot_path())
-          continue;
-        if (*itr == dot_dot_path())
-        {
-          if (result != root)
-            result.remove_filename();
-          continue;
-        }
-
-        result /= *itr;
-
-        bool is_sym (is_symlink(detail::symlink_status(result, ec)));
-        if (ec && *ec)
-          return path();
-
-        if (is_sym)
+        err = compare_file_data(infile, tofile);
+        ::close(tofile);
+        if (err == 0)
         {
-          path link(detail::read_symlink(result, ec));
-          if (ec && *ec)
-            return path();
-          result.remove_filename();
-
-          if (link.is_absolute())
-          {
-            for (++itr; itr != source.end(); ++itr)
-              link /= *itr;
-            source = link;
-          }
-          else // link is relative
-          {
-            path new_source(result);
-            new_source /= link;
-            for (++itr; itr != source.end(); ++itr)
-              new_source /= *itr;
-            source = new_source;
-          }
-          scan = true;  // symlink causes scan to be restarted
-          break;
+          ::close(infile);
+          return 0;  // copied by an earlier move that did not complete
         }
+        if (err == contents_differ)
+          err = 0;
+      }
+      if (err == 0 && ::lseek(infile, 0, SEEK_SET) < 0)
+        err = errno;
+      if (err != 0)
+      {
+        ::close(infile);
+        return err;
       }
     }
-    if (ec != 0)
-      ec->clear();
-    BOOST_ASSERT_MSG(result.is_absolute(), "canonical() implementation error; please report");
-    return result;
-  }
 
-  BOOST_FILESYSTEM_DECL
-  void copy(const path& from, const path& to, system::error_code* ec)
-  {
-    file_status s(symlink_status(from, *ec));
-    if (ec != 0 && *ec) return;
+    int outfile = ::open(tmp.c_str(), O_CREAT | O_WRONLY | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (outfile < 0)
+    {
+      err = errno;
+      ::close(infile);
+      return err;
+    }
 
-    if(is_symlink(s))
+    if (!copy_file_data(infile, outfile, &bytes)
+      || ::fchmod(outfile, from_stat.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO
+        | S_ISUID | S_ISGID | S_ISVTX))!= 0)
+      err = errno;
+#   if defined(__linux__)
+    if (err == 0)
     {
-      copy_symlink(from, to, *ec);
+      struct timespec times[2];
+      times[0] = from_stat.st_atim;
+      times[1] = from_stat.st_mtim;
+      if (::futimens(outfile, times)!= 0)
+        err = errno;
     }
-    else if(is_directory(s))
+#   endif
+    ::close(infile);
+    if (::close(outfile)!= 0 && err == 0)
+      err = errno;
+#   if !defined(__linux__)
+    if (err == 0)
     {
-      copy_directory(from, to, *ec);
+      ::utimbuf buf;
+      buf.actime = from_stat.st_atime;
+      buf.modtime = from_stat.st_mtime;
+      if (::utime(tmp.c_str(), &buf)!= 0)
+        err = errno;
     }
-    else if(is_regular_file(s))
+#   endif
+
+    if (err == 0 && ::rename(tmp.c_str(), to.c_str())!= 0)
+      err = errno;
+    if (err != 0)
+      ::unlink(tmp.c_str());
+    return err;
+
+#   else
+
+    WIN32_FILE_ATTRIBUTE_DATA from_fad, to_fad;
+    if (!::GetFileAttributesExW(from.c_str(), ::GetFileExInfoStandard, &from_fad))
+      return BOOST_ERRNO;
+    if (resume && ::GetFileAttributesExW(to.c_str(), ::GetFileExInfoStandard, &to_fad)
+      && (to_fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)== 0
+      && to_fad.nFileSizeHigh == from_fad.nFileSizeHigh
+      && to_fad.nFileSizeLow == from_fad.nFileSizeLow
+      && ::CompareFileTime(&to_fad.ftLastWriteTime, &from_fad.ftLastWriteTime)== 0)
     {
-      copy_file(from, to, fs::copy_option::fail_if_exists, *ec);
+      err_t err = compare_file_data(from, to);
+      if (err == 0)
+        return 0;  // copied by an earlier move that did not complete
+      if (err != contents_differ)
+        return err;
     }
-    else
+
+    //  CopyFileW() keeps the attributes and times
+    if (!::CopyFileW(from.c_str(), tmp.c_str(), FALSE))
+      return BOOST_ERRNO;
+    if (!::MoveFileExW(tmp.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING))
     {
-      if (ec == 0)
-        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy",
-          from, to, error_code(BOOST_ERROR_NOT_SUPPORTED, system_category())));
-      ec->assign(BOOST_ERROR_NOT_SUPPORTED, system_category());
+      err_t err = BOOST_ERRNO;
+      ::DeleteFileW(tmp.c_str());
+      return err;
     }
-  }
+    bytes = (static_cast<boost::uintmax_t>(from_fad.nFileSizeHigh) << 32)
+      | from_fad.nFileSizeLow;
+    return 0;
 
-  BOOST_FILESYSTEM_DECL
-  void copy_directory(const path& from, const path& to, system::error_code* ec)
-  {
-#   ifdef BOOST_POSIX_API
-    struct stat from_stat;
 #   endif
-    error(!BOOST_COPY_DIRECTORY(from.c_str(), to.c_str()) ? BOOST_ERRNO : 0,
-      from, to, ec, "boost::filesystem::copy_directory");
-  }
-
-  BOOST_FILESYSTEM_DECL
-  void copy_file(const path& from, const path& to, copy_option option, error_code* ec)
-  {
-    error(!BOOST_COPY_FILE(from.c_str(), to.c_str(),
-      option == fail_if_exists) ? BOOST_ERRNO : 0,
-        from, to, ec, "boost::filesystem::copy_file");
   }
 
-  BOOST_FILESYSTEM_DECL
-  void copy_symlink(const path& existing_symlink, const path& new_symlink,
-    system::error_code* ec)
+  struct move_task
   {
-# if defined(_WIN32_WINNT) && _WIN32_WINNT < 0x0600
-    error(BOOST_ERROR_NOT_SUPPORTED, new_symlink, existing_symlink, ec,
-      "boost::filesystem::copy_symlink");
+    move_task(const path& f, const path& t, fs::file_type ft)
+      : from(f), to(t), type(ft) {}
 
-# else  // modern Windows or BOOST_POSIX_API 
-    path p(read_symlink(existing_symlink, ec));
-    if (ec != 0 && *ec) return;
-    create_symlink(p, new_symlink, ec);
+    path           from;
+    path           to;
+    fs::file_type  type;  // of from, not following symlinks
+  };
 
-# endif
+  inline bool deeper_first(const move_task& lhs, const move_task& rhs)
+  {
+    return lhs.to.native().size() > rhs.to.native().size();
   }
 
- BOOST_FILESYSTEM_DECL
-  bool create_directories(const path& p, system::error_code* ec)
+  //  Returns an error if to is not a target rename() would accept for a file of type
+  //  from_type: a directory must go to an empty directory or nowhere, and anything else
+  //  must not go to a directory.
+  err_t move_target_error(fs::file_type from_type, const path& to)
   {
-   if (p.empty())
-   {
-     if (ec == 0)
-       BOOST_FILESYSTEM_THROW(filesystem_error(
-         "boost::filesystem::create_directories", p,
-         system::errc::make_error_code(system::errc::invalid_argument)));
-     else
-       ec->assign(system::errc::invalid_argument, system::generic_category());
-     return false;
-   }
-
-    if (p.filename_is_dot() || p.filename_is_dot_dot())
-      return create_directories(p.parent_path(), ec);
-    
-    error_code local_ec;
-    file_status p_status = status(p, local_ec);
+    error_code ec;
+    fs::file_status st(fs::detail::symlink_status(to, &ec));
+    if (st.type() == fs::file_not_found)
+      return 0;
+    if (ec)
+      return ec.value();
+    if (from_type != fs::directory_file || st.type() != fs::directory_file)
+      return st.type() == fs::directory_file || from_type == fs::directory_file
+        ? BOOST_ERROR_ALREADY_EXISTS : 0;
+    bool empty = fs::detail::is_empty(to, &ec);
+    if (ec)
+      return ec.value();
+#   ifdef BOOST_POSIX_API
+    return empty ? 0 : ENOTEMPTY;
+#   else
+    return empty ? 0 : ERROR_DIR_NOT_EMPTY;
+#   endif
+  }
 
-    if (p_status.type() == directory_file)
+  //  Worker for the work_queue copying a tree: a directory task creates the target
+  //  directory and queues a task for each entry, other tasks copy one file or symlink.
+  //  Below the root, only a resumed move finds targets already there.
+  class tree_mover
+  {
+  public:
+    tree_mover(const path& root, bool resume, fs::move_progress_handler handler,
+      void* context)
+      : m_root(root), m_resume(resume), m_handler(handler), m_context(context),
+        m_error(0)
     {
-      if (ec != 0)
-        ec->clear();
-      return false;
+      m_progress.files = m_progress.bytes = m_progress.removed = 0;
     }
 
-    path parent = p.parent_path();
-    BOOST_ASSERT_MSG(parent != p, "internal error: p == p.parent_path()");
-    if (!parent.empty())
+    void operator()(const move_task& task, fs::detail::work_queue<move_task>& queue)
     {
-      // determine if the parent exists
-      file_status parent_status = status(parent, local_ec);
+      err_t err = 0;
+      boost::uintmax_t bytes = 0;
+      error_code ec;
 
-      // if the parent does not exist, create the parent
-      if (parent_status.type() == file_not_found)
+      switch (task.type)
       {
-        create_directories(parent, local_ec);
-        if (local_ec)
+      case fs::directory_file:
         {
-          if (ec == 0)
-            BOOST_FILESYSTEM_THROW(filesystem_error(
-              "boost::filesystem::create_directories", parent, local_ec));
+          bool created = fs::detail::create_directory(task.to, &ec);
+          if (ec)
+            break;
+          if (!created && !m_resume && task.to.native() != m_root.native())
+          {
+            err = BOOST_ERROR_ALREADY_EXISTS;  // not this move's, so not merged into
+            break;
+          }
+          fs::directory_iterator itr(task.from, ec);
+          for (; !ec && itr != end_dir_itr; itr.increment(ec))
+          {
+            fs::file_type type = itr->symlink_status(ec).type();
+            if (!ec)
+              queue.push(move_task(itr->path(), task.to / itr->path().filename(), type));
+          }
+          if (!ec)
+          {
+            fs::detail::scoped_worker_lock lock(m_mutex);
+            m_directories.push_back(task);
+          }
+        }
+        break;
+      case fs::regular_file:
+        err = move_copy_file(task.from, task.to, m_resume, bytes);
+        break;
+      case fs::symlink_file:
+        {
+          //  a target that is already the same symlink is kept when resuming; any other
+          //  is replaced, as rename() would replace it
+          error_code to_ec;
+          fs::file_status to_st(fs::detail::symlink_status(task.to, &to_ec));
+          if (fs::is_directory(to_st))
+            err = BOOST_ERROR_ALREADY_EXISTS;
+          else if (fs::exists(to_st))
+          {
+            if (m_resume && fs::is_symlink(to_st)
+              && fs::detail::read_symlink(task.to, &to_ec)
+                == fs::detail::read_symlink(task.from, &ec) && !to_ec && !ec)
+              break;
+            if (!ec)
+              fs::detail::remove(task.to, &ec);
+            if (!ec)
+              fs::detail::copy_symlink(task.from, task.to, &ec);
+          }
           else
-            *ec = local_ec;
-          return false;
+            fs::detail::copy_symlink(task.from, task.to, &ec);
         }
+        break;
+      default:
+        err = BOOST_ERROR_NOT_SUPPORTED;
       }
-    }
+      if (err == 0)
+        err = ec.value();
 
-    // create the directory
-    return create_directory(p, ec);
-  }
+      fs::detail::scoped_worker_lock lock(m_mutex);
+      if (err != 0)
+      {
+        if (m_error == 0)
+        {
+          m_error = err;
+          m_error_from = task.from;
+          m_error_to = task.to;
+        }
+        queue.stop();
+        return;
+      }
+      ++m_progress.files;
+      m_progress.bytes += bytes;
+      if (m_handler != 0 && m_error == 0 && !m_handler(m_progress, m_context))
+      {
+        m_error = BOOST_ERROR_CANCELLED;
+        queue.stop();
+      }
+    }
 
-  BOOST_FILESYSTEM_DECL
-  bool create_directory(const path& p, error_code* ec)
-  {
-    if (BOOST_CREATE_DIRECTORY(p.c_str()))
+    //  Gives the copied directories the permissions and modification times of the
+    //  originals. This comes last, deepest first, because adding entries updates a
+    //  directory's modification time and a read-only directory could not be filled.
+    void finish_directories()
     {
-      if (ec != 0)
-        ec->clear();
-      return true;
+      std::sort(m_directories.begin(), m_directories.end(), deeper_first);
+      for (std::vector<move_task>::const_iterator it = m_directories.begin();
+        it != m_directories.end() && m_error == 0; ++it)
+      {
+        error_code ec;
+        fs::file_status st(fs::detail::status(it->from, &ec));
+        std::time_t mtime = 0;
+        if (!ec)
+          mtime = fs::detail::last_write_time(it->from, &ec);
+        if (!ec)
+          fs::detail::permissions(it->to, st.permissions(), &ec);
+        if (!ec)
+          fs::detail::last_write_time(it->to, mtime, &ec);
+        if (ec)
+        {
+          m_error = ec.value();
+          m_error_from = it->from;
+          m_error_to = it->to;
+        }
+      }
     }
 
-    //  attempt to create directory failed
-    int errval(BOOST_ERRNO);  // save reason for failure
-    error_code dummy;
-
-    if (is_directory(p, dummy))
+    void report_removed(boost::uintmax_t count)
     {
-      if (ec != 0)
-        ec->clear();
-      return false;
+      m_progress.removed = count;
+      if (m_handler != 0)
+        m_handler(m_progress, m_context);  // too late to abandon the move
     }
 
-    //  attempt to create directory failed && it doesn't already exist
-    if (ec == 0)
-      BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::create_directory",
-        p, error_code(errval, system_category())));
-    else
-      ec->assign(errval, system_category());
+    err_t error_value() const      { return m_error; }
+    const path& error_from() const { return m_error_from; }
+    const path& error_to() const   { return m_error_to; }
+
+  private:
+    path                       m_root;
+    bool                       m_resume;
+    fs::move_progress_handler  m_handler;
+    void*                      m_context;
+    fs::move_progress          m_progress;
+    std::vector<move_task>     m_directories;
+    err_t                      m_error;
+    path                       m_error_from;
+    path                       m_error_to;
+    fs::detail::worker_mutex   m_mutex;
+  };
 
-    return false;
-  }
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                   permissions_all helpers (all operating systems)                    //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
-  BOOST_FILESYSTEM_DECL
-  void create_directory_symlink(const path& to, const path& from,
-                                 system::error_code* ec)
+  //  What permissions_all() or change_owner_all() is to change; anything not asked for
+  //  is left as it is.
+  struct attribute_change
   {
-#   if defined(BOOST_WINDOWS_API) && _WIN32_WINNT < 0x0600  // SDK earlier than Vista and Server 2008
+    attribute_change()
+      : set_mode(false), prms(fs::no_perms),
+        user(fs::unchanged_owner), group(fs::unchanged_owner) {}
 
-    error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec,
-      "boost::filesystem::create_directory_symlink");
-#   else
+    bool          set_mode;
+    fs::perms     prms;   // as for permissions()
+    fs::owner_id  user;
+    fs::owner_id  group;
 
-#     if defined(BOOST_WINDOWS_API) && _WIN32_WINNT >= 0x0600
-        // see if actually supported by Windows runtime dll
-        if (error(!create_symbolic_link_api ? BOOST_ERROR_NOT_SUPPORTED : 0, to, from, ec,
-            "boost::filesystem::create_directory_symlink"))
-          return;
-#     endif
+    bool set_owner() const
+      { return user != fs::unchanged_owner || group != fs::unchanged_owner; }
 
-    error(!BOOST_CREATE_SYMBOLIC_LINK(from.c_str(), to.c_str(),
-      SYMBOLIC_LINK_FLAG_DIRECTORY) ? BOOST_ERRNO : 0,
-      to, from, ec, "boost::filesystem::create_directory_symlink");
-#   endif
-  }
+    fs::perms new_perms(fs::perms current) const
+    {
+      current &= fs::perms_mask;
+      if (prms & fs::add_perms)
+        return current | (prms & fs::perms_mask);
+      if (prms & fs::remove_perms)
+        return current & ~(prms & fs::perms_mask);
+      return prms & fs::perms_mask;
+    }
+  };
 
-  BOOST_FILESYSTEM_DECL
-  void create_hard_link(const path& to, const path& from, error_code* ec)
+# ifdef BOOST_POSIX_API
+
+  struct directory_mode
   {
+    directory_mode(const path& d, mode_t m) : dir(d), mode(m) {}
 
-#   if defined(BOOST_WINDOWS_API) && _WIN32_WINNT < 0x0500  // SDK earlier than Win 2K
+    path    dir;
+    mode_t  mode;
+  };
 
-    error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec,
-      "boost::filesystem::create_hard_link");
-#   else
+  inline bool deeper_directory_first(const directory_mode& lhs, const directory_mode& rhs)
+  {
+    return lhs.dir.native().size() > rhs.dir.native().size();
+  }
 
-#     if defined(BOOST_WINDOWS_API) && _WIN32_WINNT >= 0x0500
-        // see if actually supported by Windows runtime dll
-        if (error(!create_hard_link_api ? BOOST_ERROR_NOT_SUPPORTED : 0, to, from, ec,
-            "boost::filesystem::create_hard_link"))
-          return;
+# endif
+
+  //  Worker for the work_queue changing a tree: each task is a directory, read once.
+  //  Where the *at() functions are available, each entry is examined with fstatat() and
+  //  changed with fchmodat() or fchownat() relative to the open directory, so no full
+  //  path is resolved per entry. An entry that already has the requested mode and owner
+  //  is not written at all. Symlinks below the root are not followed, and since they
+  //  have no mode of their own, only their owner is changed; a symlink root is followed.
+  class tree_attribute_setter
+  {
+  public:
+    explicit tree_attribute_setter(const attribute_change& change)
+      : m_change(change), m_count(0), m_error(0) {}
+
+    //  Changes p itself, following a symlink as permissions() does. Returns true if the
+    //  contents of p are to be changed too.
+    bool start(const path& p)
+    {
+      m_root = p;
+#     ifdef BOOST_POSIX_API
+      struct stat st;
+      err_t err = ::stat(p.c_str(), &st)!= 0 ? errno : 0;
+      bool changed = false;
+#       ifdef BOOST_FILESYSTEM_AT_FUNCTIONS
+      if (err == 0)
+        err = apply(AT_FDCWD, p.c_str(), st, p, true, changed);
+#       else
+      if (err == 0)
+        err = apply(0, p.c_str(), st, p, true, changed);
+#       endif
+      record(err, p, changed ? 1 : 0);
+      return err == 0 && S_ISDIR(st.st_mode);
+#     else
+      error_code ec;
+      fs::file_status st(fs::detail::status(p, &ec));
+      bool changed = false;
+      if (!ec)
+        apply(p, st, changed, ec);
+      record(ec.value(), p, changed ? 1 : 0);
+      return !ec && fs::is_directory(st);
 #     endif
+    }
 
-    error(!BOOST_CREATE_HARD_LINK(from.c_str(), to.c_str()) ? BOOST_ERRNO : 0, to, from, ec,
-      "boost::filesystem::create_hard_link");
-#   endif
-  }
+    void operator()(const path& dir, fs::detail::work_queue<path>& queue)
+    {
+      boost::uintmax_t count = 0;
+      err_t err = 0;
+      path p;
 
-  BOOST_FILESYSTEM_DECL
-  void create_symlink(const path& to, const path& from, error_code* ec)
-  {
-#   if defined(BOOST_WINDOWS_API) && _WIN32_WINNT < 0x0600  // SDK earlier than Vista and Server 2008
-    error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec,
-      "boost::filesystem::create_directory_symlink");
-#   else
+#     ifdef BOOST_POSIX_API
+#       ifdef BOOST_FILESYSTEM_AT_FUNCTIONS
+      DIR* d = 0;
+      int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY
+        | (dir.native() == m_root.native() ? 0 : O_NOFOLLOW));  // as start() did
+      if (fd < 0 || (d = ::fdopendir(fd))== 0)
+      {
+        err = errno;
+        if (fd >= 0)
+          ::close(fd);
+      }
+#       else
+      DIR* d = ::opendir(dir.c_str());
+      if (d == 0)
+        err = errno;
+#       endif
+      if (err != 0)
+        p = dir;
 
-#     if defined(BOOST_WINDOWS_API) && _WIN32_WINNT >= 0x0600
-        // see if actually supported by Windows runtime dll
-        if (error(!create_symbolic_link_api ? BOOST_ERROR_NOT_SUPPORTED : 0, to, from, ec,
-            "boost::filesystem::create_symlink"))
-          return;
+      struct dirent* entry;
+      while (err == 0 && !queue.stopped() && (errno = 0, (entry = ::readdir(d))!= 0))
+      {
+        const char* name = entry->d_name;
+        if (name[0] == dot && (name[1] == 0 || (name[1] == dot && name[2] == 0)))
+          continue;
+        p = dir / name;
+        struct stat st;
+#       ifdef BOOST_FILESYSTEM_AT_FUNCTIONS
+        if (::fstatat(::dirfd(d), name, &st, AT_SYMLINK_NOFOLLOW)!= 0)
+#       else
+        if (::lstat(p.c_str(), &st)!= 0)
+#       endif
+        {
+          if (not_found_error(errno))  // removed since readdir()
+            continue;
+          err = errno;
+          break;
+        }
+        bool changed = false;
+#       ifdef BOOST_FILESYSTEM_AT_FUNCTIONS
+        err = apply(::dirfd(d), name, st, p, false, changed);
+#       else
+        err = apply(0, p.c_str(), st, p, false, changed);
+#       endif
+        if (changed)
+          ++count;
+        if (err == 0 && S_ISDIR(st.st_mode))
+          queue.push(p);
+      }
+      if (err == 0 && errno != 0)  // readdir() failed
+      {
+        err = errno;
+        p = dir;
+      }
+      if (d != 0)
+        ::closedir(d);
+#     else
+      error_code ec;
+      fs::directory_iterator itr(dir, ec);
+      for (; !ec && itr != end_dir_itr && !queue.stopped(); itr.increment(ec))
+      {
+        p = itr->path();
+        fs::file_status st(itr->symlink_status(ec));
+        bool changed = false;
+        if (!ec)
+          apply(p, st, changed, ec);
+        if (changed)
+          ++count;
+        if (!ec && fs::is_directory(st))
+          queue.push(p);
+      }
+      err = ec.value();
+      if (err != 0 && p.empty())
+        p = dir;
 #     endif
 
-    error(!BOOST_CREATE_SYMBOLIC_LINK(from.c_str(), to.c_str(), 0) ? BOOST_ERRNO : 0,
-      to, from, ec, "boost::filesystem::create_symlink");
+      record(err, p, count);
+      if (err != 0)
+        queue.stop();
+    }
+
+    //  Gives directories their new modes only now, deepest first, where the new mode
+    //  would have kept their owner from reading or searching them while their contents
+    //  were being changed.
+    void finish_directories()
+    {
+#     ifdef BOOST_POSIX_API
+      std::sort(m_directories.begin(), m_directories.end(), deeper_directory_first);
+      for (std::vector<directory_mode>::const_iterator it = m_directories.begin();
+        it != m_directories.end() && m_error == 0; ++it)
+      {
+        if (::chmod(it->dir.c_str(), it->mode)!= 0)
+          record(errno, it->dir, 0);
+      }
+#     endif
+    }
+
+    boost::uintmax_t count() const  { return m_count; }
+    err_t error_value() const       { return m_error; }
+    const path& error_path() const  { return m_error_path; }
+
+  private:
+    attribute_change            m_change;
+    path                        m_root;
+    boost::uintmax_t            m_count;   // entries changed
+    err_t                       m_error;
+    path                        m_error_path;
+    fs::detail::worker_mutex    m_mutex;
+#   ifdef BOOST_POSIX_API
+    std::vector<directory_mode> m_directories;
 #   endif
-  }
 
-  BOOST_FILESYSTEM_DECL
-  path current_path(error_code* ec)
-  {
+    void record(err_t err, const path& p, boost::uintmax_t count)
+    {
+      fs::detail::scoped_worker_lock lock(m_mutex);
+      m_count += count;
+      if (err != 0 && m_error == 0)
+      {
+        m_error = err;
+        m_error_path = p;
+      }
+    }
+
 #   ifdef BOOST_POSIX_API
-    path cur;
-    for (long path_max = 128;; path_max *=2)// loop 'til buffer large enough
+
+    //  Changes name, relative to the directory open as dir_fd, whose status is st. p is
+    //  the full path, needed only if the mode change has to wait for
+    //  finish_directories(). Returns 0 or an errno value.
+    int apply(int dir_fd, const char* name, const struct stat& st, const path& p,
+      bool follow, bool& changed)
     {
-      boost::scoped_array<char>
-        buf(new char[static_cast<std::size_t>(path_max)]);
-      if (::getcwd(buf.get(), static_cast<std::size_t>(path_max))== 0)
+      if (m_change.set_owner())
       {
-        if (error(errno != ERANGE ? errno : 0
-      // bug in some versions of the Metrowerks C lib on the Mac: wrong errno set 
-#         if defined(__MSL__) && (defined(macintosh) || defined(__APPLE__) || defined(__APPLE_CC__))
-          && errno != 0
-#         endif
-          , ec, "boost::filesystem::current_path"))
+        uid_t uid = m_change.user == fs::unchanged_owner
+          ? st.st_uid : static_cast<uid_t>(m_change.user);
+        gid_t gid = m_change.group == fs::unchanged_owner
+          ? st.st_gid : static_cast<gid_t>(m_change.group);
+        if (uid != st.st_uid || gid != st.st_gid)
         {
-          break;
+#         ifdef BOOST_FILESYSTEM_AT_FUNCTIONS
+          if (::fchownat(dir_fd, name, uid, gid, follow ? 0 : AT_SYMLINK_NOFOLLOW)!= 0)
+#         else
+          if ((follow ? ::chown(name, uid, gid) : ::lchown(name, uid, gid))!= 0)
+#         endif
+            return errno;
+          changed = true;
         }
       }
-      else
+
+      if (m_change.set_mode && !S_ISLNK(st.st_mode))
       {
-        cur = buf.get();
-        if (ec != 0) ec->clear();
-        break;
+        mode_t current = st.st_mode & fs::perms_mask;
+        mode_t mode = static_cast<mode_t>(
+          m_change.new_perms(static_cast<fs::perms>(current)));
+        if (mode != current)
+        {
+          if (S_ISDIR(st.st_mode) && (mode & (S_IRUSR | S_IXUSR))!= (S_IRUSR | S_IXUSR))
+          {
+            fs::detail::scoped_worker_lock lock(m_mutex);
+            m_directories.push_back(directory_mode(p, mode));
+          }
+#         ifdef BOOST_FILESYSTEM_AT_FUNCTIONS
+          else if (::fchmodat(dir_fd, name, mode, 0)!= 0)
+#         else
+          else if (::chmod(name, mode)!= 0)
+#         endif
+            return errno;
+          changed = true;
+        }
       }
+      return 0;
     }
-    return cur;
 
 #   else
-    DWORD sz;
-    if ((sz = ::GetCurrentDirectoryW(0, NULL)) == 0)sz = 1;
-    boost::scoped_array<path::value_type> buf(new path::value_type[sz]);
-    error(::GetCurrentDirectoryW(sz, buf.get()) == 0 ? BOOST_ERRNO : 0, ec,
-      "boost::filesystem::current_path");
-    return path(buf.get());
-#   endif
-  }
 
+    //  Windows has no owner to change here, and the only permission it keeps is whether
+    //  the file is read-only, so that is all that is compared.
+    void apply(const path& p, fs::file_status st, bool& changed, error_code& ec)
+    {
+      if (!m_change.set_mode || fs::is_symlink(st))
+        return;
+      fs::perms write_bits = fs::owner_write | fs::group_write | fs::others_write;
+      fs::perms mode = m_change.new_perms(st.permissions());
+      if (((mode & write_bits)== 0) != ((st.permissions() & write_bits)== 0))
+      {
+        fs::detail::permissions(p, mode, &ec);
+        changed = !ec;
+      }
+    }
 
-  BOOST_FILESYSTEM_DECL
-  void current_path(const path& p, system::error_code* ec)
-  {
-    error(!BOOST_SET_CURRENT_DIRECTORY(p.c_str()) ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::current_path");
-  }
+#   endif
+  };
 
-  BOOST_FILESYSTEM_DECL
-  bool equivalent(const path& p1, const path& p2, system::error_code* ec)
+  boost::uintmax_t change_attributes_all(const path& p, const attribute_change& change,
+    error_code* ec, const char* message)
   {
-#   ifdef BOOST_POSIX_API
-    struct stat s2;
-    int e2(::stat(p2.c_str(), &s2));
-    struct stat s1;
-    int e1(::stat(p1.c_str(), &s1));
-
-    if (e1 != 0 || e2 != 0)
+    tree_attribute_setter setter(change);
+    fs::detail::work_queue<path> queue;
+    if (setter.start(p))
     {
-      // if one is invalid and the other isn't then they aren't equivalent,
-      // but if both are invalid then it is an error
-      error (e1 != 0 && e2 != 0, p1, p2, ec, "boost::filesystem::equivalent");
-      return false;
+      queue.push(p);
+      queue.run(setter);
     }
+    setter.finish_directories();
+    if (error(setter.error_value(), setter.error_path(), ec, message))
+      return 0;
+    return setter.count();
+  }
 
-    // both stats now known to be valid
-    return  s1.st_dev == s2.st_dev && s1.st_ino == s2.st_ino
-        // According to the POSIX stat specs, "The st_ino and st_dev fields
-        // taken together uniquely identify the file within the system."
-        // Just to be sure, size and mod time are also checked.
-        && s1.st_size == s2.st_size && s1.st_mtime == s2.st_mtime;
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                 cached_current_path helpers (all operating systems)                  //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
-#   else  // Windows
+  //  The working directory as cached_current_path() last found it, with the device and
+  //  inode of the directory that "." was then, so that a change of directory made other
+  //  than by current_path(p) can be noticed by a stat rather than a getcwd.
+  struct cwd_snapshot
+  {
+    cwd_snapshot() : valid(false), device(0), inode(0) {}
 
-    // Note well: Physical location on external media is part of the
-    // equivalence criteria. If there are no open handles, physical location
-    // can change due to defragmentation or other relocations. Thus handles
-    // must be held open until location information for both paths has
-    // been retrieved.
+    fs::detail::worker_mutex  mutex;
+    bool                      valid;
+    path                      cwd;
+    boost::uint64_t           device;  // POSIX only
+    boost::uint64_t           inode;
+  };
 
-    // p2 is done first, so any error reported is for p1
-    handle_wrapper h2(
-      create_file_handle(
-          p2.c_str(),
-          0,
-          FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-          0,
-          OPEN_EXISTING,
-          FILE_FLAG_BACKUP_SEMANTICS,
-          0));
+  //  Made on first use, once however many threads ask for it at once. C++11 makes the
+  //  initialization of a local static thread-safe; C++03 does not, so it is done here.
+# if !defined(BOOST_FILESYSTEM_WORKER_THREADS) && defined(BOOST_HAS_PTHREADS)
+  cwd_snapshot* cwd_snapshot_instance = 0;
 
-    handle_wrapper h1(
-      create_file_handle(
-          p1.c_str(),
-          0,
-          FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-          0,
-          OPEN_EXISTING,
-          FILE_FLAG_BACKUP_SEMANTICS,
-          0));
+  void make_cwd_snapshot() { cwd_snapshot_instance = new cwd_snapshot; }
+# endif
 
-    if (h1.handle == INVALID_HANDLE_VALUE
-      || h2.handle == INVALID_HANDLE_VALUE)
+  cwd_snapshot& the_cwd_snapshot()
+  {
+#   if defined(BOOST_FILESYSTEM_WORKER_THREADS)
+    static cwd_snapshot snapshot;
+    return snapshot;
+#   elif defined(BOOST_HAS_PTHREADS)
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    ::pthread_once(&once, make_cwd_snapshot);
+    return *cwd_snapshot_instance;
+#   elif defined(BOOST_WINDOWS_API)
+    static cwd_snapshot* volatile instance = 0;
+    if (instance == 0)
     {
-      // if one is invalid and the other isn't, then they aren't equivalent,
-      // but if both are invalid then it is an error
-      error((h1.handle == INVALID_HANDLE_VALUE
-        && h2.handle == INVALID_HANDLE_VALUE) ? BOOST_ERROR_NOT_SUPPORTED : 0, p1, p2, ec,
-          "boost::filesystem::equivalent");
-      return false;
+      cwd_snapshot* made = new cwd_snapshot;
+      if (::InterlockedCompareExchangePointer(
+        reinterpret_cast<void* volatile*>(&instance), made, 0) != 0)
+        delete made;  // another thread's was published first
     }
+    return *instance;
+#   else
+    static cwd_snapshot snapshot;  // no threads to race
+    return snapshot;
+#   endif
+  }
 
-    // at this point, both handles are known to be valid
-
-    BY_HANDLE_FILE_INFORMATION info1, info2;
-
-    if (error(!::GetFileInformationByHandle(h1.handle, &info1) ? BOOST_ERRNO : 0,
-      p1, p2, ec, "boost::filesystem::equivalent"))
-        return  false;
+//#ifdef BOOST_WINDOWS_API
+//
+//
+//  inline bool get_free_disk_space(const std::wstring& ph,
+//    PULARGE_INTEGER avail, PULARGE_INTEGER total, PULARGE_INTEGER free)
+//    { return ::GetDiskFreeSpaceExW(ph.c_str(), avail, total, free)!= 0; }
+//
+//#endif
 
-    if (error(!::GetFileInformationByHandle(h2.handle, &info2) ? BOOST_ERRNO : 0,
-      p1, p2, ec, "boost::filesystem::equivalent"))
-        return  false;
+} // unnamed namespace
 
-    // In theory, volume serial numbers are sufficient to distinguish between
-    // devices, but in practice VSN's are sometimes duplicated, so last write
-    // time and file size are also checked.
-      return 
-        info1.dwVolumeSerialNumber == info2.dwVolumeSerialNumber
-        && info1.nFileIndexHigh == info2.nFileIndexHigh
-        && info1.nFileIndexLow == info2.nFileIndexLow
-        && info1.nFileSizeHigh == info2.nFileSizeHigh
-        && info1.nFileSizeLow == info2.nFileSizeLow
-        && info1.ftLastWriteTime.dwLowDateTime
-          == info2.ftLastWriteTime.dwLowDateTime
-        && info1.ftLastWriteTime.dwHighDateTime
-          == info2.ftLastWriteTime.dwHighDateTime;
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                operations functions declared in operations.hpp                       //
+//                            in alphabetic order                                       //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
-#   endif
-  }
+namespace boost
+{
+namespace filesystem
+{
 
   BOOST_FILESYSTEM_DECL
-  boost::uintmax_t file_size(const path& p, error_code* ec)
+  path absolute(const path& p, const path& base)
   {
-#   ifdef BOOST_POSIX_API
+//    if ( p.empty() || p.is_absolute() )
+//      return p;
+//    //  recursively calling absolute is sub-optimal, but is simple
+//    path abs_base(base.is_absolute() ? base : absolute(base));
+//# ifdef BOOST_WINDOWS_API
+//    if (p.has_root_directory())
+//      return abs_base.root_name() / p;
+//    //  !p.has_root_directory
+//    if (p.has_root_name())
+//      return p.root_name()
+//        / abs_base.root_directory() / abs_base.relative_path() / p.relative_path();
+//    //  !p.has_root_name()
+//# endif
+//    return abs_base / p;
 
-    struct stat path_stat;
-    if (error(::stat(p.c_str(), &path_stat)!= 0 ? BOOST_ERRNO : 0,
-        p, ec, "boost::filesystem::file_size"))
-      return static_cast<boost::uintmax_t>(-1);
-   if (error(!S_ISREG(path_stat.st_mode) ? EPERM : 0,
-        p, ec, "boost::filesystem::file_size"))
-      return static_cast<boost::uintmax_t>(-1);
+    //  recursively calling absolute is sub-optimal, but is sure and simple
+    path abs_base(base.is_absolute() ? base : absolute(base));
 
-    return static_cast<boost::uintmax_t>(path_stat.st_size);
+    //  store expensive to compute values that are needed multiple times
+    path p_root_name (p.root_name());
+    path base_root_name (abs_base.root_name());
+    path p_root_directory (p.root_directory());
 
-#   else  // Windows
+    if (p.empty())
+      return abs_base;
 
-    // assume uintmax_t is 64-bits on all Windows compilers
+    if (!p_root_name.empty())  // p.has_root_name()
+    {
+      if (p_root_directory.empty())  // !p.has_root_directory()
+        return p_root_name / abs_base.root_directory()
+        / abs_base.relative_path() / p.relative_path();
+      // p is absolute, so fall through to return p at end of block
+    }
 
-    WIN32_FILE_ATTRIBUTE_DATA fad;
-
-    if (error(::GetFileAttributesExW(p.c_str(), ::GetFileExInfoStandard, &fad)== 0
-      ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::file_size"))
-          return static_cast<boost::uintmax_t>(-1);
-
-    if (error((fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)!= 0
-      ? ERROR_NOT_SUPPORTED : 0, p, ec, "boost::filesystem::file_size"))
-      return static_cast<boost::uintmax_t>(-1);
-
-    return (static_cast<boost::uintmax_t>(fad.nFileSizeHigh)
-              << (sizeof(fad.nFileSizeLow)*8)) + fad.nFileSizeLow;
-#   endif
-  }
-
-  BOOST_FILESYSTEM_DECL
-  boost::uintmax_t hard_link_count(const path& p, system::error_code* ec)
-  {
-#   ifdef BOOST_POSIX_API
-
-    struct stat path_stat;
-    return error(::stat(p.c_str(), &path_stat)!= 0 ? BOOST_ERRNO : 0,
-                  p, ec, "boost::filesystem::hard_link_count")
-           ? 0
-           : static_cast<boost::uintmax_t>(path_stat.st_nlink);
+    else if (!p_root_directory.empty())  // p.has_root_directory()
+    {
+#     ifdef BOOST_POSIX_API
+      // POSIX can have root name it it is a network path
+      if (base_root_name.empty())   // !abs_base.has_root_name()
+        return p;
+#     endif
+      return base_root_name / p;
+    }
 
-#   else // Windows
+    else
+    {
+      return abs_base / p;
+    }
 
-    // Link count info is only available through GetFileInformationByHandle
-    BY_HANDLE_FILE_INFORMATION info;
-    handle_wrapper h(
-      create_file_handle(p.c_str(), 0,
-          FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
-          OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, 0));
-    return
-      !error(h.handle == INVALID_HANDLE_VALUE ? BOOST_ERRNO : 0,
-              p, ec, "boost::filesystem::hard_link_count")
-      && !error(::GetFileInformationByHandle(h.handle, &info)== 0 ? BOOST_ERRNO : 0,
-                 p, ec, "boost::filesystem::hard_link_count")
-           ? info.nNumberOfLinks
-           : 0;
-#   endif
+    return p;  // p.is_absolute() is true
   }
 
+namespace detail
+{
   BOOST_FILESYSTEM_DECL
-  path initial_path(error_code* ec)
+  std::vector<path> absolute_batch(const std::vector<path>& paths, error_code* ec)
   {
-      static path init_path;
-      if (init_path.empty())
-        init_path = current_path(ec);
-      else if (ec != 0) ec->clear();
-      return init_path;
+    std::vector<path> results;
+    error_code tmp_ec;
+    path base(cached_current_path(true, &tmp_ec));
+    if (error(tmp_ec.value(), ec, "boost::filesystem::absolute_batch"))
+      return results;
+    results.reserve(paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i)
+      results.push_back(absolute(paths[i], base));
+    return results;
   }
 
-  BOOST_FILESYSTEM_DECL
-  bool is_empty(const path& p, system::error_code* ec)
+  BOOST_FILESYSTEM_DECL bool possible_large_file_size_support()
   {
 #   ifdef BOOST_POSIX_API
-
-    struct stat path_stat;
-    if (error(::stat(p.c_str(), &path_stat)!= 0,
-        p, ec, "boost::filesystem::is_empty"))
-      return false;        
-    return S_ISDIR(path_stat.st_mode)
-      ? is_empty_directory(p, ec)
-      : path_stat.st_size == 0;
+    struct stat lcl_stat;
+    return sizeof(lcl_stat.st_size)> 4;
 #   else
-
-    WIN32_FILE_ATTRIBUTE_DATA fad;
-    if (error(::GetFileAttributesExW(p.c_str(), ::GetFileExInfoStandard, &fad)== 0
-      ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::is_empty"))
-        return false;
-
-    if (ec != 0) ec->clear();
-    return 
-      (fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
-        ? is_empty_directory(p, ec)
-        : (!fad.nFileSizeHigh && !fad.nFileSizeLow);
+    return true;
 #   endif
   }
 
   BOOST_FILESYSTEM_DECL
-  std::time_t last_write_time(const path& p, system::error_code* ec)
+  path canonical(const path& p, const path& base, system::error_code* ec)
   {
-#   ifdef BOOST_POSIX_API
+    path source (p.is_absolute() ? p : absolute(p, base));
+    path root(source.root_path());
+    path result;
 
-    struct stat path_stat;
-    if (error(::stat(p.c_str(), &path_stat)!= 0 ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::last_write_time"))
-        return std::time_t(-1);
-    return path_stat.st_mtime;
+    system::error_code local_ec;
+    file_status stat (status(source, local_ec));
 
-#   else
+    if (stat.type() == fs::file_not_found)
+    {
+      if (ec == 0)
+        BOOST_FILESYSTEM_THROW(filesystem_error(
+          "boost::filesystem::canonical", source,
+          error_code(system::errc::no_such_file_or_directory, system::generic_category())));
+      ec->assign(system::errc::no_such_file_or_directory, system::generic_category());
+      return result;
+    }
+    else if (local_ec)
+    {
+      if (ec == 0)
+        BOOST_FILESYSTEM_THROW(filesystem_error(
+          "boost::filesystem::canonical", source, local_ec));
+      *ec = local_ec;
+      return result;
+    }
 
-    handle_wrapper hw(
-      create_file_handle(p.c_str(), 0,
-        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
-        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, 0));
+    bool scan (true);
+    while (scan)
+    {
+      scan = false;
+      result.clear();
+      for (path::iterator itr = source.begin(); itr != source.end(); ++itr)
+      {
+        if (*itr == dot_path())
+          continue;
+        if (*itr == dot_dot_path())
+        {
+          if (result != root)
+            result.remove_filename();
+          continue;
+        }
 
-    if (error(hw.handle == INVALID_HANDLE_VALUE ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::last_write_time"))
-        return std::time_t(-1);
+        result /= *itr;
 
-    FILETIME lwt;
+        bool is_sym (is_symlink(detail::symlink_status(result, ec)));
+        if (ec && *ec)
+          return path();
 
-    if (error(::GetFileTime(hw.handle, 0, 0, &lwt)== 0 ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::last_write_time"))
-        return std::time_t(-1);
+        if (is_sym)
+        {
+          path link(detail::read_symlink(result, ec));
+          if (ec && *ec)
+            return path();
+          result.remove_filename();
 
-    return to_time_t(lwt);
-#   endif
+          if (link.is_absolute())
+          {
+            for (++itr; itr != source.end(); ++itr)
+              link /= *itr;
+            source = link;
+          }
+          else // link is relative
+          {
+            path new_source(result);
+            new_source /= link;
+            for (++itr; itr != source.end(); ++itr)
+              new_source /= *itr;
+            source = new_source;
+          }
+          scan = true;  // symlink causes scan to be restarted
+          break;
+        }
+      }
+    }
+    if (ec != 0)
+      ec->clear();
+    BOOST_ASSERT_MSG(result.is_absolute(), "canonical() implementation error; please report");
+    return result;
   }
 
   BOOST_FILESYSTEM_DECL
-  void last_write_time(const path& p, const std::time_t new_time,
-                        system::error_code* ec)
+  boost::uintmax_t change_owner_all(const path& p, owner_id user, owner_id group,
+    system::error_code* ec)
   {
 #   ifdef BOOST_POSIX_API
-
-    struct stat path_stat;
-    if (error(::stat(p.c_str(), &path_stat)!= 0,
-      p, ec, "boost::filesystem::last_write_time"))
-        return;
-    ::utimbuf buf;
-    buf.actime = path_stat.st_atime; // utime()updates access time too:-(
-    buf.modtime = new_time;
-    error(::utime(p.c_str(), &buf)!= 0 ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::last_write_time");
-
+    if (!native_files(p, ec, "boost::filesystem::change_owner_all"))
+      return 0;
+    attribute_change change;
+    change.user = user;
+    change.group = group;
+    boost::uintmax_t count
+      = change_attributes_all(p, change, ec, "boost::filesystem::change_owner_all");
+    backend_changed(p, true);
+    return count;
 #   else
-
-    handle_wrapper hw(
-      create_file_handle(p.c_str(), FILE_WRITE_ATTRIBUTES,
-        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
-        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, 0));
-
-    if (error(hw.handle == INVALID_HANDLE_VALUE ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::last_write_time"))
-        return;
-
-    FILETIME lwt;
-    to_FILETIME(new_time, lwt);
-
-    error(::SetFileTime(hw.handle, 0, 0, &lwt)== 0 ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::last_write_time");
+    (void)user; (void)group;
+    error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::change_owner_all");
+    return 0;
 #   endif
   }
 
-# ifdef BOOST_POSIX_API
-    const perms active_bits(all_all | set_uid_on_exe | set_gid_on_exe | sticky_bit);
-    inline mode_t mode_cast(perms prms) { return prms & active_bits; }
-# endif
-
   BOOST_FILESYSTEM_DECL
-  void permissions(const path& p, perms prms, system::error_code* ec)
+  void copy(const path& from, const path& to, system::error_code* ec)
   {
-    BOOST_ASSERT_MSG(!((prms & add_perms) && (prms & remove_perms)),
-      "add_perms and remove_perms are mutually exclusive");
-
-    if ((prms & add_perms) && (prms & remove_perms))  // precondition failed
-      return;
+    file_status s(symlink_status(from, *ec));
+    if (ec != 0 && *ec) return;
 
-# ifdef BOOST_POSIX_API
-    error_code local_ec;
-    file_status current_status((prms & symlink_perms)
-                               ? fs::symlink_status(p, local_ec)
-                               : fs::status(p, local_ec));
-    if (local_ec)
+    if(is_symlink(s))
+    {
+      copy_symlink(from, to, *ec);
+    }
+    else if(is_directory(s))
+    {
+      copy_directory(from, to, *ec);
+    }
+    else if(is_regular_file(s))
+    {
+      copy_file(from, to, fs::copy_option::fail_if_exists, *ec);
+    }
+    else
     {
       if (ec == 0)
-      BOOST_FILESYSTEM_THROW(filesystem_error(
-          "boost::filesystem::permissions", p, local_ec));
-      else
-        *ec = local_ec;
-      return;
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy",
+          from, to, error_code(BOOST_ERROR_NOT_SUPPORTED, system_category())));
+      ec->assign(BOOST_ERROR_NOT_SUPPORTED, system_category());
     }
+  }
 
-    if (prms & add_perms)
-      prms |= current_status.permissions();
-    else if (prms & remove_perms)
-      prms = current_status.permissions() & ~prms;
-
-    // OS X <10.10, iOS <8.0 and some other platforms don't support fchmodat().
-    // Solaris (SunPro and gcc) only support fchmodat() on Solaris 11 and higher,
-    // and a runtime check is too much trouble.
-    // Linux does not support permissions on symbolic links and has no plans to
-    // support them in the future.  The chmod() code is thus more practical,
-    // rather than always hitting ENOTSUP when sending in AT_SYMLINK_NO_FOLLOW.
-    //  - See the 3rd paragraph of
-    // "Symbolic link ownership, permissions, and timestamps" at:
-    //   "http://man7.org/linux/man-pages/man7/symlink.7.html"
-    //  - See the fchmodat() Linux man page:
-    //   "http://man7.org/linux/man-pages/man2/fchmodat.2.html"
-#   if defined(AT_FDCWD) && defined(AT_SYMLINK_NOFOLLOW) \
-      && !(defined(__SUNPRO_CC) || defined(__sun) || defined(sun)) \
-      && !(defined(linux) || defined(__linux) || defined(__linux__)) \
-      && !(defined(__MAC_OS_X_VERSION_MIN_REQUIRED) \
-           && __MAC_OS_X_VERSION_MIN_REQUIRED < 101000) \
-      && !(defined(__IPHONE_OS_VERSION_MIN_REQUIRED) \
-           && __IPHONE_OS_VERSION_MIN_REQUIRED < 80000)
-      if (::fchmodat(AT_FDCWD, p.c_str(), mode_cast(prms),
-           !(prms & symlink_perms) ? 0 : AT_SYMLINK_NOFOLLOW))
-#   else  // fallback if fchmodat() not supported
-      if (::chmod(p.c_str(), mode_cast(prms)))
-#   endif
+  BOOST_FILESYSTEM_DECL
+  void copy_directory(const path& from, const path& to, system::error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(copy_directory_op, &from, ec);
+    if (installed_backend)
     {
-      if (ec == 0)
-      BOOST_FILESYSTEM_THROW(filesystem_error(
-          "boost::filesystem::permissions", p,
-          error_code(errno, system::generic_category())));
-      else
-        ec->assign(errno, system::generic_category());
+      //  a backend records no attributes worth copying, so just create the directory
+      error_code result;
+      file_status from_status = installed_backend->status(from, result);
+      if (!result && from_status.type() != directory_file)
+        result.assign(from_status.type() == file_not_found
+          ? system::errc::no_such_file_or_directory : system::errc::not_a_directory,
+          system::generic_category());
+      if (!result && !installed_backend->create_directory(to, result) && !result)
+        result.assign(system::errc::file_exists, system::generic_category());
+      backend_error(result, from, to, ec, "boost::filesystem::copy_directory");
+      return;
     }
+#   ifdef BOOST_POSIX_API
+    struct stat from_stat;
+#   endif
+    error(!BOOST_COPY_DIRECTORY(from.c_str(), to.c_str()) ? BOOST_ERRNO : 0,
+      from, to, ec, "boost::filesystem::copy_directory");
+  }
 
-# else  // Windows
+  void native_copy_file(const path& from, const path& to, copy_option option,
+    error_code* ec)
+  {
+    error(!BOOST_COPY_FILE(from.c_str(), to.c_str(),
+      (option & overwrite_if_exists) == 0, (option & _detail_preallocate) != 0)
+        ? BOOST_ERRNO : 0, from, to, ec, "boost::filesystem::copy_file");
+  }
 
-    // if not going to alter FILE_ATTRIBUTE_READONLY, just return
-    if (!(!((prms & (add_perms | remove_perms)))
-      || (prms & (owner_write|group_write|others_write))))
+  BOOST_FILESYSTEM_DECL
+  void copy_file(const path& from, const path& to, copy_option option, error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(copy_file_op, &from, ec);
+    if (installed_backend)
+    {
+      error_code result;
+      installed_backend->copy_file(from, to, (option & overwrite_if_exists) != 0,
+        result);
+      backend_error(result, from, to, ec, "boost::filesystem::copy_file");
       return;
+    }
+    native_copy_file(from, to, option, ec);
+  }
 
-    DWORD attr = ::GetFileAttributesW(p.c_str());
-
-    if (error(attr == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::permissions"))
-      return;
+  BOOST_FILESYSTEM_DECL
+  void copy_symlink(const path& existing_symlink, const path& new_symlink,
+    system::error_code* ec)
+  {
+# if defined(_WIN32_WINNT) && _WIN32_WINNT < 0x0600
+    error(BOOST_ERROR_NOT_SUPPORTED, new_symlink, existing_symlink, ec,
+      "boost::filesystem::copy_symlink");
 
-    if (prms & add_perms)
-      attr &= ~FILE_ATTRIBUTE_READONLY;
-    else if (prms & remove_perms)
-      attr |= FILE_ATTRIBUTE_READONLY;
-    else if (prms & (owner_write|group_write|others_write))
-      attr &= ~FILE_ATTRIBUTE_READONLY;
-    else
-      attr |= FILE_ATTRIBUTE_READONLY;
+# else  // modern Windows or BOOST_POSIX_API 
+    path p(read_symlink(existing_symlink, ec));
+    if (ec != 0 && *ec) return;
+    create_symlink(p, new_symlink, ec);
 
-    error(::SetFileAttributesW(p.c_str(), attr) == 0 ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::permissions");
 # endif
   }
 
-  BOOST_FILESYSTEM_DECL
-  path read_symlink(const path& p, system::error_code* ec)
+ BOOST_FILESYSTEM_DECL
+  bool create_directories(const path& p, system::error_code* ec)
   {
-    path symlink_path;
+   BOOST_FILESYSTEM_PROBE(create_directories_op, &p, ec);
+   if (p.empty())
+   {
+     if (ec == 0)
+       BOOST_FILESYSTEM_THROW(filesystem_error(
+         "boost::filesystem::create_directories", p,
+         system::errc::make_error_code(system::errc::invalid_argument)));
+     else
+       ec->assign(system::errc::invalid_argument, system::generic_category());
+     return false;
+   }
 
-#   ifdef BOOST_POSIX_API
+    if (p.filename_is_dot() || p.filename_is_dot_dot())
+      return create_directories(p.parent_path(), ec);
+    
+    error_code local_ec;
+    file_status p_status = status(p, local_ec);
 
-    for (std::size_t path_max = 64;; path_max *= 2)// loop 'til buffer large enough
+    if (p_status.type() == directory_file)
     {
-      boost::scoped_array<char> buf(new char[path_max]);
-      ssize_t result;
-      if ((result=::readlink(p.c_str(), buf.get(), path_max))== -1)
-      {
-        if (ec == 0)
-          BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::read_symlink",
-            p, error_code(errno, system_category())));
-        else ec->assign(errno, system_category());
-        break;
-      }
-      else
+      if (ec != 0)
+        ec->clear();
+      return false;
+    }
+
+    path parent = p.parent_path();
+    BOOST_ASSERT_MSG(parent != p, "internal error: p == p.parent_path()");
+    if (!parent.empty())
+    {
+      // determine if the parent exists
+      file_status parent_status = status(parent, local_ec);
+
+      // if the parent does not exist, create the parent
+      if (parent_status.type() == file_not_found)
       {
-        if(result != static_cast<ssize_t>(path_max))
+        create_directories(parent, local_ec);
+        if (local_ec)
         {
-          symlink_path.assign(buf.get(), buf.get() + result);
-          if (ec != 0) ec->clear();
-          break;
+          if (ec == 0)
+            BOOST_FILESYSTEM_THROW(filesystem_error(
+              "boost::filesystem::create_directories", parent, local_ec));
+          else
+            *ec = local_ec;
+          return false;
         }
       }
     }
 
-#   elif _WIN32_WINNT < 0x0600  // SDK earlier than Vista and Server 2008
-    error(BOOST_ERROR_NOT_SUPPORTED, p, ec,
-          "boost::filesystem::read_symlink");
-#   else  // Vista and Server 2008 SDK, or later
+    // create the directory
+    return create_directory(p, ec);
+  }
 
-    union info_t
+  bool native_create_directory(const path& p, error_code* ec)
+  {
+    if (BOOST_CREATE_DIRECTORY(p.c_str()))
     {
-      char buf[REPARSE_DATA_BUFFER_HEADER_SIZE+MAXIMUM_REPARSE_DATA_BUFFER_SIZE];
-      REPARSE_DATA_BUFFER rdb;
-    } info;
+      if (ec != 0)
+        ec->clear();
+      return true;
+    }
 
-    handle_wrapper h(
-      create_file_handle(p.c_str(), GENERIC_READ, 0, 0, OPEN_EXISTING,
-        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT, 0));
+    //  attempt to create directory failed
+    int errval(BOOST_ERRNO);  // save reason for failure
+    error_code dummy;
 
-    if (error(h.handle == INVALID_HANDLE_VALUE ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::read_symlink"))
-        return symlink_path;
+    if (is_directory(p, dummy))
+    {
+      if (ec != 0)
+        ec->clear();
+      return false;
+    }
 
-    DWORD sz;
+    //  attempt to create directory failed && it doesn't already exist
+    if (ec == 0)
+      BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::create_directory",
+        p, error_code(errval, system_category())));
+    else
+      ec->assign(errval, system_category());
 
-    if (!error(::DeviceIoControl(h.handle, FSCTL_GET_REPARSE_POINT,
-          0, 0, info.buf, sizeof(info), &sz, 0) == 0 ? BOOST_ERRNO : 0, p, ec,
-          "boost::filesystem::read_symlink" ))
-      symlink_path.assign(
-        static_cast<wchar_t*>(info.rdb.SymbolicLinkReparseBuffer.PathBuffer)
-        + info.rdb.SymbolicLinkReparseBuffer.PrintNameOffset/sizeof(wchar_t),
-        static_cast<wchar_t*>(info.rdb.SymbolicLinkReparseBuffer.PathBuffer)
-        + info.rdb.SymbolicLinkReparseBuffer.PrintNameOffset/sizeof(wchar_t)
-        + info.rdb.SymbolicLinkReparseBuffer.PrintNameLength/sizeof(wchar_t));
-#     endif
-    return symlink_path;
+    return false;
   }
 
   BOOST_FILESYSTEM_DECL
-  path relative(const path& p, const path& base, error_code* ec)
+  bool create_directory(const path& p, error_code* ec)
   {
-    error_code tmp_ec;
-    path wc_base(weakly_canonical(base, &tmp_ec));
-    if (error(tmp_ec.value(), base, ec, "boost::filesystem::relative"))
-      return path();
-    path wc_p(weakly_canonical(p, &tmp_ec));
-    if (error(tmp_ec.value(), base, ec, "boost::filesystem::relative"))
-      return path();
-    return wc_p.lexically_relative(wc_base);
+    BOOST_FILESYSTEM_PROBE(create_directory_op, &p, ec);
+    if (installed_backend)
+    {
+      error_code result;
+      bool created = installed_backend->create_directory(p, result);
+      return !backend_error(result, p, ec, "boost::filesystem::create_directory")
+        && created;
+    }
+    return native_create_directory(p, ec);
   }
-  
+
   BOOST_FILESYSTEM_DECL
-  bool remove(const path& p, error_code* ec)
+  void create_directory_symlink(const path& to, const path& from,
+                                 system::error_code* ec)
   {
-    error_code tmp_ec;
-    file_type type = query_file_type(p, &tmp_ec);
-    if (error(type == status_error ? tmp_ec.value() : 0, p, ec,
-        "boost::filesystem::remove"))
-      return false;
+    if (installed_backend && !installed_backend->native())
+    {
+      //  the backend's symlinks do not distinguish directories
+      error_code result;
+      installed_backend->create_symlink(to, from, result);
+      backend_error(result, to, from, ec, "boost::filesystem::create_directory_symlink");
+      return;
+    }
 
-    // Since POSIX remove() is specified to work with either files or directories, in a
-    // perfect world it could just be called. But some important real-world operating
-    // systems (Windows, Mac OS X, for example) don't implement the POSIX spec. So
-    // remove_file_or_directory() is always called to keep it simple.
-    return remove_file_or_directory(p, type, ec);
-  }
+#   if defined(BOOST_WINDOWS_API) && _WIN32_WINNT < 0x0600  // SDK earlier than Vista and Server 2008
 
-  BOOST_FILESYSTEM_DECL
-  boost::uintmax_t remove_all(const path& p, error_code* ec)
-  {
-    error_code tmp_ec;
-    file_type type = query_file_type(p, &tmp_ec);
-    if (error(type == status_error ? tmp_ec.value() : 0, p, ec,
-      "boost::filesystem::remove_all"))
-      return 0;
+    error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec,
+      "boost::filesystem::create_directory_symlink");
+#   else
 
-    return (type != status_error && type != file_not_found) // exists
-      ? remove_all_aux(p, type, ec)
-      : 0;
-  }
+#     if defined(BOOST_WINDOWS_API) && _WIN32_WINNT >= 0x0600
+        // see if actually supported by Windows runtime dll
+        if (error(!create_symbolic_link_api ? BOOST_ERROR_NOT_SUPPORTED : 0, to, from, ec,
+            "boost::filesystem::create_directory_symlink"))
+          return;
+#     endif
 
-  BOOST_FILESYSTEM_DECL
-  void rename(const path& old_p, const path& new_p, error_code* ec)
-  {
-    error(!BOOST_MOVE_FILE(old_p.c_str(), new_p.c_str()) ? BOOST_ERRNO : 0, old_p, new_p,
-      ec, "boost::filesystem::rename");
+    error(!BOOST_CREATE_SYMBOLIC_LINK(from.c_str(), to.c_str(),
+      SYMBOLIC_LINK_FLAG_DIRECTORY) ? BOOST_ERRNO : 0,
+      to, from, ec, "boost::filesystem::create_directory_symlink");
+    backend_changed(from, true);  // paths below from now resolve through it
+#   endif
   }
 
   BOOST_FILESYSTEM_DECL
-  void resize_file(const path& p, uintmax_t size, system::error_code* ec)
+  void create_hard_link(const path& to, const path& from, error_code* ec)
   {
-    error(!BOOST_RESIZE_FILE(p.c_str(), size) ? BOOST_ERRNO : 0, p, ec,
-      "boost::filesystem::resize_file");
+    if (!native_files(from, ec, "boost::filesystem::create_hard_link"))
+      return;
+
+#   if defined(BOOST_WINDOWS_API) && _WIN32_WINNT < 0x0500  // SDK earlier than Win 2K
+
+    error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec,
+      "boost::filesystem::create_hard_link");
+#   else
+
+#     if defined(BOOST_WINDOWS_API) && _WIN32_WINNT >= 0x0500
+        // see if actually supported by Windows runtime dll
+        if (error(!create_hard_link_api ? BOOST_ERROR_NOT_SUPPORTED : 0, to, from, ec,
+            "boost::filesystem::create_hard_link"))
+          return;
+#     endif
+
+    error(!BOOST_CREATE_HARD_LINK(from.c_str(), to.c_str()) ? BOOST_ERRNO : 0, to, from, ec,
+      "boost::filesystem::create_hard_link");
+    backend_changed(from, false);
+#   endif
   }
 
-  BOOST_FILESYSTEM_DECL
-  space_info space(const path& p, error_code* ec)
+  void native_create_symlink(const path& to, const path& from, error_code* ec)
   {
-#   ifdef BOOST_POSIX_API
-    struct BOOST_STATVFS vfs;
-    space_info info;
-    if (!error(::BOOST_STATVFS(p.c_str(), &vfs) ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::space"))
-    {
-      info.capacity 
-        = static_cast<boost::uintmax_t>(vfs.f_blocks)* BOOST_STATVFS_F_FRSIZE;
-      info.free 
-        = static_cast<boost::uintmax_t>(vfs.f_bfree)* BOOST_STATVFS_F_FRSIZE;
-      info.available
-        = static_cast<boost::uintmax_t>(vfs.f_bavail)* BOOST_STATVFS_F_FRSIZE;
-    }
-
+#   if defined(BOOST_WINDOWS_API) && _WIN32_WINNT < 0x0600  // SDK earlier than Vista and Server 2008
+    error(BOOST_ERROR_NOT_SUPPORTED, to, from, ec,
+      "boost::filesystem::create_directory_symlink");
 #   else
-    ULARGE_INTEGER avail, total, free;
-    space_info info;
 
-    if (!error(::GetDiskFreeSpaceExW(p.c_str(), &avail, &total, &free)== 0,
-       p, ec, "boost::filesystem::space"))
-    {
-      info.capacity
-        = (static_cast<boost::uintmax_t>(total.HighPart)<< 32)
-          + total.LowPart;
-      info.free
-        = (static_cast<boost::uintmax_t>(free.HighPart)<< 32)
-          + free.LowPart;
-      info.available
-        = (static_cast<boost::uintmax_t>(avail.HighPart)<< 32)
-          + avail.LowPart;
-    }
+#     if defined(BOOST_WINDOWS_API) && _WIN32_WINNT >= 0x0600
+        // see if actually supported by Windows runtime dll
+        if (error(!create_symbolic_link_api ? BOOST_ERROR_NOT_SUPPORTED : 0, to, from, ec,
+            "boost::filesystem::create_symlink"))
+          return;
+#     endif
 
+    error(!BOOST_CREATE_SYMBOLIC_LINK(from.c_str(), to.c_str(), 0) ? BOOST_ERRNO : 0,
+      to, from, ec, "boost::filesystem::create_symlink");
 #   endif
+  }
 
-    else
+  BOOST_FILESYSTEM_DECL
+  void create_symlink(const path& to, const path& from, error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(create_symlink_op, &from, ec);
+    if (installed_backend)
     {
-      info.capacity = info.free = info.available = 0;
+      error_code result;
+      installed_backend->create_symlink(to, from, result);
+      backend_error(result, to, from, ec, "boost::filesystem::create_symlink");
+      return;
     }
-    return info;
+    native_create_symlink(to, from, ec);
   }
 
   BOOST_FILESYSTEM_DECL
-  file_status status(const path& p, error_code* ec)
+  path current_path(error_code* ec)
   {
 #   ifdef BOOST_POSIX_API
-
-    struct stat path_stat;
-    if (::stat(p.c_str(), &path_stat)!= 0)
+    path cur;
+    char small_buf[1024];  // almost always enough, so the heap is seldom needed
+    boost::scoped_array<char> big_buf;
+    char* buf = small_buf;
+    for (std::size_t path_max = sizeof(small_buf);; path_max *=2)// 'til large enough
     {
-      if (ec != 0)                            // always report errno, even though some
-        ec->assign(errno, system_category());   // errno values are not status_errors
-
-      if (not_found_error(errno))
+      if (::getcwd(buf, path_max)== 0)
       {
-        return fs::file_status(fs::file_not_found, fs::no_perms);
+        if (error(errno != ERANGE ? errno : 0
+      // bug in some versions of the Metrowerks C lib on the Mac: wrong errno set 
+#         if defined(__MSL__) && (defined(macintosh) || defined(__APPLE__) || defined(__APPLE_CC__))
+          && errno != 0
+#         endif
+          , ec, "boost::filesystem::current_path"))
+        {
+          break;
+        }
+        big_buf.reset(new char[path_max * 2]);
+        buf = big_buf.get();
       }
-      if (ec == 0)
-        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::status",
-          p, error_code(errno, system_category())));
-      return fs::file_status(fs::status_error);
-    }
-    if (ec != 0) ec->clear();;
-    if (S_ISDIR(path_stat.st_mode))
-      return fs::file_status(fs::directory_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISREG(path_stat.st_mode))
-      return fs::file_status(fs::regular_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISBLK(path_stat.st_mode))
-      return fs::file_status(fs::block_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISCHR(path_stat.st_mode))
-      return fs::file_status(fs::character_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISFIFO(path_stat.st_mode))
-      return fs::file_status(fs::fifo_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISSOCK(path_stat.st_mode))
-      return fs::file_status(fs::socket_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    return fs::file_status(fs::type_unknown);
-
-#   else  // Windows
-
-    DWORD attr(::GetFileAttributesW(p.c_str()));
-    if (attr == 0xFFFFFFFF)
-    {
-      return process_status_failure(p, ec);
-    }
-
-    //  reparse point handling;
-    //    since GetFileAttributesW does not resolve symlinks, try to open a file
-    //    handle to discover if the file exists
-    if (attr & FILE_ATTRIBUTE_REPARSE_POINT)
-    {
-      handle_wrapper h(
-        create_file_handle(
-            p.c_str(),
-            0,  // dwDesiredAccess; attributes only
-            FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
-            0,  // lpSecurityAttributes
-            OPEN_EXISTING,
-            FILE_FLAG_BACKUP_SEMANTICS,
-            0)); // hTemplateFile
-      if (h.handle == INVALID_HANDLE_VALUE)
+      else
       {
-        return process_status_failure(p, ec);
+        cur = buf;
+        if (ec != 0) ec->clear();
+        break;
       }
+    }
+    return cur;
 
-      if (!is_reparse_point_a_symlink(p))
-        return file_status(reparse_file, make_permissions(p, attr));
+#   else
+    path::value_type small_buf[MAX_PATH];
+    DWORD sz = ::GetCurrentDirectoryW(MAX_PATH, small_buf);
+    if (sz != 0 && sz < MAX_PATH)  // otherwise sz is the size needed, or 0 on error
+    {
+      if (ec != 0) ec->clear();
+      return path(small_buf);
     }
+    if (sz == 0)sz = 1;
+    boost::scoped_array<path::value_type> buf(new path::value_type[sz]);
+    buf[0] = 0;
+    error(::GetCurrentDirectoryW(sz, buf.get()) == 0 ? BOOST_ERRNO : 0, ec,
+      "boost::filesystem::current_path");
+    return path(buf.get());
+#   endif
+  }
 
-    if (ec != 0) ec->clear();
-    return (attr & FILE_ATTRIBUTE_DIRECTORY)
-      ? file_status(directory_file, make_permissions(p, attr))
-      : file_status(regular_file, make_permissions(p, attr));
 
-#   endif
+  BOOST_FILESYSTEM_DECL
+  void current_path(const path& p, system::error_code* ec)
+  {
+    err_t err = !BOOST_SET_CURRENT_DIRECTORY(p.c_str()) ? BOOST_ERRNO : 0;
+    if (err == 0)
+      invalidate_cached_current_path();
+    error(err, p, ec, "boost::filesystem::current_path");
   }
 
   BOOST_FILESYSTEM_DECL
-  file_status symlink_status(const path& p, error_code* ec)
+  path cached_current_path(bool revalidate, system::error_code* ec)
   {
+    cwd_snapshot& snapshot = the_cwd_snapshot();
+    fs::detail::scoped_worker_lock lock(snapshot.mutex);
 #   ifdef BOOST_POSIX_API
+    struct stat dot;
+    if (snapshot.valid && revalidate
+      && (::stat(".", &dot)!= 0
+        || static_cast<boost::uint64_t>(dot.st_dev)!= snapshot.device
+        || static_cast<boost::uint64_t>(dot.st_ino)!= snapshot.inode))
+      snapshot.valid = false;
+#   else
+    if (revalidate)  // GetCurrentDirectoryW makes no system call, so just call it again
+      snapshot.valid = false;
+#   endif
 
-    struct stat path_stat;
-    if (::lstat(p.c_str(), &path_stat)!= 0)
+    if (!snapshot.valid)
     {
-      if (ec != 0)                            // always report errno, even though some
-        ec->assign(errno, system_category());   // errno values are not status_errors
-
-      if (errno == ENOENT || errno == ENOTDIR) // these are not errors
-      {
-        return fs::file_status(fs::file_not_found, fs::no_perms);
-      }
-      if (ec == 0)
-        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::status",
-          p, error_code(errno, system_category())));
-      return fs::file_status(fs::status_error);
+#     ifdef BOOST_POSIX_API
+      //  "." is looked at before the directory is found, so that a change of directory
+      //  in between leaves a snapshot that the next revalidation will find stale
+      if (::stat(".", &dot)!= 0)
+        dot.st_dev = dot.st_ino = 0;
+#     endif
+      error_code tmp_ec;
+      path cwd(current_path(&tmp_ec));
+      if (error(tmp_ec.value(), ec, "boost::filesystem::cached_current_path"))
+        return path();
+      snapshot.cwd.swap(cwd);
+#     ifdef BOOST_POSIX_API
+      snapshot.device = static_cast<boost::uint64_t>(dot.st_dev);
+      snapshot.inode = static_cast<boost::uint64_t>(dot.st_ino);
+#     endif
+      snapshot.valid = true;
     }
-    if (ec != 0) ec->clear();
-    if (S_ISREG(path_stat.st_mode))
-      return fs::file_status(fs::regular_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISDIR(path_stat.st_mode))
-      return fs::file_status(fs::directory_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISLNK(path_stat.st_mode))
-      return fs::file_status(fs::symlink_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISBLK(path_stat.st_mode))
-      return fs::file_status(fs::block_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISCHR(path_stat.st_mode))
-      return fs::file_status(fs::character_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISFIFO(path_stat.st_mode))
-      return fs::file_status(fs::fifo_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    if (S_ISSOCK(path_stat.st_mode))
-      return fs::file_status(fs::socket_file,
-        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
-    return fs::file_status(fs::type_unknown);
+    else if (ec != 0)
+      ec->clear();
+    return snapshot.cwd;
+  }
 
-#   else  // Windows
+  BOOST_FILESYSTEM_DECL
+  void invalidate_cached_current_path()
+  {
+    cwd_snapshot& snapshot = the_cwd_snapshot();
+    fs::detail::scoped_worker_lock lock(snapshot.mutex);
+    snapshot.valid = false;
+  }
 
-    DWORD attr(::GetFileAttributesW(p.c_str()));
-    if (attr == 0xFFFFFFFF)
+  BOOST_FILESYSTEM_DECL
+  bool equivalent(const path& p1, const path& p2, system::error_code* ec)
+  {
+    if (!native_files(p1, ec, "boost::filesystem::equivalent"))
+      return false;
+#   ifdef BOOST_POSIX_API
+    struct stat s2;
+    int e2(::stat(p2.c_str(), &s2));
+    struct stat s1;
+    int e1(::stat(p1.c_str(), &s1));
+
+    if (e1 != 0 || e2 != 0)
     {
-      return process_status_failure(p, ec);
+      // if one is invalid and the other isn't then they aren't equivalent,
+      // but if both are invalid then it is an error
+      error (e1 != 0 && e2 != 0, p1, p2, ec, "boost::filesystem::equivalent");
+      return false;
     }
 
-    if (ec != 0) ec->clear();
-
-    if (attr & FILE_ATTRIBUTE_REPARSE_POINT)
-      return is_reparse_point_a_symlink(p)
-             ? file_status(symlink_file, make_permissions(p, attr))
-             : file_status(reparse_file, make_permissions(p, attr));
+    // both stats now known to be valid
+    return  s1.st_dev == s2.st_dev && s1.st_ino == s2.st_ino
+        // According to the POSIX stat specs, "The st_ino and st_dev fields
+        // taken together uniquely identify the file within the system."
+        // Just to be sure, size and mod time are also checked.
+        && s1.st_size == s2.st_size && s1.st_mtime == s2.st_mtime;
 
-    return (attr & FILE_ATTRIBUTE_DIRECTORY)
-      ? file_status(directory_file, make_permissions(p, attr))
-      : file_status(regular_file, make_permissions(p, attr));
+#   else  // Windows
 
-#   endif
-  }
+    // Note well: Physical location on external media is part of the
+    // equivalence criteria. If there are no open handles, physical location
+    // can change due to defragmentation or other relocations. Thus handles
+    // must be held open until location information for both paths has
+    // been retrieved.
 
-   // contributed by Jeff Flinn
-  BOOST_FILESYSTEM_DECL
-  path temp_directory_path(system::error_code* ec)
-  {
+    // p2 is done first, so any error reported is for p1
+    handle_wrapper h2(
+      create_file_handle(
+          p2.c_str(),
+          0,
+          FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+          0,
+          OPEN_EXISTING,
+          FILE_FLAG_BACKUP_SEMANTICS,
+          0));
+
+    handle_wrapper h1(
+      create_file_handle(
+          p1.c_str(),
+          0,
+          FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+          0,
+          OPEN_EXISTING,
+          FILE_FLAG_BACKUP_SEMANTICS,
+          0));
+
+    if (h1.handle == INVALID_HANDLE_VALUE
+      || h2.handle == INVALID_HANDLE_VALUE)
+    {
+      // if one is invalid and the other isn't, then they aren't equivalent,
+      // but if both are invalid then it is an error
+      error((h1.handle == INVALID_HANDLE_VALUE
+        && h2.handle == INVALID_HANDLE_VALUE) ? BOOST_ERROR_NOT_SUPPORTED : 0, p1, p2, ec,
+          "boost::filesystem::equivalent");
+      return false;
+    }
+
+    // at this point, both handles are known to be valid
+
+    BY_HANDLE_FILE_INFORMATION info1, info2;
+
+    if (error(!::GetFileInformationByHandle(h1.handle, &info1) ? BOOST_ERRNO : 0,
+      p1, p2, ec, "boost::filesystem::equivalent"))
+        return  false;
+
+    if (error(!::GetFileInformationByHandle(h2.handle, &info2) ? BOOST_ERRNO : 0,
+      p1, p2, ec, "boost::filesystem::equivalent"))
+        return  false;
+
+    // In theory, volume serial numbers are sufficient to distinguish between
+    // devices, but in practice VSN's are sometimes duplicated, so last write
+    // time and file size are also checked.
+      return 
+        info1.dwVolumeSerialNumber == info2.dwVolumeSerialNumber
+        && info1.nFileIndexHigh == info2.nFileIndexHigh
+        && info1.nFileIndexLow == info2.nFileIndexLow
+        && info1.nFileSizeHigh == info2.nFileSizeHigh
+        && info1.nFileSizeLow == info2.nFileSizeLow
+        && info1.ftLastWriteTime.dwLowDateTime
+          == info2.ftLastWriteTime.dwLowDateTime
+        && info1.ftLastWriteTime.dwHighDateTime
+          == info2.ftLastWriteTime.dwHighDateTime;
+
+#   endif
+  }
+
+  boost::uintmax_t native_file_size(const path& p, error_code* ec)
+  {
 #   ifdef BOOST_POSIX_API
-      const char* val = 0;
-      
-      (val = std::getenv("TMPDIR" )) ||
-      (val = std::getenv("TMP"    )) ||
-      (val = std::getenv("TEMP"   )) ||
-      (val = std::getenv("TEMPDIR"));
-      
-#     ifdef __ANDROID__
-        const char* default_tmp = "/data/local/tmp";
-#     else
-        const char* default_tmp = "/tmp";
-#     endif
-      path p((val!=0) ? val : default_tmp);
-       
-      if (p.empty() || (ec&&!is_directory(p, *ec))||(!ec&&!is_directory(p)))
+
+    struct stat path_stat;
+    if (error(BOOST_FILESYSTEM_SYSCALL(::stat(p.c_str(), &path_stat))!= 0
+        ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::file_size"))
+      return static_cast<boost::uintmax_t>(-1);
+   if (error(!S_ISREG(path_stat.st_mode) ? EPERM : 0,
+        p, ec, "boost::filesystem::file_size"))
+      return static_cast<boost::uintmax_t>(-1);
+
+    return static_cast<boost::uintmax_t>(path_stat.st_size);
+
+#   else  // Windows
+
+    // assume uintmax_t is 64-bits on all Windows compilers
+
+    WIN32_FILE_ATTRIBUTE_DATA fad;
+
+    if (error(::GetFileAttributesExW(p.c_str(), ::GetFileExInfoStandard, &fad)== 0
+      ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::file_size"))
+          return static_cast<boost::uintmax_t>(-1);
+
+    if (error((fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)!= 0
+      ? ERROR_NOT_SUPPORTED : 0, p, ec, "boost::filesystem::file_size"))
+      return static_cast<boost::uintmax_t>(-1);
+
+    return (static_cast<boost::uintmax_t>(fad.nFileSizeHigh)
+              << (sizeof(fad.nFileSizeLow)*8)) + fad.nFileSizeLow;
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL
+  boost::uintmax_t file_size(const path& p, error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(file_size_op, &p, ec);
+    if (installed_backend)
+    {
+      error_code result;
+      boost::uintmax_t size = installed_backend->file_size(p, result);
+      return backend_error(result, p, ec, "boost::filesystem::file_size")
+        ? static_cast<boost::uintmax_t>(-1) : size;
+    }
+    return native_file_size(p, ec);
+  }
+
+  BOOST_FILESYSTEM_DECL
+  boost::uintmax_t hard_link_count(const path& p, system::error_code* ec)
+  {
+    if (!native_files(p, ec, "boost::filesystem::hard_link_count"))
+      return 0;
+#   ifdef BOOST_POSIX_API
+
+    struct stat path_stat;
+    return error(::stat(p.c_str(), &path_stat)!= 0 ? BOOST_ERRNO : 0,
+                  p, ec, "boost::filesystem::hard_link_count")
+           ? 0
+           : static_cast<boost::uintmax_t>(path_stat.st_nlink);
+
+#   else // Windows
+
+    // Link count info is only available through GetFileInformationByHandle
+    BY_HANDLE_FILE_INFORMATION info;
+    handle_wrapper h(
+      create_file_handle(p.c_str(), 0,
+          FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
+          OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, 0));
+    return
+      !error(h.handle == INVALID_HANDLE_VALUE ? BOOST_ERRNO : 0,
+              p, ec, "boost::filesystem::hard_link_count")
+      && !error(::GetFileInformationByHandle(h.handle, &info)== 0 ? BOOST_ERRNO : 0,
+                 p, ec, "boost::filesystem::hard_link_count")
+           ? info.nNumberOfLinks
+           : 0;
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL
+  path initial_path(error_code* ec)
+  {
+      static path init_path;
+      if (init_path.empty())
+        init_path = current_path(ec);
+      else if (ec != 0) ec->clear();
+      return init_path;
+  }
+
+  BOOST_FILESYSTEM_DECL
+  bool is_empty(const path& p, system::error_code* ec)
+  {
+    if (installed_backend && !installed_backend->native())
+    {
+      error_code result;
+      file_status s = detail::status(p, &result);
+      if (!result && is_directory(s))
+        return is_empty_directory(p, ec);  // lists through the backend
+      boost::uintmax_t size = result ? 0 : installed_backend->file_size(p, result);
+      return !backend_error(result, p, ec, "boost::filesystem::is_empty") && size == 0;
+    }
+
+#   ifdef BOOST_POSIX_API
+
+    struct stat path_stat;
+    if (error(::stat(p.c_str(), &path_stat)!= 0,
+        p, ec, "boost::filesystem::is_empty"))
+      return false;        
+    return S_ISDIR(path_stat.st_mode)
+      ? is_empty_directory(p, ec)
+      : path_stat.st_size == 0;
+#   else
+
+    WIN32_FILE_ATTRIBUTE_DATA fad;
+    if (error(::GetFileAttributesExW(p.c_str(), ::GetFileExInfoStandard, &fad)== 0
+      ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::is_empty"))
+        return false;
+
+    if (ec != 0) ec->clear();
+    return 
+      (fad.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        ? is_empty_directory(p, ec)
+        : (!fad.nFileSizeHigh && !fad.nFileSizeLow);
+#   endif
+  }
+
+  std::time_t native_last_write_time(const path& p, system::error_code* ec)
+  {
+#   ifdef BOOST_POSIX_API
+
+    struct stat path_stat;
+    if (error(::stat(p.c_str(), &path_stat)!= 0 ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::last_write_time"))
+        return std::time_t(-1);
+    return path_stat.st_mtime;
+
+#   else
+
+    handle_wrapper hw(
+      create_file_handle(p.c_str(), 0,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
+        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, 0));
+
+    if (error(hw.handle == INVALID_HANDLE_VALUE ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::last_write_time"))
+        return std::time_t(-1);
+
+    FILETIME lwt;
+
+    if (error(::GetFileTime(hw.handle, 0, 0, &lwt)== 0 ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::last_write_time"))
+        return std::time_t(-1);
+
+    return to_time_t(lwt);
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL
+  std::time_t last_write_time(const path& p, system::error_code* ec)
+  {
+    if (installed_backend)
+    {
+      error_code result;
+      std::time_t t = installed_backend->last_write_time(p, result);
+      return backend_error(result, p, ec, "boost::filesystem::last_write_time")
+        ? std::time_t(-1) : t;
+    }
+    return native_last_write_time(p, ec);
+  }
+
+  void native_last_write_time(const path& p, const std::time_t new_time,
+                        system::error_code* ec)
+  {
+#   ifdef BOOST_POSIX_API
+
+    struct stat path_stat;
+    if (error(::stat(p.c_str(), &path_stat)!= 0,
+      p, ec, "boost::filesystem::last_write_time"))
+        return;
+    ::utimbuf buf;
+    buf.actime = path_stat.st_atime; // utime()updates access time too:-(
+    buf.modtime = new_time;
+    error(::utime(p.c_str(), &buf)!= 0 ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::last_write_time");
+
+#   else
+
+    handle_wrapper hw(
+      create_file_handle(p.c_str(), FILE_WRITE_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
+        OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, 0));
+
+    if (error(hw.handle == INVALID_HANDLE_VALUE ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::last_write_time"))
+        return;
+
+    FILETIME lwt;
+    to_FILETIME(new_time, lwt);
+
+    error(::SetFileTime(hw.handle, 0, 0, &lwt)== 0 ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::last_write_time");
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL
+  void last_write_time(const path& p, const std::time_t new_time,
+                        system::error_code* ec)
+  {
+    if (installed_backend)
+    {
+      error_code result;
+      installed_backend->last_write_time(p, new_time, result);
+      backend_error(result, p, ec, "boost::filesystem::last_write_time");
+      return;
+    }
+    native_last_write_time(p, new_time, ec);
+  }
+
+  BOOST_FILESYSTEM_DECL
+  void move(const path& from, const path& to, unsigned int options,
+    move_progress_handler handler, void* context, system::error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(move_op, &from, ec);
+    if (installed_backend && !installed_backend->native())
+    {
+      //  a file system other than the native one is a single device, so a rename
+      //  always suffices
+      error_code result;
+      installed_backend->rename(from, to, result);
+      backend_error(result, from, to, ec, "boost::filesystem::move");
+      return;
+    }
+    err_t err = BOOST_ERROR_NOT_SAME_DEVICE;  // as if across devices, for always_copy
+    if (!(options & static_cast<unsigned int>(move_option::always_copy)))
+    {
+      if (installed_backend)
+      {
+        //  one over the native file system fails across devices as the native one does
+        error_code result;
+        installed_backend->rename(from, to, result);
+        if (result.value() != BOOST_ERROR_NOT_SAME_DEVICE
+          || result.category() != system_category())
+        {
+          backend_error(result, from, to, ec, "boost::filesystem::move");
+          return;
+        }
+      }
+      else if (BOOST_MOVE_FILE(from.c_str(), to.c_str()))
+      {
+        if (ec != 0)
+          ec->clear();
+        return;
+      }
+      else
+        err = BOOST_ERRNO;
+    }
+    if (err != BOOST_ERROR_NOT_SAME_DEVICE
+      || (options & static_cast<unsigned int>(move_option::no_copy)))
+    {
+      error(err, from, to, ec, "boost::filesystem::move");
+      return;
+    }
+
+    //  from and to are on different devices, so copy from and then remove it. Directory
+    //  trees are copied by several threads unless the caller asked for just one.
+    error_code tmp_ec;
+    file_type type = detail::symlink_status(from, &tmp_ec).type();
+    if (error(tmp_ec.value(), from, ec, "boost::filesystem::move"))
+      return;
+
+    //  what rename() would refuse is refused here too, unless the caller says the target
+    //  was left by an interrupted move of from, to be completed
+    bool resume = (options & static_cast<unsigned int>(move_option::resume)) != 0;
+    if (!resume)
+    {
+      err = move_target_error(type, to);
+      if (error(err, from, to, ec, "boost::filesystem::move"))
+        return;
+    }
+
+    tree_mover mover(to, resume, handler, context);
+    detail::work_queue<move_task> queue(type == directory_file
+      && !(options & static_cast<unsigned int>(move_option::single_thread)) ? 0 : 1);
+    queue.push(move_task(from, to, type));
+    queue.run(mover);
+    backend_changed(to, true);  // files are copied by system calls, not the backend
+    if (mover.error_value() == 0)
+      mover.finish_directories();
+    if (mover.error_value() != 0)
+    {
+      if (mover.error_from().empty())  // abandoned by the progress handler
+        error(mover.error_value(), from, to, ec, "boost::filesystem::move");
+      else
+        error(mover.error_value(), mover.error_from(), mover.error_to(), ec,
+          "boost::filesystem::move");
+      return;
+    }
+
+    //  the copy is complete; only now is it safe to remove the source
+    boost::uintmax_t removed = 0;
+#   ifdef BOOST_FILESYSTEM_AT_FUNCTIONS
+    err = remove_all_at(AT_FDCWD, from.c_str(), true, removed);
+#   else
+    removed = detail::remove_all(from, &tmp_ec);
+    err = tmp_ec.value();
+#   endif
+    backend_changed(from, true);
+    if (error(err, from, ec, "boost::filesystem::move"))
+      return;
+    mover.report_removed(removed);
+  }
+
+# ifdef BOOST_POSIX_API
+    const perms active_bits(all_all | set_uid_on_exe | set_gid_on_exe | sticky_bit);
+    inline mode_t mode_cast(perms prms) { return prms & active_bits; }
+# endif
+
+  void native_permissions(const path& p, perms prms, system::error_code* ec)
+  {
+    BOOST_ASSERT_MSG(!((prms & add_perms) && (prms & remove_perms)),
+      "add_perms and remove_perms are mutually exclusive");
+
+    if ((prms & add_perms) && (prms & remove_perms))  // precondition failed
+      return;
+
+# ifdef BOOST_POSIX_API
+    error_code local_ec;
+    file_status current_status((prms & symlink_perms)
+                               ? fs::symlink_status(p, local_ec)
+                               : fs::status(p, local_ec));
+    if (local_ec)
+    {
+      if (ec == 0)
+      BOOST_FILESYSTEM_THROW(filesystem_error(
+          "boost::filesystem::permissions", p, local_ec));
+      else
+        *ec = local_ec;
+      return;
+    }
+
+    if (prms & add_perms)
+      prms |= current_status.permissions();
+    else if (prms & remove_perms)
+      prms = current_status.permissions() & ~prms;
+
+    // OS X <10.10, iOS <8.0 and some other platforms don't support fchmodat().
+    // Solaris (SunPro and gcc) only support fchmodat() on Solaris 11 and higher,
+    // and a runtime check is too much trouble.
+    // Linux does not support permissions on symbolic links and has no plans to
+    // support them in the future.  The chmod() code is thus more practical,
+    // rather than always hitting ENOTSUP when sending in AT_SYMLINK_NO_FOLLOW.
+    //  - See the 3rd paragraph of
+    // "Symbolic link ownership, permissions, and timestamps" at:
+    //   "http://man7.org/linux/man-pages/man7/symlink.7.html"
+    //  - See the fchmodat() Linux man page:
+    //   "http://man7.org/linux/man-pages/man2/fchmodat.2.html"
+#   if defined(AT_FDCWD) && defined(AT_SYMLINK_NOFOLLOW) \
+      && !(defined(__SUNPRO_CC) || defined(__sun) || defined(sun)) \
+      && !(defined(linux) || defined(__linux) || defined(__linux__)) \
+      && !(defined(__MAC_OS_X_VERSION_MIN_REQUIRED) \
+           && __MAC_OS_X_VERSION_MIN_REQUIRED < 101000) \
+      && !(defined(__IPHONE_OS_VERSION_MIN_REQUIRED) \
+           && __IPHONE_OS_VERSION_MIN_REQUIRED < 80000)
+      if (::fchmodat(AT_FDCWD, p.c_str(), mode_cast(prms),
+           !(prms & symlink_perms) ? 0 : AT_SYMLINK_NOFOLLOW))
+#   else  // fallback if fchmodat() not supported
+      if (::chmod(p.c_str(), mode_cast(prms)))
+#   endif
+    {
+      if (ec == 0)
+      BOOST_FILESYSTEM_THROW(filesystem_error(
+          "boost::filesystem::permissions", p,
+          error_code(errno, system::generic_category())));
+      else
+        ec->assign(errno, system::generic_category());
+    }
+
+# else  // Windows
+
+    // if not going to alter FILE_ATTRIBUTE_READONLY, just return
+    if (!(!((prms & (add_perms | remove_perms)))
+      || (prms & (owner_write|group_write|others_write))))
+      return;
+
+    DWORD attr = ::GetFileAttributesW(p.c_str());
+
+    if (error(attr == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::permissions"))
+      return;
+
+    if (prms & add_perms)
+      attr &= ~FILE_ATTRIBUTE_READONLY;
+    else if (prms & remove_perms)
+      attr |= FILE_ATTRIBUTE_READONLY;
+    else if (prms & (owner_write|group_write|others_write))
+      attr &= ~FILE_ATTRIBUTE_READONLY;
+    else
+      attr |= FILE_ATTRIBUTE_READONLY;
+
+    error(::SetFileAttributesW(p.c_str(), attr) == 0 ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::permissions");
+# endif
+  }
+
+  BOOST_FILESYSTEM_DECL
+  void permissions(const path& p, perms prms, system::error_code* ec)
+  {
+    if (!native_files(p, ec, "boost::filesystem::permissions"))
+      return;
+    native_permissions(p, prms, ec);
+    backend_changed(p, false);
+  }
+
+  BOOST_FILESYSTEM_DECL
+  boost::uintmax_t permissions_all(const path& p, perms prms, system::error_code* ec)
+  {
+    BOOST_ASSERT_MSG(!((prms & add_perms) && (prms & remove_perms)),
+      "add_perms and remove_perms are mutually exclusive");
+
+    if ((prms & add_perms) && (prms & remove_perms))  // precondition failed
+      return 0;
+
+    if (!native_files(p, ec, "boost::filesystem::permissions_all"))
+      return 0;
+    attribute_change change;
+    change.set_mode = true;
+    change.prms = prms;
+    boost::uintmax_t count
+      = change_attributes_all(p, change, ec, "boost::filesystem::permissions_all");
+    backend_changed(p, true);
+    return count;
+  }
+
+  BOOST_FILESYSTEM_DECL
+  void preallocate(const path& p, boost::uintmax_t offset, boost::uintmax_t length,
+    unsigned int options, system::error_code* ec)
+  {
+    if (!native_files(p, ec, "boost::filesystem::preallocate"))
+      return;
+#   ifdef BOOST_POSIX_API
+    int fd = ::open(p.c_str(), O_WRONLY);
+    if (error(fd < 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::preallocate"))
+      return;
+    int err = preallocate_api(fd, offset, length, options);
+    if (::close(fd)!= 0 && err == 0)
+      err = errno;
+    backend_changed(p, false);
+    error(err, p, ec, "boost::filesystem::preallocate");
+#   else
+    handle_wrapper h(
+      create_file_handle(p.c_str(), GENERIC_WRITE,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
+        OPEN_EXISTING, 0, 0));
+    if (error(h.handle == INVALID_HANDLE_VALUE ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::preallocate"))
+        return;
+    err_t err = preallocate_api(h.handle, offset, length, options);
+    backend_changed(p, false);
+    error(err, p, ec, "boost::filesystem::preallocate");
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL
+  void preallocate(native_file_handle h, boost::uintmax_t offset,
+    boost::uintmax_t length, unsigned int options, system::error_code* ec)
+  {
+    error(preallocate_api(h, offset, length, options), ec,
+      "boost::filesystem::preallocate");
+  }
+
+  BOOST_FILESYSTEM_DECL
+  boost::uintmax_t prefetch(const path& p, boost::uintmax_t offset,
+    boost::uintmax_t length, system::error_code* ec)
+  {
+    if (!native_files(p, ec, "boost::filesystem::prefetch"))
+      return 0;
+#   if defined(BOOST_POSIX_API) && defined(POSIX_FADV_WILLNEED)
+    //  O_NONBLOCK, so that opening a FIFO does not wait for a writer
+    int fd = ::open(p.c_str(), O_RDONLY | O_NONBLOCK | O_NOCTTY);
+    if (error(fd < 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::prefetch"))
+      return 0;
+    struct stat st;
+    int err = ::fstat(fd, &st) != 0 ? errno : 0;
+    boost::uintmax_t bytes = 0;
+    if (err == 0 && S_ISREG(st.st_mode)
+      && offset < static_cast<boost::uintmax_t>(st.st_size))
+    {
+      bytes = static_cast<boost::uintmax_t>(st.st_size) - offset;
+      if (length != 0 && length < bytes)
+        bytes = length;
+      //  returns the error rather than setting errno
+      err = ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(bytes),
+        POSIX_FADV_WILLNEED);
+    }
+    ::close(fd);
+    if (error(err, p, ec, "boost::filesystem::prefetch"))
+      return 0;
+    return bytes;
+#   else
+    (void)p;  // no such request to make
+    (void)offset;
+    (void)length;
+    if (ec != 0)
+      ec->clear();
+    return 0;
+#   endif
+  }
+
+  path native_read_symlink(const path& p, system::error_code* ec)
+  {
+    path symlink_path;
+
+#   ifdef BOOST_POSIX_API
+
+    for (std::size_t path_max = 64;; path_max *= 2)// loop 'til buffer large enough
+    {
+      boost::scoped_array<char> buf(new char[path_max]);
+      ssize_t result;
+      if ((result=::readlink(p.c_str(), buf.get(), path_max))== -1)
+      {
+        if (ec == 0)
+          BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::read_symlink",
+            p, error_code(errno, system_category())));
+        else ec->assign(errno, system_category());
+        break;
+      }
+      else
+      {
+        if(result != static_cast<ssize_t>(path_max))
+        {
+          symlink_path.assign(buf.get(), buf.get() + result);
+          if (ec != 0) ec->clear();
+          break;
+        }
+      }
+    }
+
+#   elif _WIN32_WINNT < 0x0600  // SDK earlier than Vista and Server 2008
+    error(BOOST_ERROR_NOT_SUPPORTED, p, ec,
+          "boost::filesystem::read_symlink");
+#   else  // Vista and Server 2008 SDK, or later
+
+    union info_t
+    {
+      char buf[REPARSE_DATA_BUFFER_HEADER_SIZE+MAXIMUM_REPARSE_DATA_BUFFER_SIZE];
+      REPARSE_DATA_BUFFER rdb;
+    } info;
+
+    handle_wrapper h(
+      create_file_handle(p.c_str(), GENERIC_READ, 0, 0, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT, 0));
+
+    if (error(h.handle == INVALID_HANDLE_VALUE ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::read_symlink"))
+        return symlink_path;
+
+    DWORD sz;
+
+    if (!error(::DeviceIoControl(h.handle, FSCTL_GET_REPARSE_POINT,
+          0, 0, info.buf, sizeof(info), &sz, 0) == 0 ? BOOST_ERRNO : 0, p, ec,
+          "boost::filesystem::read_symlink" ))
+      symlink_path.assign(
+        static_cast<wchar_t*>(info.rdb.SymbolicLinkReparseBuffer.PathBuffer)
+        + info.rdb.SymbolicLinkReparseBuffer.PrintNameOffset/sizeof(wchar_t),
+        static_cast<wchar_t*>(info.rdb.SymbolicLinkReparseBuffer.PathBuffer)
+        + info.rdb.SymbolicLinkReparseBuffer.PrintNameOffset/sizeof(wchar_t)
+        + info.rdb.SymbolicLinkReparseBuffer.PrintNameLength/sizeof(wchar_t));
+#     endif
+    return symlink_path;
+  }
+
+  BOOST_FILESYSTEM_DECL
+  path read_symlink(const path& p, system::error_code* ec)
+  {
+    if (installed_backend)
+    {
+      error_code result;
+      path symlink_path = installed_backend->read_symlink(p, result);
+      backend_error(result, p, ec, "boost::filesystem::read_symlink");
+      return symlink_path;
+    }
+    return native_read_symlink(p, ec);
+  }
+
+  BOOST_FILESYSTEM_DECL
+  path relative(const path& p, const path& base, error_code* ec)
+  {
+    error_code tmp_ec;
+    path wc_base(weakly_canonical(base, &tmp_ec));
+    if (error(tmp_ec.value(), base, ec, "boost::filesystem::relative"))
+      return path();
+    path wc_p(weakly_canonical(p, &tmp_ec));
+    if (error(tmp_ec.value(), base, ec, "boost::filesystem::relative"))
+      return path();
+    return wc_p.lexically_relative(wc_base);
+  }
+  
+  BOOST_FILESYSTEM_DECL
+  bool remove(const path& p, error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(remove_op, &p, ec);
+    error_code tmp_ec;
+    file_type type = query_file_type(p, &tmp_ec);
+    if (error(type == status_error ? tmp_ec.value() : 0, p, ec,
+        "boost::filesystem::remove"))
+      return false;
+
+    // Since POSIX remove() is specified to work with either files or directories, in a
+    // perfect world it could just be called. But some important real-world operating
+    // systems (Windows, Mac OS X, for example) don't implement the POSIX spec. So
+    // remove_file_or_directory() is always called to keep it simple.
+    return remove_file_or_directory(p, type, ec);
+  }
+
+  BOOST_FILESYSTEM_DECL
+  boost::uintmax_t remove_all(const path& p, error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(remove_all_op, &p, ec);
+    error_code tmp_ec;
+    file_type type = query_file_type(p, &tmp_ec);
+    if (error(type == status_error ? tmp_ec.value() : 0, p, ec,
+      "boost::filesystem::remove_all"))
+      return 0;
+
+    return (type != status_error && type != file_not_found) // exists
+      ? remove_all_aux(p, type, ec)
+      : 0;
+  }
+
+  void native_rename(const path& old_p, const path& new_p, error_code* ec)
+  {
+    error(!BOOST_MOVE_FILE(old_p.c_str(), new_p.c_str()) ? BOOST_ERRNO : 0, old_p, new_p,
+      ec, "boost::filesystem::rename");
+  }
+
+  BOOST_FILESYSTEM_DECL
+  void rename(const path& old_p, const path& new_p, error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(rename_op, &old_p, ec);
+    if (installed_backend)
+    {
+      error_code result;
+      installed_backend->rename(old_p, new_p, result);
+      backend_error(result, old_p, new_p, ec, "boost::filesystem::rename");
+      return;
+    }
+    native_rename(old_p, new_p, ec);
+  }
+
+  BOOST_FILESYSTEM_DECL
+  void rename(const path& old_p, const path& new_p, unsigned int option,
+    error_code* ec)
+  {
+    if (option == static_cast<unsigned int>(rename_option::none))
+    {
+      rename(old_p, new_p, ec);
+      return;
+    }
+    BOOST_FILESYSTEM_PROBE(rename_op, &old_p, ec);
+    if (installed_backend)
+    {
+      //  no_replace is checked, not atomic, as by rename_api() on older kernels; a
+      //  backend has no exchange
+      error_code result;
+      file_type new_type = status_error;
+      if (option != static_cast<unsigned int>(rename_option::no_replace))
+        result.assign(system::errc::operation_not_supported, system::generic_category());
+      else
+        new_type = installed_backend->symlink_status(new_p, result).type();
+      if (new_type == file_not_found)
+        installed_backend->rename(old_p, new_p, result);
+      else if (new_type != status_error)
+        result.assign(system::errc::file_exists, system::generic_category());
+      backend_error(result, old_p, new_p, ec, "boost::filesystem::rename");
+      return;
+    }
+    error(rename_api(old_p, new_p, option), old_p, new_p, ec,
+      "boost::filesystem::rename");
+  }
+
+  void native_resize_file(const path& p, uintmax_t size, system::error_code* ec)
+  {
+    error(!BOOST_RESIZE_FILE(p.c_str(), size) ? BOOST_ERRNO : 0, p, ec,
+      "boost::filesystem::resize_file");
+  }
+
+  BOOST_FILESYSTEM_DECL
+  void resize_file(const path& p, uintmax_t size, system::error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(resize_file_op, &p, ec);
+    if (installed_backend)
+    {
+      error_code result;
+      installed_backend->resize_file(p, size, result);
+      backend_error(result, p, ec, "boost::filesystem::resize_file");
+      return;
+    }
+    native_resize_file(p, size, ec);
+  }
+
+  BOOST_FILESYSTEM_DECL
+  space_info space(const path& p, error_code* ec)
+  {
+    if (!native_files(p, ec, "boost::filesystem::space"))
+    {
+      space_info info;
+      info.capacity = info.free = info.available = 0;
+      return info;
+    }
+#   ifdef BOOST_POSIX_API
+    struct BOOST_STATVFS vfs;
+    space_info info;
+    if (!error(::BOOST_STATVFS(p.c_str(), &vfs) ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::space"))
+    {
+      info.capacity 
+        = static_cast<boost::uintmax_t>(vfs.f_blocks)* BOOST_STATVFS_F_FRSIZE;
+      info.free 
+        = static_cast<boost::uintmax_t>(vfs.f_bfree)* BOOST_STATVFS_F_FRSIZE;
+      info.available
+        = static_cast<boost::uintmax_t>(vfs.f_bavail)* BOOST_STATVFS_F_FRSIZE;
+    }
+
+#   else
+    ULARGE_INTEGER avail, total, free;
+    space_info info;
+
+    if (!error(::GetDiskFreeSpaceExW(p.c_str(), &avail, &total, &free)== 0,
+       p, ec, "boost::filesystem::space"))
+    {
+      info.capacity
+        = (static_cast<boost::uintmax_t>(total.HighPart)<< 32)
+          + total.LowPart;
+      info.free
+        = (static_cast<boost::uintmax_t>(free.HighPart)<< 32)
+          + free.LowPart;
+      info.available
+        = (static_cast<boost::uintmax_t>(avail.HighPart)<< 32)
+          + avail.LowPart;
+    }
+
+#   endif
+
+    else
+    {
+      info.capacity = info.free = info.available = 0;
+    }
+    return info;
+  }
+
+  file_status native_status(const path& p, error_code* ec)
+  {
+#   ifdef BOOST_POSIX_API
+
+    struct stat path_stat;
+    if (BOOST_FILESYSTEM_SYSCALL(::stat(p.c_str(), &path_stat))!= 0)
+    {
+      if (ec != 0)                            // always report errno, even though some
+        ec->assign(errno, system_category());   // errno values are not status_errors
+
+      if (not_found_error(errno))
+      {
+        return fs::file_status(fs::file_not_found, fs::no_perms);
+      }
+      if (ec == 0)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::status",
+          p, error_code(errno, system_category())));
+      return fs::file_status(fs::status_error);
+    }
+    if (ec != 0) ec->clear();;
+    if (S_ISDIR(path_stat.st_mode))
+      return fs::file_status(fs::directory_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISREG(path_stat.st_mode))
+      return fs::file_status(fs::regular_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISBLK(path_stat.st_mode))
+      return fs::file_status(fs::block_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISCHR(path_stat.st_mode))
+      return fs::file_status(fs::character_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISFIFO(path_stat.st_mode))
+      return fs::file_status(fs::fifo_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISSOCK(path_stat.st_mode))
+      return fs::file_status(fs::socket_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    return fs::file_status(fs::type_unknown);
+
+#   else  // Windows
+
+    DWORD attr(::GetFileAttributesW(p.c_str()));
+    if (attr == 0xFFFFFFFF)
+    {
+      return process_status_failure(p, ec);
+    }
+
+    //  reparse point handling;
+    //    since GetFileAttributesW does not resolve symlinks, try to open a file
+    //    handle to discover if the file exists
+    if (attr & FILE_ATTRIBUTE_REPARSE_POINT)
+    {
+      handle_wrapper h(
+        create_file_handle(
+            p.c_str(),
+            0,  // dwDesiredAccess; attributes only
+            FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+            0,  // lpSecurityAttributes
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS,
+            0)); // hTemplateFile
+      if (h.handle == INVALID_HANDLE_VALUE)
+      {
+        return process_status_failure(p, ec);
+      }
+
+      if (!is_reparse_point_a_symlink(p))
+        return file_status(reparse_file, make_permissions(p, attr));
+    }
+
+    if (ec != 0) ec->clear();
+    return (attr & FILE_ATTRIBUTE_DIRECTORY)
+      ? file_status(directory_file, make_permissions(p, attr))
+      : file_status(regular_file, make_permissions(p, attr));
+
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL
+  file_status status(const path& p, error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(status_op, &p, ec);
+    if (installed_backend)
+    {
+      error_code result;
+      file_status s = installed_backend->status(p, result);
+      return backend_status(s, result, p, ec);
+    }
+    return native_status(p, ec);
+  }
+
+  file_status native_symlink_status(const path& p, error_code* ec)
+  {
+#   ifdef BOOST_POSIX_API
+
+    struct stat path_stat;
+    if (BOOST_FILESYSTEM_SYSCALL(::lstat(p.c_str(), &path_stat))!= 0)
+    {
+      if (ec != 0)                            // always report errno, even though some
+        ec->assign(errno, system_category());   // errno values are not status_errors
+
+      if (errno == ENOENT || errno == ENOTDIR) // these are not errors
+      {
+        return fs::file_status(fs::file_not_found, fs::no_perms);
+      }
+      if (ec == 0)
+        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::status",
+          p, error_code(errno, system_category())));
+      return fs::file_status(fs::status_error);
+    }
+    if (ec != 0) ec->clear();
+    if (S_ISREG(path_stat.st_mode))
+      return fs::file_status(fs::regular_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISDIR(path_stat.st_mode))
+      return fs::file_status(fs::directory_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISLNK(path_stat.st_mode))
+      return fs::file_status(fs::symlink_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISBLK(path_stat.st_mode))
+      return fs::file_status(fs::block_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISCHR(path_stat.st_mode))
+      return fs::file_status(fs::character_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISFIFO(path_stat.st_mode))
+      return fs::file_status(fs::fifo_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    if (S_ISSOCK(path_stat.st_mode))
+      return fs::file_status(fs::socket_file,
+        static_cast<perms>(path_stat.st_mode) & fs::perms_mask);
+    return fs::file_status(fs::type_unknown);
+
+#   else  // Windows
+
+    DWORD attr(::GetFileAttributesW(p.c_str()));
+    if (attr == 0xFFFFFFFF)
+    {
+      return process_status_failure(p, ec);
+    }
+
+    if (ec != 0) ec->clear();
+
+    if (attr & FILE_ATTRIBUTE_REPARSE_POINT)
+      return is_reparse_point_a_symlink(p)
+             ? file_status(symlink_file, make_permissions(p, attr))
+             : file_status(reparse_file, make_permissions(p, attr));
+
+    return (attr & FILE_ATTRIBUTE_DIRECTORY)
+      ? file_status(directory_file, make_permissions(p, attr))
+      : file_status(regular_file, make_permissions(p, attr));
+
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL
+  file_status symlink_status(const path& p, error_code* ec)
+  {
+    BOOST_FILESYSTEM_PROBE(symlink_status_op, &p, ec);
+    if (installed_backend)
+    {
+      error_code result;
+      file_status s = installed_backend->symlink_status(p, result);
+      return backend_status(s, result, p, ec);
+    }
+    return native_symlink_status(p, ec);
+  }
+
+   // contributed by Jeff Flinn
+  BOOST_FILESYSTEM_DECL
+  path temp_directory_path(system::error_code* ec)
+  {
+#   ifdef BOOST_POSIX_API
+      const char* val = 0;
+      
+      (val = std::getenv("TMPDIR" )) ||
+      (val = std::getenv("TMP"    )) ||
+      (val = std::getenv("TEMP"   )) ||
+      (val = std::getenv("TEMPDIR"));
+      
+#     ifdef __ANDROID__
+        const char* default_tmp = "/data/local/tmp";
+#     else
+        const char* default_tmp = "/tmp";
+#     endif
+      path p((val!=0) ? val : default_tmp);
+       
+      if (p.empty() || (ec&&!is_directory(p, *ec))||(!ec&&!is_directory(p)))
+      {
+        error(ENOTDIR, p, ec, "boost::filesystem::temp_directory_path");
+        return p;
+      }
+        
+      return p;
+      
+#   else  // Windows
+
+      const wchar_t* tmp_env = L"TMP";
+      const wchar_t* temp_env = L"TEMP";
+      const wchar_t* localappdata_env = L"LOCALAPPDATA";
+      const wchar_t* userprofile_env = L"USERPROFILE";
+      const wchar_t* env_list[]
+        = {tmp_env, temp_env, localappdata_env, userprofile_env, 0};
+
+      path p;
+      for (int i = 0; env_list[i]; ++i)
+      {
+        std::wstring env = wgetenv(env_list[i]);
+        if (!env.empty())
+        {
+          p = env;
+          if (i >= 2)
+            p /= L"Temp";
+          error_code lcl_ec;
+          if (exists(p, lcl_ec) && !lcl_ec && is_directory(p, lcl_ec) && !lcl_ec)
+            break;
+          p.clear();
+        }
+      }
+
+      if (p.empty())
+      {
+        // use vector since in C++03 a string is not required to be contiguous
+        std::vector<wchar_t> buf(::GetWindowsDirectoryW(NULL, 0));
+
+        if (buf.empty()
+          || ::GetWindowsDirectoryW(&buf[0], static_cast<UINT>(buf.size())) == 0)
+        {
+          error(::GetLastError(), ec, "boost::filesystem::temp_directory_path");
+          return path();
+        }
+        p = &*buf.begin();  // do not depend on buf.size(); see ticket #10388
+        p /= L"Temp";
+      }
+      return p;
+
+#   endif
+  }
+  
+  BOOST_FILESYSTEM_DECL
+  path system_complete(const path& p, system::error_code* ec)
+  {
+#   ifdef BOOST_POSIX_API
+    return (p.empty() || p.is_absolute())
+      ? p : current_path()/ p;
+
+#   else
+    if (p.empty())
+    {
+      if (ec != 0) ec->clear();
+      return p;
+    }
+    wchar_t buf[buf_size];
+    wchar_t* pfn;
+    std::size_t len = get_full_path_name(p, buf_size, buf, &pfn);
+
+    if (error(len == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::system_complete"))
+      return path();
+
+    if (len < buf_size)// len does not include null termination character
+      return path(&buf[0]);
+
+    boost::scoped_array<wchar_t> big_buf(new wchar_t[len]);
+
+    return error(get_full_path_name(p, len , big_buf.get(), &pfn)== 0 ? BOOST_ERRNO : 0,
+      p, ec, "boost::filesystem::system_complete")
+      ? path()
+      : path(big_buf.get());
+#   endif
+  }
+
+  BOOST_FILESYSTEM_DECL
+  path weakly_canonical(const path& p, system::error_code* ec)
+  {
+    path head(p);
+    path tail;
+    system::error_code tmp_ec;
+    path::iterator itr = p.end();
+
+    for (; !head.empty(); --itr)
+    {
+      file_status head_status = status(head, tmp_ec);
+      if (error(head_status.type() == fs::status_error,
+        head, ec, "boost::filesystem::weakly_canonical"))
+        return path();
+      if (head_status.type() != fs::file_not_found)
+        break;
+      head.remove_filename();
+    }
+
+    bool tail_has_dots = false;
+    for (; itr != p.end(); ++itr)
+    { 
+      tail /= *itr;
+      // for a later optimization, track if any dot or dot-dot elements are present
+      if (itr->native().size() <= 2
+        && itr->native()[0] == dot
+        && (itr->native().size() == 1 || itr->native()[1] == dot))
+        tail_has_dots = true;
+    }
+    
+    if (head.empty())
+      return p.lexically_normal();
+    head = canonical(head, tmp_ec);
+    if (error(tmp_ec.value(), head, ec, "boost::filesystem::weakly_canonical"))
+      return path();
+    return tail.empty()
+      ? head
+      : (tail_has_dots  // optimization: only normalize if tail had dot or dot-dot element
+          ? (head/tail).lexically_normal()  
+          : head/tail);
+  }
+}  // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                 directory_entry                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+  file_status
+  directory_entry::m_get_status(system::error_code* ec) const
+  {
+    if (!status_known(m_status))
+    {
+      // optimization: if the symlink status is known, and it isn't a symlink,
+      // then status and symlink_status are identical so just copy the
+      // symlink status to the regular status.
+      if (status_known(m_symlink_status)
+        && !is_symlink(m_symlink_status))
+      { 
+        m_status = m_symlink_status;
+        if (ec != 0) ec->clear();
+      }
+      else m_status = detail::status(m_path, ec);
+    }
+    else if (ec != 0) ec->clear();
+    return m_status;
+  }
+
+  file_status
+  directory_entry::m_get_symlink_status(system::error_code* ec) const
+  {
+    if (!status_known(m_symlink_status))
+      m_symlink_status = detail::symlink_status(m_path, ec);
+    else if (ec != 0) ec->clear();
+    return m_symlink_status;
+  }
+
+//  dispatch directory_entry supplied here rather than in 
+//  <boost/filesystem/path_traits.hpp>, thus avoiding header circularity.
+//  test cases are in operations_unit_test.cpp
+
+namespace path_traits
+{
+  void dispatch(const directory_entry & de,
+#                ifdef BOOST_WINDOWS_API
+    std::wstring& to,
+#                else   
+    std::string& to,
+#                endif
+    const codecvt_type &)
+  {
+    to = de.path().native();
+  }
+
+  void dispatch(const directory_entry & de,
+#                ifdef BOOST_WINDOWS_API
+    std::wstring& to
+#                else   
+    std::string& to
+#                endif
+    )
+  {
+    to = de.path().native();
+  }
+}  // namespace path_traits
+} // namespace filesystem
+} // namespace boost
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                               directory_iterator                                     //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace
+{
+# ifdef BOOST_POSIX_API
+
+  error_code path_max(std::size_t & result)
+  // this code is based on Stevens and Rago, Advanced Programming in the
+  // UNIX envirnment, 2nd Ed., ISBN 0-201-43307-9, page 49
+  {
+#   ifdef PATH_MAX
+    static std::size_t max = PATH_MAX;
+#   else
+    static std::size_t max = 0;
+#   endif
+    if (max == 0)
+    {
+      errno = 0;
+      long tmp = ::pathconf("/", _PC_NAME_MAX);
+      if (tmp < 0)
+      {
+        if (errno == 0)// indeterminate
+          max = 4096; // guess
+        else return error_code(errno, system_category());
+      }
+      else max = static_cast<std::size_t>(tmp + 1); // relative root
+    }
+    result = max;
+    return ok;
+  }
+
+#if defined(__PGI) && defined(__USE_FILE_OFFSET64)
+#define dirent dirent64
+#endif
+
+  error_code dir_itr_first(void *& handle, void *& buffer,
+    const char* dir, string& target,
+    fs::file_status &, fs::file_status &)
+  {
+    if ((handle = BOOST_FILESYSTEM_SYSCALL(::opendir(dir)))== 0)
+      return error_code(errno, system_category());
+    target = string(".");  // string was static but caused trouble
+                             // when iteration called from dtor, after
+                             // static had already been destroyed
+    std::size_t path_size (0);  // initialization quiets gcc warning (ticket #3509)
+    error_code ec = path_max(path_size);
+    if (ec)return ec;
+    dirent de;
+    buffer = std::malloc((sizeof(dirent) - sizeof(de.d_name))
+      +  path_size + 1); // + 1 for "/0"
+    return ok;
+  }  
+
+  // warning: the only dirent member updated is d_name
+  inline int readdir_r_simulator(DIR * dirp, struct dirent * entry,
+    struct dirent ** result)// *result set to 0 on end of directory
+  {
+    errno = 0;
+
+#   if !defined(__CYGWIN__)\
+    && defined(_POSIX_THREAD_SAFE_FUNCTIONS)\
+    && defined(_SC_THREAD_SAFE_FUNCTIONS)\
+    && (_POSIX_THREAD_SAFE_FUNCTIONS+0 >= 0)\
+    && (!defined(__hpux) || defined(_REENTRANT)) \
+    && (!defined(_AIX) || defined(__THREAD_SAFE))
+    if (::sysconf(_SC_THREAD_SAFE_FUNCTIONS)>= 0)
+      { return BOOST_FILESYSTEM_SYSCALL(::readdir_r(dirp, entry, result)); }
+#   endif
+
+    struct dirent * p;
+    *result = 0;
+    if ((p = BOOST_FILESYSTEM_SYSCALL(::readdir(dirp)))== 0)
+      return errno;
+    std::strcpy(entry->d_name, p->d_name);
+    *result = entry;
+    return 0;
+  }
+
+#   ifdef BOOST_FILESYSTEM_STATUS_CACHE
+  void d_type_status(unsigned char d_type, fs::file_status & sf,
+    fs::file_status & symlink_sf)
+  {
+    if (d_type == DT_UNKNOWN) // filesystem does not supply d_type value
+    {
+      sf = symlink_sf = fs::file_status(fs::status_error);
+    }
+    else  // filesystem supplies d_type value
+    {
+      if (d_type == DT_DIR)
+        sf = symlink_sf = fs::file_status(fs::directory_file);
+      else if (d_type == DT_REG)
+        sf = symlink_sf = fs::file_status(fs::regular_file);
+      else if (d_type == DT_LNK)
+      {
+        sf = fs::file_status(fs::status_error);
+        symlink_sf = fs::file_status(fs::symlink_file);
+      }
+      else sf = symlink_sf = fs::file_status(fs::status_error);
+    }
+  }
+#   endif
+
+  error_code dir_itr_increment(void *& handle, void *& buffer,
+    string& target, fs::file_status & sf, fs::file_status & symlink_sf)
+  {
+    BOOST_ASSERT(buffer != 0);
+    dirent * entry(static_cast<dirent *>(buffer));
+    dirent * result;
+    int return_code;
+    if ((return_code = readdir_r_simulator(static_cast<DIR*>(handle), entry, &result))!= 0)
+      return error_code(errno, system_category());
+    if (result == 0)
+      return fs::detail::dir_itr_close(handle, buffer);
+    target = entry->d_name;
+#   ifdef BOOST_FILESYSTEM_STATUS_CACHE
+    d_type_status(entry->d_type, sf, symlink_sf);
+#   else
+    sf = symlink_sf = fs::file_status(fs::status_error);
+#    endif
+    return ok;
+  }
+
+# else // BOOST_WINDOWS_API
+
+  error_code dir_itr_first(void *& handle, const fs::path& dir,
+    wstring& target, fs::file_status & sf, fs::file_status & symlink_sf)
+  // Note: an empty root directory has no "." or ".." entries, so this
+  // causes a ERROR_FILE_NOT_FOUND error which we do not considered an
+  // error. It is treated as eof instead.
+  {
+    // use a form of search Sebastian Martel reports will work with Win98
+    wstring dirpath(dir.wstring());
+    dirpath += (dirpath.empty()
+      || (dirpath[dirpath.size()-1] != L'\\'
+        && dirpath[dirpath.size()-1] != L'/'
+        && dirpath[dirpath.size()-1] != L':'))? L"\\*" : L"*";
+
+    WIN32_FIND_DATAW data;
+    if ((handle = ::FindFirstFileW(dirpath.c_str(), &data))
+      == INVALID_HANDLE_VALUE)
+    { 
+      handle = 0;  // signal eof
+      return error_code( (::GetLastError() == ERROR_FILE_NOT_FOUND
+                       // Windows Mobile returns ERROR_NO_MORE_FILES; see ticket #3551                                           
+                       || ::GetLastError() == ERROR_NO_MORE_FILES) 
+        ? 0 : ::GetLastError(), system_category() );
+    }
+    target = data.cFileName;
+    if (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+    // reparse points are complex, so don't try to handle them here; instead just mark
+    // them as status_error which causes directory_entry caching to call status()
+    // and symlink_status() which do handle reparse points fully
+    {
+      sf.type(fs::status_error);
+      symlink_sf.type(fs::status_error);
+    }
+    else
+    {
+      if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
       {
-        error(ENOTDIR, p, ec, "boost::filesystem::temp_directory_path");
-        return p;
+        sf.type(fs::directory_file);
+        symlink_sf.type(fs::directory_file);
       }
-        
-      return p;
-      
-#   else  // Windows
-
-      const wchar_t* tmp_env = L"TMP";
-      const wchar_t* temp_env = L"TEMP";
-      const wchar_t* localappdata_env = L"LOCALAPPDATA";
-      const wchar_t* userprofile_env = L"USERPROFILE";
-      const wchar_t* env_list[]
-        = {tmp_env, temp_env, localappdata_env, userprofile_env, 0};
-
-      path p;
-      for (int i = 0; env_list[i]; ++i)
+      else
       {
-        std::wstring env = wgetenv(env_list[i]);
-        if (!env.empty())
-        {
-          p = env;
-          if (i >= 2)
-            p /= L"Temp";
-          error_code lcl_ec;
-          if (exists(p, lcl_ec) && !lcl_ec && is_directory(p, lcl_ec) && !lcl_ec)
-            break;
-          p.clear();
-        }
+        sf.type(fs::regular_file);
+        symlink_sf.type(fs::regular_file);
       }
+      sf.permissions(make_permissions(data.cFileName, data.dwFileAttributes));
+      symlink_sf.permissions(sf.permissions());
+    }
+    return error_code();
+  }
 
-      if (p.empty())
+  error_code  dir_itr_increment(void *& handle, wstring& target,
+    fs::file_status & sf, fs::file_status & symlink_sf)
+  {
+    WIN32_FIND_DATAW data;
+    if (::FindNextFileW(handle, &data)== 0)// fails
+    {
+      int error = ::GetLastError();
+      fs::detail::dir_itr_close(handle);
+      return error_code(error == ERROR_NO_MORE_FILES ? 0 : error, system_category());
+    }
+    target = data.cFileName;
+    if (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+    // reparse points are complex, so don't try to handle them here; instead just mark
+    // them as status_error which causes directory_entry caching to call status()
+    // and symlink_status() which do handle reparse points fully
+    {
+      sf.type(fs::status_error);
+      symlink_sf.type(fs::status_error);
+    }
+    else
+    {
+      if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
       {
-        // use vector since in C++03 a string is not required to be contiguous
-        std::vector<wchar_t> buf(::GetWindowsDirectoryW(NULL, 0));
-
-        if (buf.empty()
-          || ::GetWindowsDirectoryW(&buf[0], static_cast<UINT>(buf.size())) == 0)
-        {
-          error(::GetLastError(), ec, "boost::filesystem::temp_directory_path");
-          return path();
-        }
-        p = &*buf.begin();  // do not depend on buf.size(); see ticket #10388
-        p /= L"Temp";
+        sf.type(fs::directory_file);
+        symlink_sf.type(fs::directory_file);
       }
-      return p;
-
-#   endif
+      else
+      {
+        sf.type(fs::regular_file);
+        symlink_sf.type(fs::regular_file);
+      }
+      sf.permissions(make_permissions(data.cFileName, data.dwFileAttributes));
+      symlink_sf.permissions(sf.permissions());
+    }
+    return error_code();
   }
-  
+#endif
+
+  const error_code not_found_error_code (
+#     ifdef BOOST_WINDOWS_API
+        ERROR_PATH_NOT_FOUND
+#     else
+        ENOENT 
+#     endif
+        , system_category());
+
+}  // unnamed namespace
+
+namespace boost
+{
+namespace filesystem
+{
+
+namespace detail
+{
+  //  dir_itr_close is called both from the ~dir_itr_imp()destructor 
+  //  and dir_itr_increment()
   BOOST_FILESYSTEM_DECL
-  path system_complete(const path& p, system::error_code* ec)
+  system::error_code dir_itr_close( // never throws
+    void *& handle
+#   if defined(BOOST_POSIX_API)
+    , void *& buffer
+#   endif
+   )
   {
 #   ifdef BOOST_POSIX_API
-    return (p.empty() || p.is_absolute())
-      ? p : current_path()/ p;
+    std::free(buffer);
+    buffer = 0;
+    if (handle == 0)return ok;
+    DIR * h(static_cast<DIR*>(handle));
+    handle = 0;
+    return error_code(BOOST_FILESYSTEM_SYSCALL(::closedir(h))== 0 ? 0 : errno,
+      system_category());
 
 #   else
-    if (p.empty())
+    if (handle != 0)
     {
-      if (ec != 0) ec->clear();
-      return p;
+      ::FindClose(handle);
+      handle = 0;
     }
-    wchar_t buf[buf_size];
-    wchar_t* pfn;
-    std::size_t len = get_full_path_name(p, buf_size, buf, &pfn);
+    return ok;
 
-    if (error(len == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::system_complete"))
-      return path();
+#   endif
+  }
 
-    if (len < buf_size)// len does not include null termination character
-      return path(&buf[0]);
+  void directory_iterator_construct(directory_iterator& it,
+    const path& p, system::error_code* ec)    
+  {
+    BOOST_FILESYSTEM_PROBE(directory_iterator_construct_op, &p, ec);
+    if (error(p.empty() ? not_found_error_code.value() : 0, p, ec,
+              "boost::filesystem::directory_iterator::construct"))
+      return;
 
-    boost::scoped_array<wchar_t> big_buf(new wchar_t[len]);
+    if (installed_backend)
+    {
+      error_code result;
+      it.m_imp->stream = installed_backend->open_directory(p, result);
+      if (backend_error(result, p, ec,
+          "boost::filesystem::directory_iterator::construct"))
+      {
+        it.m_imp.reset();
+        return;
+      }
+      path filename;
+      file_status file_stat, symlink_file_stat;
+      if (it.m_imp->stream->read(filename, file_stat, symlink_file_stat, result))
+        it.m_imp->dir_entry.assign(p / filename, file_stat, symlink_file_stat);
+      else
+      {
+        it.m_imp.reset();  // empty, or unreadable
+        backend_error(result, p, ec, "boost::filesystem::directory_iterator::construct");
+      }
+      return;
+    }
 
-    return error(get_full_path_name(p, len , big_buf.get(), &pfn)== 0 ? BOOST_ERRNO : 0,
-      p, ec, "boost::filesystem::system_complete")
-      ? path()
-      : path(big_buf.get());
-#   endif
+    path::string_type filename;
+    file_status file_stat, symlink_file_stat;
+    error_code result = dir_itr_first(it.m_imp->handle,
+#     if defined(BOOST_POSIX_API)
+      it.m_imp->buffer,
+#     endif
+      p.c_str(), filename, file_stat, symlink_file_stat);
+
+    if (result)
+    {
+      it.m_imp.reset();
+      error(result.value(), p,
+        ec, "boost::filesystem::directory_iterator::construct");
+      return;
+    }
+    
+    if (it.m_imp->handle == 0)
+      it.m_imp.reset(); // eof, so make end iterator
+    else // not eof
+    {
+      it.m_imp->dir_entry.assign(p / filename, file_stat, symlink_file_stat);
+      if (filename[0] == dot // dot or dot-dot
+        && (filename.size()== 1
+          || (filename[1] == dot
+            && filename.size()== 2)))
+        {  it.increment(*ec); }
+    }
   }
 
-  BOOST_FILESYSTEM_DECL
-  path weakly_canonical(const path& p, system::error_code* ec)
+  void directory_iterator_increment(directory_iterator& it,
+    system::error_code* ec)
   {
-    path head(p);
-    path tail;
-    system::error_code tmp_ec;
-    path::iterator itr = p.end();
+    BOOST_ASSERT_MSG(it.m_imp.get(), "attempt to increment end iterator");
+    BOOST_ASSERT_MSG(it.m_imp->handle != 0 || it.m_imp->stream != 0,
+      "internal program error");
+    BOOST_FILESYSTEM_PROBE(directory_iterator_increment_op, 0, ec);
 
-    for (; !head.empty(); --itr)
+    if (it.m_imp->stream)
     {
-      file_status head_status = status(head, tmp_ec);
-      if (error(head_status.type() == fs::status_error,
-        head, ec, "boost::filesystem::weakly_canonical"))
-        return path();
-      if (head_status.type() != fs::file_not_found)
-        break;
-      head.remove_filename();
+      path filename;
+      file_status file_stat, symlink_file_stat;
+      error_code result;
+      if (it.m_imp->stream->read(filename, file_stat, symlink_file_stat, result))
+      {
+        if (ec != 0) ec->clear();
+        it.m_imp->dir_entry.replace_filename(filename, file_stat, symlink_file_stat);
+        return;
+      }
+      path error_path(it.m_imp->dir_entry.path().parent_path());
+      it.m_imp.reset();
+      backend_error(result, error_path, ec,
+        "boost::filesystem::directory_iterator::operator++");
+      return;
     }
 
-    bool tail_has_dots = false;
-    for (; itr != p.end(); ++itr)
-    { 
-      tail /= *itr;
-      // for a later optimization, track if any dot or dot-dot elements are present
-      if (itr->native().size() <= 2
-        && itr->native()[0] == dot
-        && (itr->native().size() == 1 || itr->native()[1] == dot))
-        tail_has_dots = true;
+    path::string_type filename;
+    file_status file_stat, symlink_file_stat;
+    system::error_code temp_ec;
+
+    for (;;)
+    {
+      temp_ec = dir_itr_increment(it.m_imp->handle,
+#       if defined(BOOST_POSIX_API)
+        it.m_imp->buffer,
+#       endif
+        filename, file_stat, symlink_file_stat);
+
+      if (temp_ec)  // happens if filesystem is corrupt, such as on a damaged optical disc
+      {
+        path error_path(it.m_imp->dir_entry.path().parent_path());  // fix ticket #5900
+        it.m_imp.reset();
+        if (ec == 0)
+          BOOST_FILESYSTEM_THROW(
+            filesystem_error("boost::filesystem::directory_iterator::operator++",
+              error_path,
+              error_code(BOOST_ERRNO, system_category())));
+        ec->assign(BOOST_ERRNO, system_category());
+        return;
+      }
+      else if (ec != 0) ec->clear();
+
+      if (it.m_imp->handle == 0)  // eof, make end
+      {
+        it.m_imp.reset();
+        return;
+      }
+
+      if (!(filename[0] == dot // !(dot or dot-dot)
+        && (filename.size()== 1
+          || (filename[1] == dot
+            && filename.size()== 2))))
+      {
+        it.m_imp->dir_entry.replace_filename(
+          filename, file_stat, symlink_file_stat);
+        return;
+      }
     }
-    
-    if (head.empty())
-      return p.lexically_normal();
-    head = canonical(head, tmp_ec);
-    if (error(tmp_ec.value(), head, ec, "boost::filesystem::weakly_canonical"))
-      return path();
-    return tail.empty()
-      ? head
-      : (tail_has_dots  // optimization: only normalize if tail had dot or dot-dot element
-          ? (head/tail).lexically_normal()  
-          : head/tail);
   }
 }  // namespace detail
+} // namespace filesystem
+} // namespace boost
 
 //--------------------------------------------------------------------------------------//
 //                                                                                      //
-//                                 directory_entry                                      //
+//                                   native backend                                     //
 //                                                                                      //
 //--------------------------------------------------------------------------------------//
 
-  file_status
-  directory_entry::m_get_status(system::error_code* ec) const
+namespace
+{
+  //  What the native backend's open_directory() returns, for a backend such as
+  //  latency_backend that wraps it; directory_iterator itself uses the handle directly
+  class native_directory : public fs::backend_directory
   {
-    if (!status_known(m_status))
+  public:
+    native_directory() : m_handle(0), m_buffer(0), m_pending(false) {}
+
+    ~native_directory()
     {
-      // optimization: if the symlink status is known, and it isn't a symlink,
-      // then status and symlink_status are identical so just copy the
-      // symlink status to the regular status.
-      if (status_known(m_symlink_status)
-        && !is_symlink(m_symlink_status))
-      { 
-        m_status = m_symlink_status;
-        if (ec != 0) ec->clear();
+      fs::detail::dir_itr_close(m_handle
+#       if defined(BOOST_POSIX_API)
+        , m_buffer
+#       endif
+        );
+    }
+
+    error_code open(const path& p)
+    {
+      fs::file_status s, symlink_s;
+      error_code result = dir_itr_first(m_handle,
+#       if defined(BOOST_POSIX_API)
+        m_buffer,
+#       endif
+        p.c_str(), m_name, s, symlink_s);
+      m_pending = !result && m_handle != 0;
+      return result;
+    }
+
+    bool read(path& filename, fs::file_status& s, fs::file_status& symlink_s,
+      error_code& ec)
+    {
+      ec.clear();
+      for (;;)
+      {
+        if (!m_pending)
+        {
+          if (m_handle == 0)
+            return false;
+          ec = dir_itr_increment(m_handle,
+#           if defined(BOOST_POSIX_API)
+            m_buffer,
+#           endif
+            m_name, s, symlink_s);
+          if (ec || m_handle == 0)
+            return false;
+        }
+        m_pending = false;
+        if (!(m_name[0] == dot
+          && (m_name.size() == 1 || (m_name[1] == dot && m_name.size() == 2))))
+        {
+          filename = m_name;
+          return true;
+        }
       }
-      else m_status = detail::status(m_path, ec);
     }
-    else if (ec != 0) ec->clear();
-    return m_status;
-  }
 
-  file_status
-  directory_entry::m_get_symlink_status(system::error_code* ec) const
+  private:
+    void*              m_handle;
+    void*              m_buffer;   // unused on Windows
+    path::string_type  m_name;
+    bool               m_pending;  // m_name is the first entry, not yet read
+  };
+
+  class native_backend_imp : public fs::backend
   {
-    if (!status_known(m_symlink_status))
-      m_symlink_status = detail::symlink_status(m_path, ec);
-    else if (ec != 0) ec->clear();
-    return m_symlink_status;
-  }
+  public:
+    fs::file_status status(const path& p, error_code& ec)
+      { return fs::detail::native_status(p, &ec); }
+    fs::file_status symlink_status(const path& p, error_code& ec)
+      { return fs::detail::native_symlink_status(p, &ec); }
+    boost::uintmax_t file_size(const path& p, error_code& ec)
+      { return fs::detail::native_file_size(p, &ec); }
+    std::time_t last_write_time(const path& p, error_code& ec)
+      { return fs::detail::native_last_write_time(p, &ec); }
+    void last_write_time(const path& p, std::time_t new_time, error_code& ec)
+      { fs::detail::native_last_write_time(p, new_time, &ec); }
+    bool create_directory(const path& p, error_code& ec)
+      { return fs::detail::native_create_directory(p, &ec); }
+    void create_symlink(const path& to, const path& new_symlink, error_code& ec)
+      { fs::detail::native_create_symlink(to, new_symlink, &ec); }
+    path read_symlink(const path& p, error_code& ec)
+      { return fs::detail::native_read_symlink(p, &ec); }
+    void rename(const path& old_p, const path& new_p, error_code& ec)
+      { fs::detail::native_rename(old_p, new_p, &ec); }
+    void resize_file(const path& p, boost::uintmax_t size, error_code& ec)
+      { fs::detail::native_resize_file(p, size, &ec); }
+
+    bool remove(const path& p, error_code& ec)
+    {
+      fs::file_type type = fs::detail::native_symlink_status(p, &ec).type();
+      return type != fs::status_error
+        && native_remove_file_or_directory(p, type, &ec);
+    }
 
-//  dispatch directory_entry supplied here rather than in 
-//  <boost/filesystem/path_traits.hpp>, thus avoiding header circularity.
-//  test cases are in operations_unit_test.cpp
+    void copy_file(const path& from, const path& to, bool overwrite, error_code& ec)
+    {
+      fs::detail::native_copy_file(from, to, overwrite
+        ? fs::detail::overwrite_if_exists : fs::detail::fail_if_exists, &ec);
+    }
 
-namespace path_traits
+    bool native() const  { return true; }
+
+    fs::backend_directory* open_directory(const path& p, error_code& ec)
+    {
+      native_directory* dir = new native_directory;
+      ec = dir->open(p);
+      if (!ec)
+        return dir;
+      delete dir;
+      return 0;
+    }
+  };
+
+  native_backend_imp native_backend_instance;
+}  // unnamed namespace
+
+namespace boost
 {
-  void dispatch(const directory_entry & de,
-#                ifdef BOOST_WINDOWS_API
-    std::wstring& to,
-#                else   
-    std::string& to,
-#                endif
-    const codecvt_type &)
+namespace filesystem
+{
+  BOOST_FILESYSTEM_DECL backend& native_backend() BOOST_NOEXCEPT
   {
-    to = de.path().native();
+    return native_backend_instance;
   }
 
-  void dispatch(const directory_entry & de,
-#                ifdef BOOST_WINDOWS_API
-    std::wstring& to
-#                else   
-    std::string& to
-#                endif
-    )
+  BOOST_FILESYSTEM_DECL backend& current_backend() BOOST_NOEXCEPT
   {
-    to = de.path().native();
+    return installed_backend ? *installed_backend : native_backend_instance;
+  }
+
+  BOOST_FILESYSTEM_DECL backend* set_backend(backend* b) BOOST_NOEXCEPT
+  {
+    backend* previous = &current_backend();
+    installed_backend = b == &native_backend_instance ? 0 : b;
+    return previous;
   }
-}  // namespace path_traits
 } // namespace filesystem
 } // namespace boost
 
 //--------------------------------------------------------------------------------------//
 //                                                                                      //
-//                               directory_iterator                                     //
+//                                  directory_cursor                                    //
 //                                                                                      //
 //--------------------------------------------------------------------------------------//
 
 namespace
 {
-# ifdef BOOST_POSIX_API
+  inline bool is_dot_or_dot_dot(const fs::path::value_type* name)
+  {
+    return name[0] == dot && (name[1] == 0 || (name[1] == dot && name[2] == 0));
+  }
 
-  error_code path_max(std::size_t & result)
-  // this code is based on Stevens and Rago, Advanced Programming in the
-  // UNIX envirnment, 2nd Ed., ISBN 0-201-43307-9, page 49
+# ifdef BOOST_FILESYSTEM_GETDENTS
+  //  the layout of each record written by getdents64()
+  struct getdents64_record
   {
-#   ifdef PATH_MAX
-    static std::size_t max = PATH_MAX;
+    boost::uint64_t  d_ino;
+    boost::int64_t   d_off;
+    unsigned short   d_reclen;
+    unsigned char    d_type;
+    char             d_name[1];
+  };
+
+  const std::size_t cursor_buffer_size = 32 * 1024;  // as glibc allocates for a DIR
+
+  const int cursor_open_flags = O_RDONLY | O_DIRECTORY
+#   ifdef O_CLOEXEC
+    | O_CLOEXEC
+#   endif
+    ;
+# endif
+}  // unnamed namespace
+
+namespace boost
+{
+namespace filesystem
+{
+namespace detail
+{
+  BOOST_FILESYSTEM_DECL
+  void directory_cursor_close(directory_cursor& c, bool release_buffer) BOOST_NOEXCEPT
+  {
+#   if defined(BOOST_FILESYSTEM_GETDENTS)
+    if (c.m_fd >= 0)
+    {
+      ::close(c.m_fd);
+      c.m_fd = -1;
+    }
+    c.m_pos = c.m_end = 0;
+#   elif defined(BOOST_POSIX_API)
+    if (c.m_handle != 0)
+    {
+      ::closedir(static_cast<DIR*>(c.m_handle));
+      c.m_handle = 0;
+    }
 #   else
-    static std::size_t max = 0;
+    if (c.m_handle != 0)
+    {
+      ::FindClose(c.m_handle);
+      c.m_handle = 0;
+    }
 #   endif
-    if (max == 0)
+    if (release_buffer && c.m_owns_buffer)
     {
-      errno = 0;
-      long tmp = ::pathconf("/", _PC_NAME_MAX);
-      if (tmp < 0)
-      {
-        if (errno == 0)// indeterminate
-          max = 4096; // guess
-        else return error_code(errno, system_category());
-      }
-      else max = static_cast<std::size_t>(tmp + 1); // relative root
+      std::free(c.m_buffer);
+      c.m_buffer = 0;
+      c.m_size = 0;
+      c.m_owns_buffer = false;
     }
-    result = max;
-    return ok;
+    c.m_at_end = true;
+    c.m_suspended = false;
   }
 
-#if defined(__PGI) && defined(__USE_FILE_OFFSET64)
-#define dirent dirent64
-#endif
-
-  error_code dir_itr_first(void *& handle, void *& buffer,
-    const char* dir, string& target,
-    fs::file_status &, fs::file_status &)
-  {
-    if ((handle = ::opendir(dir))== 0)
-      return error_code(errno, system_category());
-    target = string(".");  // string was static but caused trouble
-                             // when iteration called from dtor, after
-                             // static had already been destroyed
-    std::size_t path_size (0);  // initialization quiets gcc warning (ticket #3509)
-    error_code ec = path_max(path_size);
-    if (ec)return ec;
-    dirent de;
-    buffer = std::malloc((sizeof(dirent) - sizeof(de.d_name))
-      +  path_size + 1); // + 1 for "/0"
-    return ok;
-  }  
-
-  // warning: the only dirent member updated is d_name
-  inline int readdir_r_simulator(DIR * dirp, struct dirent * entry,
-    struct dirent ** result)// *result set to 0 on end of directory
+  BOOST_FILESYSTEM_DECL
+  void directory_cursor_suspend(directory_cursor& c) BOOST_NOEXCEPT
   {
-    errno = 0;
-
-#   if !defined(__CYGWIN__)\
-    && defined(_POSIX_THREAD_SAFE_FUNCTIONS)\
-    && defined(_SC_THREAD_SAFE_FUNCTIONS)\
-    && (_POSIX_THREAD_SAFE_FUNCTIONS+0 >= 0)\
-    && (!defined(__hpux) || defined(_REENTRANT)) \
-    && (!defined(_AIX) || defined(__THREAD_SAFE))
-    if (::sysconf(_SC_THREAD_SAFE_FUNCTIONS)>= 0)
-      { return ::readdir_r(dirp, entry, result); }
-#   endif
-
-    struct dirent * p;
-    *result = 0;
-    if ((p = ::readdir(dirp))== 0)
-      return errno;
-    std::strcpy(entry->d_name, p->d_name);
-    *result = entry;
-    return 0;
+    if (c.m_at_end || c.m_suspended)
+      return;
+    directory_cursor_close(c, false);  // keeps c.m_entry, c.m_name and c.m_offset
+    c.m_at_end = false;
+    c.m_suspended = true;
   }
 
-  error_code dir_itr_increment(void *& handle, void *& buffer,
-    string& target, fs::file_status & sf, fs::file_status & symlink_sf)
+  BOOST_FILESYSTEM_DECL
+  void directory_cursor_open(directory_cursor& c, const path& p, system::error_code* ec)
   {
-    BOOST_ASSERT(buffer != 0);
-    dirent * entry(static_cast<dirent *>(buffer));
-    dirent * result;
-    int return_code;
-    if ((return_code = readdir_r_simulator(static_cast<DIR*>(handle), entry, &result))!= 0)
-      return error_code(errno, system_category());
-    if (result == 0)
-      return fs::detail::dir_itr_close(handle, buffer);
-    target = entry->d_name;
-#   ifdef BOOST_FILESYSTEM_STATUS_CACHE
-    if (entry->d_type == DT_UNKNOWN) // filesystem does not supply d_type value
+    BOOST_FILESYSTEM_PROBE(directory_cursor_open_op, &p, ec);
+    directory_cursor_close(c, false);
+    if (error(p.empty() ? not_found_error_code.value() : 0, p, ec,
+              "boost::filesystem::directory_cursor::open"))
+      return;
+    if (!native_files(p, ec, "boost::filesystem::directory_cursor::open"))
+      return;
+    c.m_name = p;  // each entry's path is built on this, reusing its storage
+
+#   if defined(BOOST_FILESYSTEM_GETDENTS)
+    if (c.m_buffer == 0)
     {
-      sf = symlink_sf = fs::file_status(fs::status_error);
+      c.m_buffer = static_cast<char*>(std::malloc(cursor_buffer_size));
+      if (error(c.m_buffer == 0 ? ENOMEM : 0, p, ec,
+                "boost::filesystem::directory_cursor::open"))
+        return;
+      c.m_size = cursor_buffer_size;
+      c.m_owns_buffer = true;
     }
-    else  // filesystem supplies d_type value
+    if ((c.m_fd = BOOST_FILESYSTEM_SYSCALL(::open(p.c_str(), cursor_open_flags))) < 0)
     {
-      if (entry->d_type == DT_DIR)
-        sf = symlink_sf = fs::file_status(fs::directory_file);
-      else if (entry->d_type == DT_REG)
-        sf = symlink_sf = fs::file_status(fs::regular_file);
-      else if (entry->d_type == DT_LNK)
-      {
-        sf = fs::file_status(fs::status_error);
-        symlink_sf = fs::file_status(fs::symlink_file);
-      }
-      else sf = symlink_sf = fs::file_status(fs::status_error);
+      error(errno, p, ec, "boost::filesystem::directory_cursor::open");
+      return;
+    }
+#   elif defined(BOOST_POSIX_API)
+    if ((c.m_handle = BOOST_FILESYSTEM_SYSCALL(::opendir(p.c_str()))) == 0)
+    {
+      error(errno, p, ec, "boost::filesystem::directory_cursor::open");
+      return;
     }
+    c.m_offset = 0;
 #   else
-    sf = symlink_sf = fs::file_status(fs::status_error);
-#    endif
-    return ok;
-  }
-
-# else // BOOST_WINDOWS_API
+    file_status file_stat, symlink_file_stat;
+    error_code result = dir_itr_first(c.m_handle, p, c.m_filename,
+      file_stat, symlink_file_stat);
+    if (error(result.value(), p, ec, "boost::filesystem::directory_cursor::open"))
+      return;
+    if (c.m_handle == 0)  // empty
+      return;
+    c.m_offset = 1;
+    if (!is_dot_or_dot_dot(c.m_filename.c_str()))
+    {
+      c.m_name /= c.m_filename;
+      c.m_entry.assign(c.m_name, file_stat, symlink_file_stat);
+      c.m_inode = 0;
+      c.m_type = symlink_file_stat.type();
+      c.m_at_end = false;
+      return;
+    }
+#   endif
 
-  error_code dir_itr_first(void *& handle, const fs::path& dir,
-    wstring& target, fs::file_status & sf, fs::file_status & symlink_sf)
-  // Note: an empty root directory has no "." or ".." entries, so this
-  // causes a ERROR_FILE_NOT_FOUND error which we do not considered an
-  // error. It is treated as eof instead.
+    directory_cursor_increment(c, ec);
+  }
+
+  BOOST_FILESYSTEM_DECL
+  void directory_cursor_increment(directory_cursor& c, system::error_code* ec)
   {
-    // use a form of search Sebastian Martel reports will work with Win98
-    wstring dirpath(dir.wstring());
-    dirpath += (dirpath.empty()
-      || (dirpath[dirpath.size()-1] != L'\\'
-        && dirpath[dirpath.size()-1] != L'/'
-        && dirpath[dirpath.size()-1] != L':'))? L"\\*" : L"*";
+    BOOST_FILESYSTEM_PROBE(directory_cursor_increment_op, 0, ec);
+    if (!c.m_at_end)  // c.m_name holds the previous entry's path
+      c.m_name.remove_filename();
+    c.m_at_end = true;
 
-    WIN32_FIND_DATAW data;
-    if ((handle = ::FindFirstFileW(dirpath.c_str(), &data))
-      == INVALID_HANDLE_VALUE)
-    { 
-      handle = 0;  // signal eof
-      return error_code( (::GetLastError() == ERROR_FILE_NOT_FOUND
-                       // Windows Mobile returns ERROR_NO_MORE_FILES; see ticket #3551                                           
-                       || ::GetLastError() == ERROR_NO_MORE_FILES) 
-        ? 0 : ::GetLastError(), system_category() );
-    }
-    target = data.cFileName;
-    if (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
-    // reparse points are complex, so don't try to handle them here; instead just mark
-    // them as status_error which causes directory_entry caching to call status()
-    // and symlink_status() which do handle reparse points fully
+    if (c.m_suspended)  // reopen c.m_name where suspend() left it
     {
-      sf.type(fs::status_error);
-      symlink_sf.type(fs::status_error);
+      c.m_suspended = false;
+      err_t err = 0;
+#     if defined(BOOST_FILESYSTEM_GETDENTS)
+      if ((c.m_fd = BOOST_FILESYSTEM_SYSCALL(
+            ::open(c.m_name.c_str(), cursor_open_flags))) < 0
+        || BOOST_FILESYSTEM_SYSCALL(::lseek(c.m_fd, c.m_offset, SEEK_SET)) < 0)
+        err = errno;
+#     elif defined(BOOST_POSIX_API)
+      //  a telldir() position need not survive closedir(), so skip the entries
+      //  already returned, as on Windows; running out early leaves the loop below
+      //  to find the end
+      if ((c.m_handle = BOOST_FILESYSTEM_SYSCALL(::opendir(c.m_name.c_str()))) == 0)
+        err = errno;
+      else
+      {
+        errno = 0;
+        for (boost::int64_t i = 0; i < c.m_offset; ++i)
+          if (!BOOST_FILESYSTEM_SYSCALL(::readdir(static_cast<DIR*>(c.m_handle))))
+          {
+            err = errno;
+            break;
+          }
+      }
+#     else
+      //  FindFirstFileW() has no seek, so skip the entries already returned
+      file_status file_stat, symlink_file_stat;
+      err = dir_itr_first(c.m_handle, c.m_name, c.m_filename,
+        file_stat, symlink_file_stat).value();
+      for (boost::int64_t i = 1; !err && c.m_handle != 0 && i < c.m_offset; ++i)
+        err = dir_itr_increment(c.m_handle, c.m_filename,
+          file_stat, symlink_file_stat).value();
+      if (!err && c.m_handle == 0)  // the directory has shrunk to nothing left
+      {
+        if (ec != 0)
+          ec->clear();
+        return;
+      }
+#     endif
+      if (err)
+      {
+        directory_cursor_close(c, false);
+        error(err, c.m_name, ec, "boost::filesystem::directory_cursor::increment");
+        return;
+      }
     }
-    else
+
+    for (;;)
     {
-      if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+      const path::value_type* name = 0;
+      file_status file_stat(status_error), symlink_file_stat(status_error);
+      boost::uint64_t inode = 0;
+      err_t err = 0;
+
+#     if defined(BOOST_FILESYSTEM_GETDENTS)
+      BOOST_ASSERT_MSG(c.m_fd >= 0, "increment of closed directory_cursor");
+      if (c.m_pos >= c.m_end)
       {
-        sf.type(fs::directory_file);
-        symlink_sf.type(fs::directory_file);
+        long n = BOOST_FILESYSTEM_SYSCALL(
+          ::syscall(SYS_getdents64, c.m_fd, c.m_buffer, c.m_size));
+        if (n < 0)
+          err = errno;
+        c.m_pos = 0;
+        c.m_end = n < 0 ? 0 : static_cast<std::size_t>(n);
+      }
+      if (c.m_pos < c.m_end)
+      {
+        const getdents64_record* record
+          = reinterpret_cast<const getdents64_record*>(c.m_buffer + c.m_pos);
+        c.m_pos += record->d_reclen;
+        c.m_offset = record->d_off;
+        name = record->d_name;
+        inode = record->d_ino;
+#       ifdef BOOST_FILESYSTEM_STATUS_CACHE
+        d_type_status(record->d_type, file_stat, symlink_file_stat);
+#       endif
+      }
+#     elif defined(BOOST_POSIX_API)
+      //  readdir() is safe here since no other thread reads this directory stream
+      BOOST_ASSERT_MSG(c.m_handle != 0, "increment of closed directory_cursor");
+      errno = 0;
+      if (struct dirent* entry
+        = BOOST_FILESYSTEM_SYSCALL(::readdir(static_cast<DIR*>(c.m_handle))))
+      {
+        name = entry->d_name;
+        inode = entry->d_ino;
+        ++c.m_offset;
+#       ifdef BOOST_FILESYSTEM_STATUS_CACHE
+        d_type_status(entry->d_type, file_stat, symlink_file_stat);
+#       endif
       }
       else
+        err = errno;
+#     else
+      BOOST_ASSERT_MSG(c.m_handle != 0, "increment of closed directory_cursor");
+      error_code result = dir_itr_increment(c.m_handle, c.m_filename,
+        file_stat, symlink_file_stat);
+      err = result.value();
+      if (!err && c.m_handle != 0)
       {
-        sf.type(fs::regular_file);
-        symlink_sf.type(fs::regular_file);
+        name = c.m_filename.c_str();
+        ++c.m_offset;
+      }
+#     endif
+
+      if (err || name == 0)  // error or end of directory
+      {
+        directory_cursor_close(c, false);
+        error(err, c.m_name, ec, "boost::filesystem::directory_cursor::increment");
+        return;
+      }
+
+      if (!is_dot_or_dot_dot(name))
+      {
+        c.m_name /= name;
+        c.m_entry.assign(c.m_name, file_stat, symlink_file_stat);
+        c.m_inode = inode;
+        c.m_type = symlink_file_stat.type();
+        c.m_at_end = false;
+        if (ec != 0)
+          ec->clear();
+        return;
       }
-      sf.permissions(make_permissions(data.cFileName, data.dwFileAttributes));
-      symlink_sf.permissions(sf.permissions());
     }
-    return error_code();
   }
+}  // namespace detail
+} // namespace filesystem
+} // namespace boost
 
-  error_code  dir_itr_increment(void *& handle, wstring& target,
-    fs::file_status & sf, fs::file_status & symlink_sf)
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                 extent_iterator                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace
+{
+  //  Sets extent to the extent beginning at offset, which is less than size. Returns 0
+  //  or an error value. A file system that cannot report holes is treated as all data.
+  err_t next_extent(fs::native_file_handle h, boost::uintmax_t offset,
+    boost::uintmax_t size, fs::file_extent& extent)
   {
-    WIN32_FIND_DATAW data;
-    if (::FindNextFileW(handle, &data)== 0)// fails
+    extent.offset = offset;
+    extent.length = size - offset;
+    extent.type = fs::extent_type::data;
+
+# ifdef BOOST_POSIX_API
+
+#   if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    off_t data = ::lseek(h, offset, SEEK_DATA);
+    if (data < 0 && errno == ENXIO)  // nothing but a hole from offset to the end
     {
-      int error = ::GetLastError();
-      fs::detail::dir_itr_close(handle);
-      return error_code(error == ERROR_NO_MORE_FILES ? 0 : error, system_category());
+      extent.type = fs::extent_type::hole;
+      return 0;
     }
-    target = data.cFileName;
-    if (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
-    // reparse points are complex, so don't try to handle them here; instead just mark
-    // them as status_error which causes directory_entry caching to call status()
-    // and symlink_status() which do handle reparse points fully
+    if (data >= 0)
     {
-      sf.type(fs::status_error);
-      symlink_sf.type(fs::status_error);
+      if (static_cast<boost::uintmax_t>(data) > offset)
+      {
+        extent.type = fs::extent_type::hole;
+        extent.length = std::min(static_cast<boost::uintmax_t>(data), size) - offset;
+        return 0;
+      }
+      off_t hole = ::lseek(h, offset, SEEK_HOLE);  // the end of file counts as a hole
+      if (hole < 0)
+        return errno;
+      extent.length = std::min(static_cast<boost::uintmax_t>(hole), size) - offset;
+      return 0;
     }
-    else
+    if (errno != EINVAL && errno != ENOTSUP)
+      return errno;
+    // the kernel or file system does not support SEEK_DATA
+#   endif
+
+#   if defined(FS_IOC_FIEMAP)
+    //  FIEMAP reports the allocated extents; successive ones are merged until a gap
+    boost::uint64_t buf[(sizeof(struct fiemap) + sizeof(struct fiemap_extent)) / 8 + 1];
+    struct fiemap* map = reinterpret_cast<struct fiemap*>(buf);
+    boost::uintmax_t end = offset;  // end of the data found so far
+    for (;;)
     {
-      if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+      std::memset(buf, 0, sizeof(buf));
+      map->fm_start = end;
+      map->fm_length = size - end;
+      map->fm_extent_count = 1;
+      if (::ioctl(h, FS_IOC_FIEMAP, map)!= 0)
       {
-        sf.type(fs::directory_file);
-        symlink_sf.type(fs::directory_file);
+        if (end != offset)
+          break;
+        if (errno == EOPNOTSUPP || errno == ENOTTY || errno == EINVAL)
+          return 0;
+        return errno;
       }
-      else
+      const struct fiemap_extent& fe = map->fm_extents[0];
+      if (map->fm_mapped_extents == 0 || fe.fe_logical > end)  // a hole follows end
       {
-        sf.type(fs::regular_file);
-        symlink_sf.type(fs::regular_file);
+        if (end == offset)
+        {
+          extent.type = fs::extent_type::hole;
+          extent.length = map->fm_mapped_extents == 0
+            ? size - offset : std::min<boost::uintmax_t>(fe.fe_logical, size) - offset;
+          return 0;
+        }
+        break;
       }
-      sf.permissions(make_permissions(data.cFileName, data.dwFileAttributes));
-      symlink_sf.permissions(sf.permissions());
+      end = std::min<boost::uintmax_t>(fe.fe_logical + fe.fe_length, size);
+      if ((fe.fe_flags & FIEMAP_EXTENT_LAST) || end >= size)
+        break;
     }
-    return error_code();
-  }
-#endif
+    extent.length = end - offset;
+#   endif
 
-  const error_code not_found_error_code (
-#     ifdef BOOST_WINDOWS_API
-        ERROR_PATH_NOT_FOUND
-#     else
-        ENOENT 
-#     endif
-        , system_category());
+    return 0;
+
+# else
+
+    FILE_ALLOCATED_RANGE_BUFFER query, range;
+    query.FileOffset.QuadPart = offset;
+    query.Length.QuadPart = size - offset;
+    DWORD bytes = 0;
+    if (!::DeviceIoControl(h, FSCTL_QUERY_ALLOCATED_RANGES, &query, sizeof(query),
+      &range, sizeof(range), &bytes, 0))
+    {
+      DWORD err = ::GetLastError();
+      if (err == ERROR_INVALID_FUNCTION)  // e.g. FAT, which has no holes
+        return 0;
+      if (err != ERROR_MORE_DATA)  // more ranges than fit in one buffer is expected
+        return err;
+    }
+    if (bytes < sizeof(range))  // nothing allocated from offset to the end
+      extent.type = fs::extent_type::hole;
+    else if (static_cast<boost::uintmax_t>(range.FileOffset.QuadPart) > offset)
+    {
+      extent.type = fs::extent_type::hole;
+      extent.length = range.FileOffset.QuadPart - offset;
+    }
+    else
+      extent.length = std::min(static_cast<boost::uintmax_t>(
+        range.FileOffset.QuadPart + range.Length.QuadPart), size) - offset;
+    return 0;
 
+# endif
+  }
 }  // unnamed namespace
 
 namespace boost
@@ -2333,119 +4731,95 @@ namespace filesystem
 
 namespace detail
 {
-  //  dir_itr_close is called both from the ~dir_itr_imp()destructor 
-  //  and dir_itr_increment()
   BOOST_FILESYSTEM_DECL
-  system::error_code dir_itr_close( // never throws
-    void *& handle
-#   if defined(BOOST_POSIX_API)
-    , void *& buffer
-#   endif
-   )
+  void extent_itr_close(native_file_handle handle)  // never throws
   {
 #   ifdef BOOST_POSIX_API
-    std::free(buffer);
-    buffer = 0;
-    if (handle == 0)return ok;
-    DIR * h(static_cast<DIR*>(handle));
-    handle = 0;
-    return error_code(::closedir(h)== 0 ? 0 : errno, system_category());
-
+    ::close(handle);
 #   else
-    if (handle != 0)
-    {
-      ::FindClose(handle);
-      handle = 0;
-    }
-    return ok;
-
+    ::CloseHandle(handle);
 #   endif
   }
 
-  void directory_iterator_construct(directory_iterator& it,
-    const path& p, system::error_code* ec)    
+  BOOST_FILESYSTEM_DECL
+  void extent_iterator_construct(extent_iterator& it,
+    const path& p, system::error_code* ec)
   {
-    if (error(p.empty() ? not_found_error_code.value() : 0, p, ec,
-              "boost::filesystem::directory_iterator::construct"))
+    if (!native_files(p, ec, "boost::filesystem::extent_iterator::construct"))
+    {
+      it.m_imp.reset();
       return;
+    }
+    detail::extent_itr_imp& imp = *it.m_imp;
+    err_t err = 0;
 
-    path::string_type filename;
-    file_status file_stat, symlink_file_stat;
-    error_code result = dir_itr_first(it.m_imp->handle,
-#     if defined(BOOST_POSIX_API)
-      it.m_imp->buffer,
-#     endif
-      p.c_str(), filename, file_stat, symlink_file_stat);
+#   ifdef BOOST_POSIX_API
+    struct stat path_stat;
+    imp.handle = ::open(p.c_str(), O_RDONLY);
+    if (imp.handle < 0)
+      err = errno;
+    else
+    {
+      imp.is_open = true;
+      if (::fstat(imp.handle, &path_stat)!= 0)
+        err = errno;
+      else
+        imp.size = path_stat.st_size;
+    }
+#   else
+    LARGE_INTEGER size;
+    imp.handle = create_file_handle(p.c_str(), GENERIC_READ,
+      FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE, 0, OPEN_EXISTING, 0, 0);
+    if (imp.handle == INVALID_HANDLE_VALUE)
+      err = BOOST_ERRNO;
+    else
+    {
+      imp.is_open = true;
+      if (!::GetFileSizeEx(imp.handle, &size))
+        err = BOOST_ERRNO;
+      else
+        imp.size = size.QuadPart;
+    }
+#   endif
 
-    if (result)
+    if (err != 0)
     {
       it.m_imp.reset();
-      error(result.value(), p,
-        ec, "boost::filesystem::directory_iterator::construct");
+      error(err, p, ec, "boost::filesystem::extent_iterator::construct");
       return;
     }
-    
-    if (it.m_imp->handle == 0)
-      it.m_imp.reset(); // eof, so make end iterator
-    else // not eof
-    {
-      it.m_imp->dir_entry.assign(p / filename, file_stat, symlink_file_stat);
-      if (filename[0] == dot // dot or dot-dot
-        && (filename.size()== 1
-          || (filename[1] == dot
-            && filename.size()== 2)))
-        {  it.increment(*ec); }
-    }
+
+    imp.p = p;
+    imp.extent.offset = imp.extent.length = 0;
+    imp.extent.type = extent_type::data;
+    extent_iterator_increment(it, ec);
   }
 
-  void directory_iterator_increment(directory_iterator& it,
-    system::error_code* ec)
+  BOOST_FILESYSTEM_DECL
+  void extent_iterator_increment(extent_iterator& it, system::error_code* ec)
   {
     BOOST_ASSERT_MSG(it.m_imp.get(), "attempt to increment end iterator");
-    BOOST_ASSERT_MSG(it.m_imp->handle != 0, "internal program error");
-    
-    path::string_type filename;
-    file_status file_stat, symlink_file_stat;
-    system::error_code temp_ec;
+    detail::extent_itr_imp& imp = *it.m_imp;
 
-    for (;;)
+    boost::uintmax_t next = imp.extent.offset + imp.extent.length;
+    if (next >= imp.size)  // eof, make end
     {
-      temp_ec = dir_itr_increment(it.m_imp->handle,
-#       if defined(BOOST_POSIX_API)
-        it.m_imp->buffer,
-#       endif
-        filename, file_stat, symlink_file_stat);
-
-      if (temp_ec)  // happens if filesystem is corrupt, such as on a damaged optical disc
-      {
-        path error_path(it.m_imp->dir_entry.path().parent_path());  // fix ticket #5900
-        it.m_imp.reset();
-        if (ec == 0)
-          BOOST_FILESYSTEM_THROW(
-            filesystem_error("boost::filesystem::directory_iterator::operator++",
-              error_path,
-              error_code(BOOST_ERRNO, system_category())));
-        ec->assign(BOOST_ERRNO, system_category());
-        return;
-      }
-      else if (ec != 0) ec->clear();
-
-      if (it.m_imp->handle == 0)  // eof, make end
-      {
-        it.m_imp.reset();
-        return;
-      }
+      it.m_imp.reset();
+      if (ec != 0)
+        ec->clear();
+      return;
+    }
 
-      if (!(filename[0] == dot // !(dot or dot-dot)
-        && (filename.size()== 1
-          || (filename[1] == dot
-            && filename.size()== 2))))
-      {
-        it.m_imp->dir_entry.replace_filename(
-          filename, file_stat, symlink_file_stat);
-        return;
-      }
+    err_t err = next_extent(imp.handle, next, imp.size, imp.extent);
+    if (err != 0)
+    {
+      path error_path(imp.p);
+      it.m_imp.reset();
+      error(err, error_path, ec, "boost::filesystem::extent_iterator::operator++");
+      return;
     }
+    if (ec != 0)
+      ec->clear();
   }
 }  // namespace detail
 } // namespace filesystem
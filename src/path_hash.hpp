@@ -0,0 +1,41 @@
+//  filesystem path_hash.hpp  ----------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  Private header; not part of the library interface.
+
+#ifndef BOOST_FILESYSTEM_SRC_PATH_HASH_HPP
+#define BOOST_FILESYSTEM_SRC_PATH_HASH_HPP
+
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/path.hpp>
+
+namespace boost
+{
+namespace filesystem
+{
+namespace detail
+{
+  //  FNV-1a over the characters of a native path string, as the caches use to pick the
+  //  shard that holds a path
+  inline boost::uint32_t path_hash(const path::string_type& s)
+  {
+    boost::uint32_t h = 2166136261u;
+    for (path::string_type::const_iterator it = s.begin(); it != s.end(); ++it)
+      h = (h ^ static_cast<boost::uint32_t>(*it)) * 16777619u;
+    return h;
+  }
+
+}  // namespace detail
+}  // namespace filesystem
+}  // namespace boost
+
+#endif  // BOOST_FILESYSTEM_SRC_PATH_HASH_HPP
@@ -0,0 +1,132 @@
+//  prefetcher.cpp  --------------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  define 64-bit offset macros BEFORE including boost/config.hpp (see ticket #5355)
+#if !(defined(__HP_aCC) && defined(_ILP32) && !defined(_STATVFS_ACPP_PROBLEMS_FIXED))
+#define _FILE_OFFSET_BITS 64 // at worst, these defines may have no effect,
+#endif
+#if !defined(__PGI)
+#define __USE_FILE_OFFSET64 // but that is harmless on Windows and on POSIX
+#else
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// define BOOST_FILESYSTEM_SOURCE so that <boost/filesystem/config.hpp> knows
+// the library is being built (possibly exporting rather than importing code)
+#define BOOST_FILESYSTEM_SOURCE
+
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+# define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem/prefetcher.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/assert.hpp>
+#include <deque>
+
+namespace boost
+{
+namespace filesystem
+{
+  struct file_prefetcher::impl
+  {
+    struct queued
+    {
+      explicit queued(const path& file) : p(file), bytes(0) {}
+
+      path              p;
+      boost::uintmax_t  bytes;  // prefetched
+    };
+
+    explicit impl(const prefetch_options& o) : options(o), prefetched(0), bytes(0) {}
+
+    prefetch_options     options;
+    std::deque<queued>   files;
+    std::size_t          prefetched;  // the files before this index have been
+    boost::uintmax_t     bytes;       // prefetched, these bytes of them
+    prefetch_statistics  statistics;
+  };
+
+  file_prefetcher::file_prefetcher(const prefetch_options& options)
+    : m_imp(new impl(options)) {}
+
+  file_prefetcher::~file_prefetcher() {}
+
+  void file_prefetcher::queue(const path& p, bool fill_now)
+  {
+    m_imp->files.push_back(impl::queued(p));
+    if (fill_now)
+      fill();
+  }
+
+  void file_prefetcher::fill()
+  {
+    impl& m = *m_imp;
+    std::size_t limit = m.options.window < m.files.size()
+      ? m.options.window : m.files.size();
+    for (; m.prefetched < limit; ++m.prefetched)
+    {
+      boost::uintmax_t length = m.options.bytes_per_file;
+      if (m.prefetched > 0)  // the first file is prefetched whatever the budget
+      {
+        if (m.bytes >= m.options.byte_budget)
+          break;
+        boost::uintmax_t left = m.options.byte_budget - m.bytes;
+        if (length == 0 || length > left)
+          length = left;
+      }
+      impl::queued& f = m.files[m.prefetched];
+      system::error_code ec;
+      f.bytes = detail::prefetch(f.p, 0, length, &ec);
+      if (ec)
+        ++m.statistics.failures;
+      else
+      {
+        ++m.statistics.files;
+        m.statistics.bytes += f.bytes;
+        m.bytes += f.bytes;
+      }
+    }
+  }
+
+  bool file_prefetcher::empty() const  { return m_imp->files.empty(); }
+
+  std::size_t file_prefetcher::size() const  { return m_imp->files.size(); }
+
+  const path& file_prefetcher::front() const
+  {
+    BOOST_ASSERT_MSG(!m_imp->files.empty(), "front() of empty file_prefetcher");
+    return m_imp->files.front().p;
+  }
+
+  path file_prefetcher::take()
+  {
+    impl& m = *m_imp;
+    BOOST_ASSERT_MSG(!m.files.empty(), "take() from empty file_prefetcher");
+    path result;
+    result.swap(m.files.front().p);
+    if (m.prefetched > 0)
+    {
+      m.bytes -= m.files.front().bytes;
+      --m.prefetched;
+    }
+    m.files.pop_front();
+    fill();
+    return result;
+  }
+
+  prefetch_statistics file_prefetcher::statistics() const
+  {
+    return m_imp->statistics;
+  }
+
+} // namespace filesystem
+} // namespace boost
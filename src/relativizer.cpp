@@ -0,0 +1,250 @@
+//  relativizer.cpp  -------------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  define 64-bit offset macros BEFORE including boost/config.hpp (see ticket #5355)
+#if !(defined(__HP_aCC) && defined(_ILP32) && !defined(_STATVFS_ACPP_PROBLEMS_FIXED))
+#define _FILE_OFFSET_BITS 64 // at worst, these defines may have no effect,
+#endif
+#if !defined(__PGI)
+#define __USE_FILE_OFFSET64 // but that is harmless on Windows and on POSIX
+#else
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// define BOOST_FILESYSTEM_SOURCE so that <boost/filesystem/config.hpp> knows
+// the library is being built (possibly exporting rather than importing code)
+#define BOOST_FILESYSTEM_SOURCE
+
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+# define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem/relativizer.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <algorithm>
+#include "work_queue.hpp"
+
+namespace fs = boost::filesystem;
+
+using boost::filesystem::path;
+using boost::system::error_code;
+
+namespace
+{
+  //  Keeps the first error reported by any thread
+  class first_error
+  {
+  public:
+    void set(const error_code& ec, const path& p)
+    {
+      fs::detail::scoped_worker_lock lock(m_mutex);
+      if (!m_ec)
+      {
+        m_ec = ec;
+        m_path = p;
+      }
+    }
+
+    //  Throws or sets *ec as the library's other functions do
+    void report(error_code* ec) const
+    {
+      if (!m_ec)
+      {
+        if (ec != 0)
+          ec->clear();
+        return;
+      }
+      if (ec == 0)
+        BOOST_FILESYSTEM_THROW(fs::filesystem_error(
+          "boost::filesystem::relativizer::relative", m_path, m_ec));
+      *ec = m_ec;
+    }
+
+  private:
+    error_code                m_ec;
+    path                      m_path;
+    fs::detail::worker_mutex  m_mutex;
+  };
+
+  //  Worker for the work_queue: each task is the index of the first of up to chunk
+  //  paths, as lexical relative paths cost too little to be queued one at a time
+  class relative_runner
+  {
+  public:
+    relative_runner(const fs::relativizer& r, const std::vector<path>& paths,
+      std::vector<path>& results, first_error& error, std::size_t chunk)
+      : m_relativizer(r), m_paths(paths), m_results(results), m_error(error),
+        m_chunk(chunk) {}
+
+    void operator()(std::size_t first, fs::detail::work_queue<std::size_t>& queue)
+    {
+      std::size_t last = std::min(first + m_chunk, m_paths.size());
+      for (std::size_t i = first; i < last && !queue.stopped(); ++i)
+      {
+        error_code ec;
+        m_results[i] = m_relativizer.relative(m_paths[i], ec);
+        if (ec)
+        {
+          m_error.set(ec, m_paths[i]);
+          queue.stop();
+          return;
+        }
+      }
+    }
+
+  private:
+    const fs::relativizer&    m_relativizer;
+    const std::vector<path>&  m_paths;
+    std::vector<path>&        m_results;  // each element is written by one thread
+    first_error&              m_error;
+    std::size_t               m_chunk;
+  };
+
+  const std::size_t chunk_size = 256;
+}
+
+namespace boost
+{
+namespace filesystem
+{
+  relativizer::relativizer(const path& base, bool lexical) : m_lexical(lexical)
+  {
+    m_init(base, 0);
+  }
+
+  relativizer::relativizer(const path& base, bool lexical, system::error_code& ec)
+    : m_lexical(lexical)
+  {
+    m_init(base, &ec);
+  }
+
+  void relativizer::m_init(const path& base, system::error_code* ec)
+  {
+    if (m_lexical)
+    {
+      m_base = base;
+      if (ec != 0)
+        ec->clear();
+    }
+    else
+    {
+      error_code tmp_ec;
+      m_base = fs::weakly_canonical(base, tmp_ec);
+      if (tmp_ec)
+      {
+        if (ec == 0)
+          BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::relativizer",
+            base, tmp_ec));
+        *ec = tmp_ec;
+        m_base.clear();
+      }
+      else if (ec != 0)
+        ec->clear();
+    }
+
+    m_offsets.push_back(0);
+    for (path::iterator itr = m_base.begin(); itr != m_base.end(); ++itr)
+    {
+      m_elements += itr->native();
+      m_offsets.push_back(m_elements.size());
+    }
+  }
+
+  //  What p.lexically_relative(m_base) returns, without parsing m_base again
+  path relativizer::m_lexically_relative(const path& p) const
+  {
+    const std::size_t base_size = m_offsets.size() - 1;
+    path::iterator itr = p.begin();
+    const path::iterator end = p.end();
+    std::size_t matched = 0;
+    for (; itr != end && matched < base_size; ++itr, ++matched)
+    {
+      if (itr->native().compare(0, path::string_type::npos,
+        m_elements, m_offsets[matched], m_offsets[matched + 1] - m_offsets[matched]) != 0)
+        break;
+    }
+
+    if (matched == 0)
+      return path();
+    if (itr == end && matched == base_size)
+      return detail::dot_path();
+    path tmp;
+    for (; matched != base_size; ++matched)
+      tmp /= detail::dot_dot_path();
+    for (; itr != end; ++itr)
+      tmp /= *itr;
+    return tmp;
+  }
+
+  path relativizer::m_relative(const path& p, system::error_code* ec) const
+  {
+    if (m_lexical)
+    {
+      if (ec != 0)
+        ec->clear();
+      return m_lexically_relative(p);
+    }
+    error_code tmp_ec;
+    path wc_p(fs::weakly_canonical(p, tmp_ec));
+    if (tmp_ec)
+    {
+      if (ec == 0)
+        BOOST_FILESYSTEM_THROW(filesystem_error(
+          "boost::filesystem::relativizer::relative", p, tmp_ec));
+      *ec = tmp_ec;
+      return path();
+    }
+    if (ec != 0)
+      ec->clear();
+    return m_lexically_relative(wc_p);
+  }
+
+  path relativizer::relative(const path& p) const
+  {
+    return m_relative(p, 0);
+  }
+
+  path relativizer::relative(const path& p, system::error_code& ec) const
+  {
+    return m_relative(p, &ec);
+  }
+
+  std::vector<path> relativizer::m_relative(const std::vector<path>& paths,
+    unsigned threads, system::error_code* ec) const
+  {
+    std::vector<path> results(paths.size());
+    first_error error;
+    if (!paths.empty())
+    {
+      fs::detail::work_queue<std::size_t> queue(threads);
+      for (std::size_t i = 0; i < paths.size(); i += chunk_size)
+        queue.push(i);
+      relative_runner runner(*this, paths, results, error, chunk_size);
+      queue.run(runner);
+    }
+    error.report(ec);
+    return results;
+  }
+
+  std::vector<path> relativizer::relative(const std::vector<path>& paths,
+    unsigned threads) const
+  {
+    return m_relative(paths, threads, 0);
+  }
+
+  std::vector<path> relativizer::relative(const std::vector<path>& paths,
+    unsigned threads, system::error_code& ec) const
+  {
+    return m_relative(paths, threads, &ec);
+  }
+
+} // namespace filesystem
+} // namespace boost
@@ -0,0 +1,237 @@
+//  tree_generator.cpp  ----------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  generate_tree() draws every choice from a splitmix64 generator in a fixed order, and
+//  computes sizes with integer arithmetic only, so that a profile and seed give the same
+//  tree on every platform. The std:: random distributions are not used since their
+//  results differ between standard library implementations.
+
+//  define 64-bit offset macros BEFORE including boost/config.hpp (see ticket #5355)
+#if !(defined(__HP_aCC) && defined(_ILP32) && !defined(_STATVFS_ACPP_PROBLEMS_FIXED))
+#define _FILE_OFFSET_BITS 64 // at worst, these defines may have no effect,
+#endif
+#if !defined(__PGI)
+#define __USE_FILE_OFFSET64 // but that is harmless on Windows and on POSIX
+#else
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// define BOOST_FILESYSTEM_SOURCE so that <boost/filesystem/config.hpp> knows
+// the library is being built (possibly exporting rather than importing code)
+#define BOOST_FILESYSTEM_SOURCE
+
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+# define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem/tree_generator.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+using boost::filesystem::path;
+using boost::system::error_code;
+
+namespace
+{
+  //  splitmix64, by Steele, Lea and Flood: fast, and good enough for shaping trees
+  class splitmix64
+  {
+  public:
+    explicit splitmix64(boost::uint64_t seed) : m_state(seed) {}
+
+    boost::uint64_t next()
+    {
+      boost::uint64_t z = (m_state += UINT64_C(0x9E3779B97F4A7C15));
+      z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+      z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+      return z ^ (z >> 31);
+    }
+
+    //  true with the given probability; exact, since both sides are multiples of 2^-53
+    bool chance(double probability)
+    {
+      return (next() >> 11) * (1.0 / 9007199254740992.0) < probability;
+    }
+
+    //  uniform on [lo, hi]
+    boost::uintmax_t between(boost::uintmax_t lo, boost::uintmax_t hi)
+    {
+      boost::uintmax_t range = hi - lo;
+      return range == ~boost::uintmax_t(0) ? next() : lo + next() % (range + 1);
+    }
+
+  private:
+    boost::uint64_t m_state;
+  };
+
+  unsigned bit_width(boost::uintmax_t n)
+  {
+    unsigned bits = 0;
+    for (; n != 0; n >>= 1)
+      ++bits;
+    return bits;
+  }
+
+  std::string name(char prefix, unsigned n)
+  {
+    std::string s(1, prefix);
+    char digits[12];
+    char* p = digits + sizeof(digits);
+    do { *--p = static_cast<char>('0' + n % 10); } while ((n /= 10) != 0);
+    return s.append(p, digits + sizeof(digits));
+  }
+
+  class tree_builder
+  {
+  public:
+    tree_builder(const fs::tree_profile& profile, boost::uint64_t seed)
+      : m_profile(profile), m_rng(seed), m_data(64 * 1024)
+    {
+      splitmix64 fill(seed);
+      for (std::size_t i = 0; i < m_data.size(); ++i)
+        m_data[i] = static_cast<char>(fill.next());
+    }
+
+    //  Fills dir, which exists, and the levels below it. Returns false on error.
+    bool build(const path& dir, unsigned level)
+    {
+      std::vector<unsigned> regular;  // the files in dir that a symlink may refer to
+      for (unsigned i = 0; i < m_profile.files_per_directory; ++i)
+      {
+        if (!regular.empty() && m_rng.chance(m_profile.symlink_ratio))
+        {
+          unsigned target = regular[m_rng.between(0, regular.size() - 1)];
+          path p(dir / name('l', i));
+          fs::create_symlink(name('f', target), p, ec);
+          if (failed(p))
+            return false;
+          ++stats.symlinks;
+          continue;
+        }
+        if (!make_file(dir / name('f', i)))
+          return false;
+        regular.push_back(i);
+      }
+
+      if (level == m_profile.depth)
+        return true;
+      for (unsigned i = 0; i < m_profile.fanout; ++i)
+      {
+        path sub(dir / name('d', i));
+        fs::create_directory(sub, ec);
+        if (failed(sub))
+          return false;
+        ++stats.directories;
+        if (!build(sub, level + 1))
+          return false;
+      }
+      return true;
+    }
+
+    bool failed(const path& p)
+    {
+      if (ec)
+        error_path = p;
+      return ec.value() != 0;
+    }
+
+    fs::tree_stats  stats;
+    error_code      ec;
+    path            error_path;
+
+  private:
+    const fs::tree_profile&  m_profile;
+    splitmix64               m_rng;
+    std::vector<char>        m_data;  // the contents of written files, repeated
+
+    boost::uintmax_t file_size()
+    {
+      boost::uintmax_t lo = m_profile.min_file_size;
+      boost::uintmax_t hi = (std::max)(m_profile.max_file_size, lo);
+      if (m_profile.sizes == fs::tree_profile::log_uniform)
+      {
+        //  choose a power of two range, then a size within it, so that each doubling
+        //  of size is as likely as the last
+        unsigned bits = static_cast<unsigned>(
+          m_rng.between(bit_width(lo), bit_width(hi)));
+        boost::uintmax_t first = bits == 0 ? 0 : boost::uintmax_t(1) << (bits - 1);
+        boost::uintmax_t last = bits == 0 ? 0 : first + (first - 1);
+        lo = (std::max)(lo, first);
+        hi = (std::min)(hi, last);
+      }
+      return m_rng.between(lo, hi);
+    }
+
+    bool make_file(const path& p)
+    {
+      boost::uintmax_t size = file_size();
+      bool sparse = size != 0 && m_rng.chance(m_profile.sparse_ratio);
+      {
+        fs::ofstream file(p, std::ios_base::binary);
+        for (boost::uintmax_t left = sparse ? 0 : size; file && left != 0;)
+        {
+          std::size_t n = static_cast<std::size_t>(
+            (std::min)(left, static_cast<boost::uintmax_t>(m_data.size())));
+          file.write(&m_data[0], n);
+          left -= n;
+        }
+        if (!file)
+          ec = boost::system::errc::make_error_code(boost::system::errc::io_error);
+      }
+      if (!ec && sparse)
+        fs::resize_file(p, size, ec);
+      if (failed(p))
+        return false;
+      ++stats.files;
+      if (sparse)
+        ++stats.sparse_files;
+      stats.bytes += size;
+      return true;
+    }
+  };
+}  // unnamed namespace
+
+namespace boost
+{
+namespace filesystem
+{
+namespace detail
+{
+  BOOST_FILESYSTEM_DECL
+  tree_stats generate_tree(const path& root, const tree_profile& profile,
+    boost::uint64_t seed, system::error_code* ec)
+  {
+    tree_builder builder(profile, seed);
+    if (fs::create_directories(root, builder.ec))
+      ++builder.stats.directories;
+    if (!builder.failed(root))
+      builder.build(root, 0);
+
+    if (!builder.ec)
+    {
+      if (ec != 0)
+        ec->clear();
+    }
+    else if (ec == 0)
+      BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::generate_tree",
+        builder.error_path, builder.ec));
+    else
+      *ec = builder.ec;
+    return builder.stats;
+  }
+}  // namespace detail
+}  // namespace filesystem
+}  // namespace boost
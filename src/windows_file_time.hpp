@@ -0,0 +1,44 @@
+//  filesystem windows_file_time.hpp  --------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  Private header; not part of the library interface.
+
+#ifndef BOOST_FILESYSTEM_SRC_WINDOWS_FILE_TIME_HPP
+#define BOOST_FILESYSTEM_SRC_WINDOWS_FILE_TIME_HPP
+
+#include <boost/config.hpp>
+#include <boost/cstdint.hpp>
+#include <ctime>
+#include <windows.h>
+
+namespace boost
+{
+namespace filesystem
+{
+namespace detail
+{
+  //  Converts ft, which counts 100 ns intervals since 1601, to a time_t, storing the
+  //  nanoseconds past that second in *ns if ns is not null
+  inline std::time_t filetime_to_time_t(const FILETIME& ft, long* ns = 0)
+  {
+    boost::uint64_t t = (static_cast<boost::uint64_t>(ft.dwHighDateTime) << 32)
+      | ft.dwLowDateTime;
+    t -= 116444736000000000ULL;
+    if (ns)
+      *ns = static_cast<long>(t % 10000000) * 100;
+    return static_cast<std::time_t>(t / 10000000);
+  }
+
+}  // namespace detail
+}  // namespace filesystem
+}  // namespace boost
+
+#endif  // BOOST_FILESYSTEM_SRC_WINDOWS_FILE_TIME_HPP
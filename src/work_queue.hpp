@@ -0,0 +1,229 @@
+//  filesystem work_queue.hpp  ---------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+//  Private header; not part of the library interface.
+//
+//  work_queue runs a worker function object over a queue of tasks that the worker itself
+//  may extend, which is what tree operations need: processing a directory task discovers
+//  more directory and file tasks. When the standard library supplies <thread>, <mutex>,
+//  <condition_variable>, and <atomic>, the queue is drained by several threads;
+//  otherwise it is drained by the calling thread alone, so callers need not care which.
+//  worker_mutex is a real lock either way, since the library's callers may share a
+//  backend or cache between threads of their own.
+
+#ifndef BOOST_FILESYSTEM_SRC_WORK_QUEUE_HPP
+#define BOOST_FILESYSTEM_SRC_WORK_QUEUE_HPP
+
+#include <boost/config.hpp>
+#include <boost/filesystem/config.hpp>
+#include <boost/noncopyable.hpp>
+#include <deque>
+#include <vector>
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD) && !defined(BOOST_NO_CXX11_HDR_MUTEX) \
+  && !defined(BOOST_NO_CXX11_HDR_CONDITION_VARIABLE) \
+  && !defined(BOOST_NO_CXX11_HDR_ATOMIC) \
+  && !defined(BOOST_NO_CXX11_HDR_EXCEPTION) && !defined(BOOST_NO_EXCEPTIONS)
+# define BOOST_FILESYSTEM_WORKER_THREADS
+# include <atomic>
+# include <thread>
+# include <mutex>
+# include <condition_variable>
+# include <exception>
+#elif defined(BOOST_HAS_PTHREADS)
+# include <pthread.h>
+#elif defined(BOOST_WINDOWS_API)
+# include <windows.h>
+#endif
+
+namespace boost
+{
+namespace filesystem
+{
+namespace detail
+{
+  //  Number of threads to use when the caller has no preference (0 requested).
+  inline unsigned default_worker_count()
+  {
+#   ifdef BOOST_FILESYSTEM_WORKER_THREADS
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 2 : (n > 16 ? 16 : n);  // more threads than this just adds
+                                            // contention on the kernel's inode locks
+#   else
+    return 1;
+#   endif
+  }
+
+  //  worker_mutex is std::mutex where the standard library has one, and otherwise the
+  //  platform's own mutex; only a platform without threads makes it a no-op.
+  class worker_mutex : boost::noncopyable
+  {
+  public:
+#   ifdef BOOST_FILESYSTEM_WORKER_THREADS
+    void lock()   { m_mutex.lock(); }
+    void unlock() { m_mutex.unlock(); }
+  private:
+    std::mutex m_mutex;
+#   elif defined(BOOST_HAS_PTHREADS)
+    worker_mutex()  { ::pthread_mutex_init(&m_mutex, 0); }
+    ~worker_mutex() { ::pthread_mutex_destroy(&m_mutex); }
+    void lock()     { ::pthread_mutex_lock(&m_mutex); }
+    void unlock()   { ::pthread_mutex_unlock(&m_mutex); }
+  private:
+    pthread_mutex_t m_mutex;
+#   elif defined(BOOST_WINDOWS_API)
+    worker_mutex()  { ::InitializeCriticalSection(&m_section); }
+    ~worker_mutex() { ::DeleteCriticalSection(&m_section); }
+    void lock()     { ::EnterCriticalSection(&m_section); }
+    void unlock()   { ::LeaveCriticalSection(&m_section); }
+  private:
+    CRITICAL_SECTION m_section;
+#   else
+    void lock()   {}
+    void unlock() {}
+#   endif
+  };
+
+  class scoped_worker_lock : boost::noncopyable
+  {
+  public:
+    explicit scoped_worker_lock(worker_mutex& m) : m_mutex(m) { m_mutex.lock(); }
+    ~scoped_worker_lock() { m_mutex.unlock(); }
+  private:
+    worker_mutex& m_mutex;
+  };
+
+  template <class Task>
+  class work_queue : boost::noncopyable
+  {
+  public:
+    explicit work_queue(unsigned threads = 0)
+      : m_threads(threads ? threads : default_worker_count()),
+        m_active(0), m_stop(false) {}
+
+    //  May be called before run() or from within a worker.
+    void push(const Task& task)
+    {
+#     ifdef BOOST_FILESYSTEM_WORKER_THREADS
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.push_back(task);
+      m_ready.notify_one();
+#     else
+      m_tasks.push_back(task);
+#     endif
+    }
+
+    //  Abandon the remaining tasks; tasks already running are allowed to finish.
+    void stop()
+    {
+#     ifdef BOOST_FILESYSTEM_WORKER_THREADS
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+      m_ready.notify_all();
+#     else
+      m_stop = true;
+#     endif
+    }
+
+    //  Advisory: a worker may see it stale by the time it acts on it
+    bool stopped() const
+    {
+#     ifdef BOOST_FILESYSTEM_WORKER_THREADS
+      return m_stop.load(std::memory_order_relaxed);
+#     else
+      return m_stop;
+#     endif
+    }
+
+    //  Calls worker(task, *this) for every task, including tasks pushed by the worker,
+    //  then returns. Worker must be callable concurrently from several threads. If a
+    //  worker throws, the queue is stopped and the first exception is rethrown here.
+    template <class Worker>
+    void run(Worker& worker)
+    {
+#     ifdef BOOST_FILESYSTEM_WORKER_THREADS
+      if (m_threads > 1)
+      {
+        std::vector<std::thread> helpers;
+        for (unsigned i = 1; i < m_threads; ++i)
+          helpers.push_back(std::thread(&work_queue::drain<Worker>, this, &worker));
+        drain(&worker);
+        for (std::size_t i = 0; i < helpers.size(); ++i)
+          helpers[i].join();
+        if (m_exception)
+          std::rethrow_exception(m_exception);
+        return;
+      }
+#     endif
+      while (!m_tasks.empty() && !m_stop)
+      {
+        Task task(m_tasks.front());
+        m_tasks.pop_front();
+        worker(task, *this);
+      }
+    }
+
+  private:
+    std::deque<Task>  m_tasks;
+    unsigned          m_threads;
+    unsigned          m_active;   // tasks currently being processed
+#   ifdef BOOST_FILESYSTEM_WORKER_THREADS
+    std::atomic<bool> m_stop;     // set under m_mutex; stopped() reads it without
+#   else
+    bool              m_stop;
+#   endif
+
+#   ifdef BOOST_FILESYSTEM_WORKER_THREADS
+    std::mutex               m_mutex;
+    std::condition_variable  m_ready;
+    std::exception_ptr       m_exception;
+
+    template <class Worker>
+    void drain(Worker* worker)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      for (;;)
+      {
+        //  the queue is finished only when it is empty and no running task can add to it
+        while (m_tasks.empty() && m_active != 0 && !m_stop)
+          m_ready.wait(lock);
+        if (m_stop || m_tasks.empty())
+        {
+          m_ready.notify_all();
+          return;
+        }
+        Task task(m_tasks.front());
+        m_tasks.pop_front();
+        ++m_active;
+        lock.unlock();
+        try { (*worker)(task, *this); }
+        catch (...)
+        {
+          lock.lock();
+          if (!m_exception)
+            m_exception = std::current_exception();
+          m_stop = true;
+          lock.unlock();
+        }
+        lock.lock();
+        --m_active;
+        if (m_active == 0 && m_tasks.empty())
+          m_ready.notify_all();
+      }
+    }
+#   endif
+  };
+
+}  // namespace detail
+}  // namespace filesystem
+}  // namespace boost
+
+#endif  // BOOST_FILESYSTEM_SRC_WORK_QUEUE_HPP
@@ -0,0 +1,40 @@
+//  allocation_count.cpp  --------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/config.hpp>
+#include "allocation_count.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+  std::size_t allocation_total = 0;
+  int counting_depth = 0;
+}
+
+std::size_t allocations() { return allocation_total; }
+
+allocation_counting::allocation_counting()  { ++counting_depth; }
+allocation_counting::~allocation_counting() { --counting_depth; }
+
+# if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+void* operator new(std::size_t size)
+{
+  if (counting_depth > 0)
+    ++allocation_total;
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) BOOST_NOEXCEPT { std::free(p); }
+#   if defined(__cpp_sized_deallocation)
+void operator delete(void* p, std::size_t) BOOST_NOEXCEPT { std::free(p); }
+#   endif
+# endif
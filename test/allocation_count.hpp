@@ -0,0 +1,35 @@
+//  allocation_count.hpp  --------------------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#ifndef BOOST_FILESYSTEM3_TEST_ALLOCATION_COUNT_HPP
+#define BOOST_FILESYSTEM3_TEST_ALLOCATION_COUNT_HPP
+
+#include <cstddef>
+
+//  allocation_count.cpp replaces the global operator new and delete, where the compiler
+//  has rvalue references, to count the allocations made while an allocation_counting
+//  object is live, so that a test can show what a call does not allocate. They are kept
+//  out of the tests' own translation units, where the compiler would see the new
+//  expressions paired with free().
+
+//  the number of allocations counted so far
+std::size_t allocations();
+
+class allocation_counting
+{
+public:
+  allocation_counting();
+  ~allocation_counting();
+
+private:
+  allocation_counting(const allocation_counting&);             // = delete
+  allocation_counting& operator=(const allocation_counting&);  // = delete
+};
+
+#endif  // BOOST_FILESYSTEM3_TEST_ALLOCATION_COUNT_HPP
@@ -0,0 +1,151 @@
+//  filesystem async_test.cpp  -------------------------------------------------------  //
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/config/warning_disable.hpp>
+
+#ifndef BOOST_FILESYSTEM_NO_DEPRECATED
+#  define BOOST_FILESYSTEM_NO_DEPRECATED
+#endif
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#  define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/async.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+#include <iostream>
+
+namespace fs = boost::filesystem;
+using boost::system::error_code;
+using std::cout;
+using std::endl;
+
+#ifndef BOOST_FILESYSTEM_NO_ASYNC
+
+namespace
+{
+  fs::path dir;
+
+  void future_tests()
+  {
+    cout << "future_tests..." << endl;
+
+    fs::path d(dir / "a" / "b");
+    BOOST_TEST(fs::async_create_directories(d).get());
+    fs::save_string_file(d / "f", "0123456789");
+
+    BOOST_TEST(fs::is_directory(fs::async_status(d).get()));
+    BOOST_TEST_EQ(fs::async_file_size(d / "f").get(), 10U);
+    fs::async_copy_file(d / "f", d / "g").get();
+    BOOST_TEST_EQ(fs::async_directory_listing(d).get().size(), 2U);
+
+    bool threw = false;
+    try { fs::async_file_size(dir / "no-such-file").get(); }
+    catch (const fs::filesystem_error&) { threw = true; }
+    BOOST_TEST(threw);
+
+    fs::thread_pool_executor pool(1);
+    BOOST_TEST_EQ(fs::async_remove_all(dir / "a", fs::cancellation_token(), pool).get(),
+      4U);
+    BOOST_TEST(!fs::exists(dir / "a"));
+  }
+
+  struct size_handler
+  {
+    fs::completion_queue* queue;
+    error_code* ec;
+    boost::uintmax_t* size;
+    void operator()(const error_code& e, boost::uintmax_t sz) const
+    {
+      *ec = e;
+      *size = sz;
+      queue->stop();
+    }
+  };
+
+  void callback_tests()
+  {
+    cout << "callback_tests..." << endl;
+
+    fs::save_string_file(dir / "f", "01234");
+
+    //  the handler runs on the thread calling run_one()
+    fs::completion_queue queue;
+    error_code ec;
+    boost::uintmax_t size = 0;
+    size_handler handler = { &queue, &ec, &size };
+    fs::async_file_size(dir / "f", fs::bind_executor(queue, handler));
+    BOOST_TEST(queue.run_one());
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(size, 5U);
+    BOOST_TEST(!queue.run_one());  // stopped
+    BOOST_TEST_EQ(queue.poll(), 0U);
+
+    fs::async_file_size(dir / "no-such-file", fs::bind_executor(queue, handler));
+    while (queue.poll() == 0)
+      std::this_thread::yield();
+    BOOST_TEST(ec);
+
+    std::promise<error_code> copied;
+    fs::async_copy_file(dir / "f", dir / "g", fs::copy_option::fail_if_exists,
+      [&copied](const error_code& e) { copied.set_value(e); });
+    BOOST_TEST(!copied.get_future().get());
+    BOOST_TEST_EQ(fs::file_size(dir / "g"), 5U);
+  }
+
+  void cancellation_tests()
+  {
+    cout << "cancellation_tests..." << endl;
+
+    fs::create_directories(dir / "c" / "d");
+    fs::save_string_file(dir / "c" / "d" / "f", "");
+
+    fs::cancellation_token token;
+    token.cancel();
+    std::promise<error_code> removed;
+    fs::async_remove_all(dir / "c",
+      [&removed](const error_code& e, boost::uintmax_t) { removed.set_value(e); }, token);
+    BOOST_TEST(removed.get_future().get() == boost::system::errc::operation_canceled);
+    BOOST_TEST(fs::exists(dir / "c" / "d" / "f"));
+
+    bool threw = false;
+    try { fs::async_directory_listing(dir / "c", token).get(); }
+    catch (const fs::filesystem_error& ex)
+    {
+      threw = ex.code() == boost::system::errc::operation_canceled;
+    }
+    BOOST_TEST(threw);
+
+    BOOST_TEST_EQ(fs::async_remove_all(dir / "c").get(), 3U);
+  }
+}  // unnamed namespace
+
+int cpp_main(int, char*[])
+{
+  dir = fs::temp_directory_path() / fs::unique_path("async_test-%%%%-%%%%-%%%%");
+  fs::create_directory(dir);
+
+  future_tests();
+  callback_tests();
+  cancellation_tests();
+
+  fs::remove_all(dir);
+  return ::boost::report_errors();
+}
+
+#else
+
+int cpp_main(int, char*[])
+{
+  cout << "BOOST_FILESYSTEM_NO_ASYNC is defined; nothing to test" << endl;
+  return ::boost::report_errors();
+}
+
+#endif
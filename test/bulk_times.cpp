@@ -0,0 +1,139 @@
+//  Boost Filesystem bulk_times.cpp  ---------------------------------------------------//
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Compares the thread pool and io_uring execution of the bulk operations at several
+//  io_uring queue depths. Wall-clock time is reported since the work is mostly spent
+//  waiting on the kernel.
+
+#include <boost/config/warning_disable.hpp>
+
+#ifndef BOOST_FILESYSTEM_NO_DEPRECATED
+#  define BOOST_FILESYSTEM_NO_DEPRECATED
+#endif
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#  define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/timer/timer.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/detail/lightweight_main.hpp>
+
+namespace fs = boost::filesystem;
+using namespace boost::timer;
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+namespace
+{
+  fs::path root;
+  std::vector<fs::path> dirs;   // one entry per directory to be created
+  std::vector<fs::path> files;  // one entry per file, for status
+  std::vector<fs::path> tops;   // the top level directories, for remove_all
+
+  void make_paths(int dir_count, int files_per_dir)
+  {
+    for (int i = 0; i < dir_count; ++i)
+    {
+      fs::path top(root / ("d" + std::to_string(i)));
+      tops.push_back(top);
+      dirs.push_back(top / "x" / "y");
+      for (int j = 0; j < files_per_dir; ++j)
+        files.push_back(dirs.back() / ("f" + std::to_string(j)));
+    }
+  }
+
+  void make_files()
+  {
+    for (std::vector<fs::path>::const_iterator it = files.begin();
+      it != files.end(); ++it)
+    {
+      fs::ofstream f(*it);
+    }
+  }
+
+  struct times
+  {
+    nanosecond_type create;
+    nanosecond_type status;
+    nanosecond_type remove;
+  };
+
+  times time_bulk(const fs::bulk_options& options)
+  {
+    times result;
+    cpu_timer tmr;
+    fs::bulk_create_directories(dirs, options);
+    result.create = tmr.elapsed().wall;
+
+    make_files();
+
+    tmr.start();
+    fs::bulk_status(files, options);
+    result.status = tmr.elapsed().wall;
+
+    tmr.start();
+    fs::bulk_remove_all(tops, options);
+    result.remove = tmr.elapsed().wall;
+    return result;
+  }
+
+  void report(const std::string& name, const times& t)
+  {
+    cout << std::left << std::setw(20) << name << std::right
+         << std::setw(14) << t.create / 1000
+         << std::setw(14) << t.status / 1000
+         << std::setw(14) << t.remove / 1000 << endl;
+  }
+}  // unnamed namespace
+
+//--------------------------------------------------------------------------------------//
+//                                      main                                            //
+//--------------------------------------------------------------------------------------//
+
+int cpp_main(int argc, char* argv[])
+{
+  if (argc != 3)
+  {
+    cout << "Usage: bulk_times <directories> <files-per-directory>\n";
+    return 1;
+  }
+
+  root = fs::temp_directory_path() / fs::unique_path("bulk_times-%%%%-%%%%");
+  fs::create_directory(root);
+  make_paths(std::atoi(argv[1]), std::atoi(argv[2]));
+  cout << dirs.size() << " directories, " << files.size() << " files\n"
+       << "io_uring is " << (fs::io_uring_available() ? "" : "not ")
+       << "available\n\n";
+
+  cout << std::left << std::setw(20) << "backend" << std::right
+       << std::setw(14) << "create (us)" << std::setw(14) << "status (us)"
+       << std::setw(14) << "remove (us)" << endl;
+
+  fs::bulk_options options;
+  options.use_io_uring = false;
+  report("thread pool", time_bulk(options));
+
+  const unsigned depths[] = { 1, 8, 32, 128, 512 };
+  options.use_io_uring = true;
+  for (std::size_t i = 0; i != sizeof(depths) / sizeof(depths[0]); ++i)
+  {
+    options.queue_depth = depths[i];
+    report("io_uring depth " + std::to_string(depths[i]), time_bulk(options));
+  }
+
+  fs::remove_all(root);
+  return 0;
+}
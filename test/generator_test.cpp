@@ -0,0 +1,283 @@
+//  filesystem generator_test.cpp  ---------------------------------------------------  //
+
+//  Copyright Boost.Filesystem contributors 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+#include <boost/config/warning_disable.hpp>
+
+#ifndef BOOST_FILESYSTEM_NO_DEPRECATED
+#  define BOOST_FILESYSTEM_NO_DEPRECATED
+#endif
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#  define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/generator.hpp>
+#include <boost/detail/lightweight_test.hpp>
+#include <boost/detail/lightweight_main.hpp>
+#include <iostream>
+
+namespace fs = boost::filesystem;
+using std::cout;
+using std::endl;
+
+#ifndef BOOST_FILESYSTEM_NO_COROUTINES
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+  fs::path dir;
+
+  //  dir/a/b/f, dir/a/g, dir/c
+  void make_tree()
+  {
+    fs::create_directories(dir / "a" / "b");
+    fs::save_string_file(dir / "a" / "b" / "f", "f");
+    fs::save_string_file(dir / "a" / "g", "g");
+    fs::create_directory(dir / "c");
+  }
+
+  std::string relative_name(const fs::directory_entry& e)
+  {
+    return e.path().lexically_relative(dir).generic_string();
+  }
+
+  struct skip_a
+  {
+    bool operator()(const fs::directory_entry& e) const
+    {
+      return e.path().filename() != "a";
+    }
+  };
+
+  void walk_tests()
+  {
+    cout << "walk_tests..." << endl;
+
+    std::vector<std::string> names;
+    for (const fs::directory_entry& e : fs::walk(dir))
+      names.push_back(relative_name(e));
+    BOOST_TEST_EQ(names.size(), 5U);
+    std::vector<std::string>::iterator a = std::find(names.begin(), names.end(), "a");
+    std::vector<std::string>::iterator b = std::find(names.begin(), names.end(), "a/b");
+    std::vector<std::string>::iterator f = std::find(names.begin(), names.end(), "a/b/f");
+    BOOST_TEST(a < b && b < f);  // parents before their contents
+    BOOST_TEST(std::find(names.begin(), names.end(), "a/g") != names.end());
+    BOOST_TEST(std::find(names.begin(), names.end(), "c") != names.end());
+
+    names.clear();
+    for (const fs::directory_entry& e : fs::walk(dir, skip_a()))
+      names.push_back(relative_name(e));
+    BOOST_TEST_EQ(names.size(), 2U);  // a and c
+
+    bool threw = false;
+    try { for (const fs::directory_entry& e : fs::walk(dir / "no-such-dir")) (void)e; }
+    catch (const fs::filesystem_error&) { threw = true; }
+    BOOST_TEST(threw);
+
+    //  an installed backend is walked through, not bypassed
+    fs::memory_backend memory;
+    fs::set_backend(&memory);
+    fs::create_directories("/m/x/y");
+    names.clear();
+    for (const fs::directory_entry& e : fs::walk("/m"))
+      names.push_back(e.path().generic_string());
+    fs::set_backend(0);
+    BOOST_TEST_EQ(names.size(), 2U);  // /m/x and /m/x/y
+  }
+
+  //  counts the allocations passed on to new and delete
+  class counting_resource : public std::pmr::memory_resource
+  {
+  public:
+    counting_resource() : allocations(0) {}
+    int allocations;
+
+  private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+    {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+      return this == &other;
+    }
+  };
+
+  void frame_arena_tests()
+  {
+    cout << "frame_arena_tests..." << endl;
+
+    counting_resource upstream;
+    fs::frame_arena arena(16 * 1024, &upstream);
+    BOOST_TEST_EQ(upstream.allocations, 1);  // the buffer
+    {
+      int count = 0;
+      std::size_t most_used = 0;
+      for (const fs::directory_entry& e : fs::walk(std::allocator_arg, &arena, dir))
+      {
+        (void)e;
+        ++count;
+        BOOST_TEST(arena.used() > 0);
+        most_used = std::max(most_used, arena.used());
+      }
+      BOOST_TEST_EQ(count, 5);
+      BOOST_TEST(most_used > 3 * 4 * 1024);  // each of 3 levels' read buffer too
+    }
+    BOOST_TEST_EQ(arena.used(), 0U);
+    BOOST_TEST_EQ(upstream.allocations, 1);  // every frame came from the arena
+
+    //  an arena too small for a frame passes the request upstream
+    fs::frame_arena tiny(8, &upstream);
+    int count = 0;
+    for (const fs::directory_entry& e : fs::walk(std::allocator_arg, &tiny, dir))
+      (void)e, ++count;
+    BOOST_TEST_EQ(count, 5);
+    BOOST_TEST(upstream.allocations > 2);
+    BOOST_TEST_EQ(tiny.used(), 0U);
+  }
+
+  fs::generator<int> count_to(int n)
+  {
+    for (int i = 1; i <= n; ++i)
+      co_yield i;
+  }
+
+  fs::generator<int> nested(bool fail)
+  {
+    co_yield 0;
+    co_yield fs::elements_of(count_to(2));
+    if (fail)
+      throw std::runtime_error("fail");
+    co_yield fs::elements_of(count_to(1));
+  }
+
+  fs::generator<int> failing_inner()
+  {
+    co_yield 1;
+    throw std::runtime_error("inner");
+  }
+
+  fs::generator<int> outer()
+  {
+    co_yield fs::elements_of(failing_inner());
+    co_yield 2;  // not reached
+  }
+
+  void generator_tests()
+  {
+    cout << "generator_tests..." << endl;
+
+    std::vector<int> v;
+    for (int i : nested(false))
+      v.push_back(i);
+    BOOST_TEST_EQ(v.size(), 4U);
+    BOOST_TEST(v == std::vector<int>({ 0, 1, 2, 1 }));
+
+    v.clear();
+    bool threw = false;
+    try { for (int i : nested(true)) v.push_back(i); }
+    catch (const std::runtime_error&) { threw = true; }
+    BOOST_TEST(threw);
+    BOOST_TEST_EQ(v.size(), 3U);
+
+    v.clear();
+    threw = false;
+    try { for (int i : outer()) v.push_back(i); }
+    catch (const std::runtime_error&) { threw = true; }  // through the parent
+    BOOST_TEST(threw);
+    BOOST_TEST_EQ(v.size(), 1U);
+  }
+
+  //  runs eagerly; the caller waits on a future for the result
+  struct task
+  {
+    struct promise_type
+    {
+      task get_return_object() { return task(); }
+      std::suspend_never initial_suspend() { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void() {}
+      void unhandled_exception() { std::terminate(); }
+    };
+  };
+
+  task count_entries(fs::async_generator<fs::directory_entry>& g,
+    std::promise<int>& result)
+  {
+    int n = 0;
+    try
+    {
+      while (co_await g.next())
+        ++n;
+    }
+    catch (const fs::filesystem_error&) { n = -1; }
+    result.set_value(n);
+  }
+
+  void async_walk_tests()
+  {
+    cout << "async_walk_tests..." << endl;
+
+    fs::thread_pool_executor pool(1);
+    {
+      fs::async_generator<fs::directory_entry> g(fs::async_walk(dir, pool));
+      std::promise<int> result;
+      count_entries(g, result);
+      BOOST_TEST_EQ(result.get_future().get(), 5);
+    }
+    {
+      fs::async_generator<fs::directory_entry> g(fs::async_walk(dir, pool, skip_a()));
+      std::promise<int> result;
+      count_entries(g, result);
+      BOOST_TEST_EQ(result.get_future().get(), 2);
+    }
+    {
+      fs::async_generator<fs::directory_entry>
+        g(fs::async_walk(dir / "no-such-dir", pool));
+      std::promise<int> result;
+      count_entries(g, result);
+      BOOST_TEST_EQ(result.get_future().get(), -1);
+    }
+  }
+}  // unnamed namespace
+
+int cpp_main(int, char*[])
+{
+  dir = fs::temp_directory_path() / fs::unique_path("generator_test-%%%%-%%%%-%%%%");
+  fs::create_directory(dir);
+  make_tree();
+
+  walk_tests();
+  frame_arena_tests();
+  generator_tests();
+  async_walk_tests();
+
+  fs::remove_all(dir);
+  return ::boost::report_errors();
+}
+
+#else
+
+int cpp_main(int, char*[])
+{
+  cout << "BOOST_FILESYSTEM_NO_COROUTINES is defined; nothing to test" << endl;
+  return ::boost::report_errors();
+}
+
+#endif
@@ -18,6 +18,13 @@
 #endif
 
 #include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/backend.hpp>
+#include <boost/filesystem/listing_cache.hpp>
+#include <boost/filesystem/directory_listing.hpp>
+#include <boost/filesystem/prefetcher.hpp>
+#include <boost/filesystem/string_file.hpp>
+#include <boost/filesystem/instrumentation.hpp>
+#include <boost/filesystem/tree_generator.hpp>
 
 #include <boost/config.hpp>
 # if defined( BOOST_NO_STD_WSTRING )
@@ -35,6 +42,7 @@ using boost::system::system_error;
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 using std::cout;
 using std::endl;
@@ -82,6 +90,8 @@ inline void unsetenv(const char* name)
 #else
 
 #include <stdlib.h>  // allow unqualifed calls to env funcs on SunOS
+#include <unistd.h>  // for chdir
+#include <sys/stat.h>  // for stat, to see the owner change_owner_all() sets
 
 #endif
 
@@ -219,6 +229,12 @@ namespace
     fs::remove(bad_remove_dir);
   }
 
+  void bad_list()
+  {
+    fs::listing_cache cache;
+    cache.list("no-such-path");
+  }
+
   class renamer
   {
   public:
@@ -656,6 +672,190 @@ namespace
     cout << "  recursive_directory_iterator_tests complete" << endl;
   }
 
+  //  directory_cursor_tests  ----------------------------------------------------------//
+
+  int count_entries(fs::directory_cursor& c, std::vector<fs::path>* paths = 0)
+  {
+    int count = 0;
+    for (; !c.at_end(); c.increment())
+    {
+      ++count;
+      if (paths)
+        paths->push_back(c.entry().path());
+    }
+    return count;
+  }
+
+  void directory_cursor_tests()
+  {
+    cout << "directory_cursor_tests..." << endl;
+
+    bool threw = false;
+    try { fs::directory_cursor c(""); }
+    catch (const fs::filesystem_error&) { threw = true; }
+    BOOST_TEST(threw);
+
+    error_code ec;
+    fs::directory_cursor c("nosuchdirectory", ec);
+    BOOST_TEST(ec);
+    BOOST_TEST(c.at_end());
+
+    //  the same entries as directory_iterator, including their cached status
+    std::vector<fs::path> expected, found;
+    for (fs::directory_iterator it(dir); it != fs::directory_iterator(); ++it)
+      expected.push_back(it->path());
+    c.open(dir, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(fs::is_directory(c.entry().status())
+      == fs::is_directory(c.entry().path()));
+    BOOST_TEST_EQ(count_entries(c, &found), static_cast<int>(expected.size()));
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    BOOST_TEST(found == expected);
+
+    //  reopened, and on another directory
+    c.open(dir);
+    BOOST_TEST_EQ(count_entries(c), static_cast<int>(expected.size()));
+    c.open(dir / "d1");
+    BOOST_TEST(!c.at_end());
+    BOOST_TEST(c.entry().path().parent_path() == dir / "d1");
+    //  the type, where reported, agrees with lstat
+    if (c.type() != fs::status_error)
+      BOOST_TEST_EQ(c.type(), fs::symlink_status(c.entry().path()).type());
+#   ifdef BOOST_POSIX_API
+    BOOST_TEST(c.inode() != 0U);
+#   endif
+    c.close();
+    BOOST_TEST(c.at_end());
+    fs::create_directory(dir / "empty");
+    c.open(dir / "empty");
+    BOOST_TEST(c.at_end());
+    fs::remove(dir / "empty");
+
+    //  a caller's buffer smaller than the directory needs several reads
+    boost::uint64_t buffer[64];
+    fs::directory_cursor small(buffer, sizeof(buffer));
+    small.open(dir);
+    BOOST_TEST_EQ(count_entries(small), static_cast<int>(expected.size()));
+
+#   if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    fs::directory_cursor first(dir);
+    fs::directory_cursor second(std::move(first));
+    BOOST_TEST(first.at_end());
+    BOOST_TEST_EQ(count_entries(second), static_cast<int>(expected.size()));
+    first = std::move(small);
+    first.open(dir);
+    BOOST_TEST(!first.at_end());
+#   endif
+
+    //  recursive_directory_cursor, against recursive_directory_iterator
+    int iterator_count = 0;
+    for (fs::recursive_directory_iterator it(dir);
+      it != fs::recursive_directory_iterator(); ++it)
+      ++iterator_count;
+    int count = 0, d1f1_count = 0;
+    for (fs::recursive_directory_cursor rc(dir); !rc.at_end(); rc.increment(ec))
+    {
+      BOOST_TEST(!ec);
+      ++count;
+      if (rc.entry().path().filename() == "d1f1")
+      {
+        ++d1f1_count;
+        BOOST_TEST_EQ(rc.depth(), 1);
+      }
+    }
+    BOOST_TEST_EQ(count, iterator_count);
+    BOOST_TEST_EQ(d1f1_count, 1);
+    if (create_symlink_ok)
+    {
+      d1f1_count = 0;
+      for (fs::recursive_directory_cursor rc(dir, fs::symlink_option::recurse);
+        !rc.at_end(); rc.increment(ec))  // dangling symlinks report errors
+        if (rc.entry().path().filename() == "d1f1")
+          ++d1f1_count;
+      BOOST_TEST(d1f1_count > 1);
+    }
+
+    //  recursing into nothing leaves just the top level
+    count = 0;
+    for (fs::recursive_directory_cursor rc(dir); !rc.at_end(); rc.increment())
+    {
+      rc.disable_recursion_pending();
+      BOOST_TEST(!rc.recursion_pending());
+      ++count;
+    }
+    BOOST_TEST_EQ(count, static_cast<int>(expected.size()));
+
+    //  pop() leaves the rest of d1
+    int d1_count = 0;
+    for (fs::recursive_directory_iterator it(dir / "d1");
+      it != fs::recursive_directory_iterator(); ++it)
+      ++d1_count;
+    count = 0;
+    fs::recursive_directory_cursor rc(dir);
+    while (!rc.at_end())
+    {
+      ++count;
+      if (rc.entry().path().parent_path() == dir / "d1")
+        rc.pop();
+      else
+        rc.increment();
+    }
+    BOOST_TEST_EQ(count, iterator_count - d1_count + 1);
+    rc.open(dir / "d1");  // reopened
+    BOOST_TEST(!rc.at_end());
+    BOOST_TEST_EQ(rc.depth(), 0);
+
+    //  suspended and resumed part way, with a buffer that needs several reads
+    found.clear();
+    small.open(dir);
+    for (int i = 0; !small.at_end(); small.increment(), ++i)
+    {
+      found.push_back(small.entry().path());
+      if (i % 3 == 0)
+      {
+        small.suspend();
+        BOOST_TEST(small.suspended());
+        BOOST_TEST(small.entry().path() == found.back());
+      }
+    }
+    std::sort(found.begin(), found.end());
+    BOOST_TEST(found == expected);
+
+    //  a tree deeper than max_open, with entries left at each level to resume to, and
+    //  deep enough that the cursor's levels outgrow their first block
+    fs::path deep(dir / "deep");
+    for (int i = 0; i < 20; ++i, deep /= "d")
+    {
+      fs::create_directories(deep);
+      create_file(deep / "a");
+      create_file(deep / "b");
+    }
+    std::vector<fs::path> deep_expected;
+    for (fs::recursive_directory_iterator it(dir / "deep");
+      it != fs::recursive_directory_iterator(); ++it)
+      deep_expected.push_back(it->path());
+    std::sort(deep_expected.begin(), deep_expected.end());
+    for (std::size_t n = 1; n <= 4; n += 3)
+    {
+      found.clear();
+      int max_depth = 0;
+      rc.max_open(n);
+      BOOST_TEST_EQ(rc.max_open(), n);
+      for (rc.open(dir / "deep"); !rc.at_end(); rc.increment())
+      {
+        found.push_back(rc.entry().path());
+        max_depth = (std::max)(max_depth, rc.depth());
+      }
+      BOOST_TEST_EQ(max_depth, 19);
+      std::sort(found.begin(), found.end());
+      BOOST_TEST(found == deep_expected);
+    }
+    fs::remove_all(dir / "deep");
+
+    cout << "  directory_cursor_tests complete" << endl;
+  }
+
   //  iterator_status_tests  -----------------------------------------------------------//
 
   void iterator_status_tests()
@@ -896,6 +1096,83 @@ namespace
       BOOST_TEST(fs::status(p).permissions() == 0666);
     }
   }
+
+  //  permissions_all_tests  -----------------------------------------------------------//
+
+  void permissions_all_tests()
+  {
+    cout << "permissions_all_tests..." << endl;
+
+    fs::path root(dir / "permissions_all");
+    fs::create_directories(root / "sub");
+    create_file(root / "a.txt");
+    create_file(root / "sub" / "b.txt");
+
+    error_code ec;
+    BOOST_TEST(fs::permissions_all(dir / "no-such-file", fs::owner_all, ec) == 0);
+    BOOST_TEST(ec);
+    BOOST_TEST(fs::change_owner_all(root, fs::unchanged_owner, fs::unchanged_owner) == 0);
+
+    if (platform == "POSIX")
+    {
+      BOOST_TEST_EQ(fs::permissions_all(root, fs::owner_all), 4U);
+      BOOST_TEST_EQ(fs::permissions_all(root, fs::owner_all), 0U);  // already so
+      BOOST_TEST(fs::status(root / "sub" / "b.txt").permissions() == fs::owner_all);
+
+      //  removing read and search from the directories must not stop the traversal
+      BOOST_TEST_EQ(fs::permissions_all(root, fs::remove_perms | fs::owner_read
+        | fs::owner_exe), 4U);
+      BOOST_TEST(fs::status(root).permissions() == fs::owner_write);
+      BOOST_TEST_EQ(fs::permissions_all(root, fs::add_perms | fs::owner_read
+        | fs::owner_exe), 4U);
+      BOOST_TEST(fs::status(root / "sub" / "b.txt").permissions() == fs::owner_all);
+      BOOST_TEST(fs::status(root / "sub").permissions() == fs::owner_all);
+
+      if (create_symlink_ok)  // a symlink is not followed, and has no mode to change
+      {
+        fs::create_symlink(dir / "permissions.txt", root / "link");
+        fs::perms target = fs::status(dir / "permissions.txt").permissions();
+        BOOST_TEST_EQ(fs::permissions_all(root, fs::add_perms | fs::group_read), 4U);
+        BOOST_TEST(fs::status(dir / "permissions.txt").permissions() == target);
+
+        //  but a symlink root is followed, as by permissions()
+        fs::create_directory_symlink(root, dir / "permissions_all_link");
+        BOOST_TEST_EQ(fs::permissions_all(dir / "permissions_all_link",
+          fs::remove_perms | fs::group_read), 4U);
+        BOOST_TEST(fs::status(root / "sub" / "b.txt").permissions() == fs::owner_all);
+        fs::remove(dir / "permissions_all_link");
+      }
+
+#     ifndef BOOST_WINDOWS_API
+      //  changing the owner takes privilege
+      if (::geteuid() == 0)
+      {
+        struct stat st;
+        BOOST_TEST_EQ(::stat(root.c_str(), &st), 0);
+        fs::owner_id user = st.st_uid, group = st.st_gid;
+        BOOST_TEST(fs::change_owner_all(root, 1, 1) >= 4U);
+        BOOST_TEST(::stat((root / "sub" / "b.txt").c_str(), &st) == 0
+          && st.st_uid == 1 && st.st_gid == 1);
+        BOOST_TEST_EQ(fs::change_owner_all(root, 1, fs::unchanged_owner), 0U);
+        BOOST_TEST(fs::change_owner_all(root, user, group) >= 4U);
+        BOOST_TEST(::stat((root / "sub" / "b.txt").c_str(), &st) == 0
+          && st.st_uid == user && st.st_gid == group);
+      }
+      else
+        cout << "  change_owner_all not tested: not running as root" << endl;
+#     endif
+    }
+    else // Windows
+    {
+      BOOST_TEST_EQ(fs::permissions_all(root, fs::remove_perms | fs::owner_write
+        | fs::group_write | fs::others_write), 4U);
+      BOOST_TEST(fs::status(root / "sub" / "b.txt").permissions() == 0444);
+      BOOST_TEST_EQ(fs::permissions_all(root, fs::add_perms | fs::owner_write), 4U);
+      BOOST_TEST(fs::status(root / "sub" / "b.txt").permissions() == 0666);
+      BOOST_TEST(fs::change_owner_all(root, 0, 0, ec) == 0);
+      BOOST_TEST(ec);
+    }
+  }
   
   //  rename_tests  --------------------------------------------------------------------//
 
@@ -1000,8 +1277,975 @@ namespace
     BOOST_TEST(fs::exists(d1));
     BOOST_TEST(!fs::exists(d2 / "d20"));
     BOOST_TEST(fs::exists(d1 / "f2"));
+
+    // error: rename_option::no_replace an existing file to an existent file
+    error_code ec;
+    create_file(dir / "fr1", "fr1");
+    create_file(dir / "fr2", "fr2");
+    fs::rename(dir / "fr1", dir / "fr2", fs::rename_option::no_replace, ec);
+    BOOST_TEST(ec);
+    verify_file(dir / "fr1", "fr1");
+    verify_file(dir / "fr2", "fr2");
+
+    // error: rename_option::no_replace an existing directory to an empty directory
+    fs::create_directory(dir / "dr1");
+    fs::create_directory(dir / "dr2");
+    fs::rename(dir / "dr1", dir / "dr2", fs::rename_option::no_replace, ec);
+    BOOST_TEST(ec);
+    BOOST_TEST(fs::exists(dir / "dr1"));
+    fs::remove(dir / "dr1");
+    fs::remove(dir / "dr2");
+
+    // rename_option::no_replace an existing file to a nonexistent file
+    fs::rename(dir / "fr1", dir / "fr3", fs::rename_option::no_replace);
+    BOOST_TEST(!fs::exists(dir / "fr1"));
+    verify_file(dir / "fr3", "fr1");
+
+    // rename_option::exchange two existing files, if supported
+    fs::rename(dir / "fr2", dir / "fr3", fs::rename_option::exchange, ec);
+    if (!ec)
+    {
+      verify_file(dir / "fr2", "fr1");
+      verify_file(dir / "fr3", "fr2");
+    }
+    else
+      cout << "  rename_option::exchange not supported: " << ec.message() << endl;
+    fs::remove(dir / "fr2");
+    fs::remove(dir / "fr3");
   }
   
+  //  move_tests  ----------------------------------------------------------------------//
+
+  bool count_move_progress(const fs::move_progress&, void* context)
+  {
+    ++*static_cast<int*>(context);
+    return true;
+  }
+
+  void move_tests()
+  {
+    cout << "move_tests..." << endl;
+
+    // error: move a non-existent file
+    error_code ec;
+    BOOST_TEST(!fs::exists(d1 / "f99"));
+    fs::move(d1 / "f99", d1 / "f98", ec);
+    BOOST_TEST(ec);
+    BOOST_TEST(!fs::exists(d1 / "f98"));
+
+    // move an existing file within a directory; no copy is needed
+    create_file(d1 / "m1", "file-m1");
+    fs::move(d1 / "m1", d1 / "m2", fs::move_option::no_copy);
+    BOOST_TEST(!fs::exists(d1 / "m1"));
+    verify_file(d1 / "m2", "file-m1");
+    fs::remove(d1 / "m2");
+
+    // move a tree to the temporary directory, which may be on another device. If so,
+    // the tree is copied, the progress handler called, and then the source removed.
+    fs::path src(dir / "move-src");
+    fs::create_directories(src / "d10" / "d11");
+    create_file(src / "d10" / "f10", "file-f10");
+    create_file(src / "d10" / "d11" / "f11", "file-f11");
+    fs::path dst(fs::temp_directory_path() / fs::unique_path("move-test-%%%%-%%%%"));
+    int calls = 0;
+    fs::move(src, dst, fs::move_option::none, count_move_progress, &calls);
+    BOOST_TEST(!fs::exists(src));
+    BOOST_TEST(fs::is_directory(dst / "d10" / "d11"));
+    verify_file(dst / "d10" / "f10", "file-f10");
+    verify_file(dst / "d10" / "d11" / "f11", "file-f11");
+
+    // and back again, copying on one thread if a copy is needed
+    fs::move(dst, src, fs::move_option::single_thread, count_move_progress, &calls, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(!fs::exists(dst));
+    verify_file(src / "d10" / "d11" / "f11", "file-f11");
+    cout << "  progress handler calls: " << calls << endl;
+
+    BOOST_TEST(fs::remove_all(src) == 5);
+
+    // always_copy takes the copy and remove path taken across devices
+    create_file(d1 / "m3", "file-m3");
+    fs::move(d1 / "m3", d1 / "m4", fs::move_option::always_copy);
+    BOOST_TEST(!fs::exists(d1 / "m3"));
+    verify_file(d1 / "m4", "file-m3");
+
+    // a target matching the source in size and modification time but not contents
+    // was not copied by an interrupted move, so it is replaced
+    create_file(d1 / "m3", "file-m3");
+    create_file(d1 / "m4", "FILE-M3");
+    fs::last_write_time(d1 / "m4", fs::last_write_time(d1 / "m3"));
+    BOOST_TEST_EQ(fs::file_size(d1 / "m4"), fs::file_size(d1 / "m3"));
+    fs::move(d1 / "m3", d1 / "m4", fs::move_option::always_copy);
+    BOOST_TEST(!fs::exists(d1 / "m3"));
+    verify_file(d1 / "m4", "file-m3");
+
+    // one that matches in contents too is kept when resuming an interrupted move
+    create_file(d1 / "m3", "file-m3");
+    fs::last_write_time(d1 / "m4", fs::last_write_time(d1 / "m3"));
+    fs::move(d1 / "m3", d1 / "m4",
+      fs::move_option::always_copy | fs::move_option::resume);
+    BOOST_TEST(!fs::exists(d1 / "m3"));
+    verify_file(d1 / "m4", "file-m3");
+
+    // a tree is not merged into a directory that is not empty, as rename() would not,
+    // but goes into an empty one
+    fs::path tree(d1 / "mt-src"), target(d1 / "mt-dst");
+    fs::create_directories(tree / "sub");
+    create_file(tree / "sub" / "f", "new");
+    fs::create_directories(target / "sub");
+    create_file(target / "sub" / "f", "unrelated");
+    fs::move(tree, target, fs::move_option::always_copy, 0, 0, ec);
+    BOOST_TEST(ec);
+    verify_file(tree / "sub" / "f", "new");
+    verify_file(target / "sub" / "f", "unrelated");
+    fs::move(tree, d1 / "m4", fs::move_option::always_copy, 0, 0, ec);  // onto a file
+    BOOST_TEST(ec);
+    BOOST_TEST(fs::exists(tree));
+    fs::remove_all(target);
+    fs::create_directory(target);
+    fs::move(tree, target, fs::move_option::always_copy);
+    BOOST_TEST(!fs::exists(tree));
+    verify_file(target / "sub" / "f", "new");
+
+    // resume completes an interrupted move into its own partial target
+    fs::create_directories(tree / "sub");
+    create_file(tree / "sub" / "f", "new");
+    create_file(tree / "sub" / "g", "new-g");
+    fs::remove(target / "sub" / "f");
+    fs::move(tree, target, fs::move_option::always_copy | fs::move_option::resume);
+    BOOST_TEST(!fs::exists(tree));
+    verify_file(target / "sub" / "f", "new");
+    verify_file(target / "sub" / "g", "new-g");
+    fs::remove_all(target);
+
+    // a symlink target pointing elsewhere is replaced, whether resuming or not
+    if (create_symlink_ok)
+    {
+      fs::create_directory(tree);
+      fs::create_symlink("a", tree / "l");
+      fs::create_directory(target);
+      fs::create_symlink("b", target / "l");
+      fs::move(tree, target, fs::move_option::always_copy | fs::move_option::resume);
+      BOOST_TEST(fs::read_symlink(target / "l") == "a");
+      fs::create_symlink("c", d1 / "ml1");
+      fs::move(target / "l", d1 / "ml1", fs::move_option::always_copy);
+      BOOST_TEST(fs::read_symlink(d1 / "ml1") == "a");
+      BOOST_TEST(!fs::exists(fs::symlink_status(target / "l")));
+      fs::remove(d1 / "ml1");
+      fs::remove_all(target);
+    }
+
+    // no_copy forbids the copy always_copy asks for
+    create_file(d1 / "m3", "file-m3");
+    fs::move(d1 / "m3", d1 / "m5",
+      fs::move_option::always_copy | fs::move_option::no_copy, 0, 0, ec);
+    BOOST_TEST(ec);
+    BOOST_TEST(fs::exists(d1 / "m3"));
+    fs::remove(d1 / "m3");
+    fs::remove(d1 / "m4");
+  }
+
+  //  bulk_tests  ----------------------------------------------------------------------//
+
+  //  Runs with use_io_uring true and false, so both ways are exercised where the
+  //  library was built with BOOST_FILESYSTEM_USE_IO_URING.
+  void bulk_tests(bool use_io_uring)
+  {
+    cout << "bulk_tests(" << use_io_uring << ")..." << endl;
+
+    fs::bulk_options options;
+    options.use_io_uring = use_io_uring;
+    options.queue_depth = 4;  // fewer than the paths, so the queue is refilled
+    options.threads = 2;
+
+    fs::path root(dir / "bulk");
+    std::vector<fs::path> dirs;
+    for (int i = 0; i < 6; ++i)
+      dirs.push_back(root / "x" / fs::path(std::string(1, char('a' + i))) / "y");
+    dirs.push_back(root / "x" / "a" / "y");  // a duplicate is created once
+    BOOST_TEST_EQ(fs::bulk_create_directories(dirs, options), 6U);
+    BOOST_TEST_EQ(fs::bulk_create_directories(dirs, options), 0U);  // already exist
+    BOOST_TEST(fs::is_directory(root / "x" / "f" / "y"));
+
+    std::vector<fs::path> from, to;
+    for (int i = 0; i < 6; ++i)
+    {
+      from.push_back(dirs[i] / "f");
+      to.push_back(dirs[i] / "g");
+      create_file(from.back(), "file-f");
+    }
+    fs::bulk_copy_file(from, to, fs::copy_option::fail_if_exists, options);
+    verify_file(to[5], "file-f");
+    error_code ec;
+    fs::bulk_copy_file(from, to, fs::copy_option::fail_if_exists, options, ec);
+    BOOST_TEST(ec);
+
+    std::vector<fs::path> paths(from);
+    paths.push_back(root / "no-such-file");
+    paths.push_back(root / "x");
+    std::vector<fs::file_status> st = fs::bulk_status(paths, options);
+    BOOST_TEST_EQ(st.size(), paths.size());
+    BOOST_TEST(fs::is_regular_file(st[0]));
+    BOOST_TEST(st[6].type() == fs::file_not_found);
+    BOOST_TEST(fs::is_directory(st[7]));
+
+    dirs.assign(1, from[0]);  // a file is not a directory
+    BOOST_TEST_EQ(fs::bulk_create_directories(dirs, options, ec), 0U);
+    BOOST_TEST(ec);
+
+    //  x/?, each with a y directory holding files f and g
+    paths.clear();
+    for (int i = 0; i < 6; ++i)
+      paths.push_back(root / "x" / fs::path(std::string(1, char('a' + i))));
+    paths.push_back(root / "no-such-file");
+    BOOST_TEST_EQ(fs::bulk_remove_all(paths, options), 24U);
+    BOOST_TEST(fs::is_empty(root / "x"));
+    fs::remove_all(root);
+  }
+
+  //  generate_tree_tests  -------------------------------------------------------------//
+
+  //  relative path, type and size of each entry, sorted
+  std::vector<std::string> tree_listing(const fs::path& root)
+  {
+    std::vector<std::string> listing;
+    for (fs::recursive_directory_iterator it(root);
+      it != fs::recursive_directory_iterator(); ++it)
+    {
+      fs::file_status s = it->symlink_status();
+      std::ostringstream entry;
+      entry << it->path().lexically_relative(root).generic_string() << ' ' << s.type();
+      if (fs::is_regular_file(s))
+        entry << ' ' << fs::file_size(it->path());
+      listing.push_back(entry.str());
+    }
+    std::sort(listing.begin(), listing.end());
+    return listing;
+  }
+
+  void generate_tree_tests()
+  {
+    cout << "generate_tree_tests..." << endl;
+
+    fs::tree_profile profile;
+    profile.fanout = 2;
+    profile.depth = 2;
+    profile.files_per_directory = 5;
+    profile.max_file_size = 100000;
+    profile.sizes = fs::tree_profile::log_uniform;
+    profile.symlink_ratio = create_symlink_ok ? 0.5 : 0.0;
+    profile.sparse_ratio = 0.5;
+
+    fs::path root(dir / "generated");
+    fs::tree_stats stats = fs::generate_tree(root, profile, 42);
+    BOOST_TEST_EQ(stats.directories, 7U);  // the root, 2 and 4
+    BOOST_TEST_EQ(stats.files + stats.symlinks, 35U);
+    BOOST_TEST(stats.files >= 7U);  // each directory's first
+    BOOST_TEST(!create_symlink_ok || stats.symlinks > 0U);
+    BOOST_TEST(stats.sparse_files > 0U);
+
+    std::vector<std::string> listing(tree_listing(root));
+    BOOST_TEST_EQ(listing.size(), 6U + 35U);
+    boost::uintmax_t bytes = 0;
+    for (fs::recursive_directory_iterator it(root);
+      it != fs::recursive_directory_iterator(); ++it)
+      if (fs::is_regular_file(it->symlink_status()))
+        bytes += fs::file_size(it->path());
+    BOOST_TEST_EQ(bytes, stats.bytes);
+
+    //  the same tree again from the same seed, and another from a different seed
+    fs::path again(dir / "generated-again");
+    fs::generate_tree(again, profile, 42);
+    BOOST_TEST(tree_listing(again) == listing);
+    fs::remove_all(again);
+    fs::generate_tree(again, profile, 43);
+    BOOST_TEST(tree_listing(again) != listing);
+    fs::remove_all(again);
+
+    //  uniform sizes within the bounds
+    profile.sizes = fs::tree_profile::uniform;
+    profile.min_file_size = 10;
+    profile.max_file_size = 20;
+    profile.sparse_ratio = 0.0;
+    stats = fs::generate_tree(again, profile, 1);
+    BOOST_TEST(stats.bytes >= stats.files * 10 && stats.bytes <= stats.files * 20);
+    BOOST_TEST_EQ(stats.sparse_files, 0U);
+    fs::remove_all(again);
+
+    error_code ec;
+    fs::generate_tree(root / "f0", profile, 1, ec);  // f0 is a file
+    BOOST_TEST(ec);
+    bool threw = false;
+    try { fs::generate_tree(root / "f0", profile, 1); }
+    catch (const fs::filesystem_error&) { threw = true; }
+    BOOST_TEST(threw);
+
+    BOOST_TEST_EQ(fs::remove_all(root), listing.size() + 1);
+    cout << "  generate_tree_tests complete" << endl;
+  }
+
+  //  backend_tests  -------------------------------------------------------------------//
+
+  void backend_tests()
+  {
+    cout << "backend_tests..." << endl;
+    namespace errc = boost::system::errc;
+    BOOST_TEST(&fs::current_backend() == &fs::native_backend());
+
+    fs::memory_backend memory;
+    BOOST_TEST(fs::set_backend(&memory) == &fs::native_backend());
+    BOOST_TEST(&fs::current_backend() == &memory);
+    BOOST_TEST(!fs::exists(dir));  // not in memory
+
+    error_code ec;
+    BOOST_TEST(fs::create_directories("/m/a/b"));
+    BOOST_TEST(fs::is_directory("/m/a/b"));
+    BOOST_TEST(fs::is_directory("m/a/b/../b"));
+    memory.write_file("/m/a/f", "hello", ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(fs::file_size("/m/a/f"), 5U);
+    fs::resize_file("/m/a/f", 1000000000);  // held sparsely
+    BOOST_TEST_EQ(fs::file_size("/m/a/f"), 1000000000U);
+    fs::resize_file("/m/a/f", 2);
+    BOOST_TEST_EQ(memory.read_file("/m/a/f", ec), "he");
+    fs::copy_file("/m/a/f", "/m/a/g");
+    BOOST_TEST_EQ(memory.read_file("/m/a/g", ec), "he");
+    fs::copy_file("/m/a/f", "/m/a/g", ec);
+    BOOST_TEST(ec == errc::file_exists);
+    fs::last_write_time("/m/a/f", 12345);
+    BOOST_TEST_EQ(fs::last_write_time("/m/a/f"), 12345);
+    fs::create_symlink("a/f", "/m/l");
+    BOOST_TEST(fs::is_symlink(fs::symlink_status("/m/l")));
+    BOOST_TEST(fs::is_regular_file("/m/l"));
+    BOOST_TEST_EQ(fs::read_symlink("/m/l"), fs::path("a/f"));
+    fs::create_directory_symlink("a/b", "/m/ld");
+    BOOST_TEST(fs::is_directory("/m/ld"));
+    BOOST_TEST(fs::remove("/m/ld"));
+
+    //  operations with no backend form do not reach the native file system
+    fs::permissions("/m/a/f", fs::owner_read, ec);
+    BOOST_TEST(ec == errc::operation_not_supported);
+    fs::create_hard_link("/m/a/f", "/m/a/h", ec);
+    BOOST_TEST(ec == errc::operation_not_supported);
+    fs::preallocate("/m/a/f", 0, 10, fs::preallocate_option::none, ec);
+    BOOST_TEST(ec == errc::operation_not_supported);
+    BOOST_TEST(!fs::exists("/m/a/h"));
+    fs::equivalent("/m/a/f", "/m/a/g", ec);
+    BOOST_TEST(ec == errc::operation_not_supported);
+    fs::hard_link_count("/m/a/f", ec);
+    BOOST_TEST(ec == errc::operation_not_supported);
+    BOOST_TEST_EQ(fs::space("/m", ec).capacity, 0U);
+    BOOST_TEST(ec == errc::operation_not_supported);
+    fs::prefetch("/m/a/f", 0, 0, ec);
+    BOOST_TEST(ec == errc::operation_not_supported);
+    BOOST_TEST(fs::directory_cursor("/m/a", ec).at_end());
+    BOOST_TEST(ec == errc::operation_not_supported);
+    BOOST_TEST(fs::extent_iterator("/m/a/f", ec) == fs::extent_iterator());
+    BOOST_TEST(ec == errc::operation_not_supported);
+
+    //  whereas is_empty() lists and sizes through the backend
+    BOOST_TEST(!fs::is_empty("/m/a"));
+    BOOST_TEST(fs::is_empty("/m/a/b"));
+    BOOST_TEST(!fs::is_empty("/m/a/f"));
+    BOOST_TEST(!fs::is_empty("/m/none", ec));
+    BOOST_TEST(ec == errc::no_such_file_or_directory);
+
+    //  iteration, in name order
+    std::vector<std::string> names;
+    for (fs::directory_iterator it("/m/a"); it != fs::directory_iterator(); ++it)
+      names.push_back(it->path().filename().string());
+    BOOST_TEST_EQ(names.size(), 3U);
+    BOOST_TEST(names.size() == 3
+      && names[0] == "b" && names[1] == "f" && names[2] == "g");
+    BOOST_TEST(fs::directory_iterator("/m/a/b") == fs::directory_iterator());
+    std::size_t count = 0;
+    for (fs::recursive_directory_iterator it("/m");
+      it != fs::recursive_directory_iterator(); ++it)
+      ++count;
+    BOOST_TEST_EQ(count, 5U);
+    fs::directory_iterator("/m/a/f", ec);
+    BOOST_TEST(ec == errc::not_a_directory);
+
+    //  renames and errors
+    fs::rename("/m/a", "/m/c");
+    BOOST_TEST(!fs::exists("/m/a"));
+    BOOST_TEST(fs::exists("/m/c/f"));
+    BOOST_TEST(!fs::exists("/m/l"));  // now dangling
+    fs::rename("/m/c", "/m/c/b/x", ec);
+    BOOST_TEST(ec == errc::invalid_argument);
+    fs::rename("/m/c/f", "/m/c/g", fs::rename_option::no_replace, ec);
+    BOOST_TEST(ec == errc::file_exists);
+    fs::move("/m/c/f", "/m/c/h");
+    BOOST_TEST(fs::exists("/m/c/h"));
+    BOOST_TEST(!fs::create_directory("/m/c"));
+    fs::create_directory("/m/c/h", ec);
+    BOOST_TEST(ec == errc::file_exists);
+    BOOST_TEST(!fs::remove("/m/none"));
+    fs::remove("/m/c", ec);
+    BOOST_TEST(ec == errc::directory_not_empty);
+    bool threw = false;
+    try { fs::file_size("/m/none"); }
+    catch (const fs::filesystem_error& ex)
+    {
+      threw = ex.code() == errc::no_such_file_or_directory && ex.path1() == "/m/none";
+    }
+    BOOST_TEST(threw);
+    BOOST_TEST_EQ(fs::remove_all("/m"), 6U);
+    BOOST_TEST(!fs::exists("/m"));
+
+    //  latency_backend forwards each call after its delay
+    fs::latency_backend slow(memory, 600000);
+    BOOST_TEST(fs::set_backend(&slow) == &memory);
+    BOOST_TEST(!slow.native());
+    BOOST_TEST(fs::latency_backend(fs::native_backend(), 0).native());
+    std::time_t start = std::time(0);
+    BOOST_TEST(fs::create_directory("/s"));
+    BOOST_TEST(fs::is_directory("/s"));
+    BOOST_TEST(std::time(0) - start >= 1);
+    error_code memory_ec;
+    BOOST_TEST(fs::is_directory(memory.status("/s", memory_ec)));
+
+    BOOST_TEST(fs::set_backend(0) == &slow);
+    BOOST_TEST(&fs::current_backend() == &fs::native_backend());
+    BOOST_TEST(fs::exists(dir));
+    cout << "  backend_tests complete" << endl;
+  }
+
+  //  caching_backend_tests  -----------------------------------------------------------//
+
+  void sleep_ms(unsigned ms)
+  {
+#   ifdef BOOST_WINDOWS_API
+    ::Sleep(ms);
+#   else
+    ::usleep(ms * 1000);
+#   endif
+  }
+
+  void caching_backend_tests()
+  {
+    cout << "caching_backend_tests..." << endl;
+
+    fs::memory_backend memory;
+    fs::caching_backend cache(memory, 60000, 64, 4);
+    fs::set_backend(&cache);
+    error_code ec;
+    fs::create_directory("/c");
+    memory.write_file("/c/f", "abc", ec);
+    cache.reset_statistics();
+    BOOST_TEST_EQ(fs::file_size("/c/f"), 3U);
+    BOOST_TEST_EQ(fs::file_size("/c/f"), 3U);
+    BOOST_TEST(!fs::exists("/c/g"));
+    BOOST_TEST(!fs::exists("/c/g"));  // not found is cached too
+    fs::cache_statistics stats = cache.statistics();
+    BOOST_TEST_EQ(stats.hits, 2U);
+    BOOST_TEST_EQ(stats.misses, 2U);
+    BOOST_TEST_EQ(stats.hit_rate(), 0.5);
+    BOOST_TEST_EQ(stats.entries, 2U);
+
+    //  a change behind the cache's back is seen once invalidated
+    memory.write_file("/c/f", "abcdef", ec);
+    BOOST_TEST_EQ(fs::file_size("/c/f"), 3U);
+    cache.invalidate("/c/f");
+    BOOST_TEST_EQ(fs::file_size("/c/f"), 6U);
+
+    //  changes through the operations invalidate what they touch
+    fs::resize_file("/c/f", 10);
+    BOOST_TEST_EQ(fs::file_size("/c/f"), 10U);
+    fs::copy_file("/c/f", "/c/g");
+    BOOST_TEST(fs::exists("/c/g"));
+    fs::rename("/c", "/d");
+    BOOST_TEST(!fs::exists("/c/f"));
+    BOOST_TEST(fs::exists("/d/f"));
+    fs::remove("/d/g");
+    BOOST_TEST(!fs::exists("/d/g"));
+    BOOST_TEST(cache.statistics().invalidations > 0U);
+
+    //  a full shard makes room
+    for (int i = 0; i < 200; ++i)
+    {
+      std::ostringstream name;
+      name << "/d/" << i;
+      fs::exists(name.str());
+    }
+    stats = cache.statistics();
+    BOOST_TEST(stats.entries <= 64U);
+    BOOST_TEST(stats.evictions > 0U);
+    cache.clear();
+    BOOST_TEST_EQ(cache.statistics().entries, 0U);
+
+    //  entries expire
+    fs::caching_backend brief(memory, 1);
+    fs::set_backend(&brief);
+    BOOST_TEST_EQ(fs::file_size("/d/f"), 10U);
+    memory.write_file("/d/f", "x", ec);
+    sleep_ms(20);
+    BOOST_TEST_EQ(fs::file_size("/d/f"), 1U);
+    BOOST_TEST(brief.statistics().expirations > 0U);
+
+    //  over the native file system, permissions() invalidates as it has no backend form
+    fs::caching_backend native_cache(fs::native_backend(), 60000);
+    fs::set_backend(&native_cache);
+    fs::path file(dir / "cached_file");
+    create_file(file, "x");
+    fs::permissions(file, fs::owner_read | fs::owner_write);
+    BOOST_TEST_EQ(fs::status(file).permissions(), fs::owner_read | fs::owner_write);
+    fs::permissions(file, fs::owner_read);
+    BOOST_TEST_EQ(fs::status(file).permissions(), fs::owner_read);
+    fs::permissions(file, fs::owner_read | fs::owner_write);
+
+    //  so do create_directory_symlink() and create_hard_link()
+    if (create_symlink_ok)
+    {
+      fs::path link(dir / "cached_link");
+      BOOST_TEST(!fs::exists(link));
+      fs::create_directory_symlink(dir, link);
+      BOOST_TEST(fs::is_directory(link));
+      fs::remove(link);
+    }
+    fs::path hard(dir / "cached_hard_link");
+    BOOST_TEST(!fs::exists(hard));
+    error_code link_ec;
+    fs::create_hard_link(file, hard, link_ec);
+    if (!link_ec)
+    {
+      BOOST_TEST(fs::exists(hard));
+      fs::remove(hard);
+    }
+
+    //  and move() copies as across devices, invalidating what it copied and removed
+    fs::path moved(dir / "cached_moved");
+    BOOST_TEST(native_cache.native());
+    BOOST_TEST(!fs::exists(moved));
+    fs::move(file, moved, fs::move_option::always_copy);
+    BOOST_TEST(!fs::exists(file));
+    BOOST_TEST(fs::exists(moved));
+    verify_file(moved, "x");
+    fs::remove(moved);
+    BOOST_TEST(!fs::exists(moved));
+
+    fs::set_backend(0);
+    cout << "  caching_backend_tests complete" << endl;
+  }
+
+  //  listing_cache_tests  -------------------------------------------------------------//
+
+  void listing_cache_tests()
+  {
+    cout << "listing_cache_tests..." << endl;
+
+    fs::path d(dir / "listed");
+    fs::create_directory(d);
+    create_file(d / "f", "abc");
+    fs::create_directory(d / "sub");
+    //  a directory written this second is read again by each list(), so age it
+    std::time_t old_time = std::time(0) - 3600;
+    fs::last_write_time(d, old_time);
+
+    fs::listing_cache cache(2, 1);
+    fs::directory_snapshot_ptr first = cache.list(d);
+    BOOST_TEST_EQ(first->size(), 2U);
+    BOOST_TEST(first->directory() == d);
+    for (fs::directory_snapshot::const_iterator it = first->begin();
+      it != first->end(); ++it)
+    {
+      BOOST_TEST(fs::status_known(it->status()));
+      BOOST_TEST(fs::status_known(it->symlink_status()));
+      if (it->path().filename() == "sub")
+        BOOST_TEST(fs::is_directory(it->status()));
+      else
+        BOOST_TEST(fs::is_regular_file(it->status()));
+    }
+    fs::directory_snapshot_ptr second = cache.list(d);
+    BOOST_TEST(second == first);  // the same snapshot, shared
+    fs::listing_cache_statistics stats = cache.statistics();
+    BOOST_TEST_EQ(stats.misses, 1U);
+    BOOST_TEST_EQ(stats.hits, 1U);
+    BOOST_TEST_EQ(stats.entries, 1U);
+
+    //  a change to the directory changes its last write time
+    create_file(d / "g", "x");
+    fs::directory_snapshot_ptr third = cache.list(d);
+    BOOST_TEST(third != first);
+    BOOST_TEST_EQ(third->size(), 3U);
+    BOOST_TEST_EQ(first->size(), 2U);  // snapshots are never modified
+    fs::last_write_time(d, old_time);
+
+    //  invalidate() and make room
+    cache.invalidate(d);
+    BOOST_TEST_EQ(cache.statistics().entries, 0U);
+    BOOST_TEST(cache.list(d) != third);
+    cache.list(d / "sub");
+    cache.list(dir);
+    stats = cache.statistics();
+    BOOST_TEST_EQ(stats.entries, 2U);
+    BOOST_TEST_EQ(stats.evictions, 1U);
+
+    //  errors
+    error_code ec;
+    BOOST_TEST(!cache.list(d / "no-such-dir", ec));
+    BOOST_TEST(ec);
+    BOOST_TEST(!cache.list(d / "f", ec));
+    BOOST_TEST(ec);
+    BOOST_TEST(CHECK_EXCEPTION(bad_list, ENOENT));
+    cache.clear();
+    BOOST_TEST_EQ(cache.statistics().entries, 0U);
+
+    fs::remove_all(d);
+    cout << "  listing_cache_tests complete" << endl;
+  }
+
+  //  directory_listing_tests  ---------------------------------------------------------//
+
+  void directory_listing_tests()
+  {
+    cout << "directory_listing_tests..." << endl;
+
+    fs::path d(dir / "compact");
+    fs::create_directory(d);
+    create_file(d / "b", "bb");
+    create_file(d / "a", "a");
+    fs::create_directory(d / "c");
+
+    fs::directory_listing names(d);
+    BOOST_TEST_EQ(names.size(), 3U);
+    BOOST_TEST(names.directory() == d);
+    BOOST_TEST_EQ(names.fields(), 0U);
+    BOOST_TEST_EQ(names.permissions(0), fs::perms_not_known);
+    BOOST_TEST_EQ(names.file_size(0), 0U);
+    names.sort();
+    BOOST_TEST(names.sorted());
+    BOOST_TEST(names.filename(0) == "a");
+    BOOST_TEST_EQ(names.name_size(0), 1U);
+    BOOST_TEST(names.name(1) == fs::path("b").native());
+    BOOST_TEST(names.entry_path(2) == d / "c");
+    BOOST_TEST_EQ(names.type(0), fs::regular_file);
+    BOOST_TEST_EQ(names.type(2), fs::directory_file);
+    BOOST_TEST(fs::is_directory(names.entry(2).status()));
+    BOOST_TEST_EQ(names.find("b"), 1U);
+    BOOST_TEST_EQ(names.find("d"), fs::directory_listing::npos);
+    BOOST_TEST_EQ(names.find(""), fs::directory_listing::npos);
+
+    fs::directory_listing full(d, fs::listing_all_fields);
+    full.sort();
+    std::size_t b = full.find("b");
+    BOOST_TEST(b != fs::directory_listing::npos);
+    BOOST_TEST_EQ(full.file_size(b), 2U);
+    BOOST_TEST_EQ(full.file_size(full.find("c")), 0U);
+    BOOST_TEST(full.last_write_time(b) == fs::last_write_time(d / "b"));
+    BOOST_TEST(full.permissions(b) == fs::symlink_status(d / "b").permissions());
+#   ifdef BOOST_POSIX_API
+    BOOST_TEST(full.inode(b) != 0U);
+    fs::directory_listing inodes(d, fs::listing_inode);  // from the directory alone
+    BOOST_TEST_EQ(inodes.size(), 3U);
+    for (std::size_t i = 0; i < inodes.size(); ++i)
+    {
+      BOOST_TEST(inodes.inode(i) != 0U);
+      BOOST_TEST_EQ(inodes.inode(i), full.inode(full.find(inodes.name(i))));
+    }
+#   endif
+
+    //  the entries are examined in inode order, not the order read, yet each entry's
+    //  fields are its own
+    fs::path many(dir / "compact-many");
+    fs::create_directory(many);
+    for (int i = 0; i < 64; ++i)
+    {
+      std::ostringstream name;
+      name << 'f' << i;
+      create_file(many / name.str(), std::string(static_cast<std::size_t>(i), 'x'));
+    }
+    fs::directory_listing sized(many, fs::listing_size | fs::listing_inode);
+    BOOST_TEST_EQ(sized.size(), 64U);
+    for (std::size_t i = 0; i < sized.size(); ++i)
+    {
+      BOOST_TEST_EQ(sized.file_size(i), fs::file_size(sized.entry_path(i)));
+      BOOST_TEST_EQ(sized.type(i), fs::regular_file);
+#     ifdef BOOST_POSIX_API
+      struct stat st;
+      BOOST_TEST(::lstat(sized.entry_path(i).c_str(), &st) == 0);
+      BOOST_TEST_EQ(sized.inode(i), static_cast<boost::uint64_t>(st.st_ino));
+#     endif
+    }
+    fs::remove_all(many);
+
+    //  built by hand, and searched before and after sorting
+    fs::directory_listing built;
+    built.reserve(3, 12);
+    built.push_back("zebra", fs::file_status(fs::regular_file, fs::owner_read));
+    built.push_back("apple", fs::file_status(fs::directory_file));
+    built.push_back("mango", fs::file_status(fs::symlink_file));
+    BOOST_TEST(!built.sorted());
+    BOOST_TEST_EQ(built.find("mango"), 2U);
+    BOOST_TEST_EQ(built.permissions(0), fs::owner_read);
+    built.sort();
+    BOOST_TEST_EQ(built.find("mango"), 1U);
+    BOOST_TEST(built.filename(2) == "zebra");
+    BOOST_TEST_EQ(built.permissions(2), fs::owner_read);
+    BOOST_TEST_EQ(built.type(0), fs::directory_file);
+    BOOST_TEST(built.memory_size() > 0U);
+    built.clear();
+    BOOST_TEST(built.empty());
+
+    error_code ec;
+    fs::directory_listing missing(d / "no-such-dir", 0, ec);
+    BOOST_TEST(ec);
+    BOOST_TEST(missing.empty());
+
+    fs::remove_all(d);
+    cout << "  directory_listing_tests complete" << endl;
+  }
+
+  //  prefetch_tests  ------------------------------------------------------------------//
+
+  void prefetch_tests()
+  {
+    cout << "prefetch_tests..." << endl;
+
+    fs::path d(dir / "prefetched");
+    fs::create_directory(d);
+    create_file(d / "a", std::string(1000, 'a'));
+    create_file(d / "b", std::string(2000, 'b'));
+    create_file(d / "c", std::string(3000, 'c'));
+
+    //  0 where the system has no such request
+    boost::uintmax_t bytes = fs::prefetch(d / "b");
+    BOOST_TEST(bytes == 2000U || bytes == 0U);
+    bool advises = bytes != 0;
+    if (advises)
+    {
+      BOOST_TEST_EQ(fs::prefetch(d / "b", 500), 1500U);
+      BOOST_TEST_EQ(fs::prefetch(d / "b", 500, 100), 100U);
+      BOOST_TEST_EQ(fs::prefetch(d / "b", 5000), 0U);
+      BOOST_TEST_EQ(fs::prefetch(d), 0U);  // not a regular file
+      error_code ec;
+      fs::prefetch(d / "no-such-file", 0, 0, ec);
+      BOOST_TEST(ec);
+    }
+
+    //  a window of two, and a budget that the first two files exceed
+    fs::prefetch_options options;
+    options.window = 2;
+    options.byte_budget = 2500;
+    fs::file_prefetcher files(options);
+    files.push_back(d / "a");
+    files.push_back(d / "b");
+    files.push_back(d / "c");
+    files.push_back(d / "no-such-file");
+    BOOST_TEST_EQ(files.size(), 4U);
+    BOOST_TEST(files.front() == d / "a");
+    if (advises)
+    {
+      BOOST_TEST_EQ(files.statistics().files, 2U);
+      BOOST_TEST_EQ(files.statistics().bytes, 2500U);  // b in part
+    }
+    std::string contents;
+    BOOST_TEST(fs::load_string_file(files, contents) == d / "a");
+    BOOST_TEST_EQ(contents.size(), 1000U);
+    BOOST_TEST(files.take() == d / "b");
+    BOOST_TEST(fs::load_string_file(files, contents) == d / "c");
+    BOOST_TEST_EQ(contents, std::string(3000, 'c'));
+    BOOST_TEST(files.take() == d / "no-such-file");
+    BOOST_TEST(files.empty());
+    if (advises)
+    {
+      BOOST_TEST_EQ(files.statistics().files, 3U);
+      BOOST_TEST_EQ(files.statistics().failures, 1U);
+    }
+
+    //  in the order of a traversal
+    fs::file_prefetcher traversed;
+    traversed.append(fs::directory_iterator(d), fs::directory_iterator());
+    BOOST_TEST_EQ(traversed.size(), 3U);
+    if (advises)
+      BOOST_TEST_EQ(traversed.statistics().bytes, 6000U);
+
+    fs::remove_all(d);
+    cout << "  prefetch_tests complete" << endl;
+  }
+
+  //  instrumentation_tests  -----------------------------------------------------------//
+
+  class counting_observer : public fs::instrumentation::observer
+  {
+  public:
+    counting_observer() : calls(0), failures(0), syscalls(0) {}
+    void operation_completed(const fs::instrumentation::operation_record& r)
+    {
+      ++calls;
+      if (r.failed)
+        ++failures;
+      syscalls += r.syscalls;
+      if (r.op == fs::instrumentation::copy_file_op && r.p != 0)
+        copied = *r.p;
+    }
+
+    int               calls;
+    int               failures;
+    boost::uint64_t   syscalls;
+    fs::path          copied;
+  };
+
+  //  checks that spans nest on each thread
+  class checking_tracer : public fs::instrumentation::tracer
+  {
+  public:
+    checking_tracer() : spans(0), max_depth(0), mismatches(0) {}
+    void begin_span(const fs::instrumentation::span& s)
+    {
+      open.push_back(s.op);
+      ++spans;
+      max_depth = (std::max)(max_depth, s.depth);
+    }
+    void end_span(const fs::instrumentation::span& s,
+      const fs::instrumentation::operation_record& r)
+    {
+      if (open.empty() || open.back() != s.op || r.op != s.op)
+        ++mismatches;
+      else
+        open.pop_back();
+    }
+
+    std::vector<fs::instrumentation::operation> open;
+    int       spans;
+    unsigned  max_depth;
+    int       mismatches;
+  };
+
+  void instrumentation_tests()
+  {
+    cout << "instrumentation_tests..." << endl;
+    namespace instr = fs::instrumentation;
+
+    BOOST_TEST_EQ(std::string(instr::operation_name(instr::status_op)), "status");
+    BOOST_TEST_EQ(std::string(instr::operation_name(instr::remove_all_op)), "remove_all");
+
+    counting_observer obs;
+    BOOST_TEST(instr::set_observer(&obs) == 0);
+    instr::reset();
+
+    fs::path root(dir / "instrumented");
+    fs::create_directory(root);
+    create_file(root / "f", "instrumentation");
+    fs::copy_file(root / "f", root / "g");
+    error_code ec;
+    fs::file_size(root / "no-such-file", ec);
+    BOOST_TEST(ec);
+    fs::remove_all(root);
+
+    instr::snapshot snap;
+    instr::take_snapshot(snap);
+    BOOST_TEST(instr::set_observer(0) == (instr::enabled() ? &obs : 0));
+
+    checking_tracer tracer;
+    BOOST_TEST(instr::set_tracer(&tracer) == 0);
+    fs::create_directories(root / "a" / "b");
+    create_file(root / "a" / "b" / "f", "x");
+    fs::remove_all(root);
+    BOOST_TEST(instr::set_tracer(0) == (instr::enabled() ? &tracer : 0));
+
+    if (!instr::enabled())
+    {
+      BOOST_TEST_EQ(snap.operations[instr::remove_all_op].calls, 0U);
+      BOOST_TEST_EQ(obs.calls, 0);
+      BOOST_TEST_EQ(tracer.spans, 0);
+      cout << "  instrumentation_tests complete (not enabled)" << endl;
+      return;
+    }
+
+    const instr::operation_stats& copy = snap.operations[instr::copy_file_op];
+    BOOST_TEST_EQ(copy.calls, 1U);
+    BOOST_TEST_EQ(copy.bytes, 15U);
+    BOOST_TEST(copy.syscalls >= 4U);  // two opens and two closes, at least
+    BOOST_TEST_EQ(obs.copied, root / "f");
+
+    const instr::operation_stats& size = snap.operations[instr::file_size_op];
+    BOOST_TEST_EQ(size.calls, 1U);
+    BOOST_TEST_EQ(size.errors, 1U);
+
+    //  remove_all() counts the syscalls of the operations it calls as its own
+    const instr::operation_stats& removal = snap.operations[instr::remove_all_op];
+    BOOST_TEST_EQ(removal.calls, 1U);
+    BOOST_TEST(removal.syscalls >= 3U);  // unlink twice and rmdir
+    BOOST_TEST(removal.syscalls
+      > snap.operations[instr::symlink_status_op].syscalls);
+    BOOST_TEST(snap.operations[instr::directory_iterator_increment_op].calls >= 2U);
+
+    boost::uint64_t calls = 0, in_buckets = 0;
+    for (std::size_t i = 0; i < instr::operation_count; ++i)
+    {
+      const instr::operation_stats& stats = snap.operations[i];
+      calls += stats.calls;
+      for (std::size_t b = 0; b < instr::latency_buckets; ++b)
+        in_buckets += stats.latency[b];
+      BOOST_TEST(stats.max_ns <= stats.total_ns);
+    }
+    BOOST_TEST_EQ(calls, static_cast<boost::uint64_t>(obs.calls));
+    BOOST_TEST_EQ(in_buckets, calls);
+    BOOST_TEST(obs.failures >= 1);
+
+    //  every call traced by default, remove_all's subtrees among them
+    BOOST_TEST(tracer.spans > 10);
+    BOOST_TEST(tracer.max_depth >= 3U);  // remove_all, a, b, then symlink_status of f
+    BOOST_TEST(tracer.open.empty());
+    BOOST_TEST_EQ(tracer.mismatches, 0);
+
+    //  sampling keeps the top level, and drops whole subtrees below it
+    checking_tracer sampled;
+    instr::set_tracer(&sampled, instr::trace_options(1000000, 1));
+    fs::create_directories(root / "a" / "b");
+    fs::remove_all(root);
+    instr::set_tracer(0);
+    BOOST_TEST(sampled.spans >= 2);
+    BOOST_TEST(sampled.spans < tracer.spans);
+    BOOST_TEST_EQ(sampled.max_depth, 0U);
+    BOOST_TEST_EQ(sampled.mismatches, 0);
+
+    //  a subtree kept below full_depth is complete
+    checking_tracer whole;
+    fs::create_directories(root / "a" / "b");
+    create_file(root / "a" / "b" / "f", "x");
+    instr::set_tracer(&whole);
+    fs::remove_all(root);
+    instr::set_tracer(0);
+    checking_tracer kept;
+    fs::create_directories(root / "a" / "b");
+    create_file(root / "a" / "b" / "f", "x");
+    instr::set_tracer(&kept, instr::trace_options(2, 0));
+    int before;
+    do  // until a call is dropped, so that the next is kept
+    {
+      before = kept.spans;
+      fs::status(root);
+    } while (kept.spans != before);
+    fs::remove_all(root);
+    instr::set_tracer(0);
+    BOOST_TEST_EQ(kept.spans - before, whole.spans);
+    BOOST_TEST_EQ(kept.max_depth, whole.max_depth);
+    BOOST_TEST_EQ(kept.mismatches, 0);
+
+    std::ostringstream json;
+    {
+      instr::chrome_trace_writer writer(json);
+      instr::set_tracer(&writer);
+      fs::create_directories(root / "quote\"d");
+      fs::remove_all(root);
+      instr::set_tracer(0);
+    }
+    std::string trace(json.str());
+    BOOST_TEST(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[") == 0);
+    BOOST_TEST(trace.find("{\"name\":\"remove_all\",\"cat\":\"metadata\",\"ph\":\"B\","
+      "\"ts\":") != std::string::npos);
+    BOOST_TEST(trace.find("quote\\\"d\"}}") != std::string::npos);
+    BOOST_TEST(trace.find(",\"failed\":false}}\n]}\n") != std::string::npos);
+    BOOST_TEST(trace.size() > 100 && trace.compare(trace.size() - 4, 4, "\n]}\n") == 0);
+
+    instr::reset();
+    instr::take_snapshot(snap);
+    BOOST_TEST_EQ(snap.operations[instr::remove_all_op].calls, 0U);
+    cout << "  instrumentation_tests complete" << endl;
+  }
+
   //  predicate_and_status_tests  ------------------------------------------------------//
 
   void predicate_and_status_tests()
@@ -1126,6 +2370,59 @@ namespace
     fs::current_path(original_dir.string());
     BOOST_TEST(fs::current_path() == original_dir);
     BOOST_TEST(fs::current_path() != dir);
+
+    // the cached working directory follows current_path(p)
+    BOOST_TEST(fs::cached_current_path() == original_dir);
+    fs::current_path(dir);
+    BOOST_TEST(fs::cached_current_path() == dir);
+
+    // but not a change made behind the library's back, unless revalidated
+#   ifdef BOOST_WINDOWS_API
+    BOOST_TEST(::SetCurrentDirectoryW(original_dir.c_str()) != 0);
+#   else
+    BOOST_TEST(::chdir(original_dir.c_str()) == 0);
+#   endif
+    BOOST_TEST(fs::cached_current_path() == dir);
+    BOOST_TEST(fs::cached_current_path(true) == original_dir);
+    BOOST_TEST(fs::cached_current_path() == original_dir);
+#   ifdef BOOST_WINDOWS_API
+    BOOST_TEST(::SetCurrentDirectoryW(dir.c_str()) != 0);
+#   else
+    BOOST_TEST(::chdir(dir.c_str()) == 0);
+#   endif
+    fs::invalidate_cached_current_path();
+    BOOST_TEST(fs::cached_current_path() == dir);
+    error_code ec;
+    BOOST_TEST(fs::cached_current_path(true, ec) == dir);
+    BOOST_TEST(!ec);
+
+    // absolute_batch() makes paths absolute against the working directory
+    std::vector<fs::path> paths;
+    paths.push_back("foo");
+    paths.push_back("");
+    paths.push_back(original_dir / "bar");
+    std::vector<fs::path> absolute_paths(fs::absolute_batch(paths));
+    BOOST_TEST_EQ(absolute_paths.size(), 3U);
+    BOOST_TEST_EQ(absolute_paths[0], dir / "foo");
+    BOOST_TEST_EQ(absolute_paths[1], dir);
+    BOOST_TEST_EQ(absolute_paths[2], original_dir / "bar");
+    BOOST_TEST(fs::absolute_batch(std::vector<fs::path>(), ec).empty());
+    BOOST_TEST(!ec);
+    fs::current_path(original_dir);
+    BOOST_TEST_EQ(fs::absolute_batch(paths)[0], original_dir / "foo");
+
+#   ifdef BOOST_POSIX_API
+    // a working directory too long for current_path()'s own buffer
+    fs::path deep(dir / "deep");
+    while (deep.native().size() < 2500)
+      deep /= std::string(100, 'd');
+    fs::create_directories(deep);
+    fs::current_path(deep);
+    BOOST_TEST(fs::current_path() == deep);
+    BOOST_TEST(fs::cached_current_path() == deep);
+    fs::current_path(original_dir);
+    fs::remove_all(dir / "deep");
+#   endif
   }
 
   //  create_directories_tests  --------------------------------------------------------//
@@ -1207,6 +2504,105 @@ namespace
     BOOST_TEST(ec);
   }
 
+  //  preallocate_tests  ---------------------------------------------------------------//
+
+  void preallocate_tests()
+  {
+    cout << "preallocate_tests..." << endl;
+
+    fs::path p(dir / "preallocate_test.txt");
+    fs::path p2(dir / "preallocate_test2.txt");
+
+    fs::remove(p);
+    create_file(p, "1234567890");
+
+    error_code ec;
+    fs::preallocate(p, 0, 100, fs::preallocate_option::none, ec);
+    if (ec)
+      cout << "  preallocate not supported: " << ec.message() << endl;
+    else
+    {
+      BOOST_TEST_EQ(fs::file_size(p), 100U);
+      fs::preallocate(p, 100, 100, fs::preallocate_option::keep_size, ec);
+      BOOST_TEST_EQ(fs::file_size(p), 100U);
+    }
+
+    // the range reads as zeros afterwards, if supported
+    fs::preallocate(p, 2, 3, fs::preallocate_option::zero_range, ec);
+    if (!ec)
+    {
+      std::ifstream f(p.BOOST_FILESYSTEM_C_STR, std::ios_base::binary);
+      char buf[6];
+      f.read(buf, sizeof(buf));
+      BOOST_TEST(std::string(buf, sizeof(buf)) == std::string("12\0\0\0" "6", 6));
+    }
+
+    // copy_file with preallocate copies as before
+    fs::copy_file(p, p2,
+      fs::copy_option::overwrite_if_exists | fs::copy_option::preallocate);
+    BOOST_TEST_EQ(fs::file_size(p2), fs::file_size(p));
+    fs::remove(p2);
+
+    fs::preallocate("no such file", 0, 15, fs::preallocate_option::none, ec);
+    BOOST_TEST(ec);
+  }
+
+  //  extent_iterator_tests  -----------------------------------------------------------//
+
+  void extent_iterator_tests()
+  {
+    cout << "extent_iterator_tests..." << endl;
+
+    fs::path p(dir / "extent_test.txt");
+    fs::remove(p);
+    create_file(p, std::string(256 * 1024, 'x'));
+
+    // punch a hole in the middle, if supported, then extend the file with another
+    namespace errc = boost::system::errc;
+    error_code ec;
+    fs::punch_hole(p, 64 * 1024, 64 * 1024, ec);
+    bool punched = !ec;
+    if (ec)
+    {
+      BOOST_TEST(ec == errc::operation_not_supported || ec == errc::not_supported);
+      cout << "  punch_hole not supported: " << ec.message() << endl;
+    }
+    fs::resize_file(p, 512 * 1024);
+
+    // the extents cover the file, in order, alternating in type, with a hole where
+    // one was punched
+    boost::uintmax_t offset = 0;
+    int data_extents = 0, hole_extents = 0;
+    bool punched_hole_found = false;
+    BOOST_SCOPED_ENUM(fs::extent_type) prior_type = fs::extent_type::hole;
+    for (fs::extent_iterator it(p); it != fs::extent_iterator(); ++it)
+    {
+      BOOST_TEST_EQ(it->offset, offset);
+      BOOST_TEST(it->length != 0);
+      BOOST_TEST(offset == 0 || it->type != prior_type);
+      offset += it->length;
+      prior_type = it->type;
+      ++(it->type == fs::extent_type::data ? data_extents : hole_extents);
+      if (it->type == fs::extent_type::hole && it->offset <= 64 * 1024
+        && it->offset + it->length >= 128 * 1024)
+        punched_hole_found = true;
+    }
+    BOOST_TEST_EQ(offset, fs::file_size(p));
+    BOOST_TEST(data_extents != 0);
+    if (punched)
+      BOOST_TEST(punched_hole_found);
+    cout << "  " << data_extents << " data extents, " << hole_extents << " holes" << endl;
+
+    // an empty file has no extents
+    fs::resize_file(p, 0);
+    BOOST_TEST(fs::extent_iterator(p) == fs::extent_iterator());
+
+    fs::extent_iterator bad("no such file", ec);
+    BOOST_TEST(ec);
+    BOOST_TEST(bad == fs::extent_iterator());
+    fs::remove(p);
+  }
+
   //  status_of_nonexistent_tests  -----------------------------------------------------//
 
   void status_of_nonexistent_tests()
@@ -2250,9 +3646,12 @@ int cpp_main(int argc, char* argv[])
   create_hard_link_tests();
   create_symlink_tests();
   resize_file_tests();
+  preallocate_tests();
+  extent_iterator_tests();
   absolute_tests();
   canonical_basic_tests();
   permissions_tests();
+  permissions_all_tests();
   copy_file_tests(f1, d1);
   if (create_symlink_ok)  // only if symlinks supported
   {
@@ -2264,8 +3663,19 @@ int cpp_main(int argc, char* argv[])
   iterator_status_tests();  // lots of cases by now, so a good time to test
 //  dump_tree(dir);
   recursive_directory_iterator_tests();
+  directory_cursor_tests();
   recursive_iterator_status_tests();  // lots of cases by now, so a good time to test
   rename_tests();
+  move_tests();
+  bulk_tests(true);
+  bulk_tests(false);
+  generate_tree_tests();
+  instrumentation_tests();
+  backend_tests();
+  caching_backend_tests();
+  listing_cache_tests();
+  directory_listing_tests();
+  prefetch_tests();
   remove_tests(dir);
   if (create_symlink_ok)  // only if symlinks supported
     remove_symlink_tests();
@@ -275,6 +275,19 @@ namespace
     CHECK(de != directory_entry("goo.bar"));
     de.replace_filename("bar.foo");
     CHECK(de.path() == "bar.foo");
+
+# if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    //  a path moved in leaves its source empty, having given up its storage
+    path p("long enough to avoid small object optimization");
+    directory_entry moved(std::move(p), file_status(regular_file, owner_all));
+    CHECK(moved.path() == "long enough to avoid small object optimization");
+    CHECK(moved.status() == file_status(regular_file, owner_all));
+    CHECK(p.empty());
+    p = "another name long enough to avoid small object optimization";
+    moved.assign(std::move(p));
+    CHECK(moved.path() == "another name long enough to avoid small object optimization");
+    CHECK(p.empty());
+# endif
   }
 
   //  directory_entry_overload_test  ---------------------------------------------------//
@@ -328,6 +341,26 @@ namespace
     std::string round_trip;
     load_string_file(p, round_trip);
     BOOST_TEST_EQ(contents, round_trip);
+
+    save_string_file(p, contents + contents, preallocate_option::none);
+    BOOST_TEST_EQ(file_size(p), 20u);
+    load_string_file(p, round_trip);
+    BOOST_TEST_EQ(contents + contents, round_trip);
+
+    // options that would discard what is written are rejected, leaving the file alone
+    bool threw = false;
+    try { save_string_file(p, contents, preallocate_option::punch_hole); }
+    catch (const filesystem_error& ex)
+    {
+      threw = true;
+      BOOST_TEST(ex.code() == boost::system::errc::invalid_argument);
+    }
+    BOOST_TEST(threw);
+    threw = false;
+    try { save_string_file(p, contents, preallocate_option::zero_range); }
+    catch (const filesystem_error&) { threw = true; }
+    BOOST_TEST(threw);
+    BOOST_TEST_EQ(file_size(p), 20u);
   }
 
 }  // unnamed namespace
@@ -30,9 +30,12 @@
 #endif
 
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/path_builder.hpp>
+#include <boost/filesystem/basic_path.hpp>
 
 #include <boost/filesystem/detail/utf8_codecvt_facet.hpp>  // for imbue tests
 #include "test_codecvt.hpp"                                // for codecvt arg tests
+#include "allocation_count.hpp"                            // for move and arena tests
 #include <boost/detail/lightweight_test_report.hpp>
 #include <boost/smart_ptr.hpp>  // used constructor tests
 #include <boost/functional/hash.hpp>
@@ -49,6 +52,8 @@
 namespace fs = boost::filesystem;
 namespace bs = boost::system;
 using boost::filesystem::path;
+using boost::filesystem::path_builder;
+using boost::filesystem::join;
 using std::cout;
 using std::endl;
 using std::string;
@@ -305,6 +310,244 @@ namespace
 
   }
 
+  //  test_move_aware_api  -------------------------------------------------------------//
+
+  void test_move_aware_api()
+  {
+    std::cout << "testing move_aware_api..." << std::endl;
+    allocation_counting counting;
+
+# if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+#   ifdef BOOST_WINDOWS_API
+#     define BOOST_FS_LONG L"long enough to avoid small object optimization\\"
+#   else   // POSIX paths
+#     define BOOST_FS_LONG L"long enough to avoid small object optimization/"
+#   endif
+
+    const string name("long enough to avoid small object optimization");
+    const path::string_type native_name(name.begin(), name.end());
+
+    path::string_type s(native_name);
+    std::size_t before = allocations();
+    path from_string(std::move(s));
+    BOOST_TEST_EQ(allocations(), before);
+    BOOST_TEST(from_string.native() == native_name);
+
+    s = native_name;
+    path assigned;
+    before = allocations();
+    assigned = std::move(s);
+    BOOST_TEST_EQ(allocations(), before);
+    BOOST_TEST(assigned.native() == native_name);
+
+    before = allocations();
+    path::string_type released(assigned.release());
+    BOOST_TEST_EQ(allocations(), before);
+    BOOST_TEST(released == native_name);
+    BOOST_TEST(assigned.empty());
+
+    //  an rvalue lhs is appended to in place, so with room to spare nothing is allocated
+    released.reserve(released.size() + 16);
+    path lhs(std::move(released));
+    before = allocations();
+    path joined(std::move(lhs) / "x");
+    BOOST_TEST_EQ(allocations(), before);
+    PATH_IS(joined, BOOST_FS_LONG L"x");
+    path::string_type spare(joined.release());
+    spare.reserve(spare.size() + 16);
+    path concatenated(std::move(spare));
+    before = allocations();
+    path result(std::move(concatenated) + ".y");
+    BOOST_TEST_EQ(allocations(), before);
+    PATH_IS(result, BOOST_FS_LONG L"x.y");
+
+    //  whereas an lvalue lhs is copied
+    before = allocations();
+    path copied(result / "z");
+    BOOST_TEST(allocations() > before);
+    BOOST_TEST(!result.empty());
+    PATH_IS(result + ".w", BOOST_FS_LONG L"x.y.w");
+#   undef BOOST_FS_LONG
+# else
+    std::cout <<
+      "Test skipped because compiler does not support move semantics" << std::endl;
+# endif
+  }
+
+  //  test_join_and_path_builder  ------------------------------------------------------//
+
+  void test_join_and_path_builder()
+  {
+    std::cout << "testing join_and_path_builder..." << std::endl;
+    allocation_counting counting;
+
+# ifdef BOOST_WINDOWS_API
+#   define BOOST_FS_SEP L"\\"
+# else   // POSIX paths
+#   define BOOST_FS_SEP L"/"
+# endif
+
+    //  separators are added as operator/= adds them
+    PATH_IS(join("foo"), L"foo");
+    PATH_IS(join("foo", "bar"), L"foo" BOOST_FS_SEP L"bar");
+    PATH_IS(join("/", "foo", "bar"), L"/foo" BOOST_FS_SEP L"bar");
+    PATH_IS(join("foo/", "bar"), L"foo/bar");
+    PATH_IS(join("foo", "/bar"), L"foo/bar");
+    PATH_IS(join("", "foo", "", "bar"), L"foo" BOOST_FS_SEP L"bar");
+    PATH_IS(join(path("foo"), string("bar"), L"baz", "a", "b", "c"),
+      L"foo" BOOST_FS_SEP L"bar" BOOST_FS_SEP L"baz" BOOST_FS_SEP L"a" BOOST_FS_SEP
+      L"b" BOOST_FS_SEP L"c");
+    BOOST_TEST(join("foo", "bar") == path("foo") / "bar");
+    if (platform == "Windows")
+      PATH_IS(join("c:", "foo"), L"c:foo");
+
+# if !defined(BOOST_NO_CXX11_VARIADIC_TEMPLATES) \
+  && !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    //  the parts are paths already, so the result is the only allocation
+    const path root("a root long enough to avoid small object optimization");
+    const path dir("a directory long enough to avoid small object optimization");
+    const path name("a filename long enough to avoid small object optimization");
+    std::size_t before = allocations();
+    path joined(join(root, dir, name));
+    BOOST_TEST_EQ(allocations(), before + 1);
+    BOOST_TEST(joined == root / dir / name);
+# endif
+
+    path_builder b("/");
+    BOOST_TEST_EQ(b.depth(), 0U);
+    b.push("foo");
+    PATH_IS(b.path(), L"/foo");
+    b.push("bar").push("");
+    PATH_IS(b.path(), L"/foo" BOOST_FS_SEP L"bar");
+    BOOST_TEST_EQ(b.depth(), 3U);
+    b.pop();
+    PATH_IS(b.path(), L"/foo" BOOST_FS_SEP L"bar");
+    b.pop();
+    PATH_IS(b.path(), L"/foo");
+    b.push("baz/");
+    b.push("qux");
+    PATH_IS(b.path(), L"/foo" BOOST_FS_SEP L"baz/qux");
+    b.pop();
+    PATH_IS(b.path(), L"/foo" BOOST_FS_SEP L"baz/");
+    b.pop();
+    b.pop();
+    PATH_IS(b.path(), L"/");
+    BOOST_TEST_EQ(b.depth(), 0U);
+    b.push(b.path());                                   // self-push
+    PATH_IS(b.path(), L"//");
+    b.pop();
+    PATH_IS(b.path(), L"/");
+
+    b.assign("foo");
+    BOOST_TEST_EQ(b.depth(), 0U);
+    b.push("bar");
+    path released(b.release());
+    PATH_IS(released, L"foo" BOOST_FS_SEP L"bar");
+    BOOST_TEST(b.path().empty());
+    BOOST_TEST_EQ(b.depth(), 0U);
+
+# if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    //  pushing and popping within the room reserved allocates nothing
+    path_builder traversal(root);
+    traversal.reserve(root.native().size() + dir.native().size()
+      + name.native().size() + 2, 2);
+    before = allocations();
+    for (int i = 0; i < 3; ++i)
+    {
+      traversal.push(dir).push(name);
+      traversal.pop();
+      traversal.pop();
+    }
+    BOOST_TEST_EQ(allocations(), before);
+    BOOST_TEST(traversal.path() == root);
+# endif
+  }
+
+  //  test_basic_path_and_inline_path  -------------------------------------------------//
+
+  void test_basic_path_and_inline_path()
+  {
+    std::cout << "testing basic_path_and_inline_path..." << std::endl;
+    allocation_counting counting;
+
+    using boost::filesystem::basic_path;
+    using boost::filesystem::inline_path;
+
+    //  separators are added as operator/= adds them
+    basic_path<> bp(path("/foo"));
+    bp /= path("bar");
+    bp /= "";
+    bp /= "/baz";
+    bp += ".txt";
+    PATH_IS(bp, L"/foo" BOOST_FS_SEP L"bar/baz.txt");
+    bp = path("foo/");
+    bp /= bp;                                           // self-append
+    PATH_IS(bp, L"foo/foo/");
+    BOOST_TEST(path(bp).filename() == ".");
+    bp.clear();
+    BOOST_TEST(bp.empty());
+
+    inline_path<> ip(path("/foo"));
+    ip /= path("bar");
+    ip /= "";
+    ip /= "/baz";
+    ip += ".txt";
+    PATH_IS(ip, L"/foo" BOOST_FS_SEP L"bar/baz.txt");
+    BOOST_TEST(ip.is_inline());
+    ip /= ip;                                           // self-append
+    PATH_IS(ip, L"/foo" BOOST_FS_SEP L"bar/baz.txt/foo" BOOST_FS_SEP L"bar/baz.txt");
+    BOOST_TEST_EQ(inline_path<>::inline_capacity, 256 / sizeof(path::value_type) - 1);
+
+    //  a path too long to hold inline moves to the heap, and back when it shrinks
+    inline_path<8> small("1234567");
+    BOOST_TEST(small.is_inline());
+    small += "8";
+    BOOST_TEST(!small.is_inline());
+    PATH_IS(small, L"12345678");
+    small /= small;                                     // self-append on the heap
+    PATH_IS(small, L"12345678" BOOST_FS_SEP L"12345678");
+    inline_path<8> copy(small);
+    PATH_IS(copy, L"12345678" BOOST_FS_SEP L"12345678");
+    small = path("abc");
+    BOOST_TEST(small.is_inline());
+    PATH_IS(small, L"abc");
+    small /= "def";
+    BOOST_TEST(small.is_inline());
+    PATH_IS(small, L"abc" BOOST_FS_SEP L"def");
+    copy.clear();
+    BOOST_TEST(copy.is_inline());
+    BOOST_TEST(copy.empty());
+
+# if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+    //  an inline_path builds a long path without touching the heap
+    const path dir("a directory long enough to avoid small object optimization");
+    std::size_t before = allocations();
+    {
+      inline_path<> stack_path(dir);
+      stack_path /= dir;
+      stack_path /= "name.txt";
+      BOOST_TEST(stack_path.is_inline());
+    }
+    BOOST_TEST_EQ(allocations(), before);
+# endif
+
+# ifndef BOOST_FILESYSTEM_NO_PMR
+    //  and a pmr::path takes its storage from the arena it is given
+    char arena[1024];
+    std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena),
+      std::pmr::null_memory_resource());
+    before = allocations();
+    {
+      boost::filesystem::pmr::path arena_path(dir, &resource);
+      arena_path /= dir;
+      arena_path /= "name.txt";
+      BOOST_TEST(arena_path.get_allocator().resource() == &resource);
+      BOOST_TEST(arena_path.native().size() > dir.native().size() * 2);
+    }
+    BOOST_TEST_EQ(allocations(), before);
+# endif
+  }
+
   //  test_appends  --------------------------------------------------------------------//
 
   void test_appends()
@@ -1222,6 +1465,9 @@ int test_main(int, char*[])
   test_constructors();
   test_assignments();
   test_move_construction_and_assignment();
+  test_move_aware_api();
+  test_join_and_path_builder();
+  test_basic_path_and_inline_path();
   test_appends();
   test_concats();
   test_modifiers();
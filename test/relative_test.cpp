@@ -15,10 +15,14 @@
 
 #include <boost/config/warning_disable.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/relativizer.hpp>
 #include <boost/detail/lightweight_test_report.hpp>
 #include <iostream>
+#include <vector>
 
 using boost::filesystem::path;
+using boost::filesystem::relativizer;
 using std::cout;
 using std::endl;
 
@@ -86,6 +90,56 @@ namespace
     // paths unrelated
     BOOST_TEST(path("a/b/c").lexically_proximate("x") == "a/b/c");
   }
+
+  void relativizer_test()
+  {
+    cout << "relativizer_test..." << endl;
+
+    //  a lexical relativizer agrees with lexically_relative
+    const char* const cases[][2] =
+    {
+      {"", ""}, {"", "/foo"}, {"/foo", ""}, {"/foo", "/foo"}, {"foo", "foo"},
+      {"a/b/c", "a"}, {"a//b//c", "a"}, {"a///b//c", "a//b"}, {"a/b/c", "a/b/c"},
+      {"a/b/c", "a/b/c/x/y"}, {"a/b/c", "a/x/y"}, {"/a/b/c", "/x/y"},
+      {"a/b/c", "x"}, {"a/b/c", "/a/b/c"}, {"/a/d", "/a/b/c"}, {"c:\\y", "c:\\x"},
+      {"d:\\y", "c:\\x"}, {"/foo/new", "/foo/bar"}, {"/foo/bar/", "/foo"}
+    };
+    std::vector<path> paths;
+    for (std::size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+      relativizer lexical(cases[i][1], true);
+      BOOST_TEST(lexical.lexical());
+      BOOST_TEST(lexical.relative(cases[i][0])
+        == path(cases[i][0]).lexically_relative(cases[i][1]));
+      paths.push_back(cases[i][0]);
+    }
+
+    //  and by default it agrees with relative()
+    path base(boost::filesystem::current_path());
+    relativizer r(base / "x/../y");
+    BOOST_TEST(!r.lexical());
+    BOOST_TEST(r.base() == boost::filesystem::weakly_canonical(base / "y"));
+    BOOST_TEST(r.relative(base / "a/b") == "../a/b");
+    BOOST_TEST(r.relative(base / "y/./z") == "z");
+    BOOST_TEST(r.relative(base / "y") == ".");
+    boost::system::error_code ec;
+    BOOST_TEST(r.relative("no-such-dir/z", ec)
+      == boost::filesystem::relative("no-such-dir/z", base / "y"));
+    BOOST_TEST(!ec);
+
+    //  a batch gives the results one at a time would, on any number of threads
+    for (int i = 0; i < 1000; ++i)
+      paths.push_back(base / "y" / path(std::string(1, char('a' + i % 26))) / "f");
+    std::vector<path> one(r.relative(paths));
+    std::vector<path> several(r.relative(paths, 0, ec));
+    BOOST_TEST(!ec);
+    BOOST_TEST_EQ(one.size(), paths.size());
+    BOOST_TEST(one == several);
+    for (std::size_t i = 0; i < paths.size(); ++i)
+      BOOST_TEST(one[i] == r.relative(paths[i]));
+    BOOST_TEST(one.back() == "l/f");
+    BOOST_TEST(r.relative(std::vector<path>()).empty());
+  }
 }  // unnamed namespace
 
 //--------------------------------------------------------------------------------------//
@@ -106,6 +160,7 @@ int test_main(int, char*[])
 
   lexically_relative_test();
   lexically_proximate_test();
+  relativizer_test();
 
   return ::boost::report_errors();
 }